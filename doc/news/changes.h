@@ -38,6 +38,18 @@ inconvenience this causes.
 </p>
 
 <ol>
+  <li> Changed: The memory for user pointers and user indices of a
+  Triangulation is now only allocated when the first of them is set on
+  objects of a given kind, e.g. on the cells of one level. This first write
+  must therefore not happen concurrently with other accesses to the user
+  data of these objects; set one user index or pointer before starting
+  threads that set others. Furthermore, neighbor information can only be
+  stored for cells on less than 65535 levels, a limit that is well beyond
+  what vertex coordinates in double precision can resolve.
+  <br>
+  (agent, 2026/10/18)
+  </li>
+
   <li> Changed: deal.II used to create template instantiations for scalar
   types <tt>double</tt>, <tt>float</tt>, and <tt>long double</tt>. Since
   <tt>long double</tt> is rarely used and the additional precision does
@@ -269,6 +281,271 @@ inconvenience this causes.
 
 <ol>
 
+ <li> Fixed: GridIn::read_vtk() read the material ids of the
+ <code>CELL_DATA</code> section as integers, although the section declares
+ them as <code>double</code>. If they were written as floating point
+ numbers, e.g. <code>1.000000</code>, only the first cell got the correct
+ id and all others were assigned zero. All cells now get the ids given in
+ the file.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> Improved: KellyErrorEstimator now stores the face integrals in an array
+ indexed by the face index rather than in a map of face iterators. Since
+ every face is integrated on exactly one of its cells, the threads write
+ their results directly into this array instead of funneling them through a
+ serial copier, and the contributions of the faces are collected on the
+ cells in parallel as well.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: SolutionTransfer::build_transfer_matrix() computes the sparse
+ matrix that maps vectors on the old mesh to the interpolated vectors on the
+ new one. Any number of vectors can then be transferred by one matrix-vector
+ product each. The new function SolutionTransfer::prepare_for_transfer_matrix()
+ prepares this for meshes on which cells are also coarsened, without the
+ need to know the vectors beforehand.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> Improved: parallel::distributed::SolutionTransfer now computes the
+ values to be stored on the cells in parallel before the mesh is refined,
+ and interpolates the stored values to the new cells in parallel after it
+ has been refined. The values of all vectors are restricted and prolongated
+ at once on each cell.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: DataOut::build_coarsened_patches() creates patches on the cells of
+ a given refinement level rather than on the active cells, optionally
+ restricted to the cells intersecting a box or a slice. Solution values are
+ interpolated to the coarser cells and cell data is averaged. This allows
+ writing quick-look output of very large computations, also in parallel.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: DataOutInterface::write_flat_data() fills a DataOutBase::FlatData
+ object with flat arrays of point coordinates, connectivity and data values
+ that can be handed to in-situ visualization libraries without going through
+ a file. DataOutInterface::attach_in_situ_callback() and
+ DataOutInterface::write_in_situ() pass these arrays to user provided
+ functions, and rebuild the mesh arrays only when requested.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: The XDMFTimeSeries class writes the output of a time dependent
+ simulation into HDF5 files along with an XDMF file describing the time
+ series. The mesh is only written again if it has changed since the previous
+ time step.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: The flag DataOutBase::VtkFlags::write_raw_appended_data makes
+ DataOutBase::write_vtu() store the data arrays as raw binary data in an
+ appended data section, rather than base64 encoded within the XML elements.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: DataOut::update_patch_data() re-evaluates the data vectors on the
+ patches created by a previous call to DataOut::build_patches(), without
+ rebuilding the geometry and connectivity of the patches. The evaluation uses
+ precomputed interpolation matrices and runs in parallel over the patches.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> Improved: DataOutBase::write_vtu() now splits data arrays into blocks
+ of one megabyte that are compressed with zlib in parallel, and also base64
+ encodes the compressed data in parallel. The VTU format records the sizes
+ of the individual blocks in the header of each data array.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: The BackgroundWriter class writes files on a separate thread, in
+ the order in which they were submitted, with a bound on the memory held by
+ requests that have not been completed yet. The new function
+ DataOutInterface::write_vtu_in_background() copies the patches into such a
+ request, so that encoding, compression and writing of the output overlap
+ with the computations that follow.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: parallel::distributed::Triangulation::register_data_attach_variable_size()
+ and parallel::distributed::Triangulation::notify_ready_to_unpack_variable_size()
+ allow to attach records of different size to each cell when saving a
+ triangulation with save(). The records are written with collective MPI-IO
+ into a file that starts with a table of their offsets, so that load() only
+ reads those parts of the file that belong to the locally owned cells, also
+ when the number of processes differs from the one used for saving. The data
+ of fixed size attached through register_data_attach() is still stored
+ alongside the p4est forest. parallel::distributed::SolutionTransfer now uses
+ these records for serialization, so that every cell only stores the values
+ of its own degrees of freedom. Checkpoints written by previous versions can
+ still be read.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> Improved: GridReordering::reorder_cells() now orients the edges of 3d
+ meshes in time that is essentially linear in the number of cells, by
+ identifying edges through buckets of vertices and determining the
+ directions of all sets of parallel edges with a union-find structure. The
+ cells are then rotated in parallel.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> Improved: GridIn::read_msh(), GridIn::read_ucd() and
+ GridIn::read_vtk() now read the whole file into memory and parse the
+ vertices and cells in parallel, which makes reading large meshes
+ considerably faster. GridIn::read_msh() can now also read the binary
+ variant of version 2 of the Gmsh format.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: The class parallel::fullydistributed::Triangulation is a
+ distributed triangulation in which every processor only stores its part
+ of the coarse mesh and a ghost layer of coarse cells, rather than the
+ complete coarse mesh. It is created from a
+ parallel::fullydistributed::ConstructionData object, which can be
+ extracted from a serial mesh by
+ parallel::fullydistributed::create_construction_data(). DoFHandler
+ objects number the degrees of freedom on it in parallel. To give cells
+ the same CellId on all processors, Triangulation has the new virtual
+ functions Triangulation::coarse_cell_index_to_coarse_cell_id() and
+ Triangulation::coarse_cell_id_to_coarse_cell_index().
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: parallel::distributed::CellWeights provides a cost model for the
+ weighted partitioning of triangulations. The cost of a cell can be
+ estimated from the number of degrees of freedom of its finite element in
+ an hp::DoFHandler, or be measured, also per cell batch in a
+ MatrixFree::cell_loop(). CellWeights::repartition_if_imbalanced() only
+ repartitions the mesh if the load imbalance exceeds a threshold. The new
+ signal Triangulation::Signals::pre_distributed_repartition is triggered
+ before the cell weights are queried.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: The RemotePointEvaluation class evaluates the values and gradients
+ of finite element functions at arbitrary points of a distributed mesh,
+ including points in cells owned by other processors. The points are
+ located once, and the resulting communication pattern is reused for all
+ subsequent evaluations on the same points. CellLocator has a new function
+ find_all_active_cells_around_point().
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: Mapping::transform_points_real_to_unit_cell() maps many points on
+ the same cell to the reference cell at once. MappingQGeneric implements it
+ by computing the support points of the cell only once, by inverting affine
+ cells directly, and by running the Newton iteration on several points at
+ once with VectorizedArray. Functions::FEFieldFunction uses the new function
+ to find the reference coordinates of the points within a cell.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: The CellLocator class finds the active cells around given
+ points using a tree of the bounding boxes of the cells, rather than by a
+ search over all vertices as GridTools::find_active_cell_around_point()
+ does. It can locate many points at once in parallel, and it is rebuilt
+ automatically when the triangulation changes.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: Triangulation::set_cell_vertex_index_caching() allows to store
+ a flat table of the vertex indices of all cells. TriaAccessor::vertex()
+ and TriaAccessor::vertex_index() then read the vertices of cells directly
+ from this table instead of going through the faces and lines of the cell.
+ The table is kept up to date through the refinement signals of the
+ triangulation.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> Improved: The Triangulation class now uses less memory per cell. The
+ neighbor information is stored as a four byte index plus a two byte level
+ instead of a pair of integers, and the memory for user pointers and user
+ indices is only allocated once one of them is set, and released again by
+ Triangulation::clear_user_data(). As a consequence, the serialization
+ format of triangulations has changed.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> Improved: Triangulation::execute_coarsening_and_refinement() now
+ computes the locations of new vertices on refined edges, checks the new
+ cells for distortion, and sets up the neighbor information of all cells in
+ parallel. These steps make up a large part of the cost of refinement,
+ in particular when the new vertices are placed on curved manifolds.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> Improved: The functions std::sin, std::cos, std::tan, std::exp,
+ std::log, and std::pow for VectorizedArray<double> and
+ VectorizedArray<float> are now evaluated with SIMD instructions instead of
+ calling the scalar functions for each entry of the array. This speeds up
+ the evaluation of nonlinear coefficients in matrix-free operators.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: The testsuite now contains a category <code>benchmarks</code>
+ with programs that measure the performance of matrix-vector products,
+ matrix-free operator evaluation, constraint distribution, DoF enumeration,
+ mesh refinement and VTU output. The results are written in JSON format and
+ can be compared against a stored baseline to detect performance
+ regressions.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: The class PerformanceTrace records the number of calls, the wall
+ time, and optionally hardware counters of nested regions on all threads,
+ and can write them as a Chrome trace. A number of expensive library
+ functions as well as the sections of TimerOutput are instrumented this way.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: hp::FEValues, hp::FEFaceValues and hp::FESubfaceValues have a
+ function precalculate_fe_values() that creates the underlying FEValues
+ objects for all (or a given set of) combinations of finite element, mapping
+ and quadrature indices right away and concurrently, rather than one at a
+ time the first time they are needed. This reduces the setup time of
+ scratch objects for hp assembly loops with many finite elements.
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
+ <li> New: VectorMemory::alloc() has an overload taking a model vector
+ that returns a vector of the same layout. GrowingVectorMemory implements it
+ by preferring unused vectors whose size (or partitioner) already matches,
+ which avoids repeated reallocation when vectors of different sizes are used
+ at the same time, e.g. in multigrid. Usage of the pool can be queried via
+ GrowingVectorMemory::get_statistics().
+ <br>
+ (agent, 2026/10/18)
+ </li>
+
  <li> Fixed: The Tensor class was not explicitly instantiated. This did
  not matter in almost all contexts because its members are all defined
  as @p inline in the header file. The only cases where it matters if one
@@ -0,0 +1,236 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__background_writer_h
+#define dealii__background_writer_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/base/std_cxx11/function.h>
+
+#ifdef DEAL_II_WITH_THREADS
+#  include <deal.II/base/std_cxx11/condition_variable.h>
+#  include <deal.II/base/std_cxx11/mutex.h>
+#endif
+
+#include <list>
+#include <ostream>
+#include <string>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/**
+ * A class that writes files on a separate thread so that the program can
+ * continue with its computations while output or checkpoint data is encoded,
+ * compressed and written to disk.
+ *
+ * Each write request consists of the name of a file and either a buffer of
+ * bytes or a function that writes into a stream. The data the request
+ * operates on must be owned by the request, i.e., buffers are moved into this
+ * object and functions need to work on their own snapshot of the data to be
+ * written. DataOutInterface::write_vtu_in_background(), for example, copies
+ * the patches of a DataOut object into such a snapshot, so that the DataOut
+ * object can be reused or destroyed right away.
+ *
+ * Every object of this class owns a single worker thread that executes the
+ * requests one after the other, in the order in which they were submitted.
+ * The requests that have been submitted but not yet completed -- the staging
+ * area -- are kept in a queue. The memory they occupy can be bounded
+ * through the argument of the constructor. If submitting a new request would
+ * exceed this bound, the write() functions first wait until enough of the
+ * earlier requests have been completed. The memory of a request is released
+ * as soon as it has been written.
+ *
+ * wait() blocks until all requests submitted so far have been completed. If
+ * one of them failed, for example because the file could not be opened,
+ * the error is not reported on the worker thread but by wait(), which then
+ * throws an exception of type ExcWriteFailed. The destructor also waits for
+ * all outstanding requests, but as it can not throw an exception, errors
+ * that have not yet been reported are lost; call wait() before the object
+ * is destroyed to be notified of them.
+ *
+ * A typical use case is to overlap the writing of graphical output with the
+ * next time step:
+ * @code
+ *   BackgroundWriter writer (1<<30);
+ *   for (unsigned int timestep=0; ...; ++timestep)
+ *     {
+ *       ... solve ...
+ *
+ *       DataOut<dim> data_out;
+ *       ... attach vectors, build patches ...
+ *       data_out.write_vtu_in_background (writer, "solution-" +
+ *                                         Utilities::int_to_string (timestep, 4) +
+ *                                         ".vtu");
+ *     }
+ *   writer.wait ();
+ * @endcode
+ *
+ * @note If deal.II is configured without thread support, the requests are
+ * executed right away on the calling thread. Errors are nevertheless only
+ * reported by wait().
+ *
+ * @note Since the requests are executed on a different thread, they must not
+ * call MPI functions unless MPI has been initialized with support for
+ * multiple threads. Collective output functions like
+ * DataOutInterface::write_vtu_in_parallel() are therefore not offered in a
+ * background version.
+ *
+ * @ingroup output
+ */
+class BackgroundWriter : public Subscriptor
+{
+public:
+  /**
+   * Constructor. Starts the worker thread. The argument is the maximal
+   * number of bytes that the requests that have not yet been completed may
+   * occupy. A value of zero means that the staging area is not bounded.
+   */
+  BackgroundWriter (const std::size_t max_staging_memory = 0);
+
+  /**
+   * Destructor. Waits for all outstanding requests and stops the worker
+   * thread. Errors that have not been reported by wait() are ignored.
+   */
+  ~BackgroundWriter ();
+
+  /**
+   * Write the given bytes into the file with the given name. The contents of
+   * @p buffer are moved into this object, i.e., @p buffer is empty upon
+   * return.
+   */
+  void
+  write (const std::string &filename,
+         std::vector<char>  &buffer);
+
+  /**
+   * Create the file with the given name and call @p writer with a stream
+   * into this file. The function object must hold all the data it writes,
+   * and @p memory is the number of bytes it occupies, for the purpose of
+   * bounding the staging area.
+   */
+  void
+  write (const std::string                                  &filename,
+         const std_cxx11::function<void (std::ostream &)>  &writer,
+         const std::size_t                                   memory);
+
+  /**
+   * Wait until all requests submitted so far have been completed. If any of
+   * the requests completed since the last call to this function failed, an
+   * exception of type ExcWriteFailed is thrown that describes the first of
+   * these failures.
+   */
+  void wait ();
+
+  /**
+   * Return the number of bytes occupied by requests that have not yet been
+   * completed.
+   */
+  std::size_t staged_memory () const;
+
+  /**
+   * Exception.
+   */
+  DeclException1 (ExcFileNotOpen,
+                  std::string,
+                  << "Could not open file " << arg1 << " for writing.");
+
+  /**
+   * Exception.
+   */
+  DeclException1 (ExcWriteFailed,
+                  std::string,
+                  << "A file could not be written in the background. The "
+                  << "error was:\n" << arg1);
+
+private:
+  /**
+   * A request that has been submitted but not yet started.
+   */
+  struct Request
+  {
+    std::string                                  filename;
+    std_cxx11::function<void (std::ostream &)>   writer;
+    std::size_t                                  memory;
+  };
+
+  /**
+   * The bound on the staging area.
+   */
+  const std::size_t max_staging_memory;
+
+  /**
+   * The requests that have not yet been started, in the order of their
+   * submission.
+   */
+  std::list<Request> queue;
+
+  /**
+   * The memory occupied by the queued requests and the one currently being
+   * executed.
+   */
+  std::size_t current_memory;
+
+  /**
+   * Whether the worker thread is currently executing a request.
+   */
+  bool busy;
+
+  /**
+   * Set by the destructor to tell the worker thread to stop once the queue
+   * is empty.
+   */
+  bool shut_down;
+
+  /**
+   * The description of the first request that failed since the last call to
+   * wait(), or an empty string.
+   */
+  std::string error;
+
+  /**
+   * Execute one request and record the error if it fails.
+   */
+  void execute (const Request &request);
+
+#ifdef DEAL_II_WITH_THREADS
+  /**
+   * The mutex guarding all of the variables above, and the conditions the
+   * worker thread and the submitting thread wait for.
+   */
+  mutable std_cxx11::mutex      mutex;
+  std_cxx11::condition_variable request_submitted;
+  std_cxx11::condition_variable request_completed;
+
+  /**
+   * The worker thread.
+   */
+  Threads::Thread<void>         worker;
+
+  /**
+   * The function run by the worker thread: take requests from the queue
+   * and execute them until the destructor sets the shut_down flag.
+   */
+  void run_worker ();
+#endif
+};
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
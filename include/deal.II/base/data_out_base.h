@@ -21,7 +21,9 @@
 #include <deal.II/base/point.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/geometry_info.h>
+#include <deal.II/base/std_cxx11/function.h>
 #include <deal.II/base/std_cxx11/tuple.h>
+#include <deal.II/base/thread_management.h>
 
 #include <vector>
 #include <string>
@@ -44,6 +46,7 @@ DEAL_II_NAMESPACE_OPEN
 
 class ParameterHandler;
 class XDMFEntry;
+class BackgroundWriter;
 
 /**
  * This is a base class for output of data on meshes of very general form.
@@ -915,13 +918,32 @@ namespace DataOutBase
      */
     ZlibCompressionLevel compression_level;
 
+    /**
+     * Flag determining whether write_vtu() stores the data arrays as raw
+     * binary data in an appended data section at the end of the file, rather
+     * than base64 encoded (or, without zlib, as ASCII text) within the XML
+     * elements that describe them. Raw data avoids the encoding step and is
+     * about a third smaller than base64 encoded data, but the resulting file
+     * is no longer valid XML.
+     *
+     * The flag is ignored by write_vtk() and by
+     * DataOutBase::write_vtu_main(), and consequently by
+     * DataOutInterface::write_vtu_in_parallel() if deal.II is configured with
+     * MPI, since the appended data section can only be written once all
+     * pieces of a file are known.
+     *
+     * Default is <tt>false</tt>.
+     */
+    bool write_raw_appended_data;
+
     /**
      * Constructor.
      */
     VtkFlags (const double       time   = std::numeric_limits<double>::min(),
               const unsigned int cycle  = std::numeric_limits<unsigned int>::min(),
               const bool print_date_and_time = true,
-              const ZlibCompressionLevel compression_level = best_compression);
+              const ZlibCompressionLevel compression_level = best_compression,
+              const bool write_raw_appended_data = false);
   };
 
 
@@ -1217,6 +1239,96 @@ namespace DataOutBase
   };
 
 
+  /**
+   * A representation of a set of patches in the form of flat, contiguous
+   * arrays for the point coordinates, the connectivity of the cells, and the
+   * data sets, as needed by in-situ visualization and analysis tools. Unlike
+   * the output functions of this namespace, which encode the patches into a
+   * stream, this representation involves no encoding at all, and the arrays
+   * can be handed to other libraries without copying them, for example by
+   * wrapping the pointers <tt>&points[0]</tt> or <tt>&data(i,0)</tt> in the
+   * array types of these libraries. These pointers remain valid until the
+   * object is filled anew.
+   *
+   * Objects of this type are filled by DataOutBase::write_flat_data() and
+   * DataOutInterface::write_flat_data().
+   *
+   * @ingroup output
+   */
+  struct FlatData
+  {
+    /**
+     * Constructor.
+     */
+    FlatData ();
+
+    /**
+     * Return the number of points.
+     */
+    unsigned int n_points () const;
+
+    /**
+     * Return the number of cells.
+     */
+    unsigned int n_cells () const;
+
+    /**
+     * Return an estimate for the memory consumption, in bytes, of this
+     * object.
+     */
+    std::size_t memory_consumption () const;
+
+    /**
+     * The dimension of the cells, and the number of vertices of each cell.
+     */
+    unsigned int dimension;
+    unsigned int vertices_per_cell;
+
+    /**
+     * The type of all cells in the numbering of the VTK library, e.g. 9 for
+     * quadrilaterals and 12 for hexahedra.
+     */
+    unsigned int vtk_cell_type;
+
+    /**
+     * The coordinates of the points. Independent of the space dimension,
+     * each point has three coordinates, i.e., the coordinates of point
+     * <tt>i</tt> are stored at positions <tt>3*i</tt> to <tt>3*i+2</tt>,
+     * where unused coordinates are zero.
+     */
+    std::vector<double> points;
+
+    /**
+     * The indices of the vertices of the cells, in the order used by VTK,
+     * i.e., the vertices of cell <tt>c</tt> are stored at positions
+     * <tt>c*vertices_per_cell</tt> to <tt>(c+1)*vertices_per_cell-1</tt>.
+     */
+    std::vector<unsigned int> connectivity;
+
+    /**
+     * The number of times the points and the connectivity have been
+     * rebuilt. Consumers can compare this number with the one they saw last
+     * time to find out whether they need to update their view of the mesh.
+     */
+    unsigned int n_mesh_updates;
+
+    /**
+     * The names of the data sets, and the ranges of data sets that form
+     * vectors, as returned by DataOutInterface::get_dataset_names() and
+     * DataOutInterface::get_vector_data_ranges().
+     */
+    std::vector<std::string> data_names;
+    std::vector<std_cxx11::tuple<unsigned int, unsigned int, std::string> > vector_data_ranges;
+
+    /**
+     * The values of the data sets, one data set per row, i.e., the values of
+     * data set <tt>i</tt> at all points are stored contiguously in row
+     * <tt>i</tt>.
+     */
+    Table<2,double> data;
+  };
+
+
   /**
    * Provide a data type specifying the presently supported output formats.
    */
@@ -1634,6 +1746,9 @@ namespace DataOutBase
    * This writes the main part for the xml based vtu file format. This routine
    * is used internally together with DataOutInterface::write_vtu_header() and
    * DataOutInterface::write_vtu_footer() by DataOutBase::write_vtu().
+   *
+   * This function always writes the data arrays inline, i.e., it ignores
+   * VtkFlags::write_raw_appended_data.
    */
   template <int dim, int spacedim>
   void write_vtu_main (const std::vector<Patch<dim,spacedim> > &patches,
@@ -1751,6 +1866,21 @@ namespace DataOutBase
                             const std::vector<std_cxx11::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
                             DataOutFilter &filtered_data);
 
+  /**
+   * Fill the given FlatData object with the point coordinates, connectivity
+   * and data sets of the given patches. If @p update_mesh is false, the
+   * point coordinates and the connectivity are assumed to be unchanged since
+   * the last time the object was filled, and only the data sets are filled
+   * anew. The point coordinates and the connectivity are filled in parallel
+   * with the data sets.
+   */
+  template <int dim, int spacedim>
+  void write_flat_data (const std::vector<Patch<dim,spacedim> > &patches,
+                        const std::vector<std::string>          &data_names,
+                        const std::vector<std_cxx11::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
+                        const bool                               update_mesh,
+                        FlatData                                &flat_data);
+
   /**
    * Given an input stream that contains data written by
    * write_deal_II_intermediate(), determine the <tt>dim</tt> and
@@ -2053,6 +2183,22 @@ public:
    */
   void write_vtu_in_parallel (const char *filename, MPI_Comm comm) const;
 
+  /**
+   * Obtain data through get_patches() and write it in Vtu format to the file
+   * with the given name on the thread of the given BackgroundWriter object.
+   * The patches, names and flags are copied into a snapshot before this
+   * function returns, so the current object may be changed or destroyed
+   * while the file is being written. The encoding and compression of the
+   * data as well as the writing of the file happen in the background.
+   *
+   * Call BackgroundWriter::wait() to wait until the file has been written.
+   * The snapshot is accounted for in the staging area of @p writer with the
+   * size returned by memory_consumption() of the patches.
+   */
+  void
+  write_vtu_in_background (BackgroundWriter  &writer,
+                           const std::string &filename) const;
+
   /**
    * Some visualization programs, such as ParaView, can read several separate
    * VTU files to parallelize visualization. In that case, you need a
@@ -2285,6 +2431,35 @@ public:
    */
   void write_filtered_data (DataOutBase::DataOutFilter &filtered_data) const;
 
+  /**
+   * Fill the given object with flat arrays of the point coordinates,
+   * connectivity and data sets of the patches of this object, for use by
+   * in-situ visualization and analysis tools. See DataOutBase::FlatData and
+   * DataOutBase::write_flat_data() for details, including the meaning of
+   * @p update_mesh.
+   */
+  void write_flat_data (DataOutBase::FlatData &flat_data,
+                        const bool             update_mesh = true) const;
+
+  /**
+   * Register a function that is called by every subsequent call to
+   * write_in_situ(), with flat arrays of the current patches as argument.
+   * The arrays are owned by this object and remain valid until the next call
+   * to write_in_situ().
+   */
+  void attach_in_situ_callback (const std_cxx11::function<void (const DataOutBase::FlatData &)> &callback);
+
+  /**
+   * Fill the flat arrays owned by this object with the current patches, see
+   * write_flat_data(), and hand them to all functions registered through
+   * attach_in_situ_callback(). This function is intended to be called once
+   * per output step, after the patches have been built or updated. The
+   * arrays are reused from one call to the next, so that a time dependent
+   * simulation on a fixed mesh that passes <tt>false</tt> as @p update_mesh
+   * builds the point coordinates and connectivity only once.
+   */
+  void write_in_situ (const bool update_mesh = true);
+
 
   /**
    * Write data and grid to <tt>out</tt> according to the given data format.
@@ -2470,6 +2645,13 @@ private:
    * dimension. Can be changed by using the <tt>set_flags</tt> function.
    */
   DataOutBase::Deal_II_IntermediateFlags     deal_II_intermediate_flags;
+
+  /**
+   * The flat arrays filled by write_in_situ(), and the functions they are
+   * handed to.
+   */
+  DataOutBase::FlatData in_situ_data;
+  std::vector<std_cxx11::function<void (const DataOutBase::FlatData &)> > in_situ_callbacks;
 };
 
 
@@ -2707,6 +2889,119 @@ public:
 
 
 
+/**
+ * A class that writes the output of a time dependent simulation into a
+ * series of HDF5 files, along with an XDMF file that describes the whole time
+ * series to visualization programs.
+ *
+ * For each time step, write_time_step() writes the data vectors into a file
+ * of their own. The mesh, on the other hand, is only written if it differs
+ * from the one of the previous time step, i.e., if the node coordinates or
+ * the connectivity have changed on any of the processes. All time steps that
+ * share the same mesh refer to the same mesh file. For a simulation that runs
+ * on a fixed mesh, the mesh is therefore written only once, rather than with
+ * each time step. This saves the effort of setting up the DataOutFilter,
+ * calling DataOutInterface::write_hdf5_parallel() with separate mesh and
+ * solution files, and keeping track of the XDMF entries by hand.
+ *
+ * The files are named <tt>prefix-mesh-0000.h5</tt>, <tt>prefix-mesh-0001.h5</tt>,
+ * etc. for the meshes, <tt>prefix-00000.h5</tt>, <tt>prefix-00001.h5</tt>,
+ * etc. for the data of the individual time steps, and <tt>prefix.xdmf</tt>
+ * for the XDMF file, which is written by write_xdmf_file(). A typical use is
+ * as follows:
+ * @code
+ *   XDMFTimeSeries time_series ("solution", MPI_COMM_WORLD);
+ *   for (unsigned int timestep=0; ...; ++timestep)
+ *     {
+ *       ... solve, possibly refine the mesh ...
+ *
+ *       DataOut<dim> data_out;
+ *       ... attach vectors, build patches ...
+ *       time_series.write_time_step (data_out, time);
+ *       time_series.write_xdmf_file ();
+ *     }
+ * @endcode
+ * Since the XDMF file describes all time steps written so far, it does not
+ * need to be rewritten after each time step, but only when the visualization
+ * program is to see the latest state.
+ *
+ * @note Like DataOutInterface::write_hdf5_parallel(), this class requires
+ * deal.II to be configured with HDF5 and only supports output in two and
+ * three space dimensions.
+ *
+ * @ingroup output
+ */
+class XDMFTimeSeries
+{
+public:
+  /**
+   * Constructor. The first argument is the prefix of the names of all files
+   * written by this object, the second one the communicator of the
+   * processes that jointly write the output.
+   */
+  XDMFTimeSeries (const std::string &filename_prefix,
+                  MPI_Comm           comm);
+
+  /**
+   * Write the data vectors of the given object into a new HDF5 file, and
+   * the mesh into a new mesh file if it differs from the one of the
+   * previous time step. Add an entry with the given time to the list of
+   * time steps. This function needs to be called on all processes of the
+   * communicator.
+   */
+  template <int dim, int spacedim>
+  void write_time_step (const DataOutInterface<dim,spacedim> &data_out,
+                        const double                          time);
+
+  /**
+   * Write the XDMF file describing all time steps written so far. This
+   * function needs to be called on all processes of the communicator, but
+   * only the first one writes the file.
+   */
+  void write_xdmf_file () const;
+
+  /**
+   * Return the number of time steps written so far.
+   */
+  unsigned int n_time_steps () const;
+
+  /**
+   * Return the number of mesh files written so far.
+   */
+  unsigned int n_mesh_files () const;
+
+private:
+  /**
+   * The prefix of the names of all files.
+   */
+  const std::string filename_prefix;
+
+  /**
+   * The communicator of the processes that write the output.
+   */
+  MPI_Comm comm;
+
+  /**
+   * The XDMF entries of the time steps written so far.
+   */
+  std::vector<XDMFEntry> entries;
+
+  /**
+   * The number of mesh files written so far, and the name of the last one.
+   */
+  unsigned int n_meshes;
+  std::string  mesh_filename;
+
+  /**
+   * The locally owned node coordinates and connectivity of the last mesh
+   * written, against which the mesh of the next time step is compared.
+   */
+  std::vector<double>       node_data;
+  std::vector<unsigned int> cell_data;
+};
+
+
+
 /* -------------------- inline functions ------------------- */
 
 namespace DataOutBase
@@ -158,7 +158,6 @@ namespace Utilities
      * Input and output vectors may be the same.
      */
     template <typename T>
-    inline
     void sum (const std::vector<T> &values,
               const MPI_Comm &mpi_communicator,
               std::vector<T> &sums);
@@ -170,7 +169,6 @@ namespace Utilities
      * Input and output vectors may be the same.
      */
     template <typename T>
-    inline
     void sum (const Vector<T> &values,
               const MPI_Comm &mpi_communicator,
               Vector<T> &sums);
@@ -244,7 +242,6 @@ namespace Utilities
      * Input and output vectors may be the same.
      */
     template <typename T>
-    inline
     void max (const std::vector<T> &values,
               const MPI_Comm &mpi_communicator,
               std::vector<T> &maxima);
@@ -295,7 +292,6 @@ namespace Utilities
      * Input and output vectors may be the same.
      */
     template <typename T>
-    inline
     void min (const std::vector<T> &values,
               const MPI_Comm &mpi_communicator,
               std::vector<T> &minima);
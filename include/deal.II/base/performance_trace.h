@@ -0,0 +1,336 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__performance_trace_h
+#define dealii__performance_trace_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/mpi.h>
+
+#include <string>
+#include <map>
+#include <iosfwd>
+
+DEAL_II_NAMESPACE_OPEN
+
+/**
+ * A global facility that records how often and for how long
+ * (possibly nested) regions of a program are executed. In contrast to
+ * TimerOutput, which is an object the user program creates and passes
+ * around, this class only has static members so that it can also be used
+ * inside the library. Several expensive functions of deal.II are
+ * instrumented this way, among them MatrixFree::cell_loop(),
+ * SparseMatrix::vmult(), parallel::distributed::Vector::compress(),
+ * DoFHandler::distribute_dofs(), and
+ * Triangulation::execute_coarsening_and_refinement().
+ *
+ * Recording is switched off by default. In that case, entering and leaving
+ * a region only costs the check of a single flag. It is switched on at run
+ * time through enable():
+ * @code
+ *   PerformanceTrace::enable ();
+ *
+ *   {
+ *     PerformanceTrace::Scope scope ("assemble");
+ *     assemble_system ();
+ *   }
+ *   solve ();
+ *
+ *   PerformanceTrace::print_summary (std::cout);
+ *   std::ofstream trace ("trace.json");
+ *   PerformanceTrace::write_chrome_trace (trace);
+ * @endcode
+ *
+ * <h3>Nesting and threads</h3>
+ *
+ * Every thread keeps its own stack of the regions it is currently in. A
+ * region entered while another one is active on the same thread is recorded
+ * under the name <tt>outer/inner</tt>, so that the time spent in, say,
+ * SparseMatrix::vmult() inside a solver can be told apart from the time
+ * spent in the same function during the setup of a preconditioner. Since
+ * all data is collected per thread and only merged when queried, recording
+ * does not require any locking, and regions can be entered and left on any
+ * number of threads concurrently.
+ *
+ * On the other hand, the settings changed by enable(), disable() and clear()
+ * are plain variables that are read by all threads without synchronization.
+ * These functions must therefore only be called while no other thread is
+ * recording, for example from the main thread outside of parallel sections
+ * such as WorkStream::run() or MatrixFree::cell_loop(). Likewise,
+ * get_section_data(), print_summary() and write_chrome_trace() must not be
+ * called while other threads are recording.
+ *
+ * Sections of a TimerOutput object are also recorded as regions while
+ * tracing is enabled, so that they show up in the output of this class as
+ * well.
+ *
+ * <h3>Output</h3>
+ *
+ * The accumulated data can be queried through get_section_data() or be
+ * printed using print_summary(). The latter also reports minimum, average
+ * and maximum over all processes of an MPI communicator. In addition,
+ * write_chrome_trace() writes every single recorded region as an event in
+ * the JSON format understood by the <tt>chrome://tracing</tt> viewer of the
+ * Chromium browser and similar tools, with one process per MPI rank and one
+ * row per thread.
+ *
+ * <h3>Hardware counters</h3>
+ *
+ * On Linux, the number of CPU cycles and instructions executed in each
+ * region can be recorded in addition to the wall time, using the
+ * <tt>perf_event_open</tt> system call. This needs to be requested
+ * explicitly in enable(), and is silently skipped if the operating system
+ * does not permit access to the counters (see the documentation of
+ * <tt>/proc/sys/kernel/perf_event_paranoid</tt>).
+ *
+ * @ingroup utilities
+ */
+class PerformanceTrace
+{
+public:
+  /**
+   * Start recording. If @p record_events is true, every single execution of
+   * a region is stored in addition to the accumulated data, so that it can
+   * later be written by write_chrome_trace(). This requires memory
+   * proportional to the number of executed regions. If @p
+   * hardware_counters is true, CPU cycles and instructions are counted as
+   * well where supported.
+   *
+   * Data recorded before a previous call to disable() is retained; call
+   * clear() to discard it.
+   */
+  static void enable (const bool record_events     = true,
+                      const bool hardware_counters = false);
+
+  /**
+   * Stop recording. Regions entered through Scope or begin_region() that are
+   * active at the time of this call are still recorded when they are left.
+   * Sections of TimerOutput objects, on the other hand, are only mirrored
+   * while recording is switched on, so they should not be active when this
+   * function is called.
+   */
+  static void disable ();
+
+  /**
+   * Return whether recording is currently switched on.
+   */
+  static bool is_enabled ();
+
+  /**
+   * Discard all recorded data.
+   *
+   * This function must not be called while regions are active on any thread.
+   */
+  static void clear ();
+
+  /**
+   * A structure holding the accumulated data of one region.
+   */
+  struct SectionData
+  {
+    /**
+     * Constructor. Initialize everything with zero.
+     */
+    SectionData ();
+
+    /**
+     * Number of times the region was executed.
+     */
+    unsigned long int n_calls;
+
+    /**
+     * Accumulated wall time of all executions of the region, in seconds.
+     */
+    double total_wall_time;
+
+    /**
+     * Shortest and longest wall time of a single execution of the region.
+     */
+    double min_wall_time;
+    double max_wall_time;
+
+    /**
+     * Accumulated number of CPU cycles and instructions. These are zero if
+     * hardware counters are not recorded.
+     */
+    unsigned long long int n_cycles;
+    unsigned long long int n_instructions;
+  };
+
+  /**
+   * Return the data accumulated for all regions recorded so far, merged over
+   * all threads. The keys of the map are the hierarchical names of the
+   * regions, i.e., the names of all enclosing regions and of the region
+   * itself, separated by slashes.
+   */
+  static std::map<std::string, SectionData> get_section_data ();
+
+  /**
+   * Print a table with the number of calls and the accumulated wall time of
+   * each region, as well as the number of cycles and instructions if these
+   * were recorded.
+   *
+   * If @p mpi_communicator contains more than one process, the function is
+   * collective and all processes need to have recorded the same set of
+   * regions. The table then lists minimum, average and maximum of the
+   * accumulated wall time over all processes, and the output is only
+   * generated on the root process.
+   */
+  static void print_summary (std::ostream   &out,
+                             const MPI_Comm &mpi_communicator = MPI_COMM_SELF);
+
+  /**
+   * Write all recorded events in the Chrome trace event format. This
+   * requires that events have been recorded, see enable(). Time stamps are
+   * given in microseconds since the first call to enable(). Each MPI process
+   * writes its own events; they can be loaded into the viewer together.
+   */
+  static void write_chrome_trace (std::ostream &out);
+
+  /**
+   * A class that records a region from its construction to its destruction
+   * (or to a call of stop()), similar to TimerOutput::Scope.
+   */
+  class Scope
+  {
+  public:
+    /**
+     * Enter the region with the given name, unless recording is switched
+     * off. The name is copied, so the string only needs to exist for the
+     * duration of this call.
+     */
+    Scope (const char *name);
+
+    /**
+     * Same as above.
+     */
+    Scope (const std::string &name);
+
+    /**
+     * Destructor. Calls stop().
+     */
+    ~Scope ();
+
+    /**
+     * Leave the region before the destructor runs. The region is left by
+     * name, so this also works if other regions (for example the sections of
+     * a TimerOutput object) have been entered after it and are still active.
+     */
+    void stop ();
+
+  private:
+    /**
+     * Whether we have entered a region that needs to be left.
+     */
+    bool active;
+
+    /**
+     * The name of the region. Only set if the region was entered.
+     */
+    std::string name;
+  };
+
+  /**
+   * Enter the region with the given name on the current thread. Every call
+   * to this function needs to be matched by a call to end_region() on the
+   * same thread. In most cases, it is simpler and exception-safe to use the
+   * Scope class instead.
+   */
+  static void begin_region (const std::string &name);
+
+  /**
+   * Leave a region on the current thread. If no name is given, the region
+   * entered last is left. Otherwise, the most recently entered region of the
+   * given name is left, even if other regions have been entered after it;
+   * if no such region is active on the current thread, nothing happens.
+   * The latter is used to mirror the sections of TimerOutput, which may be
+   * left in arbitrary order.
+   */
+  static void end_region (const std::string &name = std::string());
+
+private:
+  /**
+   * Whether recording is switched on. This is the only variable that is
+   * accessed when recording is off. It is not synchronized between threads,
+   * see the class documentation.
+   */
+  static bool enabled;
+};
+
+
+
+/* ---------------- inline functions ----------------- */
+
+
+inline
+bool
+PerformanceTrace::is_enabled ()
+{
+  return enabled;
+}
+
+
+
+inline
+PerformanceTrace::Scope::Scope (const char *name)
+  :
+  active (enabled)
+{
+  if (active)
+    {
+      this->name = name;
+      begin_region (this->name);
+    }
+}
+
+
+
+inline
+PerformanceTrace::Scope::Scope (const std::string &name)
+  :
+  active (enabled)
+{
+  if (active)
+    {
+      this->name = name;
+      begin_region (this->name);
+    }
+}
+
+
+
+inline
+void
+PerformanceTrace::Scope::stop ()
+{
+  if (active)
+    {
+      end_region (name);
+      active = false;
+    }
+}
+
+
+
+inline
+PerformanceTrace::Scope::~Scope ()
+{
+  stop ();
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -229,7 +229,6 @@ private:
 
 
 
-//TODO: The following class is not thread-safe
 /**
  * This class can be used to generate formatted output from time measurements
  * of different subsections in a program. It is possible to create several
@@ -383,6 +382,17 @@ private:
  * sure that we only generate output on a single processor. See the step-32
  * and step-40 tutorial programs for this kind of usage of this class.
  *
+ *
+ * <h3>Usage with threads and relation to PerformanceTrace</h3>
+ *
+ * All member functions of this class lock a mutex, so a TimerOutput object
+ * can be used from several threads. However, the set of active sections is
+ * shared between all threads, so two threads can not be in the same section
+ * at the same time. For a per-thread and nested view of where time is spent,
+ * including the internals of the library, use the PerformanceTrace class.
+ * While PerformanceTrace is enabled, every section of a TimerOutput object
+ * is also recorded as a region there.
+ *
  * @ingroup utilities
  * @author M. Kronbichler, 2009.
  */
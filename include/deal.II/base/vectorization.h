@@ -21,6 +21,7 @@
 #include <deal.II/base/exceptions.h>
 
 #include <cmath>
+#include <limits>
 
 // Note:
 // The flag DEAL_II_COMPILER_VECTORIZATION_LEVEL is essentially constructed
@@ -825,6 +826,192 @@ private:
 
 
 
+namespace internal
+{
+  namespace VectorizedArrayMath
+  {
+    /**
+     * Building blocks for the vectorized implementations of the functions
+     * from cmath further down. Not for use in user code.
+     *
+     * Shift the bits of each entry of @p x to the left or to the right by
+     * @p shift positions, filling in zeros. The entries are interpreted as
+     * unsigned integers of the same size for this purpose.
+     */
+    template <int shift>
+    inline
+    VectorizedArray<double>
+    shift_left (const VectorizedArray<double> &x)
+    {
+      VectorizedArray<double> res;
+      res.data = _mm512_castsi512_pd
+                 (_mm512_slli_epi64 (_mm512_castpd_si512(x.data), shift));
+      return res;
+    }
+
+    template <int shift>
+    inline
+    VectorizedArray<double>
+    shift_right (const VectorizedArray<double> &x)
+    {
+      VectorizedArray<double> res;
+      res.data = _mm512_castsi512_pd
+                 (_mm512_srli_epi64 (_mm512_castpd_si512(x.data), shift));
+      return res;
+    }
+
+    /**
+     * Bitwise and, or, and exclusive or of the entries of two fields.
+     */
+    inline
+    VectorizedArray<double>
+    bit_and (const VectorizedArray<double> &x,
+             const VectorizedArray<double> &y)
+    {
+      VectorizedArray<double> res;
+      res.data = _mm512_castsi512_pd
+                 (_mm512_and_epi64 (_mm512_castpd_si512(x.data),
+                                    _mm512_castpd_si512(y.data)));
+      return res;
+    }
+
+    inline
+    VectorizedArray<double>
+    bit_or (const VectorizedArray<double> &x,
+            const VectorizedArray<double> &y)
+    {
+      VectorizedArray<double> res;
+      res.data = _mm512_castsi512_pd
+                 (_mm512_or_epi64 (_mm512_castpd_si512(x.data),
+                                   _mm512_castpd_si512(y.data)));
+      return res;
+    }
+
+    inline
+    VectorizedArray<double>
+    bit_xor (const VectorizedArray<double> &x,
+             const VectorizedArray<double> &y)
+    {
+      VectorizedArray<double> res;
+      res.data = _mm512_castsi512_pd
+                 (_mm512_xor_epi64 (_mm512_castpd_si512(x.data),
+                                    _mm512_castpd_si512(y.data)));
+      return res;
+    }
+
+    /**
+     * Return a field with the entries of @p x where <tt>a<b</tt> and the
+     * entries of @p y otherwise.
+     */
+    inline
+    VectorizedArray<double>
+    select_less (const VectorizedArray<double> &a,
+                 const VectorizedArray<double> &b,
+                 const VectorizedArray<double> &x,
+                 const VectorizedArray<double> &y)
+    {
+      const __mmask8 mask = _mm512_cmp_pd_mask (a.data, b.data, _CMP_LT_OQ);
+      VectorizedArray<double> res;
+      res.data = _mm512_mask_blend_pd (mask, y.data, x.data);
+      return res;
+    }
+
+    /**
+     * Return whether <tt>a<b</tt> holds for at least one of the entries.
+     */
+    inline
+    bool
+    any_less (const VectorizedArray<double> &a,
+              const VectorizedArray<double> &b)
+    {
+      return _mm512_cmp_pd_mask (a.data, b.data, _CMP_LT_OQ) != 0;
+    }
+
+
+
+    template <int shift>
+    inline
+    VectorizedArray<float>
+    shift_left (const VectorizedArray<float> &x)
+    {
+      VectorizedArray<float> res;
+      res.data = _mm512_castsi512_ps
+                 (_mm512_slli_epi32 (_mm512_castps_si512(x.data), shift));
+      return res;
+    }
+
+    template <int shift>
+    inline
+    VectorizedArray<float>
+    shift_right (const VectorizedArray<float> &x)
+    {
+      VectorizedArray<float> res;
+      res.data = _mm512_castsi512_ps
+                 (_mm512_srli_epi32 (_mm512_castps_si512(x.data), shift));
+      return res;
+    }
+
+    inline
+    VectorizedArray<float>
+    bit_and (const VectorizedArray<float> &x,
+             const VectorizedArray<float> &y)
+    {
+      VectorizedArray<float> res;
+      res.data = _mm512_castsi512_ps
+                 (_mm512_and_epi32 (_mm512_castps_si512(x.data),
+                                    _mm512_castps_si512(y.data)));
+      return res;
+    }
+
+    inline
+    VectorizedArray<float>
+    bit_or (const VectorizedArray<float> &x,
+            const VectorizedArray<float> &y)
+    {
+      VectorizedArray<float> res;
+      res.data = _mm512_castsi512_ps
+                 (_mm512_or_epi32 (_mm512_castps_si512(x.data),
+                                   _mm512_castps_si512(y.data)));
+      return res;
+    }
+
+    inline
+    VectorizedArray<float>
+    bit_xor (const VectorizedArray<float> &x,
+             const VectorizedArray<float> &y)
+    {
+      VectorizedArray<float> res;
+      res.data = _mm512_castsi512_ps
+                 (_mm512_xor_epi32 (_mm512_castps_si512(x.data),
+                                    _mm512_castps_si512(y.data)));
+      return res;
+    }
+
+    inline
+    VectorizedArray<float>
+    select_less (const VectorizedArray<float> &a,
+                 const VectorizedArray<float> &b,
+                 const VectorizedArray<float> &x,
+                 const VectorizedArray<float> &y)
+    {
+      const __mmask16 mask = _mm512_cmp_ps_mask (a.data, b.data, _CMP_LT_OQ);
+      VectorizedArray<float> res;
+      res.data = _mm512_mask_blend_ps (mask, y.data, x.data);
+      return res;
+    }
+
+    inline
+    bool
+    any_less (const VectorizedArray<float> &a,
+              const VectorizedArray<float> &b)
+    {
+      return _mm512_cmp_ps_mask (a.data, b.data, _CMP_LT_OQ) != 0;
+    }
+  }
+}
+
+
+
 #elif DEAL_II_COMPILER_VECTORIZATION_LEVEL >= 2  && defined(__AVX__)
 
 /**
@@ -1502,6 +1689,208 @@ vectorized_transpose_and_store(const bool                    add_into,
 
 
 
+namespace internal
+{
+  namespace VectorizedArrayMath
+  {
+    /**
+     * Building blocks for the vectorized implementations of the functions
+     * from cmath further down, see the AVX-512 variant for a description.
+     * Without AVX2, there are no integer shifts on 256 bit registers, so
+     * the two halves are shifted separately with SSE2 instructions.
+     */
+    template <int shift>
+    inline
+    VectorizedArray<double>
+    shift_left (const VectorizedArray<double> &x)
+    {
+      VectorizedArray<double> res;
+#ifdef __AVX2__
+      res.data = _mm256_castsi256_pd
+                 (_mm256_slli_epi64 (_mm256_castpd_si256(x.data), shift));
+#else
+      const __m128i lower = _mm_slli_epi64
+                            (_mm_castpd_si128(_mm256_castpd256_pd128(x.data)), shift);
+      const __m128i upper = _mm_slli_epi64
+                            (_mm_castpd_si128(_mm256_extractf128_pd(x.data, 1)), shift);
+      res.data = _mm256_insertf128_pd
+                 (_mm256_castpd128_pd256(_mm_castsi128_pd(lower)),
+                  _mm_castsi128_pd(upper), 1);
+#endif
+      return res;
+    }
+
+    template <int shift>
+    inline
+    VectorizedArray<double>
+    shift_right (const VectorizedArray<double> &x)
+    {
+      VectorizedArray<double> res;
+#ifdef __AVX2__
+      res.data = _mm256_castsi256_pd
+                 (_mm256_srli_epi64 (_mm256_castpd_si256(x.data), shift));
+#else
+      const __m128i lower = _mm_srli_epi64
+                            (_mm_castpd_si128(_mm256_castpd256_pd128(x.data)), shift);
+      const __m128i upper = _mm_srli_epi64
+                            (_mm_castpd_si128(_mm256_extractf128_pd(x.data, 1)), shift);
+      res.data = _mm256_insertf128_pd
+                 (_mm256_castpd128_pd256(_mm_castsi128_pd(lower)),
+                  _mm_castsi128_pd(upper), 1);
+#endif
+      return res;
+    }
+
+    inline
+    VectorizedArray<double>
+    bit_and (const VectorizedArray<double> &x,
+             const VectorizedArray<double> &y)
+    {
+      VectorizedArray<double> res;
+      res.data = _mm256_and_pd (x.data, y.data);
+      return res;
+    }
+
+    inline
+    VectorizedArray<double>
+    bit_or (const VectorizedArray<double> &x,
+            const VectorizedArray<double> &y)
+    {
+      VectorizedArray<double> res;
+      res.data = _mm256_or_pd (x.data, y.data);
+      return res;
+    }
+
+    inline
+    VectorizedArray<double>
+    bit_xor (const VectorizedArray<double> &x,
+             const VectorizedArray<double> &y)
+    {
+      VectorizedArray<double> res;
+      res.data = _mm256_xor_pd (x.data, y.data);
+      return res;
+    }
+
+    inline
+    VectorizedArray<double>
+    select_less (const VectorizedArray<double> &a,
+                 const VectorizedArray<double> &b,
+                 const VectorizedArray<double> &x,
+                 const VectorizedArray<double> &y)
+    {
+      VectorizedArray<double> res;
+      res.data = _mm256_blendv_pd (y.data, x.data,
+                                   _mm256_cmp_pd (a.data, b.data, _CMP_LT_OQ));
+      return res;
+    }
+
+    inline
+    bool
+    any_less (const VectorizedArray<double> &a,
+              const VectorizedArray<double> &b)
+    {
+      return _mm256_movemask_pd (_mm256_cmp_pd (a.data, b.data, _CMP_LT_OQ)) != 0;
+    }
+
+
+
+    template <int shift>
+    inline
+    VectorizedArray<float>
+    shift_left (const VectorizedArray<float> &x)
+    {
+      VectorizedArray<float> res;
+#ifdef __AVX2__
+      res.data = _mm256_castsi256_ps
+                 (_mm256_slli_epi32 (_mm256_castps_si256(x.data), shift));
+#else
+      const __m128i lower = _mm_slli_epi32
+                            (_mm_castps_si128(_mm256_castps256_ps128(x.data)), shift);
+      const __m128i upper = _mm_slli_epi32
+                            (_mm_castps_si128(_mm256_extractf128_ps(x.data, 1)), shift);
+      res.data = _mm256_insertf128_ps
+                 (_mm256_castps128_ps256(_mm_castsi128_ps(lower)),
+                  _mm_castsi128_ps(upper), 1);
+#endif
+      return res;
+    }
+
+    template <int shift>
+    inline
+    VectorizedArray<float>
+    shift_right (const VectorizedArray<float> &x)
+    {
+      VectorizedArray<float> res;
+#ifdef __AVX2__
+      res.data = _mm256_castsi256_ps
+                 (_mm256_srli_epi32 (_mm256_castps_si256(x.data), shift));
+#else
+      const __m128i lower = _mm_srli_epi32
+                            (_mm_castps_si128(_mm256_castps256_ps128(x.data)), shift);
+      const __m128i upper = _mm_srli_epi32
+                            (_mm_castps_si128(_mm256_extractf128_ps(x.data, 1)), shift);
+      res.data = _mm256_insertf128_ps
+                 (_mm256_castps128_ps256(_mm_castsi128_ps(lower)),
+                  _mm_castsi128_ps(upper), 1);
+#endif
+      return res;
+    }
+
+    inline
+    VectorizedArray<float>
+    bit_and (const VectorizedArray<float> &x,
+             const VectorizedArray<float> &y)
+    {
+      VectorizedArray<float> res;
+      res.data = _mm256_and_ps (x.data, y.data);
+      return res;
+    }
+
+    inline
+    VectorizedArray<float>
+    bit_or (const VectorizedArray<float> &x,
+            const VectorizedArray<float> &y)
+    {
+      VectorizedArray<float> res;
+      res.data = _mm256_or_ps (x.data, y.data);
+      return res;
+    }
+
+    inline
+    VectorizedArray<float>
+    bit_xor (const VectorizedArray<float> &x,
+             const VectorizedArray<float> &y)
+    {
+      VectorizedArray<float> res;
+      res.data = _mm256_xor_ps (x.data, y.data);
+      return res;
+    }
+
+    inline
+    VectorizedArray<float>
+    select_less (const VectorizedArray<float> &a,
+                 const VectorizedArray<float> &b,
+                 const VectorizedArray<float> &x,
+                 const VectorizedArray<float> &y)
+    {
+      VectorizedArray<float> res;
+      res.data = _mm256_blendv_ps (y.data, x.data,
+                                   _mm256_cmp_ps (a.data, b.data, _CMP_LT_OQ));
+      return res;
+    }
+
+    inline
+    bool
+    any_less (const VectorizedArray<float> &a,
+              const VectorizedArray<float> &b)
+    {
+      return _mm256_movemask_ps (_mm256_cmp_ps (a.data, b.data, _CMP_LT_OQ)) != 0;
+    }
+  }
+}
+
+
+
 // for safety, also check that __SSE2__ is defined in case the user manually
 // set some conflicting compile flags which prevent compilation
 
@@ -2084,6 +2473,170 @@ vectorized_transpose_and_store(const bool                    add_into,
 
 
 
+namespace internal
+{
+  namespace VectorizedArrayMath
+  {
+    /**
+     * Building blocks for the vectorized implementations of the functions
+     * from cmath further down, see the AVX-512 variant for a description.
+     */
+    template <int shift>
+    inline
+    VectorizedArray<double>
+    shift_left (const VectorizedArray<double> &x)
+    {
+      VectorizedArray<double> res;
+      res.data = _mm_castsi128_pd (_mm_slli_epi64 (_mm_castpd_si128(x.data),
+                                                   shift));
+      return res;
+    }
+
+    template <int shift>
+    inline
+    VectorizedArray<double>
+    shift_right (const VectorizedArray<double> &x)
+    {
+      VectorizedArray<double> res;
+      res.data = _mm_castsi128_pd (_mm_srli_epi64 (_mm_castpd_si128(x.data),
+                                                   shift));
+      return res;
+    }
+
+    inline
+    VectorizedArray<double>
+    bit_and (const VectorizedArray<double> &x,
+             const VectorizedArray<double> &y)
+    {
+      VectorizedArray<double> res;
+      res.data = _mm_and_pd (x.data, y.data);
+      return res;
+    }
+
+    inline
+    VectorizedArray<double>
+    bit_or (const VectorizedArray<double> &x,
+            const VectorizedArray<double> &y)
+    {
+      VectorizedArray<double> res;
+      res.data = _mm_or_pd (x.data, y.data);
+      return res;
+    }
+
+    inline
+    VectorizedArray<double>
+    bit_xor (const VectorizedArray<double> &x,
+             const VectorizedArray<double> &y)
+    {
+      VectorizedArray<double> res;
+      res.data = _mm_xor_pd (x.data, y.data);
+      return res;
+    }
+
+    inline
+    VectorizedArray<double>
+    select_less (const VectorizedArray<double> &a,
+                 const VectorizedArray<double> &b,
+                 const VectorizedArray<double> &x,
+                 const VectorizedArray<double> &y)
+    {
+      // SSE2 has no blend instruction, so combine the two fields with the
+      // mask
+      const __m128d mask = _mm_cmplt_pd (a.data, b.data);
+      VectorizedArray<double> res;
+      res.data = _mm_or_pd (_mm_and_pd (mask, x.data),
+                            _mm_andnot_pd (mask, y.data));
+      return res;
+    }
+
+    inline
+    bool
+    any_less (const VectorizedArray<double> &a,
+              const VectorizedArray<double> &b)
+    {
+      return _mm_movemask_pd (_mm_cmplt_pd (a.data, b.data)) != 0;
+    }
+
+
+
+    template <int shift>
+    inline
+    VectorizedArray<float>
+    shift_left (const VectorizedArray<float> &x)
+    {
+      VectorizedArray<float> res;
+      res.data = _mm_castsi128_ps (_mm_slli_epi32 (_mm_castps_si128(x.data),
+                                                   shift));
+      return res;
+    }
+
+    template <int shift>
+    inline
+    VectorizedArray<float>
+    shift_right (const VectorizedArray<float> &x)
+    {
+      VectorizedArray<float> res;
+      res.data = _mm_castsi128_ps (_mm_srli_epi32 (_mm_castps_si128(x.data),
+                                                   shift));
+      return res;
+    }
+
+    inline
+    VectorizedArray<float>
+    bit_and (const VectorizedArray<float> &x,
+             const VectorizedArray<float> &y)
+    {
+      VectorizedArray<float> res;
+      res.data = _mm_and_ps (x.data, y.data);
+      return res;
+    }
+
+    inline
+    VectorizedArray<float>
+    bit_or (const VectorizedArray<float> &x,
+            const VectorizedArray<float> &y)
+    {
+      VectorizedArray<float> res;
+      res.data = _mm_or_ps (x.data, y.data);
+      return res;
+    }
+
+    inline
+    VectorizedArray<float>
+    bit_xor (const VectorizedArray<float> &x,
+             const VectorizedArray<float> &y)
+    {
+      VectorizedArray<float> res;
+      res.data = _mm_xor_ps (x.data, y.data);
+      return res;
+    }
+
+    inline
+    VectorizedArray<float>
+    select_less (const VectorizedArray<float> &a,
+                 const VectorizedArray<float> &b,
+                 const VectorizedArray<float> &x,
+                 const VectorizedArray<float> &y)
+    {
+      const __m128 mask = _mm_cmplt_ps (a.data, b.data);
+      VectorizedArray<float> res;
+      res.data = _mm_or_ps (_mm_and_ps (mask, x.data),
+                            _mm_andnot_ps (mask, y.data));
+      return res;
+    }
+
+    inline
+    bool
+    any_less (const VectorizedArray<float> &a,
+              const VectorizedArray<float> &b)
+    {
+      return _mm_movemask_ps (_mm_cmplt_ps (a.data, b.data)) != 0;
+    }
+  }
+}
+
+
+
 #endif // if DEAL_II_COMPILER_VECTORIZATION_LEVEL > 0
 
 
@@ -2448,6 +3001,881 @@ operator - (const VectorizedArray<Number> &u)
 }
 
 
+
+namespace internal
+{
+  namespace VectorizedArrayMath
+  {
+    /**
+     * The implementations of the functions from cmath for VectorizedArray.
+     * The generic versions apply the respective scalar function to every
+     * entry; they are used for data types and platforms without a
+     * vectorized implementation.
+     */
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    sin (const VectorizedArray<Number> &x)
+    {
+      // put values in an array and later read in that array with an
+      // unaligned read. This should save some instructions as compared to
+      // directly setting the individual elements and also circumvents a
+      // compiler optimization bug in gcc-4.6 with SSE2 (see also deal.II
+      // developers list from April 2014, topic "matrix_free/step-48 Test").
+      Number values[VectorizedArray<Number>::n_array_elements];
+      for (unsigned int i=0; i<VectorizedArray<Number>::n_array_elements; ++i)
+        values[i] = std::sin(x[i]);
+      VectorizedArray<Number> out;
+      out.load(&values[0]);
+      return out;
+    }
+
+
+
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    cos (const VectorizedArray<Number> &x)
+    {
+      Number values[VectorizedArray<Number>::n_array_elements];
+      for (unsigned int i=0; i<VectorizedArray<Number>::n_array_elements; ++i)
+        values[i] = std::cos(x[i]);
+      VectorizedArray<Number> out;
+      out.load(&values[0]);
+      return out;
+    }
+
+
+
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    tan (const VectorizedArray<Number> &x)
+    {
+      Number values[VectorizedArray<Number>::n_array_elements];
+      for (unsigned int i=0; i<VectorizedArray<Number>::n_array_elements; ++i)
+        values[i] = std::tan(x[i]);
+      VectorizedArray<Number> out;
+      out.load(&values[0]);
+      return out;
+    }
+
+
+
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    exp (const VectorizedArray<Number> &x)
+    {
+      Number values[VectorizedArray<Number>::n_array_elements];
+      for (unsigned int i=0; i<VectorizedArray<Number>::n_array_elements; ++i)
+        values[i] = std::exp(x[i]);
+      VectorizedArray<Number> out;
+      out.load(&values[0]);
+      return out;
+    }
+
+
+
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    log (const VectorizedArray<Number> &x)
+    {
+      Number values[VectorizedArray<Number>::n_array_elements];
+      for (unsigned int i=0; i<VectorizedArray<Number>::n_array_elements; ++i)
+        values[i] = std::log(x[i]);
+      VectorizedArray<Number> out;
+      out.load(&values[0]);
+      return out;
+    }
+
+
+
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    pow (const VectorizedArray<Number> &x,
+         const Number                   p)
+    {
+      Number values[VectorizedArray<Number>::n_array_elements];
+      for (unsigned int i=0; i<VectorizedArray<Number>::n_array_elements; ++i)
+        values[i] = std::pow(x[i], p);
+      VectorizedArray<Number> out;
+      out.load(&values[0]);
+      return out;
+    }
+
+
+
+#if DEAL_II_COMPILER_VECTORIZATION_LEVEL > 0
+
+    /**
+     * Constants describing the floating point format and the polynomial
+     * approximations used in the vectorized implementations below. The
+     * polynomials are truncated Taylor series whose truncation error is
+     * below the rounding error on the reduced argument ranges.
+     */
+    template <typename Number> struct Constants;
+
+    template <>
+    struct Constants<double>
+    {
+      static const int n_bits        = 64;
+      static const int mantissa_bits = 52;
+      static const int exponent_bias = 1023;
+
+      // adding and subtracting 1.5*2^52 rounds a number of magnitude less
+      // than 2^51 to the nearest integer. In between, the integer is stored
+      // in the lowest bits of the mantissa
+      static double rounding_shift ()
+      {
+        return 6755399441055744.;
+      }
+
+      // 2^52, whose mantissa bits are all zero
+      static double mantissa_shift ()
+      {
+        return 4503599627370496.;
+      }
+
+      // log(2) split into a part with only 32 nonzero mantissa bits, so
+      // that multiples of it with small integers are exact, and the rest
+      static double ln2_hi ()
+      {
+        return 6.93147180369123816490e-01;
+      }
+      static double ln2_lo ()
+      {
+        return 1.90821492927058770002e-10;
+      }
+
+      // outside this range, exp(x) is zero or infinite, respectively
+      static double exp_lower_bound ()
+      {
+        return -746.;
+      }
+      static double exp_upper_bound ()
+      {
+        return 710.;
+      }
+
+      // numbers below this value are subnormal and get scaled by 2^54 in
+      // log(x)
+      static double min_normal ()
+      {
+        return 2.2250738585072014e-308;
+      }
+      static double subnormal_scaling ()
+      {
+        return 18014398509481984.;
+      }
+      static const int subnormal_scaling_exponent = 54;
+
+      // 2^27+1, used to split a number into two halves whose products are
+      // exact
+      static double split_factor ()
+      {
+        return 134217729.;
+      }
+
+      // pi/2 split into three parts, the first two with 33 nonzero
+      // mantissa bits. The argument reduction of sin(x) and cos(x) is
+      // accurate for |x| below the given bound
+      static double pio2_1 ()
+      {
+        return 1.57079632673412561417e+00;
+      }
+      static double pio2_2 ()
+      {
+        return 6.07710050630396597660e-11;
+      }
+      static double pio2_3 ()
+      {
+        return 2.02226624871116645580e-21;
+      }
+      static double trigonometric_bound ()
+      {
+        return 1e5;
+      }
+
+      static const unsigned int n_exp_coefficients = 14;
+      static const double *exp_coefficients ()
+      {
+        // 1/k!
+        static const double coefficients[] =
+        {
+          1., 1., 0.5, 0.16666666666666666, 0.041666666666666664,
+          0.008333333333333333, 0.001388888888888889, 0.0001984126984126984,
+          2.48015873015873e-05, 2.7557319223985893e-06, 2.755731922398589e-07,
+          2.505210838544172e-08, 2.08767569878681e-09, 1.6059043836821613e-10
+        };
+        return coefficients;
+      }
+
+      static const unsigned int n_log_coefficients = 11;
+      static const double *log_coefficients ()
+      {
+        // 2/(2k+1), starting at k=1
+        static const double coefficients[] =
+        {
+          0.6666666666666666, 0.4, 0.2857142857142857, 0.2222222222222222,
+          0.18181818181818182, 0.15384615384615385, 0.13333333333333333,
+          0.11764705882352941, 0.10526315789473684, 0.09523809523809523,
+          0.08695652173913043
+        };
+        return coefficients;
+      }
+
+      static const unsigned int n_sin_coefficients = 8;
+      static const double *sin_coefficients ()
+      {
+        // (-1)^k/(2k+1)!, starting at k=1
+        static const double coefficients[] =
+        {
+          -0.16666666666666666, 0.008333333333333333, -0.0001984126984126984,
+          2.7557319223985893e-06, -2.505210838544172e-08, 1.6059043836821613e-10,
+          -7.647163731819816e-13, 2.8114572543455206e-15
+        };
+        return coefficients;
+      }
+
+      static const unsigned int n_cos_coefficients = 8;
+      static const double *cos_coefficients ()
+      {
+        // (-1)^k/(2k)!, starting at k=1
+        static const double coefficients[] =
+        {
+          -0.5, 0.041666666666666664, -0.001388888888888889,
+          2.48015873015873e-05, -2.755731922398589e-07, 2.08767569878681e-09,
+          -1.1470745597729725e-11, 4.779477332387385e-14
+        };
+        return coefficients;
+      }
+    };
+
+
+
+    template <>
+    struct Constants<float>
+    {
+      static const int n_bits        = 32;
+      static const int mantissa_bits = 23;
+      static const int exponent_bias = 127;
+
+      static float rounding_shift ()
+      {
+        return 12582912.f;
+      }
+      static float mantissa_shift ()
+      {
+        return 8388608.f;
+      }
+      static float ln2_hi ()
+      {
+        return 0.693359375f;
+      }
+      static float ln2_lo ()
+      {
+        return -2.12194440e-4f;
+      }
+      static float exp_lower_bound ()
+      {
+        return -104.f;
+      }
+      static float exp_upper_bound ()
+      {
+        return 89.f;
+      }
+      static float min_normal ()
+      {
+        return 1.17549435e-38f;
+      }
+      static float subnormal_scaling ()
+      {
+        return 33554432.f;
+      }
+      static const int subnormal_scaling_exponent = 25;
+      static float split_factor ()
+      {
+        return 4097.f;
+      }
+
+      // pi/2 split into three parts, the first two with 8 and 15 nonzero
+      // mantissa bits, respectively
+      static float pio2_1 ()
+      {
+        return 1.5703125f;
+      }
+      static float pio2_2 ()
+      {
+        return 4.837512969970703125e-4f;
+      }
+      static float pio2_3 ()
+      {
+        return 7.54978995489188216e-8f;
+      }
+      static float trigonometric_bound ()
+      {
+        return 512.f;
+      }
+
+      static const unsigned int n_exp_coefficients = 9;
+      static const float *exp_coefficients ()
+      {
+        static const float coefficients[] =
+        {
+          1.f, 1.f, 0.5f, 1.666666667e-01f, 4.166666667e-02f, 8.333333333e-03f,
+          1.388888889e-03f, 1.984126984e-04f, 2.480158730e-05f
+        };
+        return coefficients;
+      }
+
+      static const unsigned int n_log_coefficients = 4;
+      static const float *log_coefficients ()
+      {
+        static const float coefficients[] =
+        {
+          6.666666667e-01f, 4.000000000e-01f, 2.857142857e-01f, 2.222222222e-01f
+        };
+        return coefficients;
+      }
+
+      static const unsigned int n_sin_coefficients = 4;
+      static const float *sin_coefficients ()
+      {
+        static const float coefficients[] =
+        {
+          -1.666666667e-01f, 8.333333333e-03f, -1.984126984e-04f,
+          2.755731922e-06f
+        };
+        return coefficients;
+      }
+
+      static const unsigned int n_cos_coefficients = 5;
+      static const float *cos_coefficients ()
+      {
+        static const float coefficients[] =
+        {
+          -5.000000000e-01f, 4.166666667e-02f, -1.388888889e-03f,
+          2.480158730e-05f, -2.755731922e-07f
+        };
+        return coefficients;
+      }
+    };
+
+
+
+    /**
+     * Evaluate the polynomial with the given coefficients, starting with
+     * the constant one, at @p x with the Horner scheme.
+     */
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    evaluate_polynomial (const Number                  *coefficients,
+                         const unsigned int             n_coefficients,
+                         const VectorizedArray<Number> &x)
+    {
+      VectorizedArray<Number> result = make_vectorized_array (coefficients[n_coefficients-1]);
+      for (int i=n_coefficients-2; i>=0; --i)
+        result = result * x + coefficients[i];
+      return result;
+    }
+
+
+
+    /**
+     * Round to the nearest integer. The argument must be less than 2^51
+     * (2^22 for float) in magnitude.
+     */
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    round_to_integer (const VectorizedArray<Number> &x)
+    {
+      return (x + Constants<Number>::rounding_shift()) -
+             Constants<Number>::rounding_shift();
+    }
+
+
+
+    /**
+     * Return 2^n for integral values @p n for which the result is a normal
+     * floating point number, by writing the biased exponent directly.
+     */
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    pow2 (const VectorizedArray<Number> &n)
+    {
+      typedef Constants<Number> C;
+      // the lowest bits of the mantissa of the sum hold n plus the exponent
+      // bias, which we shift into the exponent field
+      return shift_left<C::mantissa_bits>
+             (n + (C::rounding_shift() + Number(C::exponent_bias)));
+    }
+
+
+
+    /**
+     * Compute exp(x+x_lo), where @p x_lo is a small correction to @p x in
+     * case the argument is known more accurately than a single floating
+     * point number can represent.
+     */
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    exp_simd (const VectorizedArray<Number> &x,
+              const VectorizedArray<Number> &x_lo)
+    {
+      typedef Constants<Number> C;
+
+      // limit the argument to the range where the result is not zero or
+      // infinity, to avoid invalid operations for infinite arguments. These
+      // cases are selected at the end
+      const VectorizedArray<Number> lower_bound = make_vectorized_array (C::exp_lower_bound());
+      const VectorizedArray<Number> upper_bound = make_vectorized_array (C::exp_upper_bound());
+      VectorizedArray<Number> x_bounded = select_less (x, lower_bound, lower_bound, x);
+      x_bounded = select_less (upper_bound, x_bounded, upper_bound, x_bounded);
+
+      // write x = n*log(2) + r with integer n and |r| <= log(2)/2, then
+      // exp(x) = 2^n exp(r)
+      const VectorizedArray<Number> n = round_to_integer (x_bounded * Number(1.4426950408889634));
+      const VectorizedArray<Number> r
+        = ((x_bounded - n * C::ln2_hi()) - n * C::ln2_lo()) + x_lo;
+      const VectorizedArray<Number> exp_r = evaluate_polynomial (C::exp_coefficients(),
+                                                                 C::n_exp_coefficients,
+                                                                 r);
+
+      // multiply by 2^n in two steps, such that each of the two factors is
+      // a normal number also when the result is subnormal or close to
+      // overflow
+      const VectorizedArray<Number> n1 = round_to_integer (n * Number(0.5));
+      VectorizedArray<Number> result = exp_r * pow2 (n1) * pow2 (n - n1);
+
+      result = select_less (x, lower_bound, VectorizedArray<Number>(), result);
+      result = select_less (upper_bound, x,
+                            make_vectorized_array (std::numeric_limits<Number>::infinity()),
+                            result);
+      return result;
+    }
+
+
+
+    /**
+     * Compute log(x) as the unevaluated sum of @p log_hi and @p log_lo,
+     * which is accurate beyond the precision of @p Number. The argument must
+     * be positive and finite; for other arguments, the result is some finite
+     * number.
+     */
+    template <typename Number>
+    inline
+    void
+    log_simd (const VectorizedArray<Number> &x,
+              VectorizedArray<Number>       &log_hi,
+              VectorizedArray<Number>       &log_lo)
+    {
+      typedef Constants<Number> C;
+      const VectorizedArray<Number> zero = VectorizedArray<Number>();
+      const VectorizedArray<Number> min_normal = make_vectorized_array (C::min_normal());
+
+      // scale subnormal numbers into the range of normal numbers
+      const VectorizedArray<Number> y = select_less (x, min_normal,
+                                                     x * C::subnormal_scaling(), x);
+
+      // write y = 2^e m with 1 <= m < 2. To get e as a floating point
+      // number, put the biased exponent into the mantissa of 2^52 (2^23)
+      const VectorizedArray<Number> mantissa_shift = make_vectorized_array (C::mantissa_shift());
+      VectorizedArray<Number> e
+        = bit_or (shift_right<C::mantissa_bits>(y), mantissa_shift) -
+          (mantissa_shift + Number(C::exponent_bias));
+      e = e - select_less (x, min_normal,
+                           make_vectorized_array (Number(C::subnormal_scaling_exponent)),
+                           zero);
+      const VectorizedArray<Number> one = make_vectorized_array (Number(1.));
+      VectorizedArray<Number> m
+        = bit_or (shift_right<C::n_bits-C::mantissa_bits>
+                  (shift_left<C::n_bits-C::mantissa_bits>(y)), one);
+
+      // move m into the range [sqrt(2)/2, sqrt(2)) to keep the argument of
+      // the series small
+      const VectorizedArray<Number> sqrt2 = make_vectorized_array (Number(1.4142135623730951));
+      e = e + select_less (sqrt2, m, one, zero);
+      m = select_less (sqrt2, m, m * Number(0.5), m);
+
+      // with f = m-1, which is exact, and s = f/(2+f), we have log(m) =
+      // 2 atanh(s) = f - s*(f-R) with R = 2s^2/3 + 2s^4/5 + .... The
+      // correction s*(f-R) is small compared to f, so its rounding errors
+      // are much smaller than one unit in the last place of the result
+      const VectorizedArray<Number> f = m - one;
+      const VectorizedArray<Number> s = f / (f + Number(2.));
+      const VectorizedArray<Number> s2 = s * s;
+      const VectorizedArray<Number> R = s2 * evaluate_polynomial (C::log_coefficients(),
+                                                                  C::n_log_coefficients,
+                                                                  s2);
+      const VectorizedArray<Number> correction = e * C::ln2_lo() - s * (f - R);
+
+      // the product e*ln2_hi is exact, so add f to it and keep track of the
+      // rounding error. Finally, add the correction to the high part such
+      // that the low part is below one unit in its last place
+      const VectorizedArray<Number> a = e * C::ln2_hi();
+      const VectorizedArray<Number> sum = a + f;
+      const VectorizedArray<Number> f_virtual = sum - a;
+      const VectorizedArray<Number> sum_lo
+        = ((a - (sum - f_virtual)) + (f - f_virtual)) + correction;
+      log_hi = sum + sum_lo;
+      log_lo = (sum - log_hi) + sum_lo;
+    }
+
+
+
+    /**
+     * Compute sin(x) and cos(x) of the reduced argument and return the
+     * integer multiple of pi/2 that was subtracted from @p x, in the form
+     * that results from adding the rounding shift (i.e., the integer is in
+     * the lowest bits of the mantissa).
+     */
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    sin_cos_simd (const VectorizedArray<Number> &x,
+                  VectorizedArray<Number>       &sin_r,
+                  VectorizedArray<Number>       &cos_r)
+    {
+      typedef Constants<Number> C;
+      const VectorizedArray<Number> shifted_j
+        = x * Number(0.6366197723675814) + C::rounding_shift();
+      const VectorizedArray<Number> j = shifted_j - C::rounding_shift();
+      const VectorizedArray<Number> r
+        = ((x - j * C::pio2_1()) - j * C::pio2_2()) - j * C::pio2_3();
+      const VectorizedArray<Number> r2 = r * r;
+      sin_r = r + r * r2 * evaluate_polynomial (C::sin_coefficients(),
+                                                C::n_sin_coefficients, r2);
+      cos_r = Number(1.) + r2 * evaluate_polynomial (C::cos_coefficients(),
+                                                     C::n_cos_coefficients, r2);
+      return shifted_j;
+    }
+
+
+
+    /**
+     * Given the result of sin_cos_simd(), select sin(x) from the sine and
+     * cosine of the reduced argument based on the quadrant. cos(x) is
+     * obtained from the same function with the quadrant incremented by one.
+     */
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    select_sin_quadrant (const VectorizedArray<Number> &shifted_j,
+                         const VectorizedArray<Number> &sin_r,
+                         const VectorizedArray<Number> &cos_r)
+    {
+      typedef Constants<Number> C;
+
+      // the cosine is needed for odd quadrants; extract the lowest bit of
+      // the quadrant as a floating point number 0 or 1
+      const VectorizedArray<Number> mantissa_shift = make_vectorized_array (C::mantissa_shift());
+      const VectorizedArray<Number> odd
+        = bit_or (shift_right<C::n_bits-1>(shift_left<C::n_bits-1>(shifted_j)),
+                  mantissa_shift) - mantissa_shift;
+      const VectorizedArray<Number> result
+        = select_less (odd, make_vectorized_array (Number(0.5)), sin_r, cos_r);
+
+      // the sign flips in quadrants 2 and 3, so move the second bit of the
+      // quadrant into the sign bit
+      return bit_xor (result, shift_left<C::n_bits-1>(shift_right<1>(shifted_j)));
+    }
+
+
+
+    /**
+     * Return whether the reduction of the arguments of the trigonometric
+     * functions is accurate for all entries of @p x. Otherwise, the scalar
+     * functions are used.
+     */
+    template <typename Number>
+    inline
+    bool
+    trigonometric_reduction_is_accurate (const VectorizedArray<Number> &x)
+    {
+      return !any_less (make_vectorized_array (Constants<Number>::trigonometric_bound()),
+                        std::abs (x));
+    }
+
+
+
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    sin_simd (const VectorizedArray<Number> &x)
+    {
+      if (!trigonometric_reduction_is_accurate (x))
+        return sin<Number> (x);
+
+      VectorizedArray<Number> sin_r, cos_r;
+      const VectorizedArray<Number> shifted_j = sin_cos_simd (x, sin_r, cos_r);
+      return select_sin_quadrant (shifted_j, sin_r, cos_r);
+    }
+
+
+
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    cos_simd (const VectorizedArray<Number> &x)
+    {
+      if (!trigonometric_reduction_is_accurate (x))
+        return cos<Number> (x);
+
+      // cos(x) = sin(x+pi/2), i.e., the quadrant is one higher
+      VectorizedArray<Number> sin_r, cos_r;
+      const VectorizedArray<Number> shifted_j = sin_cos_simd (x, sin_r, cos_r);
+      return select_sin_quadrant (shifted_j + Number(1.), sin_r, cos_r);
+    }
+
+
+
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    tan_simd (const VectorizedArray<Number> &x)
+    {
+      if (!trigonometric_reduction_is_accurate (x))
+        return tan<Number> (x);
+
+      VectorizedArray<Number> sin_r, cos_r;
+      const VectorizedArray<Number> shifted_j = sin_cos_simd (x, sin_r, cos_r);
+      return select_sin_quadrant (shifted_j, sin_r, cos_r) /
+             select_sin_quadrant (shifted_j + Number(1.), sin_r, cos_r);
+    }
+
+
+
+    /**
+     * Return NaN for the entries of @p x that are NaN and zero otherwise,
+     * without raising floating point exceptions for infinite entries.
+     */
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    nan_or_zero (const VectorizedArray<Number> &x)
+    {
+      const VectorizedArray<Number> finite_x
+        = select_less (make_vectorized_array (std::numeric_limits<Number>::max()),
+                       std::abs (x), VectorizedArray<Number>(), x);
+      return finite_x - finite_x;
+    }
+
+
+
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    log_simd (const VectorizedArray<Number> &x)
+    {
+      VectorizedArray<Number> log_hi, log_lo;
+      log_simd (x, log_hi, log_lo);
+      VectorizedArray<Number> result = log_hi + log_lo;
+
+      // treat special values: NaN is propagated by the subtraction below,
+      // zero gives -infinity, negative numbers NaN, and infinity itself
+      result = result + nan_or_zero (x);
+      result = select_less (x, make_vectorized_array (std::numeric_limits<Number>::denorm_min()),
+                            make_vectorized_array (-std::numeric_limits<Number>::infinity()),
+                            result);
+      result = select_less (x, VectorizedArray<Number>(),
+                            make_vectorized_array (std::numeric_limits<Number>::quiet_NaN()),
+                            result);
+      result = select_less (make_vectorized_array (std::numeric_limits<Number>::max()), x,
+                            make_vectorized_array (std::numeric_limits<Number>::infinity()),
+                            result);
+      return result;
+    }
+
+
+
+    template <typename Number>
+    inline
+    VectorizedArray<Number>
+    pow_simd (const VectorizedArray<Number> &x,
+              const Number                   p)
+    {
+      typedef Constants<Number> C;
+      if (p == Number(0.))
+        return make_vectorized_array (Number(1.));
+
+      // compute pow(|x|,p) = exp(p*log|x|), keeping track of the rounding
+      // errors in log|x| and in the product with p. Otherwise, the error
+      // would be amplified by the magnitude of p*log|x|
+      const VectorizedArray<Number> abs_x = std::abs (x);
+      VectorizedArray<Number> log_hi, log_lo;
+      log_simd (abs_x, log_hi, log_lo);
+
+      const VectorizedArray<Number> y = p * log_hi;
+      VectorizedArray<Number> y_lo = p * log_lo;
+      if (std::abs(p) < Number(1e20))
+        {
+          // split both factors into halves whose products are exact to get
+          // the rounding error of p*log_hi
+          const Number p_split = p * C::split_factor();
+          const Number p_1 = p_split - (p_split - p);
+          const Number p_2 = p - p_1;
+          const VectorizedArray<Number> l_split = log_hi * C::split_factor();
+          const VectorizedArray<Number> l_1 = l_split - (l_split - log_hi);
+          const VectorizedArray<Number> l_2 = log_hi - l_1;
+          y_lo = y_lo + ((((p_1 * l_1 - y) + p_1 * l_2) + p_2 * l_1) + p_2 * l_2);
+        }
+      VectorizedArray<Number> result = exp_simd (y, y_lo);
+
+      // zero and infinity give zero or infinity, depending on the sign of
+      // p, and NaN is propagated
+      const VectorizedArray<Number> zero = VectorizedArray<Number>();
+      const VectorizedArray<Number> inf
+        = make_vectorized_array (std::numeric_limits<Number>::infinity());
+      const VectorizedArray<Number> max
+        = make_vectorized_array (std::numeric_limits<Number>::max());
+      result = select_less (abs_x, make_vectorized_array (std::numeric_limits<Number>::denorm_min()),
+                            p > 0 ? zero : inf, result);
+      result = select_less (max, abs_x, p > 0 ? inf : zero, result);
+      result = result + nan_or_zero (x);
+
+      // negative x are only allowed for integer powers
+      if (p == std::floor(p))
+        {
+          if (std::fmod(p, Number(2.)) != Number(0.))
+            result = bit_or (result, bit_and (x, make_vectorized_array (Number(-0.))));
+        }
+      else
+        {
+          result = select_less (x, zero,
+                                make_vectorized_array (std::numeric_limits<Number>::quiet_NaN()),
+                                result);
+          result = select_less (x, -max, p > 0 ? inf : zero, result);
+        }
+      return result;
+    }
+
+
+
+    /**
+     * Vectorized implementations for double and float. Their accuracy is
+     * within a few units in the last place for arguments in the range of
+     * normal floating point numbers.
+     */
+    inline
+    VectorizedArray<double>
+    sin (const VectorizedArray<double> &x)
+    {
+      return sin_simd (x);
+    }
+
+
+
+    inline
+    VectorizedArray<float>
+    sin (const VectorizedArray<float> &x)
+    {
+      return sin_simd (x);
+    }
+
+
+
+    inline
+    VectorizedArray<double>
+    cos (const VectorizedArray<double> &x)
+    {
+      return cos_simd (x);
+    }
+
+
+
+    inline
+    VectorizedArray<float>
+    cos (const VectorizedArray<float> &x)
+    {
+      return cos_simd (x);
+    }
+
+
+
+    inline
+    VectorizedArray<double>
+    tan (const VectorizedArray<double> &x)
+    {
+      return tan_simd (x);
+    }
+
+
+
+    inline
+    VectorizedArray<float>
+    tan (const VectorizedArray<float> &x)
+    {
+      return tan_simd (x);
+    }
+
+
+
+    inline
+    VectorizedArray<double>
+    exp (const VectorizedArray<double> &x)
+    {
+      return exp_simd (x, VectorizedArray<double>());
+    }
+
+
+
+    inline
+    VectorizedArray<float>
+    exp (const VectorizedArray<float> &x)
+    {
+      return exp_simd (x, VectorizedArray<float>());
+    }
+
+
+
+    inline
+    VectorizedArray<double>
+    log (const VectorizedArray<double> &x)
+    {
+      return log_simd (x);
+    }
+
+
+
+    inline
+    VectorizedArray<float>
+    log (const VectorizedArray<float> &x)
+    {
+      return log_simd (x);
+    }
+
+
+
+    inline
+    VectorizedArray<double>
+    pow (const VectorizedArray<double> &x,
+         const double                   p)
+    {
+      return pow_simd (x, p);
+    }
+
+
+
+    inline
+    VectorizedArray<float>
+    pow (const VectorizedArray<float> &x,
+         const float                   p)
+    {
+      return pow_simd (x, p);
+    }
+
+#endif
+  }
+}
+
+
 DEAL_II_NAMESPACE_CLOSE
 
 
@@ -2456,6 +3884,14 @@ DEAL_II_NAMESPACE_CLOSE
  * do not reside in the dealii namespace in order to ensure a similar
  * interface as for the respective functions in cmath. Instead, call them
  * using std::sin.
+ *
+ * For VectorizedArray<double> and VectorizedArray<float>, the functions sin,
+ * cos, tan, exp, log, and pow are evaluated with SIMD instructions on all
+ * entries at once, rather than by calling the scalar function for each entry.
+ * The results differ from the ones of the scalar functions by a few units in
+ * the last place. The trigonometric functions fall back to the scalar
+ * functions if one of the entries is larger than 1e5 (double) or 512 (float)
+ * in magnitude, where the argument reduction would lose accuracy.
  */
 namespace std
 {
@@ -2471,17 +3907,7 @@ namespace std
   ::dealii::VectorizedArray<Number>
   sin (const ::dealii::VectorizedArray<Number> &x)
   {
-    // put values in an array and later read in that array with an unaligned
-    // read. This should save some instructions as compared to directly
-    // setting the individual elements and also circumvents a compiler
-    // optimization bug in gcc-4.6 with SSE2 (see also deal.II developers list
-    // from April 2014, topic "matrix_free/step-48 Test").
-    Number values[::dealii::VectorizedArray<Number>::n_array_elements];
-    for (unsigned int i=0; i<dealii::VectorizedArray<Number>::n_array_elements; ++i)
-      values[i] = std::sin(x[i]);
-    ::dealii::VectorizedArray<Number> out;
-    out.load(&values[0]);
-    return out;
+    return ::dealii::internal::VectorizedArrayMath::sin (x);
   }
 
 
@@ -2498,12 +3924,7 @@ namespace std
   ::dealii::VectorizedArray<Number>
   cos (const ::dealii::VectorizedArray<Number> &x)
   {
-    Number values[::dealii::VectorizedArray<Number>::n_array_elements];
-    for (unsigned int i=0; i<dealii::VectorizedArray<Number>::n_array_elements; ++i)
-      values[i] = std::cos(x[i]);
-    ::dealii::VectorizedArray<Number> out;
-    out.load(&values[0]);
-    return out;
+    return ::dealii::internal::VectorizedArrayMath::cos (x);
   }
 
 
@@ -2520,12 +3941,7 @@ namespace std
   ::dealii::VectorizedArray<Number>
   tan (const ::dealii::VectorizedArray<Number> &x)
   {
-    Number values[::dealii::VectorizedArray<Number>::n_array_elements];
-    for (unsigned int i=0; i<dealii::VectorizedArray<Number>::n_array_elements; ++i)
-      values[i] = std::tan(x[i]);
-    ::dealii::VectorizedArray<Number> out;
-    out.load(&values[0]);
-    return out;
+    return ::dealii::internal::VectorizedArrayMath::tan (x);
   }
 
 
@@ -2542,12 +3958,7 @@ namespace std
   ::dealii::VectorizedArray<Number>
   exp (const ::dealii::VectorizedArray<Number> &x)
   {
-    Number values[::dealii::VectorizedArray<Number>::n_array_elements];
-    for (unsigned int i=0; i<dealii::VectorizedArray<Number>::n_array_elements; ++i)
-      values[i] = std::exp(x[i]);
-    ::dealii::VectorizedArray<Number> out;
-    out.load(&values[0]);
-    return out;
+    return ::dealii::internal::VectorizedArrayMath::exp (x);
   }
 
 
@@ -2564,12 +3975,7 @@ namespace std
   ::dealii::VectorizedArray<Number>
   log (const ::dealii::VectorizedArray<Number> &x)
   {
-    Number values[::dealii::VectorizedArray<Number>::n_array_elements];
-    for (unsigned int i=0; i<dealii::VectorizedArray<Number>::n_array_elements; ++i)
-      values[i] = std::log(x[i]);
-    ::dealii::VectorizedArray<Number> out;
-    out.load(&values[0]);
-    return out;
+    return ::dealii::internal::VectorizedArrayMath::log (x);
   }
 
 
@@ -2604,12 +4010,7 @@ namespace std
   pow (const ::dealii::VectorizedArray<Number> &x,
        const Number p)
   {
-    Number values[::dealii::VectorizedArray<Number>::n_array_elements];
-    for (unsigned int i=0; i<dealii::VectorizedArray<Number>::n_array_elements; ++i)
-      values[i] = std::pow(x[i], p);
-    ::dealii::VectorizedArray<Number> out;
-    out.load(&values[0]);
-    return out;
+    return ::dealii::internal::VectorizedArrayMath::pow (x, p);
   }
 
 
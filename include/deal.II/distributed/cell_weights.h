@@ -0,0 +1,303 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__distributed_cell_weights_h
+#define dealii__distributed_cell_weights_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/hp/dof_handler.h>
+
+#include <boost/signals2/connection.hpp>
+
+#include <utility>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+template <int dim, typename Number> class MatrixFree;
+
+namespace parallel
+{
+  namespace distributed
+  {
+    /**
+     * A cost model for the weighted partitioning of a triangulation among
+     * processors. An object of this class connects itself to the
+     * Triangulation::Signals::cell_weight signal of the triangulation and
+     * returns a weight for each cell that is proportional to the cost of
+     * the computations on that cell, so that parallel::distributed::Triangulation
+     * balances the computational work rather than the number of cells when
+     * it partitions the mesh.
+     *
+     * The cost of a cell is determined by one of the following sources, in
+     * this order of preference:
+     * <ol>
+     * <li> Measured costs, for example the time spent on the cell in the
+     * assembly or in a matrix-free operator evaluation, as passed to
+     * add_measured_cost(). The MatrixFree variant of this function
+     * distributes the time measured for a range of cell batches in a
+     * MatrixFree::cell_loop() evenly to the cells in these batches, so that
+     * the worker function of the loop can be instrumented directly:
+     * @code
+     *   void LaplaceOperator::local_apply (const MatrixFree<dim> &data,
+     *                                      Vector &dst, const Vector &src,
+     *                                      const std::pair<unsigned int,unsigned int> &cell_range) const
+     *   {
+     *     Timer timer;
+     *     ... work on the cells in cell_range ...
+     *     cell_weights.add_measured_cost (data, cell_range, timer.wall_time());
+     *   }
+     * @endcode
+     * Measured costs are used as soon as they have been given for at least one
+     * cell on any processor. Locally owned cells without measurements get the
+     * average measured cost. Since the measurements refer to the cells of the
+     * current mesh, they are discarded whenever the triangulation changes,
+     * i.e., after it has been refined or repartitioned.
+     * <li> An estimate based on the finite elements of an hp::DoFHandler, set
+     * by set_fe_cost_model(). The cost of a cell is then @p coefficient
+     * times the number of degrees of freedom per cell of its active finite
+     * element raised to the power @p exponent. An exponent of one describes
+     * matrix-free methods, where the work is proportional to the number of
+     * unknowns, while an exponent of two describes the assembly of dense
+     * cell matrices.
+     * <li> Otherwise, all cells have the same cost.
+     * </ol>
+     *
+     * Partitioning the mesh is expensive, in particular when data has to be
+     * transferred along with the cells, so it should only be done when the
+     * load is actually imbalanced. The function repartition_if_imbalanced()
+     * computes the imbalance of the current partition with respect to the
+     * cost model and only calls Triangulation::repartition() if it exceeds a
+     * given threshold. This requires creating the triangulation with the
+     * Triangulation::no_automatic_repartitioning flag, since the mesh is
+     * otherwise repartitioned during every refinement.
+     *
+     * The costs are scaled such that the average cell has a weight of 10000,
+     * which makes the constant weight of 1000 that the triangulation adds to
+     * every cell small. The scaling is computed when the triangulation
+     * triggers the Triangulation::Signals::pre_distributed_repartition signal.
+     *
+     * If the triangulation is not a parallel::Triangulation, the costs are
+     * computed in the same way but there is only one processor, and the mesh
+     * is never repartitioned.
+     *
+     * @ingroup distributed
+     */
+    template <int dim, int spacedim=dim>
+    class CellWeights : public Subscriptor
+    {
+    public:
+      /**
+       * An abbreviation for the type of cell iterators.
+       */
+      typedef typename dealii::Triangulation<dim,spacedim>::cell_iterator cell_iterator;
+
+      /**
+       * An abbreviation for the type of active cell iterators.
+       */
+      typedef typename dealii::Triangulation<dim,spacedim>::active_cell_iterator active_cell_iterator;
+
+      /**
+       * Constructor. Connect to the signals of the given triangulation.
+       */
+      CellWeights (dealii::Triangulation<dim,spacedim> &triangulation);
+
+      /**
+       * Destructor. Disconnect from the signals of the triangulation.
+       */
+      ~CellWeights ();
+
+      /**
+       * Estimate the cost of each cell from the number of degrees of freedom
+       * of its active finite element in @p dof_handler, as described in the
+       * documentation of this class.
+       */
+      void set_fe_cost_model (const hp::DoFHandler<dim,spacedim> &dof_handler,
+                              const double                        exponent = 1.,
+                              const double                        coefficient = 1.);
+
+      /**
+       * Add @p cost to the measured cost of the locally owned @p cell. This
+       * function may be called concurrently from several threads.
+       */
+      void add_measured_cost (const active_cell_iterator &cell,
+                              const double                cost);
+
+      /**
+       * Add @p cost, measured for the cell batches with indices in the range
+       * given by @p cell_range of @p matrix_free, to the measured costs of the
+       * cells in these batches, with equal parts for all cells. The range is
+       * the one passed to the worker functions of MatrixFree::cell_loop().
+       * This function may be called concurrently from several threads.
+       */
+      template <typename Number>
+      void add_measured_cost (const MatrixFree<dim,Number>                    &matrix_free,
+                              const std::pair<unsigned int,unsigned int>      &cell_range,
+                              const double                                     cost);
+
+      /**
+       * Discard all measured costs.
+       */
+      void clear_measured_costs ();
+
+      /**
+       * Return the ratio of the largest cost of the locally owned cells of any
+       * processor to the average cost per processor, minus one. This is zero
+       * for a perfectly balanced partition.
+       *
+       * This function needs to be called on all processors.
+       */
+      double compute_imbalance ();
+
+      /**
+       * Repartition the triangulation if compute_imbalance() exceeds @p
+       * threshold, and return whether this has happened. Data attached to the
+       * triangulation, for example by a SolutionTransfer object, needs to be
+       * prepared before this call as for Triangulation::repartition().
+       *
+       * This function needs to be called on all processors.
+       */
+      bool repartition_if_imbalanced (const double threshold = 0.1);
+
+      /**
+       * Determine an estimate for the memory consumption (in bytes) of this
+       * object.
+       */
+      std::size_t memory_consumption () const;
+
+    private:
+      /**
+       * Return the cost of the active @p cell according to the current cost
+       * model, without scaling.
+       */
+      double cost (const active_cell_iterator &cell) const;
+
+      /**
+       * Return the weight of @p cell. This function is connected to the
+       * Triangulation::Signals::cell_weight signal.
+       */
+      unsigned int weight (const cell_iterator                                         &cell,
+                           const typename dealii::Triangulation<dim,spacedim>::CellStatus status) const;
+
+      /**
+       * Compute the global average costs used by cost() and weight(). This
+       * function is connected to the
+       * Triangulation::Signals::pre_distributed_repartition signal.
+       */
+      void update_scaling ();
+
+      /**
+       * Resize the array of measured costs to the number of active cells and
+       * discard all measurements. This function is connected to the
+       * Triangulation::Signals::any_change signal.
+       */
+      void reset ();
+
+      /**
+       * The triangulation whose cells are weighted.
+       */
+      SmartPointer<dealii::Triangulation<dim,spacedim>,CellWeights<dim,spacedim> > triangulation;
+
+      /**
+       * The communicator of the triangulation, or MPI_COMM_SELF for serial
+       * triangulations.
+       */
+      MPI_Comm mpi_communicator;
+
+      /**
+       * The DoFHandler for the cost estimate based on the finite elements,
+       * and the parameters of this estimate.
+       */
+      SmartPointer<const hp::DoFHandler<dim,spacedim>,CellWeights<dim,spacedim> > dof_handler;
+      double fe_cost_exponent;
+      double fe_cost_coefficient;
+
+      /**
+       * The measured costs of the active cells, indexed by
+       * CellAccessor::active_cell_index(). Cells without measurements have a
+       * negative cost.
+       */
+      std::vector<double> measured_costs;
+
+      /**
+       * Whether costs have been measured for any cell on this processor.
+       */
+      bool has_local_measurements;
+
+      /**
+       * A mutex that guards the array of measured costs.
+       */
+      Threads::Mutex mutex;
+
+      /**
+       * Whether costs have been measured on any processor, the average
+       * measured cost per cell, and the average cost per cell, as computed
+       * in the last call to update_scaling().
+       */
+      bool   use_measured_costs;
+      double average_measured_cost;
+      double average_cost;
+
+      /**
+       * The connections to the signals of the triangulation.
+       */
+      std::vector<boost::signals2::connection> tria_listeners;
+    };
+
+
+
+    /* ---------------------- template functions ------------------------- */
+
+
+    template <int dim, int spacedim>
+    template <typename Number>
+    void
+    CellWeights<dim,spacedim>::
+    add_measured_cost (const MatrixFree<dim,Number>               &matrix_free,
+                       const std::pair<unsigned int,unsigned int> &cell_range,
+                       const double                                cost)
+    {
+      unsigned int n_cells = 0;
+      for (unsigned int macro_cell=cell_range.first; macro_cell<cell_range.second; ++macro_cell)
+        n_cells += matrix_free.n_components_filled (macro_cell);
+      if (n_cells == 0)
+        return;
+
+      Threads::Mutex::ScopedLock lock (mutex);
+      for (unsigned int macro_cell=cell_range.first; macro_cell<cell_range.second; ++macro_cell)
+        for (unsigned int v=0; v<matrix_free.n_components_filled (macro_cell); ++v)
+          {
+            const unsigned int index
+              = matrix_free.get_cell_iterator (macro_cell, v)->active_cell_index();
+            AssertIndexRange (index, measured_costs.size());
+            if (measured_costs[index] < 0)
+              measured_costs[index] = 0;
+            measured_costs[index] += cost / n_cells;
+          }
+      has_local_measurements = true;
+    }
+  }
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,304 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__distributed_fully_distributed_tria_h
+#define dealii__distributed_fully_distributed_tria_h
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/types.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/grid/tria.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace parallel
+{
+  /**
+   * A namespace for the class parallel::fullydistributed::Triangulation, a
+   * distributed triangulation in which no processor stores the complete
+   * coarse mesh.
+   */
+  namespace fullydistributed
+  {
+    /**
+     * The part of a partitioned coarse mesh that one processor stores. It
+     * consists of the coarse cells owned by this processor and of the layer
+     * of coarse cells owned by other processors that share at least one
+     * vertex with them, the ghost layer. All other coarse cells are omitted.
+     *
+     * The vertex indices in @p cells refer to the array @p vertices, which
+     * only contains the vertices of the stored cells. Each coarse cell has a
+     * global index in @p coarse_cell_ids that is the same on all processors
+     * that store the cell, and an owner in @p coarse_cell_owners. The order
+     * of the vertices of each cell must be the same on all processors that
+     * store it, and the cells need to be consistently oriented, as they are
+     * after GridReordering::reorder_cells(), since the triangulation does not
+     * reorder them: processors that store the same cell would otherwise not
+     * agree on the numbering of its children.
+     *
+     * Such a description can be created from a serial triangulation by
+     * create_construction_data(), or directly by a tool that partitions the
+     * mesh before the simulation and writes one file per processor.
+     */
+    template <int dim, int spacedim=dim>
+    struct ConstructionData
+    {
+      /**
+       * The vertices of the locally stored coarse cells.
+       */
+      std::vector<Point<spacedim> > vertices;
+
+      /**
+       * The locally stored coarse cells.
+       */
+      std::vector<CellData<dim> > cells;
+
+      /**
+       * The global indices of the locally stored coarse cells. This array
+       * has the same length as @p cells.
+       */
+      std::vector<unsigned int> coarse_cell_ids;
+
+      /**
+       * The subdomain ids of the processors that own the locally stored
+       * coarse cells. This array has the same length as @p cells.
+       */
+      std::vector<types::subdomain_id> coarse_cell_owners;
+
+      /**
+       * Boundary and manifold indicators of the faces and, in 3d, edges of
+       * the locally stored coarse cells, in the same form as for
+       * dealii::Triangulation::create_triangulation().
+       */
+      SubCellData boundary_data;
+
+      /**
+       * Determine an estimate for the memory consumption (in bytes) of this
+       * object.
+       */
+      std::size_t memory_consumption () const;
+    };
+
+
+
+    /**
+     * Extract the description of the part of the coarse mesh of @p
+     * triangulation that the processor with subdomain id @p subdomain stores
+     * from a serial triangulation. The owners of the coarse cells are taken
+     * from their subdomain ids, as set for example by
+     * GridTools::partition_triangulation(), and their global indices are
+     * their indices in @p triangulation, which must not be refined.
+     *
+     * This function requires the complete coarse mesh. It is intended to be
+     * called on one processor, or in a separate program that partitions the
+     * mesh once, to create the descriptions for all processors.
+     */
+    template <int dim, int spacedim>
+    ConstructionData<dim,spacedim>
+    create_construction_data (const dealii::Triangulation<dim,spacedim> &triangulation,
+                              const types::subdomain_id                  subdomain);
+
+
+
+    /**
+     * A distributed triangulation in which every processor only stores its
+     * own part of the coarse mesh and a ghost layer of coarse cells owned by
+     * other processors. In contrast, parallel::distributed::Triangulation
+     * stores the complete coarse mesh, as well as the connectivity of the
+     * coarse mesh in p4est, on every processor, which is prohibitive for
+     * coarse meshes with millions of cells that are imported from mesh
+     * generators.
+     *
+     * The triangulation is created from a ConstructionData object that
+     * describes the part of the coarse mesh of the current processor. The
+     * partition of the coarse mesh is fixed; the mesh can not be
+     * repartitioned. All descendants of a coarse cell belong to the owner of
+     * the coarse cell, and the ghost layer consists of all descendants of
+     * the coarse cells in the ghost layer of the description. Compared to
+     * parallel::distributed::Triangulation, where the ghost layer is one
+     * active cell thick, the ghost layer is thus larger for meshes that have
+     * been refined several times.
+     *
+     * Refinement and coarsening of cells are synchronized between the
+     * processors that store a cell: prepare_coarsening_and_refinement()
+     * repeatedly exchanges the refinement and coarsening flags of the ghost
+     * cells with their owners and applies the smoothing of the mesh until no
+     * processor changes its flags anymore. This function, and thus
+     * execute_coarsening_and_refinement(), needs to be called on all
+     * processors at the same time. Only isotropic refinement is supported.
+     *
+     * The global indices of the coarse cells are used by
+     * CellAccessor::id(), so that the CellId of a cell is the same on all
+     * processors that store it. DoFHandler objects on this triangulation
+     * number the degrees of freedom in parallel as for
+     * parallel::distributed::Triangulation, with the same notion of locally
+     * owned and locally relevant degrees of freedom. Multigrid levels,
+     * hp::DoFHandler, and the transfer of solutions during refinement with
+     * parallel::distributed::SolutionTransfer are not supported.
+     *
+     * @ingroup distributed
+     */
+    template <int dim, int spacedim=dim>
+    class Triangulation : public dealii::parallel::Triangulation<dim,spacedim>
+    {
+    public:
+      /**
+       * An abbreviation for the type of cell iterators.
+       */
+      typedef typename dealii::Triangulation<dim,spacedim>::cell_iterator        cell_iterator;
+
+      /**
+       * An abbreviation for the type of active cell iterators.
+       */
+      typedef typename dealii::Triangulation<dim,spacedim>::active_cell_iterator active_cell_iterator;
+
+      /**
+       * Constructor. The argument denotes the MPI communicator to be used
+       * for the triangulation.
+       */
+      explicit Triangulation (MPI_Comm mpi_communicator);
+
+      /**
+       * Destructor.
+       */
+      virtual ~Triangulation ();
+
+      /**
+       * Create the triangulation from the description of the part of the
+       * coarse mesh that is stored on the current processor. This function
+       * needs to be called on all processors at the same time.
+       */
+      void create_triangulation (const ConstructionData<dim,spacedim> &construction_data);
+
+      /**
+       * This function is not supported by this class, since it requires the
+       * complete coarse mesh. Use the function above instead.
+       */
+      virtual void create_triangulation (const std::vector<Point<spacedim> > &vertices,
+                                         const std::vector<CellData<dim> >   &cells,
+                                         const SubCellData                   &subcelldata);
+
+      /**
+       * This function is not supported by this class.
+       */
+      virtual void copy_triangulation (const dealii::Triangulation<dim,spacedim> &old_tria);
+
+      /**
+       * Exchange the refinement and coarsening flags of the ghost cells with
+       * their owners and smooth the mesh until the flags are consistent on
+       * all processors, see the documentation of this class. This function
+       * needs to be called on all processors at the same time.
+       */
+      virtual bool prepare_coarsening_and_refinement ();
+
+      /**
+       * Coarsen and refine the mesh according to the flags, after making
+       * them consistent between the processors by
+       * prepare_coarsening_and_refinement(). This function needs to be
+       * called on all processors at the same time.
+       */
+      virtual void execute_coarsening_and_refinement ();
+
+      /**
+       * Return the global index of the locally stored coarse cell with index
+       * @p coarse_cell_index.
+       */
+      virtual unsigned int
+      coarse_cell_index_to_coarse_cell_id (const unsigned int coarse_cell_index) const;
+
+      /**
+       * Return the index of the locally stored coarse cell with global index
+       * @p coarse_cell_id, or numbers::invalid_unsigned_int if it is not
+       * stored on the current processor.
+       */
+      virtual unsigned int
+      coarse_cell_id_to_coarse_cell_index (const unsigned int coarse_cell_id) const;
+
+      /**
+       * Return, for each processor that stores locally owned coarse cells
+       * in its ghost layer, the indices of these coarse cells, sorted by
+       * their global indices. The active descendants of these cells, in the
+       * order in which they are visited by a depth-first traversal of the
+       * children, are the ghost cells of the other processor.
+       */
+      const std::map<types::subdomain_id, std::vector<unsigned int> > &
+      coarse_cells_in_ghost_layers () const;
+
+      /**
+       * Return, for each processor that owns coarse cells in the ghost layer
+       * of the current processor, the indices of these coarse cells, sorted
+       * by their global indices. Their active descendants correspond one to
+       * one to those of the cells returned on the other processor by
+       * coarse_cells_in_ghost_layers().
+       */
+      const std::map<types::subdomain_id, std::vector<unsigned int> > &
+      coarse_cells_of_ghost_owners () const;
+
+      /**
+       * Return the local memory consumption in bytes.
+       */
+      virtual std::size_t memory_consumption () const;
+
+    private:
+      /**
+       * Set the subdomain ids of all active cells to those of their coarse
+       * cells.
+       */
+      void update_subdomain_ids ();
+
+      /**
+       * Send the refinement and coarsening flags of the locally owned cells
+       * to the processors that store them as ghost cells, and set the flags
+       * of the ghost cells to the ones received from their owners.
+       */
+      void exchange_refinement_flags ();
+
+      /**
+       * The global indices of the locally stored coarse cells.
+       */
+      std::vector<unsigned int> coarse_cell_ids;
+
+      /**
+       * The pairs of global and local indices of the locally stored coarse
+       * cells, sorted by the global indices.
+       */
+      std::vector<std::pair<unsigned int, unsigned int> > coarse_cell_id_to_index;
+
+      /**
+       * The subdomain ids of the locally stored coarse cells.
+       */
+      std::vector<types::subdomain_id> coarse_cell_subdomain_ids;
+
+      /**
+       * The coarse cells that are sent to and received from the neighboring
+       * processors, see coarse_cells_in_ghost_layers() and
+       * coarse_cells_of_ghost_owners().
+       */
+      std::map<types::subdomain_id, std::vector<unsigned int> > send_coarse_cells;
+      std::map<types::subdomain_id, std::vector<unsigned int> > receive_coarse_cells;
+    };
+  }
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -19,7 +19,9 @@
 #include <deal.II/base/config.h>
 #include <deal.II/distributed/tria.h>
 #include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/full_matrix.h>
 
+#include <utility>
 #include <vector>
 
 
@@ -100,6 +102,35 @@ namespace parallel
      * sol_trans.deserialize (distributed_vector);
      * @endcode
      *
+     * The values of the vectors are stored cell by cell in records of
+     * variable size through
+     * parallel::distributed::Triangulation::register_data_attach_variable_size(),
+     * so that each cell only takes as much space in the file as its finite
+     * element has degrees of freedom. Upon deserialization, each process only
+     * reads the records of the cells it owns.
+     *
+     *
+     * <h3>Performance</h3>
+     *
+     * The triangulation asks for the data to be stored on each cell, and
+     * hands back the stored data, one cell at a time. To avoid doing the
+     * actual work in these callbacks,
+     * prepare_for_coarsening_and_refinement() computes the values of all
+     * vectors on all cells that the triangulation will presumably ask for
+     * in parallel on the available threads, and the callback only copies
+     * them. Likewise, interpolate() and deserialize() first collect the data
+     * the triangulation hands back, and then interpolate it to the new cells
+     * in parallel. In both cases, the values of all vectors on a cell are
+     * restricted or prolongated at once, using restriction and prolongation
+     * matrices that are looked up only once per transfer. PETSc vectors can
+     * not be read from several threads at the same time, so for them the
+     * values are computed on a single thread.
+     *
+     * As a consequence, the values of the vectors passed to
+     * prepare_for_coarsening_and_refinement() are read at the time of this
+     * call, not when Triangulation::execute_coarsening_and_refinement() is
+     * called.
+     *
      *
      * <h3>Interaction with hanging nodes</h3>
      *
@@ -185,8 +216,10 @@ namespace parallel
       /**
        * Execute the deserialization of the given vector. This needs to be
        * done after calling Triangulation::load(). The given vector must be a
-       * fully distributed vector without ghost elements. See documentation of
-       * this class for more information.
+       * fully distributed vector without ghost elements. Checkpoints written
+       * by previous versions of deal.II, which stored the values of each cell
+       * in a slot of fixed size, can also be read. See documentation of this
+       * class for more information.
        */
       void deserialize(VectorType &in);
 
@@ -214,6 +247,35 @@ namespace parallel
        */
       unsigned int offset;
 
+      /**
+       * The values of the input vectors on the cells that pack_callback()
+       * will presumably be called for, computed in parallel by
+       * prepare_for_coarsening_and_refinement(). The values on the cell with
+       * index @p i on level @p l start at
+       * <tt>packed_values[packed_value_offsets[l][i]]</tt>, or the offset is
+       * numbers::invalid_dof_index if they have not been computed.
+       */
+      std::vector<typename VectorType::value_type> packed_values;
+      std::vector<std::vector<types::global_dof_index> > packed_value_offsets;
+
+      /**
+       * The cells handed to unpack_callback() or
+       * unpack_callback_variable_size(), along with the position of the data
+       * for them in @p unpacked_values. The data is only interpolated to the
+       * new cells once the triangulation has handed out all of it, so that
+       * this can be done in parallel.
+       */
+      std::vector<std::pair<typename DoFHandlerType::cell_iterator, std::size_t> > unpacked_cells;
+      std::vector<typename VectorType::value_type> unpacked_values;
+
+      /**
+       * Pointers to the restriction and prolongation matrices of the finite
+       * element for each child of an isotropically refined cell. They are
+       * only set up once they are needed.
+       */
+      std::vector<const FullMatrix<double> *> restriction_matrices;
+      std::vector<const FullMatrix<double> *> prolongation_matrices;
+
       /**
        * A callback function used to pack the data on the current mesh into
        * objects that can later be retrieved after refinement, coarsening and
@@ -239,6 +301,38 @@ namespace parallel
        */
       void register_data_attach(const std::size_t size);
 
+      /**
+       * Compute the values of all input vectors on the locally owned active
+       * cells, and on the parents of cells that will be coarsened, and store
+       * them in @p packed_values.
+       */
+      void compute_packed_values ();
+
+      /**
+       * Interpolate the data collected in @p unpacked_cells and
+       * @p unpacked_values to the active cells of the new mesh, and write it
+       * into the given vectors.
+       */
+      void interpolate_unpacked_values (std::vector<VectorType *> &all_out);
+
+      /**
+       * A callback function used to pack the values of all vectors on the
+       * given cell into a record of variable size for serialization.
+       */
+      std::vector<char>
+      pack_callback_variable_size(const typename Triangulation<dim,DoFHandlerType::space_dimension>::cell_iterator &cell,
+                                  const typename Triangulation<dim,DoFHandlerType::space_dimension>::CellStatus status);
+
+      /**
+       * A callback function used to unpack a record of variable size written
+       * by pack_callback_variable_size() during deserialization.
+       */
+      void unpack_callback_variable_size(const typename Triangulation<dim,DoFHandlerType::space_dimension>::cell_iterator &cell,
+                                         const typename Triangulation<dim,DoFHandlerType::space_dimension>::CellStatus status,
+                                         const void *data,
+                                         const std::size_t size,
+                                         std::vector<VectorType *> &all_out);
+
     };
 
 
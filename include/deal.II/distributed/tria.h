@@ -740,6 +740,68 @@ namespace parallel
                                                               const CellStatus,
                                                               const void *)> &unpack_callback);
 
+      /**
+       * Register a function that will be used to attach data of variable
+       * size to each locally owned active cell when the triangulation is
+       * written by save(). Contrary to register_data_attach(), the callback
+       * does not have to fit its data into a fixed number of bytes, but
+       * returns a buffer of whatever length is needed for the given cell.
+       * This avoids reserving the maximal record size for every cell, as is
+       * necessary for example when saving solution vectors of hp::DoFHandler
+       * objects.
+       *
+       * The records of all registered functions are written by save() into a
+       * separate file <code>filename.variable</code> using collective MPI-IO.
+       * The file starts with a table that stores, for every cell of the
+       * global mesh in the order of the space filling curve and every
+       * registered function, the end of the corresponding record, followed by
+       * the records themselves. When reading the file back in with load(),
+       * each process therefore only reads those parts of the table and those
+       * records that belong to the cells it owns, independent of the number
+       * of processes that were used to write the file.
+       *
+       * The returned handle has to be passed to
+       * notify_ready_to_unpack_variable_size() after load(). The functions
+       * need to be registered in the same order before save() and after
+       * load().
+       *
+       * @note Data of variable size can currently only be transferred through
+       * save() and load(), not through execute_coarsening_and_refinement().
+       * The CellStatus argument of the callback will therefore always be
+       * CELL_PERSIST.
+       */
+      unsigned int
+      register_data_attach_variable_size
+      (const std_cxx11::function<std::vector<char> (const cell_iterator &,
+                                                    const CellStatus)> &pack_callback);
+
+      /**
+       * Call the supplied function for each locally owned active cell after
+       * load() and hand it the record that was stored for this cell by the
+       * function registered with register_data_attach_variable_size() before
+       * save(). The @p handle is the value returned by
+       * register_data_attach_variable_size() after load(). The last two
+       * arguments of the callback are a pointer to the beginning of the
+       * record and its size in bytes.
+       */
+      void
+      notify_ready_to_unpack_variable_size
+      (const unsigned int handle,
+       const std_cxx11::function<void (const cell_iterator &,
+                                       const CellStatus,
+                                       const void *,
+                                       const std::size_t)> &unpack_callback);
+
+      /**
+       * Return the number of functions whose records of variable size were
+       * read by the last call to load() and have not yet been handed out
+       * through notify_ready_to_unpack_variable_size(). This is zero for
+       * files written before records of variable size existed, i.e., for
+       * files whose <code>filename.info</code> file has version 2.
+       */
+      unsigned int
+      n_variable_size_data_to_unpack () const;
+
       /**
        * Return a permutation vector for the order the coarse cells are handed
        * off to p4est. For example the value of the $i$th element in this
@@ -862,6 +924,61 @@ namespace parallel
        */
       callback_list_t attached_data_pack_callbacks;
 
+      typedef std_cxx11::function<
+      std::vector<char> (typename Triangulation<dim,spacedim>::cell_iterator, CellStatus)
+      > variable_size_pack_callback_t;
+
+      /**
+       * List of callback functions registered by
+       * register_data_attach_variable_size() that are going to be called for
+       * packing data in save().
+       */
+      std::vector<variable_size_pack_callback_t> variable_size_pack_callbacks;
+
+      /**
+       * Number of functions registered with
+       * register_data_attach_variable_size() before the call to save() that
+       * created the file read by the last call to load().
+       */
+      unsigned int n_variable_size_datas_loaded;
+
+      /**
+       * Number of those functions that have not yet unpacked their data
+       * through notify_ready_to_unpack_variable_size().
+       */
+      unsigned int n_variable_size_deserialize;
+
+      /**
+       * The records of variable size read by load() for the locally owned
+       * cells, in the order of the space filling curve, and the offsets of
+       * each record into this array. The records of cell $i$ and registered
+       * function $j$ are stored in the range
+       * <code>[variable_size_offsets[i*n+j], variable_size_offsets[i*n+j+1])</code>
+       * where $n$ is the number of registered functions.
+       */
+      std::vector<char>     variable_size_data;
+      std::vector<uint64_t> variable_size_offsets;
+
+      /**
+       * Write the records of all functions registered with
+       * register_data_attach_variable_size() to the file
+       * <code>filename.variable</code>.
+       */
+      void save_variable_size_data (const char *filename) const;
+
+      /**
+       * Read the records stored by save_variable_size_data() for the locally
+       * owned cells into variable_size_data.
+       */
+      void load_variable_size_data (const char *filename,
+                                    const unsigned int n_objects);
+
+      /**
+       * Return all locally owned active cells in the order in which p4est
+       * stores them, i.e., ordered along the space filling curve.
+       */
+      std::vector<cell_iterator> locally_owned_cells_in_p4est_order () const;
+
 
       /**
        * Two arrays that store which p4est tree corresponds to which coarse
@@ -214,6 +214,44 @@ namespace internal
                        dealii::DoFHandler<dim,spacedim> &dof_handler,
                        NumberCache &number_cache) const;
       };
+
+
+      /**
+       * This class implements the policy for operations when we use a
+       * parallel::fullydistributed::Triangulation object. The degrees of
+       * freedom are numbered as for parallel::distributed::Triangulation,
+       * but the indices on the ghost cells are exchanged along the ghost
+       * layers of coarse cells that the triangulation provides.
+       */
+      template <int dim, int spacedim>
+      class ParallelFullyDistributed : public PolicyBase<dim,spacedim>
+      {
+      public:
+        /**
+         * Distribute degrees of freedom on the object given as last argument.
+         */
+        virtual
+        void
+        distribute_dofs (dealii::DoFHandler<dim,spacedim> &dof_handler,
+                         NumberCache &number_cache) const;
+
+        /**
+         * This function is not implemented.
+         */
+        virtual
+        void
+        distribute_mg_dofs (dealii::DoFHandler<dim,spacedim> &dof_handler,
+                            std::vector<NumberCache> &number_caches) const;
+
+        /**
+         * Renumber degrees of freedom as specified by the first argument.
+         */
+        virtual
+        void
+        renumber_dofs (const std::vector<types::global_dof_index>  &new_numbers,
+                       dealii::DoFHandler<dim,spacedim> &dof_handler,
+                       NumberCache &number_cache) const;
+      };
     }
   }
 }
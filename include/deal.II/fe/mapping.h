@@ -391,6 +391,31 @@ public:
   transform_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
                                const Point<spacedim>                                     &p) const = 0;
 
+  /**
+   * Map the points @p real_points on the real @p cell to the corresponding
+   * points on the unit cell, and store their coordinates in @p unit_points,
+   * which needs to have the same size as @p real_points. This function is
+   * equivalent to calling transform_real_to_unit_cell() for each of the
+   * points, but derived classes may implement it more efficiently by doing
+   * the work that only depends on the cell once for all points, and by
+   * working on several points at once.
+   *
+   * Rather than throwing an exception of type
+   * Mapping::ExcTransformationFailed, the first coordinate of the unit
+   * point is set to <tt>std::numeric_limits<double>::infinity()</tt> for
+   * each point for which the transformation fails. Such points lie outside
+   * the cell and can be recognized by GeometryInfo::is_inside_unit_cell()
+   * like any other point outside the cell.
+   *
+   * The default implementation calls transform_real_to_unit_cell() for each
+   * of the points.
+   */
+  virtual
+  void
+  transform_points_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                      const ArrayView<const Point<spacedim> >                   &real_points,
+                                      const ArrayView<Point<dim> >                              &unit_points) const;
+
   /**
    * Transforms the point @p p on the real @p cell to the corresponding point
    * on the unit cell, and then projects it to a dim-1  point on the face with
@@ -150,6 +150,19 @@ public:
   transform_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
                                const Point<spacedim>                                     &p) const;
 
+  /**
+   * Map many points from the real cell to the unit cell, see
+   * Mapping::transform_points_real_to_unit_cell(). This function uses the
+   * same choice between the Q1 and the higher order mapping as
+   * transform_real_to_unit_cell(), and forwards to the implementation in
+   * MappingQGeneric.
+   */
+  virtual
+  void
+  transform_points_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                      const ArrayView<const Point<spacedim> >                   &real_points,
+                                      const ArrayView<Point<dim> >                              &unit_points) const;
+
   // for documentation, see the Mapping base class
   virtual
   void
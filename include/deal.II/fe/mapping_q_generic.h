@@ -134,6 +134,31 @@ public:
   transform_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
                                const Point<spacedim>                            &p) const;
 
+  /**
+   * Map many points from the real cell to the unit cell, see
+   * Mapping::transform_points_real_to_unit_cell().
+   *
+   * This function computes the mapping support points of the cell only once
+   * for all points. If the mapping is affine on the cell, i.e., if all
+   * support points are the image of the reference support points under an
+   * affine map, the points are mapped back by the inverse of this map
+   * directly. Otherwise, the Newton iteration of
+   * transform_real_to_unit_cell() is run on the points in groups of
+   * VectorizedArray<double>::n_array_elements points at once, with the
+   * points that do not converge within a few steps handed to
+   * transform_real_to_unit_cell() one by one. The results agree with those
+   * of transform_real_to_unit_cell() up to the tolerance of the Newton
+   * iteration.
+   *
+   * The accelerated algorithm is only available for dim==spacedim. Otherwise,
+   * the implementation of the base class is used.
+   */
+  virtual
+  void
+  transform_points_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                      const ArrayView<const Point<spacedim> >                   &real_points,
+                                      const ArrayView<Point<dim> >                              &unit_points) const;
+
   /**
    * @}
    */
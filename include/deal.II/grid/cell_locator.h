@@ -0,0 +1,255 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__cell_locator_h
+#define dealii__cell_locator_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/fe/mapping.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/grid/tria.h>
+
+#include <boost/signals2/connection.hpp>
+
+#include <utility>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/**
+ * A class that finds the active cells of a triangulation that surround given
+ * points, for applications that locate many points in the same mesh, such as
+ * particle methods or the evaluation of a solution at many probe points.
+ *
+ * GridTools::find_active_cell_around_point() starts its search at the vertex
+ * closest to the point, which it finds by a loop over all vertices of the
+ * mesh, and therefore needs a number of operations proportional to the
+ * number of vertices for each point. This class instead sets up a tree of
+ * axis-parallel bounding boxes of the active cells (a bulk-loaded R-tree
+ * with two children per node), so that the cells whose bounding boxes
+ * contain a point are found with a number of operations proportional to the
+ * logarithm of the number of cells. For each of these candidate cells, the
+ * point is transformed to the reference cell with the given mapping, and the
+ * cell is selected by the same rules as used by
+ * GridTools::find_active_cell_around_point().
+ *
+ * The bounding box of a cell is the bounding box of its vertices as
+ * returned by Mapping::get_vertices(), enlarged on each side by a fraction
+ * of its size given to the constructor. This enlargement has to cover the
+ * parts of cells that bulge out of the bounding box of their vertices, for
+ * example for curved cells described by a higher order mapping; points in
+ * such parts are otherwise not found.
+ *
+ * The tree is connected to the Triangulation::Signals::any_change signal of
+ * the triangulation and is rebuilt automatically whenever the triangulation
+ * is refined, coarsened, or otherwise changed. If the positions of the
+ * vertices are changed without triggering this signal, for example by
+ * moving the vertices directly or by changing the displacement field of a
+ * MappingQEulerian object, then rebuild() needs to be called explicitly.
+ *
+ * Besides finding the cell around a single point, the class offers
+ * find_active_cells_around_points() that locates many points at once and
+ * works on them in parallel.
+ *
+ * @note When applied to a parallel::distributed::Triangulation object, the
+ * cell returned may be a ghost or artificial cell, as with
+ * GridTools::find_active_cell_around_point().
+ *
+ * @ingroup grid
+ */
+template <int dim, int spacedim=dim>
+class CellLocator : public Subscriptor
+{
+public:
+  /**
+   * The type of iterators returned by this class.
+   */
+  typedef typename Triangulation<dim,spacedim>::active_cell_iterator active_cell_iterator;
+
+  /**
+   * Constructor. Set up the tree of bounding boxes for the active cells of
+   * @p triangulation, using @p mapping to determine the location of the
+   * vertices of the cells and to transform points to the reference cell.
+   * The bounding box of each cell is enlarged on each side by @p
+   * relative_tolerance times its largest extent.
+   */
+  CellLocator (const Triangulation<dim,spacedim> &triangulation,
+               const Mapping<dim,spacedim>       &mapping = StaticMappingQ1<dim,spacedim>::mapping,
+               const double                       relative_tolerance = 0.1);
+
+  /**
+   * Destructor. Disconnects from the signals of the triangulation.
+   */
+  ~CellLocator ();
+
+  /**
+   * Set up the tree of bounding boxes again. This needs to be called if the
+   * locations of the vertices have changed without triggering the
+   * Triangulation::Signals::any_change signal.
+   */
+  void rebuild ();
+
+  /**
+   * Find the active cell that surrounds the point @p p, and return it
+   * together with the coordinates of @p p in the reference coordinate system
+   * of that cell. As in GridTools::find_active_cell_around_point(), points
+   * located slightly outside the returned cell due to roundoff are accepted,
+   * and if a point lies on the boundary of two or more cells, the one with
+   * the highest refinement level is returned.
+   *
+   * If the point does not lie in any of the active cells, an exception of
+   * type GridTools::ExcPointNotFound is thrown.
+   */
+  std::pair<active_cell_iterator, Point<dim> >
+  find_active_cell_around_point (const Point<spacedim> &p) const;
+
+  /**
+   * Find the active cells that surround the given @p points, as in the
+   * previous function. The result for <tt>points[i]</tt> is stored in
+   * <tt>cells_and_reference_points[i]</tt>, which is resized to the size of
+   * @p points. Rather than throwing an exception, the iterator of a point
+   * that does not lie in any cell is set to the end iterator of the
+   * triangulation.
+   *
+   * The points are processed in parallel if multithreading is enabled.
+   */
+  void
+  find_active_cells_around_points (const std::vector<Point<spacedim> > &points,
+                                   std::vector<std::pair<active_cell_iterator, Point<dim> > > &cells_and_reference_points) const;
+
+  /**
+   * Find all active cells that contain the point @p p, up to the same
+   * roundoff tolerance as used by find_active_cell_around_point(), together
+   * with the coordinates of @p p in the reference coordinate systems of
+   * these cells. This is more than one cell if @p p lies on a face, edge or
+   * vertex shared by several cells, and the vector is empty if @p p is not
+   * in any cell.
+   */
+  void
+  find_all_active_cells_around_point (const Point<spacedim>                                      &p,
+                                      std::vector<std::pair<active_cell_iterator, Point<dim> > > &cells_and_reference_points) const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * An active cell of the triangulation together with its (enlarged)
+   * bounding box.
+   */
+  struct Item
+  {
+    Point<spacedim> lower_corner;
+    Point<spacedim> upper_corner;
+    int             level;
+    int             index;
+  };
+
+  /**
+   * A node of the tree. It covers the items with indices in the range
+   * [begin,end), and its bounding box contains all of their bounding boxes.
+   * Inner nodes have two children with indices @p first_child and
+   * <tt>first_child+1</tt>, while leaves have @p first_child set to
+   * numbers::invalid_unsigned_int.
+   */
+  struct Node
+  {
+    Point<spacedim> lower_corner;
+    Point<spacedim> upper_corner;
+    unsigned int    begin;
+    unsigned int    end;
+    unsigned int    first_child;
+  };
+
+  /**
+   * Set up the node with index @p node for the items with indices in the
+   * range [begin,end), and recursively its children.
+   */
+  void build_node (const unsigned int node,
+                   const unsigned int begin,
+                   const unsigned int end);
+
+  /**
+   * Store the indices of all items whose bounding boxes contain the point
+   * @p p in @p candidates. The vector @p node_stack is used as scratch
+   * space.
+   */
+  void find_candidates (const Point<spacedim>     &p,
+                        std::vector<unsigned int> &node_stack,
+                        std::vector<unsigned int> &candidates) const;
+
+  /**
+   * Find the cell around the point @p p. Return whether one was found,
+   * and if so, store it in @p result. The vectors @p node_stack and @p
+   * candidates are used as scratch space.
+   */
+  bool find_cell (const Point<spacedim>                          &p,
+                  std::pair<active_cell_iterator, Point<dim> >   &result,
+                  std::vector<unsigned int>                      &node_stack,
+                  std::vector<unsigned int>                      &candidates) const;
+
+  /**
+   * Call find_cell() for the points with indices in the range [begin,end).
+   * This function is used to work on subranges of the points in parallel.
+   */
+  void find_cells_on_range (const std::vector<Point<spacedim> >                        &points,
+                            std::vector<std::pair<active_cell_iterator, Point<dim> > > &cells_and_reference_points,
+                            const unsigned int                                          begin,
+                            const unsigned int                                          end) const;
+
+  /**
+   * The triangulation whose cells are located.
+   */
+  SmartPointer<const Triangulation<dim,spacedim>,CellLocator<dim,spacedim> > triangulation;
+
+  /**
+   * The mapping used for the vertex locations and for the transformation
+   * to the reference cell.
+   */
+  SmartPointer<const Mapping<dim,spacedim>,CellLocator<dim,spacedim> > mapping;
+
+  /**
+   * The enlargement of the bounding boxes relative to their size.
+   */
+  const double relative_tolerance;
+
+  /**
+   * The active cells, sorted such that the items of each node are stored
+   * contiguously.
+   */
+  std::vector<Item> items;
+
+  /**
+   * The nodes of the tree. The root is the first element.
+   */
+  std::vector<Node> nodes;
+
+  /**
+   * The connection to the Triangulation::Signals::any_change signal of the
+   * triangulation.
+   */
+  boost::signals2::connection tria_listener;
+};
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
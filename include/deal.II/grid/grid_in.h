@@ -144,7 +144,7 @@ template <int dim> struct CellData;
  *
  * <li> <tt>Gmsh 2.0 mesh</tt> format: this is a variant of the above format.
  * The read_msh() function automatically determines whether an input file is
- * version 1 or version 2.
+ * version 1 or version 2, and whether it is stored in ASCII or binary form.
  *
  * <li> <tt>Tecplot</tt> format: this format is used by @p TECPLOT and often
  * serves as a basis for data exchange between different applications. Note,
@@ -366,6 +366,8 @@ public:
 
   /**
    * Read grid data from an ucd file. Numerical data is ignored.
+   * Like read_msh(), this function parses the lines of the file in parallel
+   * if every vertex and every cell is given on a line of its own.
    * It is not possible to use a ucd file to set both boundary_id and
    * manifold_id for the same cell. Yet it is possible to use
    * the flag apply_all_indicators_to_manifolds to decide if
@@ -432,9 +434,14 @@ public:
    * file format. The GMSH formats are documented at
    * http://www.geuz.org/gmsh/.
    *
+   * Files of version 2 may be given in ASCII or in binary format, with
+   * either byte order.
+   *
    * @note The input function of deal.II does not distinguish between newline
    * and other whitespace. Therefore, deal.II will be able to read files in a
-   * slightly more general format than Gmsh.
+   * slightly more general format than Gmsh. Files that have one vertex or
+   * element per line, as written by Gmsh, are read fastest, since their
+   * lines are then parsed in parallel.
    */
   void read_msh (std::istream &in);
 
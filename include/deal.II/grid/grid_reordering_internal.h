@@ -343,40 +343,6 @@ namespace internal
       bool operator != (const EdgeOrientation &edge_orientation) const;
     };
 
-    /**
-     * During building the connectivity information we don't need all the
-     * heavy duty information about edges that we will need later. So we can
-     * save memory and time by using a light-weight class for edges. It stores
-     * the two vertices, but no direction, so we make the optimization to
-     * store the vertex number in sorted order to allow for easier comparison
-     * of edge objects.
-     */
-    struct CheapEdge
-    {
-      /**
-       * The first node
-       */
-      const unsigned int node0;
-
-      /**
-       * The second node
-       */
-      const unsigned int node1;
-
-      /**
-       * Constructor. Take the vertex numbers and store them sorted.
-       */
-      CheapEdge (const unsigned int n0,
-                 const unsigned int n1);
-
-      /**
-       * Need a partial ordering for sorting algorithms
-       */
-      bool operator< (const CheapEdge &e2) const;
-    };
-
-
-
     /**
      * A connectivity and orientation aware edge class.
      */
@@ -403,15 +369,10 @@ namespace internal
        * Used to determine which "sheet" or equivalence class of parallel
        * edges the edge falls in when oriented. numbers::invalid_unsigned_int
        * means not yet decided. This is also the default value after
-       * construction. Each edge will later be assigned an index greater than
-       * zero.
+       * construction. The sheets are numbered in the order in which they
+       * are first encountered in the list of cells.
        */
       unsigned int group;
-
-      /**
-       * Indices of neighboring cubes.
-       */
-      std::vector<unsigned int> neighboring_cubes;
     };
 
     /**
@@ -448,12 +409,6 @@ namespace internal
        * of the edge in local element (1) or node 1 is the base (-1).
        */
       EdgeOrientation local_orientation_flags[GeometryInfo<3>::lines_per_cell];
-
-      /**
-       * An internal flag used to determine whether the cell is in the queue
-       * of cells to be oriented in the current sheet.
-       */
-      bool waiting_to_be_processed;
     };
 
 
@@ -497,6 +452,12 @@ namespace internal
       /**
        * Given the cell list, build the edge list and all the connectivity
        * information and other stuff that we will need later.
+       *
+       * The edges are identified by sorting the edges of all cells into
+       * buckets according to their vertex with the smaller index, and
+       * searching for the other vertex within each bucket. Since the number
+       * of edges that meet at a vertex is bounded in practice, this takes
+       * time linear in the number of cells.
        */
       void build_connectivity ();
 
@@ -524,8 +485,22 @@ namespace internal
 
 
     /**
-     * The class that orients the edges of a triangulation in 3d. The member
-     * variables basically only store the present state of the algorithm.
+     * The class that orients the edges of a triangulation in 3d.
+     *
+     * The four parallel edges of each cell have to point in the same
+     * direction, as seen from the cell. The edges that are connected through
+     * this condition form "sheets", and within each sheet, the direction of
+     * one edge determines the directions of all others. The sheets and the
+     * relative directions of their edges are computed with a union-find
+     * structure over the edges, in which each edge also stores whether it
+     * points in the same or the opposite direction as its parent. This takes
+     * time that is essentially linear in the number of cells. The mesh can
+     * not be oriented if a cell requires two edges of the same sheet to have
+     * directions that contradict the ones already known.
+     *
+     * Once all edges are oriented, the cells are rotated independently of
+     * each other to match the directions of their edges, which is done in
+     * parallel.
      */
     class Orienter
     {
@@ -551,35 +526,6 @@ namespace internal
        */
       Mesh mesh;
 
-      /**
-       * The cube we're looking at presently.
-       */
-      unsigned int cur_posn;
-
-      /**
-       * We have fully oriented all cubes before this one.
-       */
-      unsigned int marker_cube;
-
-      /**
-       * The index of the sheet or equivalence class we are presently
-       * processing.
-       */
-      unsigned int cur_edge_group;
-
-      /**
-       * Indices of the cells to be processed within the present sheet. If a
-       * cell is being processed presently, it is taken from this list.
-       */
-      std::vector<int> sheet_to_process;
-
-
-      /**
-       * Which edges of the current cell have been oriented during the current
-       * iteration. Is reset when moving on to the next cube.
-       */
-      bool edge_orient_array[12];
-
       /**
        * Constructor. Take a list of cells and set up the internal data
        * structures of the mesh member variable.
@@ -590,7 +536,9 @@ namespace internal
       Orienter (const std::vector<CellData<3> > &incubes);
 
       /**
-       * Orient all the edges of a mesh.
+       * Orient all the edges of a mesh. The direction of each sheet is
+       * chosen such that the first cell in which the sheet appears does not
+       * need to be rotated in the direction of its edges.
        *
        * Returns, whether this action was carried out successfully.
        */
@@ -602,28 +550,12 @@ namespace internal
        */
       void orient_cubes ();
 
-      bool get_next_unoriented_cube ();
-
       /**
-       * Return whether the cell with cell number @p cell_num is fully
-       * oriented.
+       * Rotate the cubes with indices in the range <code>[begin,end)</code>,
+       * see orient_cubes().
        */
-      bool is_oriented (const unsigned int cell_num) const;
-
-      bool orient_edges_in_current_cube ();
-      bool orient_edge_set_in_current_cube (const unsigned int edge_set);
-      bool orient_next_unoriented_edge ();
-
-      /**
-       * Return whether the cell is consistently oriented at present (i.e.
-       * only considering those edges that are already oriented. This is a
-       * sanity check that should be called from inside an assert macro.
-       */
-      bool cell_is_consistent (const unsigned int cell_num) const;
-
-
-      void get_adjacent_cubes ();
-      bool get_next_active_cube ();
+      void orient_cubes_in_range (const unsigned int begin,
+                                  const unsigned int end);
     };
   }  // namespace GridReordering3d
 }  // namespace internal
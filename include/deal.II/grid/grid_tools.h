@@ -551,6 +551,11 @@ namespace GridTools
    * If a point lies on the boundary of two or more cells, then the algorithm
    * tries to identify the cell that is of highest refinement level.
    *
+   * Finding the closest vertex requires a loop over all vertices of the mesh
+   * for every call of this function. If many points have to be located in
+   * the same mesh, the CellLocator class is considerably faster since it
+   * sets up a search tree of the cells once.
+   *
    * @param mapping The mapping used to determine whether the given point is
    * inside a given cell.
    * @param mesh A variable of a type that satisfies the requirements of the
@@ -876,6 +876,13 @@ namespace internal
  * use and does not allow access to the other one, until clear_user_data() has
  * been called.
  *
+ * @note The memory for user pointers and user indices is only allocated when
+ * the first one of them is set on objects of a given kind (e.g. on lines, or
+ * on the cells of one level), and it is released again by clear_user_data().
+ * Reading them before that simply returns zero. Since the first write
+ * allocates memory, it must not happen concurrently from several threads;
+ * set one user index or pointer before starting threads that write others.
+ *
  *
  * <h3>%Boundary approximation</h3>
  *
@@ -1536,6 +1543,33 @@ public:
    */
   virtual void set_mesh_smoothing (const MeshSmoothing mesh_smoothing);
 
+  /**
+   * Enable or disable caching the vertex indices of all cells.
+   *
+   * Cells only store the indices of their faces, and
+   * TriaAccessor::vertex_index() and TriaAccessor::vertex() on cells have to
+   * go through the faces and lines of the cell to find the index of a
+   * vertex. If caching is enabled, the triangulation in addition stores a
+   * flat table of the vertex indices of all cells on each level, which these
+   * functions then read directly. This speeds up code that frequently
+   * queries the vertices of cells, such as MappingQGeneric and MappingQ1,
+   * GridTools::find_active_cell_around_point(), or DataOut, at the cost of
+   * GeometryInfo<dim>::vertices_per_cell integers of memory per cell.
+   *
+   * The table is discarded when refinement or coarsening starts (i.e., upon
+   * the Signals::pre_refinement signal) and is rebuilt whenever the
+   * triangulation has changed (i.e., upon the Signals::any_change signal),
+   * before any other function connected to these signals is called. Caching
+   * is disabled by default, and the setting is retained by clear().
+   */
+  void set_cell_vertex_index_caching (const bool enable);
+
+  /**
+   * Return whether the vertex indices of cells are cached. See
+   * set_cell_vertex_index_caching().
+   */
+  bool cell_vertex_indices_are_cached () const;
+
   /**
    * If @p dim==spacedim, assign a boundary object to a certain part of the
    * boundary of a the triangulation. If a face with boundary number @p number
@@ -1865,6 +1899,15 @@ public:
    * distorted (see the extensive discussion on
    * @ref GlossDistorted "distorted cells").
    *
+   * @note The new vertices on refined edges, the check for distorted
+   * children, and the neighbor information of all cells are computed in
+   * parallel if deal.II was configured with threads. Consequently, the
+   * functions of the Manifold objects attached to this triangulation may be
+   * called concurrently from several threads. This is not a problem for the
+   * manifolds provided by deal.II, which do not modify any state when
+   * computing new points, but needs to be kept in mind when implementing a
+   * manifold that caches data.
+   *
    * @note This function is <tt>virtual</tt> to allow derived classes to
    * insert hooks, such as saving refinement flags and the like (see e.g. the
    * PersistentTriangulation class).
@@ -2063,6 +2106,18 @@ public:
     boost::signals2::signal<unsigned int (const cell_iterator &,
                                           const CellStatus),
                                                 CellWeightSum<unsigned int> > cell_weight;
+
+    /**
+     * This signal is triggered once during every automatic or manual
+     * repartitioning of a distributed parallel triangulation, right before
+     * the @p cell_weight signal is triggered for the cells. Like the latter,
+     * it is only triggered if functions are connected to the @p cell_weight
+     * signal. It allows connected objects to compute quantities that the
+     * cell weights depend on and that require communication, for example
+     * the global average cost of a cell, since the @p cell_weight signal is
+     * only called for the locally owned cells and must not communicate.
+     */
+    boost::signals2::signal<void ()> pre_distributed_repartition;
   };
 
   /**
@@ -2804,6 +2859,25 @@ public:
    */
   virtual types::subdomain_id locally_owned_subdomain () const;
 
+  /**
+   * Return the global index of the coarse cell with index @p
+   * coarse_cell_index in this triangulation. This is the index used in the
+   * CellId of a cell, see CellAccessor::id(). For this class, both indices
+   * are the same, but triangulations that store only a part of the coarse
+   * mesh, like parallel::fullydistributed::Triangulation, map their local
+   * coarse cells to indices that are the same on all processors.
+   */
+  virtual unsigned int
+  coarse_cell_index_to_coarse_cell_id (const unsigned int coarse_cell_index) const;
+
+  /**
+   * The inverse of coarse_cell_index_to_coarse_cell_id(). Return
+   * numbers::invalid_unsigned_int if the coarse cell with global index @p
+   * coarse_cell_id is not stored in this triangulation.
+   */
+  virtual unsigned int
+  coarse_cell_id_to_coarse_cell_index (const unsigned int coarse_cell_id) const;
+
   /**
    * Return a reference to the current object.
    *
@@ -3286,6 +3360,20 @@ private:
    */
   void reset_active_cell_indices ();
 
+  /**
+   * Rebuild the cached vertex indices of all cells if caching is enabled,
+   * and delete them otherwise. See set_cell_vertex_index_caching(). This
+   * function is connected to the Signals::any_change signal.
+   */
+  void update_cell_vertex_index_cache ();
+
+  /**
+   * Delete the cached vertex indices of all cells, since they become invalid
+   * once the triangulation is changed. This function is connected to the
+   * Signals::pre_refinement signal.
+   */
+  void clear_cell_vertex_index_cache ();
+
   /**
    * Refine all cells on all levels which were previously flagged for
    * refinement.
@@ -3358,6 +3446,12 @@ private:
    */
   const bool check_for_distorted_cells;
 
+  /**
+   * Whether the vertex indices of cells are cached. See
+   * set_cell_vertex_index_caching().
+   */
+  bool cache_cell_vertex_indices;
+
   /**
    * Cache to hold the numbers of lines, quads, hexes, etc. These numbers are
    * set at the end of the refinement and coarsening functions and enable
@@ -3257,7 +3257,7 @@ CellAccessor<dim,spacedim>::id() const
     }
 
   Assert(ptr.level()==0, ExcInternalError());
-  coarse_index = ptr.index();
+  coarse_index = this->tria->coarse_cell_index_to_coarse_cell_id (ptr.index());
 
   return CellId(coarse_index, id);
 }
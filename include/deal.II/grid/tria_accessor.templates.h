@@ -1169,6 +1169,17 @@ vertex_index (const unsigned int corner) const
   Assert (corner<GeometryInfo<structdim>::vertices_per_cell,
           ExcIndexRange(corner,0,GeometryInfo<structdim>::vertices_per_cell));
 
+  // for cells, use the vertex indices cached by the triangulation if
+  // available. see Triangulation::set_cell_vertex_index_caching()
+  if (structdim == dim)
+    {
+      const std::vector<unsigned int> &cache
+        = this->tria->levels[this->present_level]->cell_vertex_indices_cache;
+      if (cache.size() != 0)
+        return cache[this->present_index * GeometryInfo<structdim>::vertices_per_cell
+                     + corner];
+    }
+
   return dealii::internal::TriaAccessor::Implementation::vertex_index (*this, corner);
 }
 
@@ -1714,7 +1725,10 @@ template <int structdim, int dim, int spacedim>
 void *TriaAccessor<structdim,dim,spacedim>::user_pointer () const
 {
   Assert (this->used(), TriaAccessorExceptions::ExcCellNotUsed());
-  return this->objects().user_pointer(this->present_index);
+  // go through the const version, which does not allocate memory for the
+  // user data if it has never been set
+  const dealii::internal::Triangulation::TriaObjects<dealii::internal::Triangulation::TriaObject<structdim> > &objects = this->objects();
+  return const_cast<void *>(objects.user_pointer(this->present_index));
 }
 
 
@@ -1767,7 +1781,8 @@ template <int structdim, int dim, int spacedim>
 unsigned int TriaAccessor<structdim,dim,spacedim>::user_index () const
 {
   Assert (this->used(), TriaAccessorExceptions::ExcCellNotUsed());
-  return this->objects().user_index(this->present_index);
+  const dealii::internal::Triangulation::TriaObjects<dealii::internal::Triangulation::TriaObject<structdim> > &objects = this->objects();
+  return objects.user_index(this->present_index);
 }
 
 
@@ -3022,8 +3037,9 @@ int
 CellAccessor<dim,spacedim>::neighbor_index (const unsigned int i) const
 {
   AssertIndexRange (i,GeometryInfo<dim>::faces_per_cell);
-  return this->tria->levels[this->present_level]->
-         neighbors[this->present_index*GeometryInfo<dim>::faces_per_cell+i].second;
+  // the conversion turns numbers::invalid_unsigned_int into -1
+  return static_cast<int>(this->tria->levels[this->present_level]->
+                          neighbor_indices[this->present_index*GeometryInfo<dim>::faces_per_cell+i]);
 }
 
 
@@ -3034,8 +3050,13 @@ int
 CellAccessor<dim,spacedim>::neighbor_level (const unsigned int i) const
 {
   AssertIndexRange (i, GeometryInfo<dim>::faces_per_cell);
-  return this->tria->levels[this->present_level]->
-         neighbors[this->present_index*GeometryInfo<dim>::faces_per_cell+i].first;
+  const unsigned short int level = this->tria->levels[this->present_level]->
+                                   neighbor_levels[this->present_index*GeometryInfo<dim>::faces_per_cell+i];
+  return (level == internal::Triangulation::TriaLevel<dim>::invalid_neighbor_level
+          ?
+          -1
+          :
+          static_cast<int>(level));
 }
 
 
@@ -79,19 +79,20 @@ namespace internal
       std::vector<unsigned int> active_cell_indices;
 
       /**
-       * Levels and indices of the neighbors of the cells. Convention is, that
-       * the neighbors of the cell with index @p i are stored in the fields
+       * Indices of the neighbors of the cells. Convention is, that the
+       * neighbors of the cell with index @p i are stored in the fields
        * following $i*(2*real\_space\_dimension)$, e.g. in one spatial
        * dimension, the neighbors of cell 0 are stored in
-       * <tt>neighbors[0]</tt> and <tt>neighbors[1]</tt>, the neighbors of
-       * cell 1 are stored in <tt>neighbors[2]</tt> and <tt>neighbors[3]</tt>,
-       * and so on.
+       * <tt>neighbor_indices[0]</tt> and <tt>neighbor_indices[1]</tt>, the
+       * neighbors of cell 1 are stored in <tt>neighbor_indices[2]</tt> and
+       * <tt>neighbor_indices[3]</tt>, and so on. The levels of the neighbors
+       * are stored in the same order in neighbor_levels. We use two separate
+       * arrays rather than one array of pairs of integers since the level
+       * fits into two bytes, which saves a quarter of the memory.
        *
-       * In neighbors, <tt>neighbors[i].first</tt> is the level, while
-       * <tt>neighbors[i].first</tt> is the index of the neighbor.
-       *
-       * If a neighbor does not exist (cell is at the boundary),
-       * <tt>level=index=-1</tt> is set.
+       * If a neighbor does not exist (cell is at the boundary), the index is
+       * set to numbers::invalid_unsigned_int and the level to
+       * invalid_neighbor_level.
        *
        * <em>Conventions:</em> The @p ith neighbor of a cell is the one which
        * shares the @p ith face (@p Line in 2D, @p Quad in 3D) of this cell.
@@ -111,7 +112,21 @@ namespace internal
        * level down (in which case its neighbor pointer points to the mother
        * cell of this cell).
        */
-      std::vector<std::pair<int,int> > neighbors;
+      std::vector<unsigned int> neighbor_indices;
+
+      /**
+       * Levels of the neighbors of the cells, see neighbor_indices.
+       */
+      std::vector<unsigned short int> neighbor_levels;
+
+      /**
+       * The value stored in neighbor_levels for neighbors that do not exist.
+       * This also means that neighbors can only be stored for levels less
+       * than this value. Since every refinement halves the size of a cell,
+       * vertex coordinates in double precision can not resolve cells on
+       * nearly as many levels anyway.
+       */
+      static const unsigned short int invalid_neighbor_level = static_cast<unsigned short int>(-1);
 
       /**
        * One integer per cell to store which subdomain it belongs to. This
@@ -151,6 +166,19 @@ namespace internal
        */
       TriaObjects<TriaObject<dim> > cells;
 
+      /**
+       * If the triangulation caches the vertex indices of its cells (see
+       * Triangulation::set_cell_vertex_index_caching()), the indices of the
+       * vertices of the cell with index @p i are stored in the fields
+       * starting at <tt>i*GeometryInfo<dim>::vertices_per_cell</tt>.
+       * Otherwise, and while the triangulation is being refined or
+       * coarsened, this array is empty.
+       *
+       * This field is not serialized since it is rebuilt by the
+       * triangulation whenever it is changed or loaded.
+       */
+      std::vector<unsigned int> cell_vertex_indices_cache;
+
 
       /**
        * Reserve enough space to accommodate @p total_cells cells on this
@@ -219,7 +247,9 @@ namespace internal
       std::vector<unsigned char> refine_flags;
       std::vector<bool> coarsen_flags;
       std::vector<unsigned int> active_cell_indices;
-      std::vector<std::pair<int,int> > neighbors;
+      std::vector<unsigned int> neighbor_indices;
+      std::vector<unsigned short int> neighbor_levels;
+      static const unsigned short int invalid_neighbor_level = static_cast<unsigned short int>(-1);
       std::vector<types::subdomain_id> subdomain_ids;
       std::vector<types::subdomain_id> level_subdomain_ids;
       std::vector<int> parents;
@@ -233,6 +263,7 @@ namespace internal
       std::vector<bool> direction_flags;
 
       TriaObjectsHex cells;
+      std::vector<unsigned int> cell_vertex_indices_cache;
 
 
       void reserve_space (const unsigned int total_cells,
@@ -279,7 +310,7 @@ namespace internal
       // to the stream and re-reading them again later, we just rebuild them
       // in Triangulation::load()
 
-      ar &neighbors;
+      ar &neighbor_indices &neighbor_levels;
       ar &subdomain_ids;
       ar &level_subdomain_ids;
       ar &parents;
@@ -299,7 +330,7 @@ namespace internal
       // to the stream and re-reading them again later, we just rebuild them
       // in Triangulation::load()
 
-      ar &neighbors;
+      ar &neighbor_indices &neighbor_levels;
       ar &subdomain_ids;
       ar &level_subdomain_ids;
       ar &parents;
@@ -271,7 +271,8 @@ namespace internal
 
       /**
        * Clear all user pointers or indices and reset their type, such that
-       * the next access may be either or.
+       * the next access may be either or. This also releases the memory
+       * used for the user data, see user_data.
        */
       void clear_user_data();
 
@@ -399,9 +400,20 @@ namespace internal
       /**
        * Pointer which is not used by the library but may be accessed and set
        * by the user to handle data local to a line/quad/etc.
+       *
+       * Since most programs never use user data, this array is only
+       * allocated upon the first write access through user_pointer() or
+       * user_index(). Until then, it is empty and all user pointers and
+       * indices are considered to be zero. Otherwise, it has the same size as
+       * @p cells.
        */
       std::vector<UserData> user_data;
 
+      /**
+       * Allocate the user_data array if this has not happened yet.
+       */
+      void allocate_user_data ();
+
       /**
        * In order to avoid confusion between user pointers and indices, this
        * enum is set by the first function accessing either and subsequent
@@ -620,6 +632,7 @@ namespace internal
              ExcPointerIndexClash());
       user_data_type = data_pointer;
 
+      allocate_user_data ();
       Assert(i<user_data.size(), ExcIndexRange(i,0,user_data.size()));
       return user_data[i].p;
     }
@@ -634,6 +647,8 @@ namespace internal
              ExcPointerIndexClash());
       user_data_type = data_pointer;
 
+      if (user_data.size() == 0)
+        return 0;
       Assert(i<user_data.size(), ExcIndexRange(i,0,user_data.size()));
       return user_data[i].p;
     }
@@ -648,6 +663,7 @@ namespace internal
              ExcPointerIndexClash());
       user_data_type = data_index;
 
+      allocate_user_data ();
       Assert(i<user_data.size(), ExcIndexRange(i,0,user_data.size()));
       return user_data[i].i;
     }
@@ -658,11 +674,26 @@ namespace internal
     void
     TriaObjects<G>::clear_user_data (const unsigned int i)
     {
+      if (user_data.size() == 0)
+        return;
       Assert(i<user_data.size(), ExcIndexRange(i,0,user_data.size()));
       user_data[i].i = 0;
     }
 
 
+    template<typename G>
+    inline
+    void
+    TriaObjects<G>::allocate_user_data ()
+    {
+      if (user_data.size() != cells.size())
+        {
+          Assert (user_data.size() == 0, ExcInternalError());
+          user_data.resize (cells.size());
+        }
+    }
+
+
     template <typename G>
     inline
     TriaObjects<G>::TriaObjects()
@@ -680,6 +711,8 @@ namespace internal
              ExcPointerIndexClash());
       user_data_type = data_index;
 
+      if (user_data.size() == 0)
+        return 0;
       Assert(i<user_data.size(), ExcIndexRange(i,0,user_data.size()));
       return user_data[i].i;
     }
@@ -690,8 +723,9 @@ namespace internal
     void TriaObjects<G>::clear_user_data ()
     {
       user_data_type = data_unknown;
-      for (unsigned int i=0; i<user_data.size(); ++i)
-        user_data[i].p = 0;
+      // release the memory. it is allocated again upon the next write
+      // access
+      std::vector<UserData>().swap (user_data);
     }
 
 
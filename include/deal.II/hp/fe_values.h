@@ -109,6 +109,40 @@ namespace internal
        */
       const FEValuesType &get_present_fe_values () const;
 
+      /**
+       * Create the FEValues objects for the given combinations of finite
+       * element, mapping, and quadrature indices right away, rather than
+       * lazily the first time they are needed in a call to reinit(). The
+       * @p i th object is created for the combination <tt>(fe_indices[i],
+       * mapping_indices[i], q_indices[i])</tt>; all three arrays therefore
+       * need to have the same length. Objects that already exist are not
+       * touched.
+       *
+       * Setting up an FEValues object requires the finite element and the
+       * mapping to evaluate their shape functions on the reference cell,
+       * which can be expensive for collections with many and high-order
+       * elements. This function creates all requested objects concurrently
+       * on the available threads. It is therefore useful to call it right
+       * after constructing an hp::FEValues object that will be used for many
+       * different active_fe_index values, for example in the scratch data of
+       * WorkStream::run().
+       */
+      void
+      precalculate_fe_values (const std::vector<unsigned int> &fe_indices,
+                              const std::vector<unsigned int> &mapping_indices,
+                              const std::vector<unsigned int> &q_indices);
+
+      /**
+       * Same as above, but create the objects for all finite elements of the
+       * collection. For the @p i th element, the mapping and the quadrature
+       * formula are chosen in the same way as in the <tt>reinit()</tt>
+       * functions of derived classes when no explicit indices are given:
+       * the @p i th object of the respective collection is used if the
+       * collection has more than one element, and the only element otherwise.
+       */
+      void
+      precalculate_fe_values ();
+
     protected:
 
       /**
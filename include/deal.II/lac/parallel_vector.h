@@ -23,6 +23,7 @@
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/partitioner.h>
+#include <deal.II/base/performance_trace.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/lac/vector_view.h>
 
@@ -1400,6 +1401,7 @@ namespace parallel
     void
     Vector<Number>::compress (::dealii::VectorOperation::values operation)
     {
+      PerformanceTrace::Scope trace_scope ("parallel::distributed::Vector::compress");
       compress_start (0, operation);
       compress_finish(operation);
     }
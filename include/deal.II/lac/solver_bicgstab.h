@@ -442,20 +442,13 @@ SolverBicgstab<VectorType>::solve(const MatrixType         &A,
                                   const PreconditionerType &precondition)
 {
   deallog.push("Bicgstab");
-  Vr    = this->memory.alloc();
-  Vr->reinit(x, true);
-  Vrbar = this->memory.alloc();
-  Vrbar->reinit(x, true);
-  Vp    = this->memory.alloc();
-  Vp->reinit(x, true);
-  Vy    = this->memory.alloc();
-  Vy->reinit(x, true);
-  Vz    = this->memory.alloc();
-  Vz->reinit(x, true);
-  Vt    = this->memory.alloc();
-  Vt->reinit(x, true);
-  Vv    = this->memory.alloc();
-  Vv->reinit(x, true);
+  Vr    = this->memory.alloc(x);
+  Vrbar = this->memory.alloc(x);
+  Vp    = this->memory.alloc(x);
+  Vy    = this->memory.alloc(x);
+  Vz    = this->memory.alloc(x);
+  Vt    = this->memory.alloc(x);
+  Vv    = this->memory.alloc(x);
 
   Vx = &x;
   Vb = &b;
@@ -462,10 +462,12 @@ SolverCG<VectorType>::solve (const MatrixType         &A,
 
   deallog.push("cg");
 
-  // Memory allocation
-  Vr = this->memory.alloc();
-  Vz = this->memory.alloc();
-  Vp = this->memory.alloc();
+  // Memory allocation. The vectors get the
+  // size of x, but their values are not set
+  // since they'd be overwritten soon anyway.
+  Vr = this->memory.alloc(x);
+  Vz = this->memory.alloc(x);
+  Vp = this->memory.alloc(x);
   // Should we build the matrix for
   // eigenvalue computations?
   const bool do_eigenvalues = !condition_number_signal.empty()
@@ -491,12 +493,6 @@ SolverCG<VectorType>::solve (const MatrixType         &A,
       VectorType &g = *Vr;
       VectorType &d = *Vz;
       VectorType &h = *Vp;
-      // resize the vectors, but do not set
-      // the values since they'd be overwritten
-      // soon anyway.
-      g.reinit(x, true);
-      d.reinit(x, true);
-      h.reinit(x, true);
 
       double gh,alpha,beta;
 
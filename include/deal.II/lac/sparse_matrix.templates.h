@@ -21,6 +21,7 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/template_constraints.h>
 #include <deal.II/base/parallel.h>
+#include <deal.II/base/performance_trace.h>
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/lac/sparse_matrix.h>
@@ -760,6 +761,8 @@ SparseMatrix<number>::vmult (OutVector &dst,
 
   Assert (!PointerComparison::equal(&src, &dst), ExcSourceEqualsDestination());
 
+  PerformanceTrace::Scope trace_scope ("SparseMatrix::vmult");
+
   parallel::apply_to_subranges (0U, m(),
                                 std_cxx11::bind (&internal::SparseMatrix::vmult_on_subrange
                                                  <number,InVector,OutVector>,
@@ -86,6 +86,18 @@ public:
    */
   virtual VectorType *alloc () = 0;
 
+  /**
+   * Return a pointer to a new vector that has the same size and parallel
+   * layout as @p model. The contents of the vector are unspecified.
+   *
+   * The default implementation calls alloc() and then
+   * <tt>reinit(model, true)</tt> on the result. Derived classes that keep
+   * vectors around for reuse may override this function to prefer a vector
+   * that already has the right layout, thus avoiding the allocation of new
+   * memory inside <tt>reinit()</tt>.
+   */
+  virtual VectorType *alloc (const VectorType &model);
+
   /**
    * Return a vector and indicate that it is not going to be used any further
    * by the instance that called alloc() to get a pointer to it.
@@ -122,6 +134,14 @@ public:
      * Constructor, automatically allocating a vector from @p mem.
      */
     Pointer(VectorMemory<VectorType> &mem);
+
+    /**
+     * Constructor, automatically allocating a vector from @p mem that has the
+     * same layout as @p model. See VectorMemory::alloc(const VectorType &).
+     */
+    Pointer(VectorMemory<VectorType> &mem,
+            const VectorType         &model);
+
     /**
      * Destructor, automatically releasing the vector from the memory #pool.
      */
@@ -171,6 +191,11 @@ public:
    */
   PrimitiveVectorMemory () {}
 
+  /**
+   * Make the overload of alloc() taking a model vector visible.
+   */
+  using VectorMemory<VectorType>::alloc;
+
   /**
    * Return a pointer to a new vector. The number of elements or their
    * subdivision into blocks (if applicable) is unspecified and users of this
@@ -223,6 +248,19 @@ public:
  * Nevertheless, the since they are reused, this should be of no concern.
  * Additionally, the destructor of the Pool warns about memory leaks.
  *
+ * <h3>Reuse of vectors with matching layout</h3>
+ *
+ * Vectors returned to the pool keep their size. If a vector is requested
+ * through alloc(const VectorType &), the pool prefers a free vector whose
+ * size (and, for parallel::distributed::Vector, whose partitioner) matches
+ * the one of the model vector. This way, programs that use vectors of many
+ * different sizes at the same time, such as multigrid methods with a solver
+ * on each level, do not repeatedly grow and shrink the same vectors. The
+ * effectiveness of this strategy can be queried through get_statistics().
+ *
+ * All access to the pool is protected by a mutex, so objects of this class
+ * may be used concurrently from several threads.
+ *
  * @author Guido Kanschat, 1999, 2007
  */
 template<typename VectorType = dealii::Vector<double> >
@@ -258,6 +296,17 @@ public:
    */
   virtual VectorType *alloc ();
 
+  /**
+   * Return a pointer to a new vector with the same layout as @p model. The
+   * contents of the vector are unspecified.
+   *
+   * For the present class, this function first looks for an unused vector in
+   * the pool whose layout already matches the one of @p model. Only if no
+   * such vector exists, an arbitrary unused vector (or a newly created one)
+   * is reinitialized.
+   */
+  virtual VectorType *alloc (const VectorType &model);
+
   /**
    * Return a vector and indicate that it is not going to be used any further
    * by the instance that called alloc() to get a pointer to it.
@@ -277,6 +326,50 @@ public:
    */
   virtual std::size_t memory_consumption() const;
 
+  /**
+   * A structure collecting information about the usage of the pool shared by
+   * all GrowingVectorMemory objects of the current vector type.
+   */
+  struct Statistics
+  {
+    /**
+     * Number of calls to any of the alloc() functions.
+     */
+    size_type n_allocations;
+
+    /**
+     * Number of calls to alloc(const VectorType &) that could be served by a
+     * vector of matching layout.
+     */
+    size_type n_matched_allocations;
+
+    /**
+     * Number of vectors that had to be created because no unused vector was
+     * available in the pool.
+     */
+    size_type n_created_vectors;
+
+    /**
+     * Number of vectors currently stored in the pool.
+     */
+    size_type n_vectors;
+
+    /**
+     * Number of vectors of the pool that are currently in use.
+     */
+    size_type n_vectors_in_use;
+
+    /**
+     * Memory consumed by all vectors of the pool, in bytes.
+     */
+    std::size_t memory_consumption;
+  };
+
+  /**
+   * Return statistics about the pool shared by all objects of this class.
+   */
+  static Statistics get_statistics ();
+
 private:
   /**
    * Type to enter into the array. First component will be a flag telling
@@ -311,6 +404,13 @@ private:
      * Pointer to the storage object
      */
     std::vector<entry_type> *data;
+
+    /**
+     * Counters reported by get_statistics().
+     */
+    size_type n_allocations;
+    size_type n_matched_allocations;
+    size_type n_created_vectors;
   };
 
   /**
@@ -347,6 +447,18 @@ private:
 /* --------------------- inline functions ---------------------- */
 
 
+template <typename VectorType>
+inline
+VectorType *
+VectorMemory<VectorType>::alloc (const VectorType &model)
+{
+  VectorType *v = alloc();
+  v->reinit(model, true);
+  return v;
+}
+
+
+
 template <typename VectorType>
 inline
 VectorMemory<VectorType>::Pointer::Pointer(VectorMemory<VectorType> &mem)
@@ -357,6 +469,17 @@ VectorMemory<VectorType>::Pointer::Pointer(VectorMemory<VectorType> &mem)
 }
 
 
+template <typename VectorType>
+inline
+VectorMemory<VectorType>::Pointer::Pointer(VectorMemory<VectorType> &mem,
+                                           const VectorType         &model)
+  :
+  pool(&mem, typeid(*this).name()), v(0)
+{
+  v = pool->alloc(model);
+}
+
+
 template <typename VectorType>
 inline
 VectorMemory<VectorType>::Pointer::~Pointer()
@@ -21,6 +21,48 @@
 
 DEAL_II_NAMESPACE_OPEN
 
+namespace parallel
+{
+  namespace distributed
+  {
+    template <typename Number> class Vector;
+  }
+}
+
+
+namespace internal
+{
+  namespace GrowingVectorMemory
+  {
+    /**
+     * Return whether the vector @p v already has the layout of @p model,
+     * i.e., whether <tt>v.reinit(model,true)</tt> can be done without
+     * touching the memory allocation. For general vectors, we can only
+     * compare sizes.
+     */
+    template <typename VectorType>
+    inline
+    bool same_layout (const VectorType &v,
+                      const VectorType &model)
+    {
+      return v.size() == model.size();
+    }
+
+    /**
+     * Same as above, but for parallel vectors for which we require the
+     * partitioner to be the same object.
+     */
+    template <typename Number>
+    inline
+    bool same_layout (const parallel::distributed::Vector<Number> &v,
+                      const parallel::distributed::Vector<Number> &model)
+    {
+      return v.get_partitioner().get() == model.get_partitioner().get();
+    }
+  }
+}
+
+
 
 template <typename VectorType>
 typename GrowingVectorMemory<VectorType>::Pool GrowingVectorMemory<VectorType>::pool;
@@ -32,7 +74,10 @@ template <typename VectorType>
 inline
 GrowingVectorMemory<VectorType>::Pool::Pool()
   :
-  data(0)
+  data(0),
+  n_allocations(0),
+  n_matched_allocations(0),
+  n_created_vectors(0)
 {}
 
 
@@ -74,6 +119,7 @@ GrowingVectorMemory<VectorType>::Pool::initialize(const size_type size)
           i->first = false;
           i->second = new VectorType;
         }
+      n_created_vectors += size;
     }
 }
 
@@ -118,6 +164,7 @@ GrowingVectorMemory<VectorType>::alloc ()
   Threads::Mutex::ScopedLock lock(mutex);
   ++total_alloc;
   ++current_alloc;
+  ++pool.n_allocations;
   // see if there is a free vector
   // available in our list
   for (typename std::vector<entry_type>::iterator i=pool.data->begin();
@@ -134,12 +181,68 @@ GrowingVectorMemory<VectorType>::alloc ()
   // just allocate a new one
   const entry_type t (true, new VectorType);
   pool.data->push_back(t);
+  ++pool.n_created_vectors;
 
   return t.second;
 }
 
 
 
+template<typename VectorType>
+inline
+VectorType *
+GrowingVectorMemory<VectorType>::alloc (const VectorType &model)
+{
+  VectorType *v = 0;
+  {
+    Threads::Mutex::ScopedLock lock(mutex);
+    ++total_alloc;
+    ++current_alloc;
+    ++pool.n_allocations;
+
+    // look for a free vector that already has the right layout. remember
+    // the first free vector as a fallback in case there is none
+    typename std::vector<entry_type>::iterator fallback = pool.data->end();
+    for (typename std::vector<entry_type>::iterator i=pool.data->begin();
+         i != pool.data->end(); ++i)
+      if (i->first == false)
+        {
+          if (internal::GrowingVectorMemory::same_layout(*i->second, model))
+            {
+              i->first = true;
+              ++pool.n_matched_allocations;
+              v = i->second;
+              break;
+            }
+          else if (fallback == pool.data->end())
+            fallback = i;
+        }
+
+    if (v == 0)
+      {
+        if (fallback != pool.data->end())
+          {
+            fallback->first = true;
+            v = fallback->second;
+          }
+        else
+          {
+            const entry_type t (true, new VectorType);
+            pool.data->push_back(t);
+            ++pool.n_created_vectors;
+            v = t.second;
+          }
+      }
+  }
+
+  // the vector is now marked as used, so we can set its size outside the
+  // lock. if the layout already matches, this does not allocate memory
+  v->reinit(model, true);
+  return v;
+}
+
+
+
 template<typename VectorType>
 inline
 void
@@ -205,6 +308,40 @@ GrowingVectorMemory<VectorType>::memory_consumption () const
 }
 
 
+
+template<typename VectorType>
+inline
+typename GrowingVectorMemory<VectorType>::Statistics
+GrowingVectorMemory<VectorType>::get_statistics ()
+{
+  Threads::Mutex::ScopedLock lock(mutex);
+
+  Statistics stats;
+  stats.n_allocations         = pool.n_allocations;
+  stats.n_matched_allocations = pool.n_matched_allocations;
+  stats.n_created_vectors     = pool.n_created_vectors;
+  stats.n_vectors             = 0;
+  stats.n_vectors_in_use      = 0;
+  stats.memory_consumption    = 0;
+
+  if (pool.data != 0)
+    {
+      const typename std::vector<entry_type>::const_iterator
+      end = pool.data->end();
+      for (typename std::vector<entry_type>::const_iterator
+           i = pool.data->begin(); i != end ; ++i)
+        {
+          ++stats.n_vectors;
+          if (i->first == true)
+            ++stats.n_vectors_in_use;
+          stats.memory_consumption += i->second->memory_consumption();
+        }
+    }
+
+  return stats;
+}
+
+
 DEAL_II_NAMESPACE_CLOSE
 
 #endif
@@ -19,6 +19,7 @@
 
 #include <deal.II/base/exceptions.h>
 #include <deal.II/base/parallel.h>
+#include <deal.II/base/performance_trace.h>
 #include <deal.II/base/quadrature.h>
 #include <deal.II/base/vectorization.h>
 #include <deal.II/base/template_constraints.h>
@@ -2211,6 +2212,8 @@ MatrixFree<dim, Number>::cell_loop
  OutVector       &dst,
  const InVector  &src) const
 {
+  PerformanceTrace::Scope trace_scope ("MatrixFree::cell_loop");
+
   // in any case, need to start the ghost import at the beginning
   bool ghosts_were_not_set = internal::update_ghost_values_start (src);
 
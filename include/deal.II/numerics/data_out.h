@@ -20,6 +20,7 @@
 
 #include <deal.II/base/config.h>
 #include <deal.II/numerics/data_out_dof_data.h>
+#include <deal.II/lac/full_matrix.h>
 
 #include <deal.II/base/std_cxx11/shared_ptr.h>
 
@@ -247,6 +248,103 @@ public:
                               const unsigned int n_subdivisions = 0,
                               const CurvedCellRegion curved_region = curved_boundary);
 
+  /**
+   * Re-evaluate the data vectors on the patches created by the last call to
+   * build_patches(), but keep the geometry and connectivity of these patches.
+   * This is useful when writing output for many time steps on the same mesh,
+   * where only the values of the vectors change from one output to the next:
+   * rather than re-initializing FEValues objects and re-creating all patches
+   * on every cell, this function only computes the values of the data vectors
+   * at the (cached) evaluation points of each patch.
+   *
+   * To this end, the values of the shape functions of each finite element at
+   * the evaluation points are computed once and stored as an interpolation
+   * matrix that maps the values at the degrees of freedom of a cell to the
+   * values at the points of its patch. The evaluation on the individual cells
+   * then only consists of a matrix-vector product, and is done in parallel.
+   *
+   * The data vectors are looked up anew, so the vectors attached to this
+   * object may have changed their values (but not their sizes) since the
+   * last call to build_patches(). In particular, this function can be used
+   * as follows:
+   * @code
+   *   DataOut<dim> data_out;
+   *   data_out.attach_dof_handler (dof_handler);
+   *   data_out.add_data_vector (solution, "solution");
+   *   data_out.build_patches (2);
+   *
+   *   for (unsigned int timestep=0; ...; ++timestep)
+   *     {
+   *       ... compute new solution ...
+   *
+   *       data_out.update_patch_data ();
+   *       data_out.write_vtu (...);
+   *     }
+   * @endcode
+   *
+   * Since the evaluation does not involve a mapping, this function can only
+   * be used if all finite elements are primitive, i.e., if their shape
+   * functions on the real cell are the same as the ones on the reference
+   * cell, no DataPostprocessor objects are attached, and the last call to
+   * build_patches() did not request curved cells. Furthermore, the mesh must
+   * not have changed since this last call, and the data vectors must be the
+   * same (in number and in the DoFHandler objects they refer to) as at the
+   * time of the call.
+   */
+  void update_patch_data ();
+
+  /**
+   * Build patches that represent the data on a coarser mesh than the active
+   * cells, for example to produce quick-look output of very large
+   * computations. Rather than one patch per active cell, this function
+   * creates one patch for each cell on the given refinement @p level, and
+   * one patch for each active cell that is coarser than this level. The
+   * number of patches, and consequently the size of output files and the
+   * time it takes to write them, is therefore bounded by the number of cells
+   * on this level, independent of the refinement of the mesh beyond it.
+   *
+   * On cells that are not active, the values of the data vectors are
+   * interpolated from the children in the same way as
+   * DoFCellAccessor::get_interpolated_dof_values() does, i.e., using the
+   * restriction matrices of the finite element, whereas cell data is
+   * averaged over the active descendants, weighted by their measure.
+   *
+   * For parallel::distributed::Triangulation objects, every processor
+   * creates patches only for those cells of which it owns all active
+   * descendants. Where a cell on the given level is split between several
+   * processors, each of them instead creates patches for the coarsest cells
+   * below it of which it owns all active descendants. Consequently, the
+   * union of the patches of all processors covers the domain without
+   * overlap, and no communication is necessary to create them. They can be
+   * written with DataOutInterface::write_vtu_in_parallel(), for example.
+   *
+   * The patches are created with the geometry of the cells, i.e., as with
+   * build_patches() without a mapping argument. Since the data is evaluated
+   * in the same way as update_patch_data() does it, the same restrictions
+   * apply: all finite elements must be primitive and no DataPostprocessor
+   * objects may be attached. For hp::DoFHandler objects, the data on cells
+   * that are not active is interpolated into the first element of the
+   * collection. After calling this function, update_patch_data() can be
+   * used to update the data on the patches created by it.
+   *
+   * @param level The refinement level on which to create patches.
+   * @param n_subdivisions The number of subdivisions of each patch, with the
+   * same meaning as for build_patches().
+   */
+  void build_coarsened_patches (const unsigned int level,
+                                const unsigned int n_subdivisions = 0);
+
+  /**
+   * Same as above, except that patches are only created for cells whose
+   * bounding box intersects the box with the given lower and upper corners.
+   * Output on a slice through the domain can be created by choosing the same
+   * coordinate for both corners in one direction.
+   */
+  void build_coarsened_patches (const unsigned int level,
+                                const Point<DoFHandlerType::space_dimension> &lower_corner,
+                                const Point<DoFHandlerType::space_dimension> &upper_corner,
+                                const unsigned int n_subdivisions = 0);
+
   /**
    * Return the first cell which we want output for. The default
    * implementation returns the first active cell, but you might want to
@@ -298,6 +396,35 @@ private:
    const unsigned int                                            n_subdivisions,
    const CurvedCellRegion                                        curved_cell_region,
    std::vector<DataOutBase::Patch<DoFHandlerType::dimension, DoFHandlerType::space_dimension> > &patches);
+
+  /**
+   * Re-evaluate the data vectors on the patches with numbers in the half
+   * open range <tt>[begin,end)</tt>. This function is called in parallel by
+   * update_patch_data().
+   */
+  void update_patch_data_on_range (const unsigned int begin,
+                                   const unsigned int end);
+
+  /**
+   * The cells from which the patches were created by the last call to
+   * build_patches() or build_coarsened_patches(), along with their active
+   * index, i.e., patch_cells[i] describes the cell of the patch with number
+   * <tt>i</tt>. For cells that are not active, the index is
+   * numbers::invalid_unsigned_int.
+   */
+  std::vector<std::pair<cell_iterator, unsigned int> > patch_cells;
+
+  /**
+   * For each data vector and each element of the finite element collection
+   * it refers to, the matrix that maps the values at the degrees of freedom
+   * of a cell to the values at the evaluation points of its patch. The row
+   * with index <tt>component*n_points+q</tt> corresponds to the given
+   * vector component at evaluation point <tt>q</tt>.
+   *
+   * These matrices are computed upon the first call to update_patch_data()
+   * after build_patches().
+   */
+  std::vector<std::vector<FullMatrix<double> > > interpolation_matrices;
 };
 
 
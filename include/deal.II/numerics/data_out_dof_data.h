@@ -195,6 +195,16 @@ namespace internal
       double
       get_cell_data_value (const unsigned int cell_number) const = 0;
 
+      /**
+       * Assuming that the stored vector is a vector of nodal values, extract
+       * the elements with the given global indices, for example the values
+       * at the degrees of freedom of one cell.
+       */
+      virtual
+      void
+      get_dof_values (const std::vector<types::global_dof_index> &dof_indices,
+                      dealii::Vector<double>                     &dof_values) const = 0;
+
       /**
        * Given a FEValuesBase object, extract the values on the present cell
        * from the vector we actually store.
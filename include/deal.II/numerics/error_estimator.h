@@ -109,6 +109,12 @@ namespace hp
  * contributions of the faces (which are the integrated square of the jumps
  * times some factor) of each cell and take the square root.
  *
+ * Both loops run in parallel. Every face is integrated by exactly one of its
+ * adjacent cells, and the results are stored in an array indexed by the
+ * index of the face in the triangulation. Consequently, the threads that
+ * work on different cells write into different elements of this array and
+ * need not synchronize with each other.
+ *
  * The integration is done using a quadrature formula on the face. For linear
  * trial functions (FEQ1), the QGauss2 or even the QMidpoint rule will
  * suffice. For higher order elements, it is necessary to utilize higher order
@@ -218,7 +224,7 @@ namespace hp
  * Since we integrate from the coarse side of the face, we have the mother
  * face readily at hand and store the result of the integration over that
  * mother face (being the sum of the integrals along the subfaces) in the
- * abovementioned map of integrals as well. This consumes some memory more
+ * abovementioned array of integrals as well. This consumes some memory more
  * than needed, but makes the summing up of the face contributions to the
  * cells easier, since then we have the information from all faces of all
  * cells at hand and need not think about explicitly determining whether a
@@ -308,37 +308,58 @@ namespace internal
 
 
     /**
-     * Copy data from the local_face_integrals map of a single ParallelData
-     * object into a global such map. This is the copier stage of a WorkStream
-     * pipeline.
+     * The integrals of the jumps over the faces, for all solution vectors.
+     * The integrals for one face are stored contiguously and are found via
+     * the index of the face in the triangulation, which is dense, rather
+     * than in a map keyed by face iterators. Since every face is integrated
+     * from exactly one of the cells adjacent to it, the threads working on
+     * different cells write into different elements of this array and need
+     * neither a lock nor a copier stage to collect their results.
+     *
+     * Elements that have not been written to have the value -1, which allows
+     * to check that every face of every cell we care for has been treated.
      */
-    template <typename DoFHandlerType>
-    void
-    copy_local_to_global
-    (const std::map<typename DoFHandlerType::face_iterator,std::vector<double> > &local_face_integrals,
-     std::map<typename DoFHandlerType::face_iterator,std::vector<double> > &face_integrals)
+    class FaceIntegrals
     {
+    public:
+      /**
+       * Constructor. @p n_faces is the total number of faces of the
+       * triangulation, used or not.
+       */
+      FaceIntegrals (const unsigned int n_faces,
+                     const unsigned int n_solution_vectors)
+        :
+        n_solution_vectors (n_solution_vectors),
+        integrals (static_cast<std::size_t>(n_faces) * n_solution_vectors, -1.)
+      {}
 
-      // now copy locally computed elements into the global map
-      for (typename std::map<typename DoFHandlerType::face_iterator,std::vector<double> >::const_iterator
-           p=local_face_integrals.begin();
-           p!=local_face_integrals.end();
-           ++p)
-        {
-          // double check that the element does not already exists in the
-          // global map
-          Assert (face_integrals.find (p->first) == face_integrals.end(),
-                  ExcInternalError());
+      /**
+       * Return a pointer to the integrals of the solution vectors over the
+       * given face.
+       */
+      template <typename FaceIterator>
+      double *operator [] (const FaceIterator &face)
+      {
+        Assert (static_cast<std::size_t>(face->index()) * n_solution_vectors < integrals.size(),
+                ExcIndexRange (face->index(), 0, integrals.size() / n_solution_vectors));
+        return &integrals[static_cast<std::size_t>(face->index()) * n_solution_vectors];
+      }
 
-          for (unsigned int i=0; i<p->second.size(); ++i)
-            {
-              Assert (numbers::is_finite(p->second[i]), ExcInternalError());
-              Assert (p->second[i] >= 0, ExcInternalError());
-            }
+      /**
+       * Same as above, but for read access.
+       */
+      template <typename FaceIterator>
+      const double *operator [] (const FaceIterator &face) const
+      {
+        Assert (static_cast<std::size_t>(face->index()) * n_solution_vectors < integrals.size(),
+                ExcIndexRange (face->index(), 0, integrals.size() / n_solution_vectors));
+        return &integrals[static_cast<std::size_t>(face->index()) * n_solution_vectors];
+      }
 
-          face_integrals[p->first] = p->second;
-        }
-    }
+    private:
+      const unsigned int  n_solution_vectors;
+      std::vector<double> integrals;
+    };
 
 
     /**
@@ -346,11 +367,12 @@ namespace internal
      * ParallelData.
      */
     template <typename DoFHandlerType, typename number>
-    std::vector<double>
+    void
     integrate_over_face
     (ParallelData<DoFHandlerType,number>                 &parallel_data,
      const typename DoFHandlerType::face_iterator        &face,
-     dealii::hp::FEFaceValues<DoFHandlerType::dimension, DoFHandlerType::space_dimension> &fe_face_values_cell)
+     dealii::hp::FEFaceValues<DoFHandlerType::dimension, DoFHandlerType::space_dimension> &fe_face_values_cell,
+     double                                              *face_integral)
     {
       const unsigned int n_q_points         = parallel_data.psi[0].size(),
                          n_components       = parallel_data.finite_element.n_components(),
@@ -472,15 +494,15 @@ namespace internal
         = fe_face_values_cell.get_present_fe_values().get_JxW_values();
 
       // take the square of the phi[i] for integration, and sum up
-      std::vector<double> face_integral (n_solution_vectors, 0);
       for (unsigned int n=0; n<n_solution_vectors; ++n)
-        for (unsigned int component=0; component<n_components; ++component)
-          if (parallel_data.component_mask[component] == true)
-            for (unsigned int p=0; p<n_q_points; ++p)
-              face_integral[n] += numbers::NumberTraits<number>::abs_square(parallel_data.phi[n][p][component]) *
-                                  parallel_data.JxW_values[p];
-
-      return face_integral;
+        {
+          face_integral[n] = 0;
+          for (unsigned int component=0; component<n_components; ++component)
+            if (parallel_data.component_mask[component] == true)
+              for (unsigned int p=0; p<n_q_points; ++p)
+                face_integral[n] += numbers::NumberTraits<number>::abs_square(parallel_data.phi[n][p][component]) *
+                                    parallel_data.JxW_values[p];
+        }
     }
 
     /**
@@ -631,7 +653,7 @@ namespace internal
     void
     integrate_over_regular_face (const std::vector<const InputVector *>   &solutions,
                                  ParallelData<DoFHandlerType, typename InputVector::value_type> &parallel_data,
-                                 std::map<typename DoFHandlerType::face_iterator,std::vector<double> > &local_face_integrals,
+                                 FaceIntegrals                           &face_integrals,
                                  const typename DoFHandlerType::active_cell_iterator &cell,
                                  const unsigned int                       face_no,
                                  dealii::hp::FEFaceValues<DoFHandlerType::dimension, DoFHandlerType::space_dimension> &fe_face_values_cell,
@@ -703,12 +725,12 @@ namespace internal
         }
 
       // now go to the generic function that does all the other things
-      local_face_integrals[face] =
-        integrate_over_face (parallel_data, face,
-                             fe_face_values_cell);
+      double *const face_integral = face_integrals[face];
+      integrate_over_face (parallel_data, face,
+                           fe_face_values_cell, face_integral);
 
-      for (unsigned int i = 0; i < local_face_integrals[face].size(); i++)
-        local_face_integrals[face][i] *= factor;
+      for (unsigned int n=0; n<n_solution_vectors; ++n)
+        face_integral[n] *= factor;
     }
 
 
@@ -723,7 +745,7 @@ namespace internal
     void
     integrate_over_irregular_face (const std::vector<const InputVector *>   &solutions,
                                    ParallelData<DoFHandlerType, typename InputVector::value_type> &parallel_data,
-                                   std::map<typename DoFHandlerType::face_iterator,std::vector<double> > &local_face_integrals,
+                                   FaceIntegrals                           &face_integrals,
                                    const typename DoFHandlerType::active_cell_iterator    &cell,
                                    const unsigned int                          face_no,
                                    dealii::hp::FEFaceValues<DoFHandlerType::dimension,DoFHandlerType::space_dimension>    &fe_face_values,
@@ -796,33 +818,36 @@ namespace internal
           parallel_data.neighbor_normal_vectors =
             fe_subface_values.get_present_fe_values().get_all_normal_vectors();
 
-          local_face_integrals[neighbor_child->face(neighbor_neighbor)] =
-            integrate_over_face (parallel_data, face, fe_face_values);
-          for (unsigned int i = 0; i < local_face_integrals[neighbor_child->face(neighbor_neighbor)].size(); i++)
-            local_face_integrals[neighbor_child->face(neighbor_neighbor)][i] *= factor;
+          double *const subface_integral
+            = face_integrals[neighbor_child->face(neighbor_neighbor)];
+          integrate_over_face (parallel_data, face, fe_face_values,
+                               subface_integral);
+          for (unsigned int n=0; n<n_solution_vectors; ++n)
+            subface_integral[n] *= factor;
         }
 
       // finally loop over all subfaces to collect the contributions of the
       // subfaces and store them with the mother face
-      std::vector<double> sum (n_solution_vectors, 0);
+      double *const sum = face_integrals[face];
+      for (unsigned int n=0; n<n_solution_vectors; ++n)
+        sum[n] = 0;
       for (unsigned int subface_no=0; subface_no<face->n_children(); ++subface_no)
         {
-          Assert (local_face_integrals.find(face->child(subface_no)) !=
-                  local_face_integrals.end(),
-                  ExcInternalError());
-          Assert (local_face_integrals[face->child(subface_no)][0] >= 0,
+          const double *const subface_integral = face_integrals[face->child(subface_no)];
+          Assert (subface_integral[0] >= 0,
                   ExcInternalError());
 
           for (unsigned int n=0; n<n_solution_vectors; ++n)
-            sum[n] += local_face_integrals[face->child(subface_no)][n];
+            sum[n] += subface_integral[n];
         }
-
-      local_face_integrals[face] = sum;
     }
 
 
     /**
-     * Computate the error on the faces of a single cell.
+     * Computate the error on the faces of a single cell, and write it into
+     * the elements of @p face_integrals that belong to these faces. The
+     * faces of a cell that are integrated when visiting one of its neighbors
+     * are skipped, so that every element is written by exactly one cell.
      *
      * This function is only needed in two or three dimensions.  The error
      * estimator in one dimension is implemented separately.
@@ -831,9 +856,9 @@ namespace internal
     void
     estimate_one_cell (const typename DoFHandlerType::active_cell_iterator &cell,
                        ParallelData<DoFHandlerType, typename InputVector::value_type> &parallel_data,
-                       std::map<typename DoFHandlerType::face_iterator,std::vector<double> > &local_face_integrals,
                        const std::vector<const InputVector *> &solutions,
-                       const typename KellyErrorEstimator<DoFHandlerType::dimension,DoFHandlerType::space_dimension>::Strategy strategy)
+                       const typename KellyErrorEstimator<DoFHandlerType::dimension,DoFHandlerType::space_dimension>::Strategy strategy,
+                       FaceIntegrals                          &face_integrals)
     {
       const unsigned int dim = DoFHandlerType::dimension;
       const unsigned int n_solution_vectors = solutions.size();
@@ -841,9 +866,6 @@ namespace internal
       const types::subdomain_id subdomain_id = parallel_data.subdomain_id;
       const unsigned int material_id  = parallel_data.material_id;
 
-      // empty our own copy of the local face integrals
-      local_face_integrals.clear();
-
       // loop over all faces of this cell
       for (unsigned int face_no=0;
            face_no<GeometryInfo<dim>::faces_per_cell; ++face_no)
@@ -880,8 +902,9 @@ namespace internal
               (parallel_data.neumann_bc->find(face->boundary_id()) ==
                parallel_data.neumann_bc->end()))
             {
-              local_face_integrals[face]
-                = std::vector<double> (n_solution_vectors, 0.);
+              double *const face_integral = face_integrals[face];
+              for (unsigned int n=0; n<n_solution_vectors; ++n)
+                face_integral[n] = 0.;
               continue;
             }
 
@@ -951,7 +974,7 @@ namespace internal
             // the integration of these both cases together
             integrate_over_regular_face (solutions,
                                          parallel_data,
-                                         local_face_integrals,
+                                         face_integrals,
                                          cell, face_no,
                                          parallel_data.fe_face_values_cell,
                                          parallel_data.fe_face_values_neighbor,
@@ -962,13 +985,70 @@ namespace internal
             // fit into the framework of the above function
             integrate_over_irregular_face (solutions,
                                            parallel_data,
-                                           local_face_integrals,
+                                           face_integrals,
                                            cell, face_no,
                                            parallel_data.fe_face_values_cell,
                                            parallel_data.fe_subface_values,
                                            strategy);
         }
     }
+
+
+
+    /**
+     * Sum up the contributions of the faces of a single cell to the error
+     * indicators of this cell, and take the square root. Only do something if
+     * this is a cell we care for based on the subdomain and material id.
+     * Every cell only writes into its own elements of the output vectors.
+     */
+    template <typename DoFHandlerType>
+    void
+    collect_one_cell (const typename DoFHandlerType::active_cell_iterator &cell,
+                      const FaceIntegrals                                 &face_integrals,
+                      const types::subdomain_id                            subdomain_id,
+                      const types::material_id                             material_id,
+                      const typename KellyErrorEstimator<DoFHandlerType::dimension,DoFHandlerType::space_dimension>::Strategy strategy,
+                      const DoFHandlerType                                &dof_handler,
+                      const std::vector<dealii::Vector<float>*>                 &errors)
+    {
+      const unsigned int dim = DoFHandlerType::dimension;
+
+      if ( ((subdomain_id == numbers::invalid_subdomain_id)
+            ||
+            (cell->subdomain_id() == subdomain_id))
+           &&
+           ((material_id == numbers::invalid_material_id)
+            ||
+            (cell->material_id() == material_id)))
+        {
+          const unsigned int n_solution_vectors = errors.size();
+          const unsigned int present_cell = cell->active_cell_index();
+
+          // loop over all faces of this cell
+          for (unsigned int face_no=0; face_no<GeometryInfo<dim>::faces_per_cell;
+               ++face_no)
+            {
+              const double *const face_integral = face_integrals[cell->face(face_no)];
+              const double factor = cell_factor<DoFHandlerType>(cell,
+                                                                face_no,
+                                                                dof_handler,
+                                                                strategy);
+
+              for (unsigned int n=0; n<n_solution_vectors; ++n)
+                {
+                  // make sure that we have written a meaningful value into
+                  // this slot
+                  Assert (numbers::is_finite(face_integral[n]), ExcInternalError());
+                  Assert (face_integral[n] >= 0, ExcInternalError());
+
+                  (*errors[n])(present_cell) += (face_integral[n] * factor);
+                }
+            }
+
+          for (unsigned int n=0; n<n_solution_vectors; ++n)
+            (*errors[n])(present_cell) = std::sqrt((*errors[n])(present_cell));
+        }
+    }
   }
 }
 
@@ -1151,11 +1231,12 @@ estimate (const Mapping<dim, spacedim>               &mapping,
 
   const unsigned int n_solution_vectors = solutions.size();
 
-  // Map of integrals indexed by the corresponding face. In this map we store
-  // the integrated jump of the gradient for each face.  At the end of the
+  // Integrals indexed by the corresponding face. Here we store the
+  // integrated jump of the gradient for each face. At the end of the
   // function, we again loop over the cells and collect the contributions of
   // the different faces of the cell.
-  std::map<typename DoFHandlerType::face_iterator,std::vector<double> > face_integrals;
+  internal::FaceIntegrals face_integrals (dof_handler.get_triangulation().n_raw_faces(),
+                                          n_solution_vectors);
 
   // all the data needed in the error estimator by each of the threads is
   // gathered in the following structures
@@ -1171,69 +1252,38 @@ estimate (const Mapping<dim, spacedim>               &mapping,
                  &neumann_bc,
                  component_mask,
                  coefficients);
-  std::map<typename DoFHandlerType::face_iterator,std::vector<double> > sample_local_face_integrals;
 
-  // now let's work on all those cells:
+  // now let's work on all those cells. every face is integrated on exactly
+  // one of the cells adjacent to it, which writes the result right into its
+  // slot of face_integrals
   WorkStream::run (dof_handler.begin_active(),
                    static_cast<typename DoFHandlerType::active_cell_iterator>(dof_handler.end()),
                    std_cxx11::bind (&internal::estimate_one_cell<InputVector,DoFHandlerType>,
-                                    std_cxx11::_1, std_cxx11::_2, std_cxx11::_3, std_cxx11::ref(solutions),strategy),
-                   std_cxx11::bind (&internal::copy_local_to_global<DoFHandlerType>,
-                                    std_cxx11::_1, std_cxx11::ref(face_integrals)),
+                                    std_cxx11::_1, std_cxx11::_2, std_cxx11::ref(solutions), strategy,
+                                    std_cxx11::ref(face_integrals)),
+                   // no copy-local-to-global function needed here
+                   std_cxx11::function<void (const int &)>(),
                    parallel_data,
-                   sample_local_face_integrals);
+                   /* dummy CopyData object = */ 0);
 
   // finally add up the contributions of the faces for each cell
 
   // reserve one slot for each cell and set it to zero
   for (unsigned int n=0; n<n_solution_vectors; ++n)
-    {
-      (*errors[n]).reinit (dof_handler.get_triangulation().n_active_cells());
-      for (unsigned int i=0; i<dof_handler.get_triangulation().n_active_cells(); ++i)
-        (*errors[n])(i)=0;
-    }
+    (*errors[n]).reinit (dof_handler.get_triangulation().n_active_cells());
 
-  // now walk over all cells and collect information from the faces. only do
-  // something if this is a cell we care for based on the subdomain id
-  unsigned int present_cell=0;
-  for (typename DoFHandlerType::active_cell_iterator cell=dof_handler.begin_active();
-       cell!=dof_handler.end();
-       ++cell, ++present_cell)
-    if ( ((subdomain_id == numbers::invalid_subdomain_id)
-          ||
-          (cell->subdomain_id() == subdomain_id))
-         &&
-         ((material_id == numbers::invalid_material_id)
-          ||
-          (cell->material_id() == material_id)))
-      {
-        // loop over all faces of this cell
-        for (unsigned int face_no=0; face_no<GeometryInfo<dim>::faces_per_cell;
-             ++face_no)
-          {
-            Assert(face_integrals.find(cell->face(face_no))
-                   != face_integrals.end(),
-                   ExcInternalError());
-            const double factor = internal::cell_factor<DoFHandlerType>(cell,
-                                                                        face_no,
-                                                                        dof_handler,
-                                                                        strategy);
-
-            for (unsigned int n=0; n<n_solution_vectors; ++n)
-              {
-                // make sure that we have written a meaningful value into this
-                // slot
-                Assert (face_integrals[cell->face(face_no)][n] >= 0,
-                        ExcInternalError());
-
-                (*errors[n])(present_cell)
-                += (face_integrals[cell->face(face_no)][n] * factor);
-              }
-          }
-
-        for (unsigned int n=0; n<n_solution_vectors; ++n)
-          (*errors[n])(present_cell) = std::sqrt((*errors[n])(present_cell));
-      }
+  // now walk over all cells and collect information from the faces. this
+  // only reads from face_integrals, and every cell writes into its own
+  // elements of the output vectors, so it can again be done in parallel
+  WorkStream::run (dof_handler.begin_active(),
+                   static_cast<typename DoFHandlerType::active_cell_iterator>(dof_handler.end()),
+                   std_cxx11::bind (&internal::collect_one_cell<DoFHandlerType>,
+                                    std_cxx11::_1, std_cxx11::cref(face_integrals),
+                                    subdomain_id, material_id, strategy,
+                                    std_cxx11::cref(dof_handler), std_cxx11::cref(errors)),
+                   std_cxx11::function<void (const int &)>(),
+                   /* dummy ScratchData object = */ 0,
+                   /* dummy CopyData object = */ 0);
 }
 
 
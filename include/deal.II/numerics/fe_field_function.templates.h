@@ -15,6 +15,7 @@
 
 
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/array_view.h>
 #include <deal.II/base/logstream.h>
 #include <deal.II/grid/grid_tools.h>
 #include <deal.II/hp/fe_collection.h>
@@ -498,6 +499,11 @@ namespace Functions
     // And this is the index of the current cell
     unsigned int c = 0;
 
+    // Scratch arrays for the points not yet assigned to a cell
+    std::vector<unsigned int> remaining_indices;
+    std::vector<Point<dim> >  remaining_points;
+    std::vector<Point<dim> >  remaining_unit_points;
+
     while (left_over == true)
       {
         // Assume this is the last one
@@ -505,27 +511,42 @@ namespace Functions
         Assert(first_outside < np,
                ExcIndexRange(first_outside, 0, np));
 
-        // If we found one in this cell, keep looking in the same cell
+        // If we found one in this cell, keep looking in the same cell. all
+        // remaining points are transformed to the reference cell of this
+        // cell at once, which is much cheaper than doing so one by one
+        remaining_indices.clear();
+        remaining_points.clear();
         for (unsigned int p=first_outside; p<np; ++p)
           if (point_flags[p] == false)
             {
-              // same logic as above
-              const boost::optional<Point<dim> >
-              qp = get_reference_coordinates (cells[c], points[p]);
-              if (qp)
-                {
-                  point_flags[p] = true;
-                  qpoints[c].push_back(qp.get());
-                  maps[c].push_back(p);
-                }
-              else
-                {
-                  // Set things up for next round
-                  if (left_over == false)
-                    first_outside = p;
-                  left_over = true;
-                }
+              remaining_indices.push_back(p);
+              remaining_points.push_back(points[p]);
             }
+        if (remaining_points.size() == 0)
+          break;
+        remaining_unit_points.resize(remaining_points.size());
+        mapping.transform_points_real_to_unit_cell (cells[c],
+                                                    make_array_view(remaining_points),
+                                                    make_array_view(remaining_unit_points));
+
+        for (unsigned int i=0; i<remaining_indices.size(); ++i)
+          {
+            // same logic as in get_reference_coordinates()
+            const unsigned int p = remaining_indices[i];
+            if (GeometryInfo<dim>::is_inside_unit_cell(remaining_unit_points[i]))
+              {
+                point_flags[p] = true;
+                qpoints[c].push_back(remaining_unit_points[i]);
+                maps[c].push_back(p);
+              }
+            else
+              {
+                // Set things up for next round
+                if (left_over == false)
+                  first_outside = p;
+                left_over = true;
+              }
+          }
         // If we got here and there is
         // no left over, we are
         // done. Else we need to find
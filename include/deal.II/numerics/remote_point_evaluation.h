@@ -0,0 +1,388 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__remote_point_evaluation_h
+#define dealii__remote_point_evaluation_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/tensor.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/grid/cell_locator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/lac/vector.h>
+
+#include <boost/signals2/connection.hpp>
+
+#include <utility>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/**
+ * A class that evaluates finite element functions at arbitrary points of a
+ * possibly distributed mesh. VectorTools::point_value() and
+ * Functions::FEFieldFunction can only evaluate a function at points that lie
+ * in locally owned cells, whereas each process may here ask for the values
+ * and gradients at any points in the domain, and the processes that own the
+ * cells around these points do the evaluation and send the results back.
+ * This is useful for probes, for coupling at interfaces between independent
+ * meshes, or for interpolating a field to particles.
+ *
+ * Finding the owners of the points and the cells around them requires
+ * global communication and is done once in reinit(). Each process computes
+ * the bounding boxes of its locally owned cells within each coarse cell, and
+ * these boxes are exchanged between all processes. A point is then sent to
+ * the processes whose boxes contain it, which find the cell around it using
+ * a CellLocator. If a point lies on the boundary between cells owned by
+ * different processes, the process with the lowest rank evaluates it. The
+ * resulting communication pattern, i.e., which process evaluates which
+ * points in which cells and at which reference coordinates, is stored, so
+ * that evaluate_values() and evaluate_gradients() only need one exchange
+ * of the results with the processes involved, and can be called repeatedly
+ * for different solution vectors on the same points:
+ * @code
+ *   RemotePointEvaluation<dim> evaluation (triangulation, mapping);
+ *   evaluation.reinit (probe_points);
+ *
+ *   for (unsigned int timestep=0; ...; ++timestep)
+ *     {
+ *       ... solve ...
+ *       std::vector<Vector<double> > values;
+ *       evaluation.evaluate_values (dof_handler, ghosted_solution, values);
+ *     }
+ * @endcode
+ * On each process, the points for which the owning cells are evaluated are
+ * grouped by cells, so that the finite element field is evaluated at all
+ * points in a cell at once.
+ *
+ * All functions of this class are collective, i.e., they need to be called
+ * on all processes of the communicator of the triangulation, even if a
+ * process does not ask for any points. If the triangulation is not derived
+ * from parallel::Triangulation, there is only one process and all points
+ * are evaluated locally.
+ *
+ * The communication pattern becomes invalid when the triangulation changes,
+ * and reinit() needs to be called again before the next evaluation.
+ *
+ * @ingroup numerics
+ */
+template <int dim, int spacedim=dim>
+class RemotePointEvaluation : public Subscriptor
+{
+public:
+  /**
+   * Constructor. The @p mapping is used to locate the points in the cells
+   * of @p triangulation and to evaluate the finite element fields. The
+   * bounding boxes of the cells are enlarged by @p relative_tolerance as
+   * described for the CellLocator class.
+   */
+  RemotePointEvaluation (const Triangulation<dim,spacedim> &triangulation,
+                         const Mapping<dim,spacedim>       &mapping = StaticMappingQ1<dim,spacedim>::mapping,
+                         const double                       relative_tolerance = 0.1);
+
+  /**
+   * Destructor.
+   */
+  ~RemotePointEvaluation ();
+
+  /**
+   * Set up the communication pattern for the evaluation at the given @p
+   * points. Every process passes the points it wants to know the values at,
+   * and the results of the evaluation functions below are in the same
+   * order.
+   */
+  void reinit (const std::vector<Point<spacedim> > &points);
+
+  /**
+   * Return the number of points passed to the last call of reinit() on
+   * this process.
+   */
+  unsigned int n_points () const;
+
+  /**
+   * Return whether the point with index @p i has been found in a locally
+   * owned cell of some process. The values and gradients at points not found
+   * are set to zero.
+   */
+  bool point_found (const unsigned int i) const;
+
+  /**
+   * Return whether all points of this process have been found.
+   */
+  bool all_points_found () const;
+
+  /**
+   * Evaluate the finite element function given by @p dof_handler and @p
+   * solution at the points given to reinit(). The values of all vector
+   * components at the point with index <tt>i</tt> are stored in
+   * <tt>values[i]</tt>.
+   *
+   * For parallel triangulations, the @p solution vector needs to provide
+   * the values of all degrees of freedom on the locally owned cells, i.e.,
+   * it needs to contain ghost elements as when used with FEValues.
+   */
+  template <typename VectorType>
+  void evaluate_values (const DoFHandler<dim,spacedim> &dof_handler,
+                        const VectorType               &solution,
+                        std::vector<Vector<double> >   &values) const;
+
+  /**
+   * Evaluate the gradients of the finite element function at the points
+   * given to reinit(). The gradients of all vector components at the point
+   * with index <tt>i</tt> are stored in <tt>gradients[i]</tt>. The
+   * requirements on @p solution are the same as for evaluate_values().
+   */
+  template <typename VectorType>
+  void evaluate_gradients (const DoFHandler<dim,spacedim>                    &dof_handler,
+                           const VectorType                                  &solution,
+                           std::vector<std::vector<Tensor<1,spacedim> > >   &gradients) const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * Send the results of the evaluation at the points owned by this process,
+   * which are stored in @p owned_results with @p n_values_per_point values
+   * per point in the order given by @p send_ranks, to the processes that
+   * asked for them, and receive the results for the points of this process
+   * into @p results in the order of the points given to reinit().
+   */
+  void communicate_results (const std::vector<double> &owned_results,
+                            const unsigned int         n_values_per_point,
+                            std::vector<double>       &results) const;
+
+  /**
+   * Mark the communication pattern as invalid. This function is connected
+   * to the Triangulation::Signals::any_change signal of the triangulation.
+   */
+  void invalidate ();
+
+  /**
+   * The triangulation on which the points are located.
+   */
+  SmartPointer<const Triangulation<dim,spacedim>,RemotePointEvaluation<dim,spacedim> > triangulation;
+
+  /**
+   * The mapping used to locate the points and to evaluate the fields.
+   */
+  SmartPointer<const Mapping<dim,spacedim>,RemotePointEvaluation<dim,spacedim> > mapping;
+
+  /**
+   * The enlargement of the bounding boxes of the cells relative to their
+   * size.
+   */
+  const double relative_tolerance;
+
+  /**
+   * The communicator of the triangulation, or MPI_COMM_SELF for serial
+   * triangulations.
+   */
+  MPI_Comm mpi_communicator;
+
+  /**
+   * An object to find the cells around the points sent to this process.
+   */
+  CellLocator<dim,spacedim> cell_locator;
+
+  /**
+   * Whether reinit() has been called since the last change of the
+   * triangulation.
+   */
+  bool is_valid;
+
+  /**
+   * The number of points given to reinit() on this process, and whether
+   * they have been found.
+   */
+  std::vector<bool> found;
+
+  /**
+   * The ranks of the processes that evaluate points of this process, in
+   * increasing order, and the ranges in @p recv_point_indices of the points
+   * each of them evaluates.
+   */
+  std::vector<unsigned int> recv_ranks;
+  std::vector<unsigned int> recv_offsets;
+
+  /**
+   * The indices of the points of this process in the order in which their
+   * results arrive.
+   */
+  std::vector<unsigned int> recv_point_indices;
+
+  /**
+   * The ranks of the processes for which this process evaluates points, in
+   * increasing order, and the ranges of the positions of their points in
+   * the buffer of results sent.
+   */
+  std::vector<unsigned int> send_ranks;
+  std::vector<unsigned int> send_offsets;
+
+  /**
+   * The locally owned cells that contain points evaluated by this process,
+   * given by their level and index, and the ranges in @p
+   * owned_reference_points of the points in each of them.
+   */
+  std::vector<std::pair<int,int> > owned_cells;
+  std::vector<unsigned int>        owned_cell_offsets;
+
+  /**
+   * The coordinates of the points evaluated by this process in the
+   * reference coordinate systems of their cells, and the positions of the
+   * points in the buffer of results sent.
+   */
+  std::vector<Point<dim> >   owned_reference_points;
+  std::vector<unsigned int>  owned_result_positions;
+
+  /**
+   * The connection to the Triangulation::Signals::any_change signal of the
+   * triangulation.
+   */
+  boost::signals2::connection tria_listener;
+};
+
+
+/* ---------------------- template functions ------------------------- */
+
+
+template <int dim, int spacedim>
+template <typename VectorType>
+void
+RemotePointEvaluation<dim,spacedim>::
+evaluate_values (const DoFHandler<dim,spacedim> &dof_handler,
+                 const VectorType               &solution,
+                 std::vector<Vector<double> >   &values) const
+{
+  Assert (is_valid,
+          ExcMessage ("The triangulation has changed since the last call of "
+                      "reinit(), or reinit() has not been called at all."));
+  Assert (&dof_handler.get_triangulation() == &*triangulation,
+          ExcMessage ("The DoFHandler must be based on the triangulation "
+                      "given to the constructor."));
+
+  const unsigned int n_components = dof_handler.get_fe().n_components();
+
+  // evaluate at the points owned by this process, one cell at a time
+  std::vector<double> owned_results (owned_reference_points.size() * n_components);
+  std::vector<Vector<typename VectorType::value_type> > cell_values;
+  for (unsigned int c=0; c<owned_cells.size(); ++c)
+    {
+      const typename DoFHandler<dim,spacedim>::active_cell_iterator
+      cell (&*triangulation, owned_cells[c].first, owned_cells[c].second,
+            &dof_handler);
+      const Quadrature<dim> quadrature
+      (std::vector<Point<dim> > (owned_reference_points.begin() + owned_cell_offsets[c],
+                                 owned_reference_points.begin() + owned_cell_offsets[c+1]));
+      FEValues<dim,spacedim> fe_values (*mapping, dof_handler.get_fe(), quadrature,
+                                        update_values);
+      fe_values.reinit (cell);
+
+      cell_values.resize (quadrature.size(),
+                          Vector<typename VectorType::value_type> (n_components));
+      fe_values.get_function_values (solution, cell_values);
+      for (unsigned int q=0; q<quadrature.size(); ++q)
+        for (unsigned int d=0; d<n_components; ++d)
+          owned_results[owned_result_positions[owned_cell_offsets[c]+q] * n_components + d]
+            = cell_values[q][d];
+    }
+
+  std::vector<double> results;
+  communicate_results (owned_results, n_components, results);
+
+  values.resize (found.size());
+  for (unsigned int i=0; i<found.size(); ++i)
+    {
+      values[i].reinit (n_components);
+      for (unsigned int d=0; d<n_components; ++d)
+        values[i][d] = results[i * n_components + d];
+    }
+}
+
+
+
+template <int dim, int spacedim>
+template <typename VectorType>
+void
+RemotePointEvaluation<dim,spacedim>::
+evaluate_gradients (const DoFHandler<dim,spacedim>                  &dof_handler,
+                    const VectorType                                &solution,
+                    std::vector<std::vector<Tensor<1,spacedim> > > &gradients) const
+{
+  Assert (is_valid,
+          ExcMessage ("The triangulation has changed since the last call of "
+                      "reinit(), or reinit() has not been called at all."));
+  Assert (&dof_handler.get_triangulation() == &*triangulation,
+          ExcMessage ("The DoFHandler must be based on the triangulation "
+                      "given to the constructor."));
+
+  const unsigned int n_components = dof_handler.get_fe().n_components();
+  const unsigned int n_values_per_point = n_components * spacedim;
+
+  // evaluate at the points owned by this process, one cell at a time
+  std::vector<double> owned_results (owned_reference_points.size() * n_values_per_point);
+  std::vector<std::vector<Tensor<1,spacedim,typename VectorType::value_type> > > cell_gradients;
+  for (unsigned int c=0; c<owned_cells.size(); ++c)
+    {
+      const typename DoFHandler<dim,spacedim>::active_cell_iterator
+      cell (&*triangulation, owned_cells[c].first, owned_cells[c].second,
+            &dof_handler);
+      const Quadrature<dim> quadrature
+      (std::vector<Point<dim> > (owned_reference_points.begin() + owned_cell_offsets[c],
+                                 owned_reference_points.begin() + owned_cell_offsets[c+1]));
+      FEValues<dim,spacedim> fe_values (*mapping, dof_handler.get_fe(), quadrature,
+                                        update_gradients);
+      fe_values.reinit (cell);
+
+      cell_gradients.resize (quadrature.size(),
+                             std::vector<Tensor<1,spacedim,typename VectorType::value_type> > (n_components));
+      fe_values.get_function_gradients (solution, cell_gradients);
+      for (unsigned int q=0; q<quadrature.size(); ++q)
+        for (unsigned int d=0; d<n_components; ++d)
+          for (unsigned int e=0; e<spacedim; ++e)
+            owned_results[owned_result_positions[owned_cell_offsets[c]+q] * n_values_per_point
+                          + d*spacedim + e]
+              = cell_gradients[q][d][e];
+    }
+
+  std::vector<double> results;
+  communicate_results (owned_results, n_values_per_point, results);
+
+  gradients.resize (found.size());
+  for (unsigned int i=0; i<found.size(); ++i)
+    {
+      gradients[i].resize (n_components);
+      for (unsigned int d=0; d<n_components; ++d)
+        for (unsigned int e=0; e<spacedim; ++e)
+          gradients[i][d][e] = results[i * n_values_per_point + d*spacedim + e];
+    }
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -23,6 +23,7 @@
 #include <deal.II/base/config.h>
 #include <deal.II/base/smartpointer.h>
 #include <deal.II/lac/vector.h>
+#include <deal.II/lac/full_matrix.h>
 #include <deal.II/base/exceptions.h>
 #include <deal.II/dofs/dof_handler.h>
 
@@ -30,6 +31,9 @@
 
 DEAL_II_NAMESPACE_OPEN
 
+class SparsityPattern;
+template <typename number> class SparseMatrix;
+
 /**
  * This class implements the transfer of a discrete FE function (e.g. a
  * solution vector) from one mesh to another that is obtained from the first
@@ -118,6 +122,40 @@ DEAL_II_NAMESPACE_OPEN
  * prepare_for_coarsening_and_refinement function taking several vectors as
  * input before actually refining and coarsening the triangulation (see
  * there).
+ *
+ * <li> If several vectors, or vectors that belong to several DoFHandler
+ * objects with identical finite element and DoF numbering on the same
+ * triangulation, need to be transferred, or if the same transfer needs to
+ * be applied again later (e.g. when replaying a stored history of meshes),
+ * it is cheaper to compute the mapping between old and new degrees of
+ * freedom once, in the form of a sparse matrix, and to transfer each vector
+ * by a single matrix-vector product:
+ * @code
+ * SolutionTransfer<dim, Vector<double> > soltrans(*dof_handler);
+ *                                     // flag some cells for refinement
+ *                                     // and coarsening, and prepare the
+ *                                     // triangulation,
+ * tria->prepare_coarsening_and_refinement();
+ *                                     // store the information needed to
+ *                                     // build the transfer matrix,
+ * soltrans.prepare_for_transfer_matrix();
+ *                                     // actually execute the refinement,
+ * tria->execute_coarsening_and_refinement ();
+ *                                     // redistribute dofs,
+ * dof_handler->distribute_dofs (fe);
+ *                                     // build the transfer matrix
+ * SparsityPattern      transfer_sparsity;
+ * SparseMatrix<double> transfer_matrix;
+ * soltrans.build_transfer_matrix(transfer_sparsity, transfer_matrix);
+ *                                     // and apply it to as many vectors
+ *                                     // as desired
+ * Vector<double> interpolated_solution(dof_handler->n_dofs());
+ * transfer_matrix.vmult(interpolated_solution, solution);
+ * @endcode
+ * The vectors so obtained are the same as the ones computed by
+ * <tt>interpolate(all_in, all_out)</tt>. Since no vectors are needed before
+ * the refinement, the matrix can also be used for vectors that are only
+ * computed after it has been built.
  * </ul>
  *
  * For deleting all stored data in @p SolutionTransfer and reinitializing it
@@ -332,6 +370,33 @@ public:
    */
   void prepare_for_coarsening_and_refinement (const VectorType &in);
 
+  /**
+   * Prepares the @p SolutionTransfer for the computation of a transfer
+   * matrix by build_transfer_matrix(). Cells may be both refined and
+   * coarsened. In contrast to prepare_for_coarsening_and_refinement(), no
+   * vectors are needed: on the cells whose children will be coarsened away,
+   * the dof indices of the children are stored together with the local
+   * matrix that restricts their values to the parent cell.
+   */
+  void prepare_for_transfer_matrix ();
+
+  /**
+   * Build the matrix that maps a vector on the grid before refinement
+   * and/or coarsening to the vector interpolated onto the new grid, i.e.
+   * the matrix has <tt>n_dofs_refined</tt> rows and <tt>n_dofs_old</tt>
+   * columns and <tt>transfer_matrix.vmult(out, in)</tt> computes the same
+   * vector as <tt>interpolate(in, out)</tt> or <tt>refine_interpolate(in,
+   * out)</tt> would. The sparsity pattern of the matrix is stored in @p
+   * sparsity_pattern, which needs to live at least as long as the matrix.
+   *
+   * Calling this function is allowed only if @p prepare_for_pure_refinement
+   * or @p prepare_for_transfer_matrix has been called and the refinement has
+   * been executed and the degrees of freedom have been distributed
+   * afterwards. The function may be called several times.
+   */
+  void build_transfer_matrix (SparsityPattern      &sparsity_pattern,
+                              SparseMatrix<double> &transfer_matrix) const;
+
   /**
    * This function interpolates the discrete function @p in, which is a vector
    * on the grid before the refinement, to the function @p out which then is a
@@ -427,13 +492,14 @@ private:
   types::global_dof_index n_dofs_old;
 
   /**
-   * Declaration of @p PreparationState that denotes the three possible states
+   * Declaration of @p PreparationState that denotes the four possible states
    * of the @p SolutionTransfer: being prepared for 'pure refinement',
-   * prepared for 'coarsening and refinement' or not prepared.
+   * prepared for 'coarsening and refinement', prepared for building a
+   * transfer matrix for coarsening and refinement, or not prepared.
    */
   enum PreparationState
   {
-    none, pure_refinement, coarsening_and_refinement
+    none, pure_refinement, coarsening_and_refinement, transfer_matrix_preparation
   };
 
   /**
@@ -445,7 +511,9 @@ private:
   /**
    * Is used for @p prepare_for_refining (of course also for @p
    * repare_for_refining_and_coarsening) and stores all dof indices of the
-   * cells that'll be refined
+   * cells that'll be refined. For @p prepare_for_transfer_matrix, it also
+   * stores the dof indices of all children of the cells that will be
+   * coarsened, one child after the other.
    */
   std::vector<std::vector<types::global_dof_index> > indices_on_cell;
 
@@ -462,22 +530,32 @@ private:
    */
   struct Pointerstruct
   {
-    Pointerstruct() : indices_ptr(0), dof_values_ptr(0), active_fe_index(0) {};
+    Pointerstruct() : indices_ptr(0), dof_values_ptr(0), restriction_matrix_ptr(0), active_fe_index(0) {};
     Pointerstruct(std::vector<types::global_dof_index> *indices_ptr_in,
                   const unsigned int active_fe_index_in = 0)
       :
       indices_ptr(indices_ptr_in),
       dof_values_ptr (0),
+      restriction_matrix_ptr (0),
       active_fe_index(active_fe_index_in) {};
     Pointerstruct(std::vector<Vector<typename VectorType::value_type> > *dof_values_ptr_in,
                   const unsigned int active_fe_index_in = 0) :
       indices_ptr (0),
       dof_values_ptr(dof_values_ptr_in),
+      restriction_matrix_ptr (0),
+      active_fe_index(active_fe_index_in) {};
+    Pointerstruct(std::vector<types::global_dof_index> *indices_ptr_in,
+                  FullMatrix<double>                   *restriction_matrix_ptr_in,
+                  const unsigned int                    active_fe_index_in = 0) :
+      indices_ptr (indices_ptr_in),
+      dof_values_ptr (0),
+      restriction_matrix_ptr (restriction_matrix_ptr_in),
       active_fe_index(active_fe_index_in) {};
     std::size_t memory_consumption () const;
 
     std::vector<types::global_dof_index>    *indices_ptr;
     std::vector<Vector<typename VectorType::value_type> > *dof_values_ptr;
+    FullMatrix<double>                      *restriction_matrix_ptr;
     unsigned int active_fe_index;
   };
 
@@ -494,6 +572,14 @@ private:
    * values of all cells that'll be coarsened will be stored in this vector.
    */
   std::vector<std::vector<Vector<typename VectorType::value_type> > > dof_values_on_cell;
+
+  /**
+   * Is used for @p prepare_for_transfer_matrix. For each cell whose children
+   * will be coarsened away, this vector stores the matrix that maps the
+   * values on all children (in the order of the dof indices stored in @p
+   * indices_on_cell for this cell) to the values on the parent cell.
+   */
+  std::vector<FullMatrix<double> > restriction_matrices_on_cell;
 };
 
 
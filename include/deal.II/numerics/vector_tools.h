@@ -2196,6 +2196,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    */
   template <int dim, typename VectorType, int spacedim>
   void point_difference (const DoFHandler<dim,spacedim>  &dof,
@@ -2215,6 +2217,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    */
   template <int dim, typename VectorType, int spacedim>
   void point_difference (const Mapping<dim, spacedim>    &mapping,
@@ -2234,6 +2238,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -2258,6 +2264,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -2291,6 +2299,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -2314,6 +2324,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -2342,6 +2354,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -2367,6 +2381,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -2397,6 +2413,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -2421,6 +2439,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -2450,6 +2470,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -2473,6 +2495,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -2501,6 +2525,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -2523,6 +2549,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
     *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -2550,6 +2578,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -2574,6 +2604,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -2603,6 +2635,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -2626,6 +2660,8 @@ namespace VectorTools
    *
    * @note If the cell in which the point is found is not locally owned, an
    * exception of type VectorTools::ExcPointNotAvailableHere is thrown.
+   * The RemotePointEvaluation class can evaluate finite element functions
+   * at points in cells owned by other processors.
    *
    * @note This function needs to find the cell within which a point lies,
    *   and this can only be done up to a certain numerical tolerance of course.
@@ -0,0 +1,219 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/background_writer.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/base/std_cxx11/shared_ptr.h>
+
+#include <fstream>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  void
+  write_bytes (const std_cxx11::shared_ptr<const std::vector<char> > buffer,
+               std::ostream                                         &out)
+  {
+    if (buffer->size() > 0)
+      out.write (&(*buffer)[0], buffer->size());
+  }
+}
+
+
+
+BackgroundWriter::BackgroundWriter (const std::size_t max_staging_memory)
+  :
+  max_staging_memory (max_staging_memory),
+  current_memory (0),
+  busy (false),
+  shut_down (false)
+{
+#ifdef DEAL_II_WITH_THREADS
+  worker = Threads::new_thread (&BackgroundWriter::run_worker, *this);
+#endif
+}
+
+
+
+BackgroundWriter::~BackgroundWriter ()
+{
+#ifdef DEAL_II_WITH_THREADS
+  // the worker thread empties the queue before it checks the flag, so this
+  // also waits for all outstanding requests
+  {
+    std_cxx11::unique_lock<std_cxx11::mutex> lock (mutex);
+    shut_down = true;
+  }
+  request_submitted.notify_one ();
+  worker.join ();
+#endif
+}
+
+
+
+void
+BackgroundWriter::write (const std::string &filename,
+                         std::vector<char>  &buffer)
+{
+  std_cxx11::shared_ptr<std::vector<char> > data (new std::vector<char>());
+  data->swap (buffer);
+
+  const std::size_t memory = data->size();
+  write (filename,
+         std_cxx11::bind (&write_bytes,
+                          std_cxx11::shared_ptr<const std::vector<char> >(data),
+                          std_cxx11::_1),
+         memory);
+}
+
+
+
+void
+BackgroundWriter::write (const std::string                                  &filename,
+                         const std_cxx11::function<void (std::ostream &)>  &writer,
+                         const std::size_t                                   memory)
+{
+  Request request;
+  request.filename = filename;
+  request.writer   = writer;
+  request.memory   = memory;
+
+#ifdef DEAL_II_WITH_THREADS
+  {
+    std_cxx11::unique_lock<std_cxx11::mutex> lock (mutex);
+
+    // wait for earlier requests to complete until the new one fits. a
+    // request that is larger than the bound on its own is admitted once
+    // everything else has been written
+    if (max_staging_memory > 0)
+      while ((current_memory > 0)
+             &&
+             (current_memory + memory > max_staging_memory))
+        request_completed.wait (lock);
+
+    queue.push_back (request);
+    current_memory += memory;
+  }
+  request_submitted.notify_one ();
+#else
+  execute (request);
+#endif
+}
+
+
+
+void
+BackgroundWriter::wait ()
+{
+  std::string first_error;
+  {
+#ifdef DEAL_II_WITH_THREADS
+    std_cxx11::unique_lock<std_cxx11::mutex> lock (mutex);
+    while ((queue.size() > 0) || busy)
+      request_completed.wait (lock);
+#endif
+    first_error.swap (error);
+  }
+
+  AssertThrow (first_error.empty(), ExcWriteFailed (first_error));
+}
+
+
+
+std::size_t
+BackgroundWriter::staged_memory () const
+{
+#ifdef DEAL_II_WITH_THREADS
+  std_cxx11::unique_lock<std_cxx11::mutex> lock (mutex);
+#endif
+  return current_memory;
+}
+
+
+
+void
+BackgroundWriter::execute (const Request &request)
+{
+  std::string message;
+  try
+    {
+      std::ofstream out (request.filename.c_str(), std::ios::binary);
+      AssertThrow (out, ExcFileNotOpen (request.filename));
+      request.writer (out);
+      out.close ();
+      AssertThrow (out, ExcIO());
+    }
+  catch (const std::exception &exc)
+    {
+      message = exc.what();
+    }
+  catch (...)
+    {
+      message = "Unknown exception while writing " + request.filename + ".";
+    }
+
+  if (message.size() > 0)
+    {
+#ifdef DEAL_II_WITH_THREADS
+      std_cxx11::unique_lock<std_cxx11::mutex> lock (mutex);
+#endif
+      if (error.empty())
+        error = message;
+    }
+}
+
+
+
+#ifdef DEAL_II_WITH_THREADS
+void
+BackgroundWriter::run_worker ()
+{
+  while (true)
+    {
+      Request request;
+      {
+        std_cxx11::unique_lock<std_cxx11::mutex> lock (mutex);
+        while ((queue.size() == 0) && (shut_down == false))
+          request_submitted.wait (lock);
+
+        if (queue.size() == 0)
+          return;
+
+        request = queue.front();
+        queue.pop_front ();
+        busy = true;
+      }
+
+      execute (request);
+
+      // release the data of the request before its memory is taken out of
+      // the staging area
+      const std::size_t memory = request.memory;
+      request = Request();
+
+      {
+        std_cxx11::unique_lock<std_cxx11::mutex> lock (mutex);
+        current_memory -= memory;
+        busy = false;
+      }
+      request_completed.notify_all ();
+    }
+}
+#endif
+
+
+DEAL_II_NAMESPACE_CLOSE
@@ -32,11 +32,14 @@
 //////////////////////////////////////////////////////////////////////
 
 #include <deal.II/base/data_out_base.h>
+#include <deal.II/base/background_writer.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/parameter_handler.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/std_cxx11/shared_ptr.h>
+#include <deal.II/base/std_cxx11/bind.h>
 #include <deal.II/base/mpi.h>
 
 #include <cstring>
@@ -243,11 +246,138 @@ namespace
       }
   }
 
+  /**
+   * The size in bytes of the blocks into which write_compressed_block()
+   * splits the data. The blocks are compressed independently of each other,
+   * and consequently in parallel. The VTK format stores the compressed size
+   * of each block in the header of a data array.
+   */
+  const std::size_t compression_block_size = (1<<20);
+
+  /**
+   * The size in bytes of the chunks that are base64 encoded in parallel.
+   * This needs to be a multiple of three, so that the encoded chunks can
+   * simply be concatenated.
+   */
+  const std::size_t encoding_chunk_size = 3 * (1<<18);
+
+
+  /**
+   * Compress the blocks with numbers in the range [begin,end) of the given
+   * data into the given buffers.
+   */
+  void compress_blocks (const char                      *data,
+                        const std::size_t                data_size,
+                        const int                        compression_level,
+                        std::vector<std::vector<char> > &compressed_blocks,
+                        const unsigned int               begin,
+                        const unsigned int               end)
+  {
+    for (unsigned int b=begin; b<end; ++b)
+      {
+        const std::size_t offset = b * compression_block_size;
+        const std::size_t size   = std::min (compression_block_size,
+                                             data_size - offset);
+
+        uLongf compressed_data_length = compressBound (size);
+        compressed_blocks[b].resize (compressed_data_length);
+        int err = compress2 ((Bytef *) &compressed_blocks[b][0],
+                             &compressed_data_length,
+                             (const Bytef *) data + offset,
+                             size,
+                             compression_level);
+        (void)err;
+        Assert (err == Z_OK, ExcInternalError());
+        compressed_blocks[b].resize (compressed_data_length);
+      }
+  }
+
+
+  /**
+   * Base64 encode the chunks with numbers in the range [begin,end) of the
+   * given data.
+   */
+  void encode_chunks (const char          *data,
+                      const std::size_t    data_size,
+                      std::vector<char *> &encoded_chunks,
+                      const unsigned int   begin,
+                      const unsigned int   end)
+  {
+    for (unsigned int c=begin; c<end; ++c)
+      {
+        const std::size_t offset = c * encoding_chunk_size;
+        encoded_chunks[c] = encode_block (data + offset,
+                                          std::min (encoding_chunk_size,
+                                                    data_size - offset));
+      }
+  }
+
+
+  /**
+   * Compress the given data with zlib. The data is split into blocks that
+   * are compressed in parallel. On return, @p compression_header contains
+   * the number of blocks, the size of each block before compression, the
+   * size of the last block before compression, and the list of compressed
+   * sizes of the blocks, while @p compressed_data contains the compressed
+   * blocks one after the other.
+   */
+  template <typename T>
+  void compress_data (const std::vector<T>        &data,
+                      const DataOutBase::VtkFlags &flags,
+                      std::vector<uint32_t>       &compression_header,
+                      std::vector<char>           &compressed_data)
+  {
+    Assert (data.size() != 0, ExcInternalError());
+
+    const std::size_t  data_size = data.size() * sizeof(T);
+    const unsigned int n_blocks  = (data_size + compression_block_size - 1) /
+                                   compression_block_size;
+
+    // compress the blocks independently of each other
+    std::vector<std::vector<char> > compressed_blocks (n_blocks);
+    parallel::apply_to_subranges (0U, n_blocks,
+                                  std_cxx11::bind (&compress_blocks,
+                                                   (const char *) &data[0],
+                                                   data_size,
+                                                   get_zlib_compression_level(flags.compression_level),
+                                                   std_cxx11::ref(compressed_blocks),
+                                                   std_cxx11::_1,
+                                                   std_cxx11::_2),
+                                  1);
+
+    compression_header.resize (3 + n_blocks);
+    compression_header[0] = n_blocks;
+    compression_header[1] = (n_blocks > 1 ? compression_block_size : data_size);
+    compression_header[2] = data_size - (n_blocks-1) * compression_block_size;
+    std::size_t compressed_data_length = 0;
+    for (unsigned int b=0; b<n_blocks; ++b)
+      {
+        compression_header[3+b] = compressed_blocks[b].size();
+        compressed_data_length += compressed_blocks[b].size();
+      }
+
+    compressed_data.clear ();
+    compressed_data.reserve (compressed_data_length);
+    for (unsigned int b=0; b<n_blocks; ++b)
+      {
+        compressed_data.insert (compressed_data.end(),
+                                compressed_blocks[b].begin(),
+                                compressed_blocks[b].end());
+        std::vector<char>().swap (compressed_blocks[b]);
+      }
+  }
+
+
   /**
    * Do a zlib compression followed
    * by a base64 encoding of the
    * given data. The result is then
    * written to the given stream.
+   *
+   * The data is split into blocks that
+   * are compressed in parallel, and the
+   * result is encoded in parallel as
+   * well.
    */
   template <typename T>
   void write_compressed_block (const std::vector<T>        &data,
@@ -256,43 +386,79 @@ namespace
   {
     if (data.size() != 0)
       {
-        // allocate a buffer for compressing
-        // data and do so
-        uLongf compressed_data_length
-          = compressBound (data.size() * sizeof(T));
-        char *compressed_data = new char[compressed_data_length];
-        int err = compress2 ((Bytef *) compressed_data,
-                             &compressed_data_length,
-                             (const Bytef *) &data[0],
-                             data.size() * sizeof(T),
-                             get_zlib_compression_level(flags.compression_level));
-        (void)err;
-        Assert (err == Z_OK, ExcInternalError());
-
-        // now encode the compression header
-        const uint32_t compression_header[4]
-          = { 1,                                   /* number of blocks */
-              (uint32_t)(data.size() * sizeof(T)), /* size of block */
-              (uint32_t)(data.size() * sizeof(T)), /* size of last block */
-              (uint32_t)compressed_data_length
-            }; /* list of compressed sizes of blocks */
+        std::vector<uint32_t> compression_header;
+        std::vector<char>     compressed_data;
+        compress_data (data, flags, compression_header, compressed_data);
 
         char *encoded_header = encode_block ((char *)&compression_header[0],
-                                             4 * sizeof(compression_header[0]));
+                                             compression_header.size() * sizeof(compression_header[0]));
         output_stream << encoded_header;
         delete[] encoded_header;
 
-        // next do the compressed
-        // data encoding in base64
-        char *encoded_data = encode_block (compressed_data,
-                                           compressed_data_length);
-        delete[] compressed_data;
-
-        output_stream << encoded_data;
-        delete[] encoded_data;
+        // next do the compressed data encoding in base64. the header and
+        // the data are encoded separately, but the data of all blocks
+        // together
+        const std::size_t  compressed_data_length = compressed_data.size();
+        const unsigned int n_chunks = (compressed_data_length + encoding_chunk_size - 1) /
+                                      encoding_chunk_size;
+        std::vector<char *> encoded_chunks (n_chunks);
+        parallel::apply_to_subranges (0U, n_chunks,
+                                      std_cxx11::bind (&encode_chunks,
+                                                       (const char *) &compressed_data[0],
+                                                       compressed_data_length,
+                                                       std_cxx11::ref(encoded_chunks),
+                                                       std_cxx11::_1,
+                                                       std_cxx11::_2),
+                                      1);
+
+        for (unsigned int c=0; c<n_chunks; ++c)
+          {
+            output_stream << encoded_chunks[c];
+            delete[] encoded_chunks[c];
+          }
       }
   }
 #endif
+
+
+  /**
+   * Append the given data to the appended data section of a VTU file, in
+   * raw binary form. If zlib is available, the data is compressed and
+   * preceded by the compression header. Otherwise, it is preceded by its
+   * size in bytes.
+   */
+  template <typename T>
+  void append_raw_block (const std::vector<T>        &data,
+                         const DataOutBase::VtkFlags &flags,
+                         std::vector<char>           &appended_data)
+  {
+#ifdef DEAL_II_WITH_ZLIB
+    std::vector<uint32_t> header (3, 0);
+    std::vector<char>     compressed_data;
+    if (data.size() != 0)
+      compress_data (data, flags, header, compressed_data);
+
+    appended_data.insert (appended_data.end(),
+                          (const char *) &header[0],
+                          (const char *) &header[0] + header.size() * sizeof(header[0]));
+    appended_data.insert (appended_data.end(),
+                          compressed_data.begin(),
+                          compressed_data.end());
+#else
+    (void)flags;
+    Assert (data.size() * sizeof(T) <= std::numeric_limits<uint32_t>::max(),
+            ExcMessage ("Data arrays larger than 4GB can not be written as "
+                        "uncompressed raw data."));
+    const uint32_t data_size = data.size() * sizeof(T);
+    appended_data.insert (appended_data.end(),
+                          (const char *) &data_size,
+                          (const char *) &data_size + sizeof(data_size));
+    if (data.size() != 0)
+      appended_data.insert (appended_data.end(),
+                            (const char *) &data[0],
+                            (const char *) &data[0] + data_size);
+#endif
+  }
 }
 
 
@@ -989,8 +1155,21 @@ namespace
   class VtuStream : public StreamBase<DataOutBase::VtkFlags>
   {
   public:
+    /**
+     * Constructor. If @p appended_data is not a null pointer, the data
+     * arrays are not written to the stream, but appended in raw binary form
+     * to the given buffer, which is to be written into the appended data
+     * section of the file.
+     */
     VtuStream (std::ostream &stream,
-               const DataOutBase::VtkFlags &flags);
+               const DataOutBase::VtkFlags &flags,
+               std::vector<char> *appended_data = 0);
+
+    /**
+     * Return the format attribute of the next data array, including its
+     * offset into the appended data section if the data is appended.
+     */
+    std::string format_attribute () const;
 
     template <int dim>
     void write_point (const unsigned int index,
@@ -1049,6 +1228,18 @@ namespace
      */
     std::vector<double>  vertices;
     std::vector<int32_t> cells;
+
+    /**
+     * The buffer holding the appended data section, or a null pointer if
+     * the data is written inline.
+     */
+    std::vector<char> *appended_data;
+
+    /**
+     * Whether the vertices and cells are collected in the arrays above
+     * before they are written, rather than being written one by one.
+     */
+    bool collect_data () const;
   };
 
 
@@ -1376,46 +1567,80 @@ namespace
 
 
   VtuStream::VtuStream (std::ostream &out,
-                        const DataOutBase::VtkFlags &f)
+                        const DataOutBase::VtkFlags &f,
+                        std::vector<char> *appended_data)
     :
-    StreamBase<DataOutBase::VtkFlags> (out, f)
+    StreamBase<DataOutBase::VtkFlags> (out, f),
+    appended_data (appended_data)
   {}
 
 
+
+  std::string
+  VtuStream::format_attribute () const
+  {
+    if (appended_data != 0)
+      return "format=\"appended\" offset=\"" +
+             Utilities::to_string (appended_data->size()) + "\"";
+
+#ifdef DEAL_II_WITH_ZLIB
+    return "format=\"binary\"";
+#else
+    return "format=\"ascii\"";
+#endif
+  }
+
+
+
+  bool
+  VtuStream::collect_data () const
+  {
+#ifdef DEAL_II_WITH_ZLIB
+    return true;
+#else
+    return (appended_data != 0);
+#endif
+  }
+
+
   template<int dim>
   void
   VtuStream::write_point (const unsigned int,
                           const Point<dim> &p)
   {
-#if !defined(DEAL_II_WITH_ZLIB)
-    // write out coordinates
-    stream << p;
-    // fill with zeroes
-    for (unsigned int i=dim; i<3; ++i)
-      stream << " 0";
-    stream << '\n';
-#else
-    // if we want to compress, then
-    // first collect all the data in
-    // an array
-    for (unsigned int i=0; i<dim; ++i)
-      vertices.push_back(p[i]);
-    for (unsigned int i=dim; i<3; ++i)
-      vertices.push_back(0);
-#endif
+    if (collect_data() == false)
+      {
+        // write out coordinates
+        stream << p;
+        // fill with zeroes
+        for (unsigned int i=dim; i<3; ++i)
+          stream << " 0";
+        stream << '\n';
+      }
+    else
+      {
+        // if we want to compress or
+        // append, then first collect
+        // all the data in an array
+        for (unsigned int i=0; i<dim; ++i)
+          vertices.push_back(p[i]);
+        for (unsigned int i=dim; i<3; ++i)
+          vertices.push_back(0);
+      }
   }
 
 
   void
   VtuStream::flush_points ()
   {
-#ifdef DEAL_II_WITH_ZLIB
-    // compress the data we have in
-    // memory and write them to the
-    // stream. then release the data
-    *this << vertices << '\n';
-    vertices.clear ();
-#endif
+    if (collect_data())
+      {
+        // compress the data we have in
+        // memory and write them to the
+        // stream. then release the data
+        *this << vertices << '\n';
+        vertices.clear ();
+      }
   }
 
 
@@ -1427,38 +1652,41 @@ namespace
                          unsigned int d2,
                          unsigned int d3)
   {
-#if !defined(DEAL_II_WITH_ZLIB)
-    stream << start << '\t'
-           << start+d1;
-    if (dim>=2)
+    if (collect_data() == false)
       {
-        stream << '\t' << start+d2+d1
-               << '\t' << start+d2;
-        if (dim>=3)
+        stream << start << '\t'
+               << start+d1;
+        if (dim>=2)
           {
-            stream << '\t' << start+d3
-                   << '\t' << start+d3+d1
-                   << '\t' << start+d3+d2+d1
-                   << '\t' << start+d3+d2;
+            stream << '\t' << start+d2+d1
+                   << '\t' << start+d2;
+            if (dim>=3)
+              {
+                stream << '\t' << start+d3
+                       << '\t' << start+d3+d1
+                       << '\t' << start+d3+d2+d1
+                       << '\t' << start+d3+d2;
+              }
           }
+        stream << '\n';
       }
-    stream << '\n';
-#else
-    cells.push_back (start);
-    cells.push_back (start+d1);
-    if (dim>=2)
+    else
       {
-        cells.push_back (start+d2+d1);
-        cells.push_back (start+d2);
-        if (dim>=3)
+        cells.push_back (start);
+        cells.push_back (start+d1);
+        if (dim>=2)
           {
-            cells.push_back (start+d3);
-            cells.push_back (start+d3+d1);
-            cells.push_back (start+d3+d2+d1);
-            cells.push_back (start+d3+d2);
+            cells.push_back (start+d2+d1);
+            cells.push_back (start+d2);
+            if (dim>=3)
+              {
+                cells.push_back (start+d3);
+                cells.push_back (start+d3+d1);
+                cells.push_back (start+d3+d2+d1);
+                cells.push_back (start+d3+d2);
+              }
           }
       }
-#endif
   }
 
 
@@ -1466,13 +1694,14 @@ namespace
   void
   VtuStream::flush_cells ()
   {
-#ifdef DEAL_II_WITH_ZLIB
-    // compress the data we have in
-    // memory and write them to the
-    // stream. then release the data
-    *this << cells << '\n';
-    cells.clear ();
-#endif
+    if (collect_data())
+      {
+        // compress the data we have in
+        // memory and write them to the
+        // stream. then release the data
+        *this << cells << '\n';
+        cells.clear ();
+      }
   }
 
 
@@ -1480,6 +1709,12 @@ namespace
   std::ostream &
   VtuStream::operator<< (const std::vector<T> &data)
   {
+    if (appended_data != 0)
+      {
+        append_raw_block (data, flags, *appended_data);
+        return stream;
+      }
+
 #ifdef DEAL_II_WITH_ZLIB
     // compress the data we have in
     // memory and write them to the
@@ -1492,6 +1727,85 @@ namespace
 
     return stream;
   }
+
+
+
+  /**
+   * A class with the interface of the stream classes above that writes the
+   * points and cells of the patches into the arrays of a
+   * DataOutBase::FlatData object, which need to have the right size
+   * already.
+   */
+  class FlatDataStream
+  {
+  public:
+    FlatDataStream (DataOutBase::FlatData &flat_data);
+
+    template <int dim>
+    void write_point (const unsigned int index,
+                      const Point<dim> &);
+
+    void flush_points () {}
+
+    template <int dim>
+    void write_cell (const unsigned int index,
+                     const unsigned int start,
+                     const unsigned int x_offset,
+                     const unsigned int y_offset,
+                     const unsigned int z_offset);
+
+    void flush_cells () {}
+
+  private:
+    DataOutBase::FlatData &flat_data;
+  };
+
+
+
+  FlatDataStream::FlatDataStream (DataOutBase::FlatData &flat_data)
+    :
+    flat_data (flat_data)
+  {}
+
+
+
+  template <int dim>
+  void
+  FlatDataStream::write_point (const unsigned int index,
+                               const Point<dim>  &p)
+  {
+    Assert (3*index+2 < flat_data.points.size(), ExcInternalError());
+    for (unsigned int i=0; i<dim; ++i)
+      flat_data.points[3*index+i] = p[i];
+  }
+
+
+
+  template <int dim>
+  void
+  FlatDataStream::write_cell (const unsigned int index,
+                              const unsigned int start,
+                              const unsigned int d1,
+                              const unsigned int d2,
+                              const unsigned int d3)
+  {
+    // use the same order of vertices as the VTU writer
+    unsigned int *cell = &flat_data.connectivity[index*GeometryInfo<dim>::vertices_per_cell];
+    cell[0] = start;
+    cell[1] = start+d1;
+    if (dim>=2)
+      {
+        cell[2] = start+d2+d1;
+        cell[3] = start+d2;
+        if (dim>=3)
+          {
+            cell[4] = start+d3;
+            cell[5] = start+d3+d1;
+            cell[6] = start+d3+d2+d1;
+            cell[7] = start+d3+d2;
+          }
+      }
+  }
 }
 
 
@@ -2015,12 +2329,14 @@ namespace DataOutBase
   VtkFlags::VtkFlags (const double time,
                       const unsigned int cycle,
                       const bool print_date_and_time,
-                      const VtkFlags::ZlibCompressionLevel compression_level)
+                      const VtkFlags::ZlibCompressionLevel compression_level,
+                      const bool write_raw_appended_data)
     :
     time (time),
     cycle (cycle),
     print_date_and_time (print_date_and_time),
-    compression_level (compression_level)
+    compression_level (compression_level),
+    write_raw_appended_data (write_raw_appended_data)
   {}
 
 
@@ -4919,387 +5235,433 @@ namespace DataOutBase
 
 
 
-  template <int dim, int spacedim>
-  void
-  write_vtu (const std::vector<Patch<dim,spacedim> > &patches,
-             const std::vector<std::string>          &data_names,
-             const std::vector<std_cxx11::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
-             const VtkFlags                          &flags,
-             std::ostream                            &out)
-  {
-    write_vtu_header(out, flags);
-    write_vtu_main (patches, data_names, vector_data_ranges, flags, out);
-    write_vtu_footer(out);
-
-    out << std::flush;
-  }
-
-
-  template <int dim, int spacedim>
-  void write_vtu_main (const std::vector<Patch<dim,spacedim> > &patches,
-                       const std::vector<std::string>          &data_names,
-                       const std::vector<std_cxx11::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
-                       const VtkFlags                          &flags,
-                       std::ostream                            &out)
+  namespace
   {
-    AssertThrow (out, ExcIO());
+    /**
+     * Write the main part of a vtu file. If @p appended_data is not a null
+     * pointer, the data arrays are appended to it in raw binary form rather
+     * than written inline.
+     */
+    template <int dim, int spacedim>
+    void write_vtu_piece (const std::vector<Patch<dim,spacedim> > &patches,
+                          const std::vector<std::string>          &data_names,
+                          const std::vector<std_cxx11::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
+                          const VtkFlags                          &flags,
+                          std::ostream                            &out,
+                          std::vector<char>                       *appended_data)
+    {
+      AssertThrow (out, ExcIO());
 
 #ifndef DEAL_II_WITH_MPI
-    // verify that there are indeed
-    // patches to be written out. most
-    // of the times, people just forget
-    // to call build_patches when there
-    // are no patches, so a warning is
-    // in order. that said, the
-    // assertion is disabled if we
-    // support MPI since then it can
-    // happen that on the coarsest
-    // mesh, a processor simply has no
-    // cells it actually owns, and in
-    // that case it is legit if there
-    // are no patches
-    Assert (patches.size() > 0, ExcNoPatches());
+      // verify that there are indeed
+      // patches to be written out. most
+      // of the times, people just forget
+      // to call build_patches when there
+      // are no patches, so a warning is
+      // in order. that said, the
+      // assertion is disabled if we
+      // support MPI since then it can
+      // happen that on the coarsest
+      // mesh, a processor simply has no
+      // cells it actually owns, and in
+      // that case it is legit if there
+      // are no patches
+      Assert (patches.size() > 0, ExcNoPatches());
 #else
-    if (patches.size() == 0)
-      {
-        // we still need to output a valid vtu file, because other CPUs
-        // might output data. This is the minimal file that is accepted by paraview and visit.
-        // if we remove the field definitions, visit is complaining.
-        out << "<Piece NumberOfPoints=\"0\" NumberOfCells=\"0\" >\n"
-            << "<Cells>\n"
-            << "<DataArray type=\"UInt8\" Name=\"types\"></DataArray>\n"
-            << "</Cells>\n"
-            << "  <PointData Scalars=\"scalars\">\n";
-        std::vector<bool> data_set_written (data_names.size(), false);
-        for (unsigned int n_th_vector=0; n_th_vector<vector_data_ranges.size(); ++n_th_vector)
-          {
-            // mark these components as already
-            // written:
-            for (unsigned int i=std_cxx11::get<0>(vector_data_ranges[n_th_vector]);
-                 i<=std_cxx11::get<1>(vector_data_ranges[n_th_vector]);
-                 ++i)
-              data_set_written[i] = true;
+      if (patches.size() == 0)
+        {
+          // we still need to output a valid vtu file, because other CPUs
+          // might output data. This is the minimal file that is accepted by paraview and visit.
+          // if we remove the field definitions, visit is complaining.
+          out << "<Piece NumberOfPoints=\"0\" NumberOfCells=\"0\" >\n"
+              << "<Cells>\n"
+              << "<DataArray type=\"UInt8\" Name=\"types\"></DataArray>\n"
+              << "</Cells>\n"
+              << "  <PointData Scalars=\"scalars\">\n";
+          std::vector<bool> data_set_written (data_names.size(), false);
+          for (unsigned int n_th_vector=0; n_th_vector<vector_data_ranges.size(); ++n_th_vector)
+            {
+              // mark these components as already
+              // written:
+              for (unsigned int i=std_cxx11::get<0>(vector_data_ranges[n_th_vector]);
+                   i<=std_cxx11::get<1>(vector_data_ranges[n_th_vector]);
+                   ++i)
+                data_set_written[i] = true;
+
+              // write the
+              // header. concatenate all the
+              // component names with double
+              // underscores unless a vector
+              // name has been specified
+              out << "    <DataArray type=\"Float64\" Name=\"";
+
+              if (std_cxx11::get<2>(vector_data_ranges[n_th_vector]) != "")
+                out << std_cxx11::get<2>(vector_data_ranges[n_th_vector]);
+              else
+                {
+                  for (unsigned int i=std_cxx11::get<0>(vector_data_ranges[n_th_vector]);
+                       i<std_cxx11::get<1>(vector_data_ranges[n_th_vector]);
+                       ++i)
+                    out << data_names[i] << "__";
+                  out << data_names[std_cxx11::get<1>(vector_data_ranges[n_th_vector])];
+                }
 
-            // write the
-            // header. concatenate all the
-            // component names with double
-            // underscores unless a vector
-            // name has been specified
-            out << "    <DataArray type=\"Float64\" Name=\"";
+              out << "\" NumberOfComponents=\"3\"></DataArray>\n";
+            }
 
-            if (std_cxx11::get<2>(vector_data_ranges[n_th_vector]) != "")
-              out << std_cxx11::get<2>(vector_data_ranges[n_th_vector]);
-            else
+          for (unsigned int data_set=0; data_set<data_names.size(); ++data_set)
+            if (data_set_written[data_set] == false)
               {
-                for (unsigned int i=std_cxx11::get<0>(vector_data_ranges[n_th_vector]);
-                     i<std_cxx11::get<1>(vector_data_ranges[n_th_vector]);
-                     ++i)
-                  out << data_names[i] << "__";
-                out << data_names[std_cxx11::get<1>(vector_data_ranges[n_th_vector])];
+                out << "    <DataArray type=\"Float64\" Name=\""
+                    << data_names[data_set]
+                    << "\"></DataArray>\n";
               }
 
-            out << "\" NumberOfComponents=\"3\"></DataArray>\n";
-          }
-
-        for (unsigned int data_set=0; data_set<data_names.size(); ++data_set)
-          if (data_set_written[data_set] == false)
-            {
-              out << "    <DataArray type=\"Float64\" Name=\""
-                  << data_names[data_set]
-                  << "\"></DataArray>\n";
-            }
-
-        out << "  </PointData>\n";
-        out << "</Piece>\n";
+          out << "  </PointData>\n";
+          out << "</Piece>\n";
 
-        out << std::flush;
+          out << std::flush;
 
-        return;
-      }
+          return;
+        }
 #endif
 
-    // first up: metadata
-    //
-    // if desired, output time and cycle of the simulation, following
-    // the instructions at
-    // http://www.visitusers.org/index.php?title=Time_and_Cycle_in_VTK_files
-    {
-      const unsigned int
-      n_metadata = ((flags.cycle != std::numeric_limits<unsigned int>::min() ? 1 : 0)
-                    +
-                    (flags.time != std::numeric_limits<double>::min() ? 1 : 0));
-      if (n_metadata > 0)
-        out << "<FieldData>\n";
+      // first up: metadata
+      //
+      // if desired, output time and cycle of the simulation, following
+      // the instructions at
+      // http://www.visitusers.org/index.php?title=Time_and_Cycle_in_VTK_files
+      {
+        const unsigned int
+        n_metadata = ((flags.cycle != std::numeric_limits<unsigned int>::min() ? 1 : 0)
+                      +
+                      (flags.time != std::numeric_limits<double>::min() ? 1 : 0));
+        if (n_metadata > 0)
+          out << "<FieldData>\n";
+
+        if (flags.cycle != std::numeric_limits<unsigned int>::min())
+          {
+            out << "<DataArray type=\"Float32\" Name=\"CYCLE\" NumberOfTuples=\"1\" format=\"ascii\">"
+                << flags.cycle
+                << "</DataArray>\n";
+          }
+        if (flags.time != std::numeric_limits<double>::min())
+          {
+            out << "<DataArray type=\"Float32\" Name=\"TIME\" NumberOfTuples=\"1\" format=\"ascii\">"
+                << flags.time
+                << "</DataArray>\n";
+          }
 
-      if (flags.cycle != std::numeric_limits<unsigned int>::min())
+        if (n_metadata > 0)
+          out << "</FieldData>\n";
+      }
+
+
+      VtuStream vtu_out(out, flags, appended_data);
+
+      const unsigned int n_data_sets = data_names.size();
+      // check against # of data sets in
+      // first patch. checks against all
+      // other patches are made in
+      // write_gmv_reorder_data_vectors
+      if (patches[0].points_are_available)
         {
-          out << "<DataArray type=\"Float32\" Name=\"CYCLE\" NumberOfTuples=\"1\" format=\"ascii\">"
-              << flags.cycle
-              << "</DataArray>\n";
+          AssertDimension(n_data_sets + spacedim, patches[0].data.n_rows())
         }
-      if (flags.time != std::numeric_limits<double>::min())
+      else
         {
-          out << "<DataArray type=\"Float32\" Name=\"TIME\" NumberOfTuples=\"1\" format=\"ascii\">"
-              << flags.time
-              << "</DataArray>\n";
+          AssertDimension(n_data_sets, patches[0].data.n_rows())
         }
 
-      if (n_metadata > 0)
-        out << "</FieldData>\n";
-    }
-
-
-    VtuStream vtu_out(out, flags);
+      // first count the number of cells
+      // and cells for later use
+      unsigned int n_nodes;
+      unsigned int n_cells;
+      compute_sizes<dim,spacedim>(patches, n_nodes, n_cells);
+      // in gmv format the vertex
+      // coordinates and the data have an
+      // order that is a bit unpleasant
+      // (first all x coordinates, then
+      // all y coordinate, ...; first all
+      // data of variable 1, then
+      // variable 2, etc), so we have to
+      // copy the data vectors a bit around
+      //
+      // note that we copy vectors when
+      // looping over the patches since we
+      // have to write them one variable
+      // at a time and don't want to use
+      // more than one loop
+      //
+      // this copying of data vectors can
+      // be done while we already output
+      // the vertices, so do this on a
+      // separate task and when wanting
+      // to write out the data, we wait
+      // for that task to finish
+      Table<2,double> data_vectors (n_data_sets, n_nodes);
+
+      void (*fun_ptr) (const std::vector<Patch<dim,spacedim> > &,
+                       Table<2,double> &)
+        = &write_gmv_reorder_data_vectors<dim,spacedim>;
+      Threads::Task<> reorder_task = Threads::new_task (fun_ptr, patches,
+                                                        data_vectors);
+
+      ///////////////////////////////
+      // first make up a list of used
+      // vertices along with their
+      // coordinates
+      //
+      // note that according to the standard, we
+      // have to print d=1..3 dimensions, even if
+      // we are in reality in 2d, for example
+      out << "<Piece NumberOfPoints=\"" << n_nodes
+          <<"\" NumberOfCells=\"" << n_cells << "\" >\n";
+      out << "  <Points>\n";
+      out << "    <DataArray type=\"Float64\" NumberOfComponents=\"3\" "
+          << vtu_out.format_attribute() << ">\n";
+      write_nodes(patches, vtu_out);
+      out << "    </DataArray>\n";
+      out << "  </Points>\n\n";
+      /////////////////////////////////
+      // now for the cells
+      out << "  <Cells>\n";
+      out << "    <DataArray type=\"Int32\" Name=\"connectivity\" "
+          << vtu_out.format_attribute() << ">\n";
+      write_cells(patches, vtu_out);
+      out << "    </DataArray>\n";
+
+      // XML VTU format uses offsets; this is
+      // different than the VTK format, which
+      // puts the number of nodes per cell in
+      // front of the connectivity list.
+      out << "    <DataArray type=\"Int32\" Name=\"offsets\" "
+          << vtu_out.format_attribute() << ">\n";
+
+      std::vector<int32_t> offsets (n_cells);
+      for (unsigned int i=0; i<n_cells; ++i)
+        offsets[i] = (i+1)*GeometryInfo<dim>::vertices_per_cell;
+      vtu_out << offsets;
+      out << "\n";
+      out << "    </DataArray>\n";
+
+      // next output the types of the
+      // cells. since all cells are
+      // the same, this is simple
+      out << "    <DataArray type=\"UInt8\" Name=\"types\" "
+          << vtu_out.format_attribute() << ">\n";
 
-    const unsigned int n_data_sets = data_names.size();
-    // check against # of data sets in
-    // first patch. checks against all
-    // other patches are made in
-    // write_gmv_reorder_data_vectors
-    if (patches[0].points_are_available)
-      {
-        AssertDimension(n_data_sets + spacedim, patches[0].data.n_rows())
-      }
-    else
       {
-        AssertDimension(n_data_sets, patches[0].data.n_rows())
-      }
-
+        // uint8_t might be a typedef to unsigned
+        // char which is then not printed as
+        // ascii integers
 #ifdef DEAL_II_WITH_ZLIB
-    const char *ascii_or_binary = "binary";
+        const bool binary_cell_types = true;
 #else
-    const char *ascii_or_binary = "ascii";
+        const bool binary_cell_types = (appended_data != 0);
 #endif
+        if (binary_cell_types)
+          {
+            std::vector<uint8_t> cell_types (n_cells,
+                                             static_cast<uint8_t>(vtk_cell_type[dim]));
+            // this should compress well :-)
+            vtu_out << cell_types;
+          }
+        else
+          {
+            std::vector<unsigned int> cell_types (n_cells,
+                                                  vtk_cell_type[dim]);
+            vtu_out << cell_types;
+          }
+      }
+      out << "\n";
+      out << "    </DataArray>\n";
+      out << "  </Cells>\n";
+
+
+      ///////////////////////////////////////
+      // data output.
+
+      // now write the data vectors to
+      // @p{out} first make sure that all
+      // data is in place
+      reorder_task.join ();
+
+      // then write data.  the
+      // 'POINT_DATA' means: node data
+      // (as opposed to cell data, which
+      // we do not support explicitly
+      // here). all following data sets
+      // are point data
+      out << "  <PointData Scalars=\"scalars\">\n";
+
+      // when writing, first write out
+      // all vector data, then handle the
+      // scalar data sets that have been
+      // left over
+      std::vector<bool> data_set_written (n_data_sets, false);
+      for (unsigned int n_th_vector=0; n_th_vector<vector_data_ranges.size(); ++n_th_vector)
+        {
+          AssertThrow (std_cxx11::get<1>(vector_data_ranges[n_th_vector]) >=
+                       std_cxx11::get<0>(vector_data_ranges[n_th_vector]),
+                       ExcLowerRange (std_cxx11::get<1>(vector_data_ranges[n_th_vector]),
+                                      std_cxx11::get<0>(vector_data_ranges[n_th_vector])));
+          AssertThrow (std_cxx11::get<1>(vector_data_ranges[n_th_vector]) < n_data_sets,
+                       ExcIndexRange (std_cxx11::get<1>(vector_data_ranges[n_th_vector]),
+                                      0, n_data_sets));
+          AssertThrow (std_cxx11::get<1>(vector_data_ranges[n_th_vector]) + 1
+                       - std_cxx11::get<0>(vector_data_ranges[n_th_vector]) <= 3,
+                       ExcMessage ("Can't declare a vector with more than 3 components "
+                                   "in VTK"));
+
+          // mark these components as already
+          // written:
+          for (unsigned int i=std_cxx11::get<0>(vector_data_ranges[n_th_vector]);
+               i<=std_cxx11::get<1>(vector_data_ranges[n_th_vector]);
+               ++i)
+            data_set_written[i] = true;
 
+          // write the
+          // header. concatenate all the
+          // component names with double
+          // underscores unless a vector
+          // name has been specified
+          out << "    <DataArray type=\"Float64\" Name=\"";
 
-    // first count the number of cells
-    // and cells for later use
-    unsigned int n_nodes;
-    unsigned int n_cells;
-    compute_sizes<dim,spacedim>(patches, n_nodes, n_cells);
-    // in gmv format the vertex
-    // coordinates and the data have an
-    // order that is a bit unpleasant
-    // (first all x coordinates, then
-    // all y coordinate, ...; first all
-    // data of variable 1, then
-    // variable 2, etc), so we have to
-    // copy the data vectors a bit around
-    //
-    // note that we copy vectors when
-    // looping over the patches since we
-    // have to write them one variable
-    // at a time and don't want to use
-    // more than one loop
-    //
-    // this copying of data vectors can
-    // be done while we already output
-    // the vertices, so do this on a
-    // separate task and when wanting
-    // to write out the data, we wait
-    // for that task to finish
-    Table<2,double> data_vectors (n_data_sets, n_nodes);
-
-    void (*fun_ptr) (const std::vector<Patch<dim,spacedim> > &,
-                     Table<2,double> &)
-      = &write_gmv_reorder_data_vectors<dim,spacedim>;
-    Threads::Task<> reorder_task = Threads::new_task (fun_ptr, patches,
-                                                      data_vectors);
-
-    ///////////////////////////////
-    // first make up a list of used
-    // vertices along with their
-    // coordinates
-    //
-    // note that according to the standard, we
-    // have to print d=1..3 dimensions, even if
-    // we are in reality in 2d, for example
-    out << "<Piece NumberOfPoints=\"" << n_nodes
-        <<"\" NumberOfCells=\"" << n_cells << "\" >\n";
-    out << "  <Points>\n";
-    out << "    <DataArray type=\"Float64\" NumberOfComponents=\"3\" format=\""
-        << ascii_or_binary << "\">\n";
-    write_nodes(patches, vtu_out);
-    out << "    </DataArray>\n";
-    out << "  </Points>\n\n";
-    /////////////////////////////////
-    // now for the cells
-    out << "  <Cells>\n";
-    out << "    <DataArray type=\"Int32\" Name=\"connectivity\" format=\""
-        << ascii_or_binary << "\">\n";
-    write_cells(patches, vtu_out);
-    out << "    </DataArray>\n";
-
-    // XML VTU format uses offsets; this is
-    // different than the VTK format, which
-    // puts the number of nodes per cell in
-    // front of the connectivity list.
-    out << "    <DataArray type=\"Int32\" Name=\"offsets\" format=\""
-        << ascii_or_binary << "\">\n";
-
-    std::vector<int32_t> offsets (n_cells);
-    for (unsigned int i=0; i<n_cells; ++i)
-      offsets[i] = (i+1)*GeometryInfo<dim>::vertices_per_cell;
-    vtu_out << offsets;
-    out << "\n";
-    out << "    </DataArray>\n";
-
-    // next output the types of the
-    // cells. since all cells are
-    // the same, this is simple
-    out << "    <DataArray type=\"UInt8\" Name=\"types\" format=\""
-        << ascii_or_binary << "\">\n";
-
-    {
-      // uint8_t might be a typedef to unsigned
-      // char which is then not printed as
-      // ascii integers
-#ifdef DEAL_II_WITH_ZLIB
-      std::vector<uint8_t> cell_types (n_cells,
-                                       static_cast<uint8_t>(vtk_cell_type[dim]));
-#else
-      std::vector<unsigned int> cell_types (n_cells,
-                                            vtk_cell_type[dim]);
-#endif
-      // this should compress well :-)
-      vtu_out << cell_types;
-    }
-    out << "\n";
-    out << "    </DataArray>\n";
-    out << "  </Cells>\n";
-
-
-    ///////////////////////////////////////
-    // data output.
+          if (std_cxx11::get<2>(vector_data_ranges[n_th_vector]) != "")
+            out << std_cxx11::get<2>(vector_data_ranges[n_th_vector]);
+          else
+            {
+              for (unsigned int i=std_cxx11::get<0>(vector_data_ranges[n_th_vector]);
+                   i<std_cxx11::get<1>(vector_data_ranges[n_th_vector]);
+                   ++i)
+                out << data_names[i] << "__";
+              out << data_names[std_cxx11::get<1>(vector_data_ranges[n_th_vector])];
+            }
 
-    // now write the data vectors to
-    // @p{out} first make sure that all
-    // data is in place
-    reorder_task.join ();
+          out << "\" NumberOfComponents=\"3\" "
+              << vtu_out.format_attribute() << ">\n";
 
-    // then write data.  the
-    // 'POINT_DATA' means: node data
-    // (as opposed to cell data, which
-    // we do not support explicitly
-    // here). all following data sets
-    // are point data
-    out << "  <PointData Scalars=\"scalars\">\n";
+          // now write data. pad all
+          // vectors to have three
+          // components
+          std::vector<double> data;
+          data.reserve (n_nodes*dim);
 
-    // when writing, first write out
-    // all vector data, then handle the
-    // scalar data sets that have been
-    // left over
-    std::vector<bool> data_set_written (n_data_sets, false);
-    for (unsigned int n_th_vector=0; n_th_vector<vector_data_ranges.size(); ++n_th_vector)
-      {
-        AssertThrow (std_cxx11::get<1>(vector_data_ranges[n_th_vector]) >=
-                     std_cxx11::get<0>(vector_data_ranges[n_th_vector]),
-                     ExcLowerRange (std_cxx11::get<1>(vector_data_ranges[n_th_vector]),
-                                    std_cxx11::get<0>(vector_data_ranges[n_th_vector])));
-        AssertThrow (std_cxx11::get<1>(vector_data_ranges[n_th_vector]) < n_data_sets,
-                     ExcIndexRange (std_cxx11::get<1>(vector_data_ranges[n_th_vector]),
-                                    0, n_data_sets));
-        AssertThrow (std_cxx11::get<1>(vector_data_ranges[n_th_vector]) + 1
-                     - std_cxx11::get<0>(vector_data_ranges[n_th_vector]) <= 3,
-                     ExcMessage ("Can't declare a vector with more than 3 components "
-                                 "in VTK"));
+          for (unsigned int n=0; n<n_nodes; ++n)
+            {
+              switch (std_cxx11::get<1>(vector_data_ranges[n_th_vector]) -
+                      std_cxx11::get<0>(vector_data_ranges[n_th_vector]))
+                {
+                case 0:
+                  data.push_back (data_vectors(std_cxx11::get<0>(vector_data_ranges[n_th_vector]), n));
+                  data.push_back (0);
+                  data.push_back (0);
+                  break;
 
-        // mark these components as already
-        // written:
-        for (unsigned int i=std_cxx11::get<0>(vector_data_ranges[n_th_vector]);
-             i<=std_cxx11::get<1>(vector_data_ranges[n_th_vector]);
-             ++i)
-          data_set_written[i] = true;
+                case 1:
+                  data.push_back (data_vectors(std_cxx11::get<0>(vector_data_ranges[n_th_vector]),   n));
+                  data.push_back (data_vectors(std_cxx11::get<0>(vector_data_ranges[n_th_vector])+1, n));
+                  data.push_back (0);
+                  break;
+                case 2:
+                  data.push_back (data_vectors(std_cxx11::get<0>(vector_data_ranges[n_th_vector]),   n));
+                  data.push_back (data_vectors(std_cxx11::get<0>(vector_data_ranges[n_th_vector])+1, n));
+                  data.push_back (data_vectors(std_cxx11::get<0>(vector_data_ranges[n_th_vector])+2, n));
+                  break;
 
-        // write the
-        // header. concatenate all the
-        // component names with double
-        // underscores unless a vector
-        // name has been specified
-        out << "    <DataArray type=\"Float64\" Name=\"";
+                default:
+                  // VTK doesn't
+                  // support
+                  // anything else
+                  // than vectors
+                  // with 1, 2, or
+                  // 3 components
+                  Assert (false, ExcInternalError());
+                }
+            }
+          vtu_out << data;
+          out << "    </DataArray>\n";
+        }
 
-        if (std_cxx11::get<2>(vector_data_ranges[n_th_vector]) != "")
-          out << std_cxx11::get<2>(vector_data_ranges[n_th_vector]);
-        else
+      // now do the left over scalar data sets
+      for (unsigned int data_set=0; data_set<n_data_sets; ++data_set)
+        if (data_set_written[data_set] == false)
           {
-            for (unsigned int i=std_cxx11::get<0>(vector_data_ranges[n_th_vector]);
-                 i<std_cxx11::get<1>(vector_data_ranges[n_th_vector]);
-                 ++i)
-              out << data_names[i] << "__";
-            out << data_names[std_cxx11::get<1>(vector_data_ranges[n_th_vector])];
+            out << "    <DataArray type=\"Float64\" Name=\""
+                << data_names[data_set]
+                << "\" "
+                << vtu_out.format_attribute() << ">\n";
+
+            std::vector<double> data (data_vectors[data_set].begin(),
+                                      data_vectors[data_set].end());
+            vtu_out << data;
+            out << "    </DataArray>\n";
           }
 
-        out << "\" NumberOfComponents=\"3\" format=\""
-            << ascii_or_binary << "\">\n";
+      out << "  </PointData>\n";
 
-        // now write data. pad all
-        // vectors to have three
-        // components
-        std::vector<double> data;
-        data.reserve (n_nodes*dim);
+      // Finish up writing a valid XML file
+      out << " </Piece>\n";
 
-        for (unsigned int n=0; n<n_nodes; ++n)
-          {
-            switch (std_cxx11::get<1>(vector_data_ranges[n_th_vector]) -
-                    std_cxx11::get<0>(vector_data_ranges[n_th_vector]))
-              {
-              case 0:
-                data.push_back (data_vectors(std_cxx11::get<0>(vector_data_ranges[n_th_vector]), n));
-                data.push_back (0);
-                data.push_back (0);
-                break;
+      // make sure everything now gets to
+      // disk
+      out.flush ();
 
-              case 1:
-                data.push_back (data_vectors(std_cxx11::get<0>(vector_data_ranges[n_th_vector]),   n));
-                data.push_back (data_vectors(std_cxx11::get<0>(vector_data_ranges[n_th_vector])+1, n));
-                data.push_back (0);
-                break;
-              case 2:
-                data.push_back (data_vectors(std_cxx11::get<0>(vector_data_ranges[n_th_vector]),   n));
-                data.push_back (data_vectors(std_cxx11::get<0>(vector_data_ranges[n_th_vector])+1, n));
-                data.push_back (data_vectors(std_cxx11::get<0>(vector_data_ranges[n_th_vector])+2, n));
-                break;
+      // assert the stream is still ok
+      AssertThrow (out, ExcIO());
+    }
+  }
 
-              default:
-                // VTK doesn't
-                // support
-                // anything else
-                // than vectors
-                // with 1, 2, or
-                // 3 components
-                Assert (false, ExcInternalError());
-              }
-          }
-        vtu_out << data;
-        out << "    </DataArray>\n";
-      }
 
-    // now do the left over scalar data sets
-    for (unsigned int data_set=0; data_set<n_data_sets; ++data_set)
-      if (data_set_written[data_set] == false)
-        {
-          out << "    <DataArray type=\"Float64\" Name=\""
-              << data_names[data_set]
-              << "\" format=\""
-              << ascii_or_binary << "\">\n";
 
-          std::vector<double> data (data_vectors[data_set].begin(),
-                                    data_vectors[data_set].end());
-          vtu_out << data;
-          out << "    </DataArray>\n";
-        }
+  template <int dim, int spacedim>
+  void write_vtu_main (const std::vector<Patch<dim,spacedim> > &patches,
+                       const std::vector<std::string>          &data_names,
+                       const std::vector<std_cxx11::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
+                       const VtkFlags                          &flags,
+                       std::ostream                            &out)
+  {
+    write_vtu_piece (patches, data_names, vector_data_ranges, flags, out,
+                     static_cast<std::vector<char> *>(0));
+  }
 
-    out << "  </PointData>\n";
 
-    // Finish up writing a valid XML file
-    out << " </Piece>\n";
 
-    // make sure everything now gets to
-    // disk
-    out.flush ();
+  template <int dim, int spacedim>
+  void
+  write_vtu (const std::vector<Patch<dim,spacedim> > &patches,
+             const std::vector<std::string>          &data_names,
+             const std::vector<std_cxx11::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
+             const VtkFlags                          &flags,
+             std::ostream                            &out)
+  {
+    write_vtu_header(out, flags);
+    if (flags.write_raw_appended_data == false)
+      {
+        write_vtu_main (patches, data_names, vector_data_ranges, flags, out);
+        write_vtu_footer(out);
+      }
+    else
+      {
+        // collect the data arrays while writing the main part, and write
+        // them after the end of the grid description. the underscore marks
+        // the start of the raw data, to which the offsets of the data arrays
+        // refer
+        std::vector<char> appended_data;
+        write_vtu_piece (patches, data_names, vector_data_ranges, flags, out,
+                         &appended_data);
+
+        out << " </UnstructuredGrid>\n";
+        out << " <AppendedData encoding=\"raw\">\n_";
+        if (appended_data.size() > 0)
+          out.write (&appended_data[0], appended_data.size());
+        out << "\n </AppendedData>\n";
+        out << "</VTKFile>\n";
+        AssertThrow (out, ExcIO());
+      }
 
-    // assert the stream is still ok
-    AssertThrow (out, ExcIO());
+    out << std::flush;
   }
 
 
@@ -6202,6 +6564,58 @@ void DataOutInterface<dim,spacedim>::write_vtu_in_parallel (const char *filename
 }
 
 
+
+namespace
+{
+  // a copy of everything DataOutBase::write_vtu() needs, so that a file can
+  // be written in the background while the object the data was taken from
+  // is changed or destroyed
+  template <int dim, int spacedim>
+  struct VtuSnapshot
+  {
+    std::vector<DataOutBase::Patch<dim,spacedim> > patches;
+    std::vector<std::string> data_names;
+    std::vector<std_cxx11::tuple<unsigned int, unsigned int, std::string> > vector_data_ranges;
+    DataOutBase::VtkFlags flags;
+  };
+
+
+
+  template <int dim, int spacedim>
+  void
+  write_vtu_snapshot (const std_cxx11::shared_ptr<const VtuSnapshot<dim,spacedim> > snapshot,
+                      std::ostream &out)
+  {
+    DataOutBase::write_vtu (snapshot->patches, snapshot->data_names,
+                            snapshot->vector_data_ranges,
+                            snapshot->flags, out);
+  }
+}
+
+
+
+template <int dim, int spacedim>
+void
+DataOutInterface<dim,spacedim>::
+write_vtu_in_background (BackgroundWriter  &writer,
+                         const std::string &filename) const
+{
+  std_cxx11::shared_ptr<VtuSnapshot<dim,spacedim> >
+  snapshot (new VtuSnapshot<dim,spacedim>());
+  snapshot->patches            = get_patches();
+  snapshot->data_names         = get_dataset_names();
+  snapshot->vector_data_ranges = get_vector_data_ranges();
+  snapshot->flags              = vtk_flags;
+
+  const std::size_t memory = MemoryConsumption::memory_consumption (snapshot->patches);
+  writer.write (filename,
+                std_cxx11::bind (&write_vtu_snapshot<dim,spacedim>,
+                                 std_cxx11::shared_ptr<const VtuSnapshot<dim,spacedim> >(snapshot),
+                                 std_cxx11::_1),
+                memory);
+}
+
+
 template <int dim, int spacedim>
 void
 DataOutInterface<dim,spacedim>::
@@ -6451,46 +6865,137 @@ create_xdmf_entry (const DataOutBase::DataOutFilter &data_filter,
     }
 }
 
+namespace
+{
+  // write the given XDMF entries into an XDMF file on the root process of
+  // the given communicator
+  void write_xdmf_entries (const std::vector<XDMFEntry> &entries,
+                           const std::string            &filename,
+                           MPI_Comm                      comm)
+  {
+    int             myrank;
+
+#ifdef DEAL_II_WITH_MPI
+    MPI_Comm_rank(comm, &myrank);
+#else
+    (void)comm;
+    myrank = 0;
+#endif
+
+    // Only rank 0 process writes the XDMF file
+    if (myrank == 0)
+      {
+        std::ofstream                               xdmf_file(filename.c_str());
+        std::vector<XDMFEntry>::const_iterator      it;
+
+        xdmf_file << "<?xml version=\"1.0\" ?>\n";
+        xdmf_file << "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n";
+        xdmf_file << "<Xdmf Version=\"2.0\">\n";
+        xdmf_file << "  <Domain>\n";
+        xdmf_file << "    <Grid Name=\"CellTime\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+
+        // Write out all the entries indented
+        for (it=entries.begin(); it!=entries.end(); ++it)
+          xdmf_file << it->get_xdmf_content(3);
+
+        xdmf_file << "    </Grid>\n";
+        xdmf_file << "  </Domain>\n";
+        xdmf_file << "</Xdmf>\n";
+
+        xdmf_file.close();
+      }
+  }
+}
+
+
+
 template <int dim, int spacedim>
 void DataOutInterface<dim,spacedim>::
 write_xdmf_file (const std::vector<XDMFEntry> &entries,
                  const std::string &filename,
                  MPI_Comm comm) const
 {
-  int             myrank;
+  write_xdmf_entries (entries, filename, comm);
+}
 
-#ifdef DEAL_II_WITH_MPI
-  MPI_Comm_rank(comm, &myrank);
-#else
-  (void)comm;
-  myrank = 0;
-#endif
 
-  // Only rank 0 process writes the XDMF file
-  if (myrank == 0)
-    {
-      std::ofstream                               xdmf_file(filename.c_str());
-      std::vector<XDMFEntry>::const_iterator      it;
 
-      xdmf_file << "<?xml version=\"1.0\" ?>\n";
-      xdmf_file << "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n";
-      xdmf_file << "<Xdmf Version=\"2.0\">\n";
-      xdmf_file << "  <Domain>\n";
-      xdmf_file << "    <Grid Name=\"CellTime\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+XDMFTimeSeries::XDMFTimeSeries (const std::string &filename_prefix,
+                                MPI_Comm           comm)
+  :
+  filename_prefix (filename_prefix),
+  comm (comm),
+  n_meshes (0)
+{}
 
-      // Write out all the entries indented
-      for (it=entries.begin(); it!=entries.end(); ++it)
-        xdmf_file << it->get_xdmf_content(3);
 
-      xdmf_file << "    </Grid>\n";
-      xdmf_file << "  </Domain>\n";
-      xdmf_file << "</Xdmf>\n";
 
-      xdmf_file.close();
+template <int dim, int spacedim>
+void
+XDMFTimeSeries::write_time_step (const DataOutInterface<dim,spacedim> &data_out,
+                                 const double                          time)
+{
+  DataOutBase::DataOutFilter data_filter (DataOutBase::DataOutFilterFlags (true, true));
+  data_out.write_filtered_data (data_filter);
+
+  // compare the mesh with the one last written. the mesh has to be written
+  // anew if it has changed on any of the processes
+  std::vector<double>       new_node_data;
+  std::vector<unsigned int> new_cell_data;
+  data_filter.fill_node_data (new_node_data);
+  data_filter.fill_cell_data (0, new_cell_data);
+
+  const bool locally_changed = ((n_meshes == 0)
+                                ||
+                                (new_node_data != node_data)
+                                ||
+                                (new_cell_data != cell_data));
+  const bool write_mesh = (Utilities::MPI::max (locally_changed ? 1U : 0U, comm) == 1);
+  if (write_mesh)
+    {
+      node_data.swap (new_node_data);
+      cell_data.swap (new_cell_data);
+      mesh_filename = filename_prefix + "-mesh-" +
+                      Utilities::int_to_string (n_meshes, 4) + ".h5";
+      ++n_meshes;
     }
+
+  const std::string solution_filename = filename_prefix + "-" +
+                                        Utilities::int_to_string (entries.size(), 5) + ".h5";
+  data_out.write_hdf5_parallel (data_filter, write_mesh,
+                                mesh_filename, solution_filename,
+                                comm);
+  entries.push_back (data_out.create_xdmf_entry (data_filter,
+                                                 mesh_filename, solution_filename,
+                                                 time, comm));
+}
+
+
+
+void
+XDMFTimeSeries::write_xdmf_file () const
+{
+  write_xdmf_entries (entries, filename_prefix + ".xdmf", comm);
+}
+
+
+
+unsigned int
+XDMFTimeSeries::n_time_steps () const
+{
+  return entries.size();
+}
+
+
+
+unsigned int
+XDMFTimeSeries::n_mesh_files () const
+{
+  return n_meshes;
 }
 
 
+
 /*
  * Get the XDMF content associated with this entry.
  * If the entry is not valid, this returns an empty string.
@@ -6553,6 +7058,39 @@ write_filtered_data (DataOutBase::DataOutFilter &filtered_data) const
                                    filtered_data);
 }
 
+
+
+template <int dim, int spacedim>
+void DataOutInterface<dim,spacedim>::
+write_flat_data (DataOutBase::FlatData &flat_data,
+                 const bool             update_mesh) const
+{
+  DataOutBase::write_flat_data (get_patches(), get_dataset_names(),
+                                get_vector_data_ranges(),
+                                update_mesh,
+                                flat_data);
+}
+
+
+
+template <int dim, int spacedim>
+void DataOutInterface<dim,spacedim>::
+attach_in_situ_callback (const std_cxx11::function<void (const DataOutBase::FlatData &)> &callback)
+{
+  in_situ_callbacks.push_back (callback);
+}
+
+
+
+template <int dim, int spacedim>
+void DataOutInterface<dim,spacedim>::
+write_in_situ (const bool update_mesh)
+{
+  write_flat_data (in_situ_data, update_mesh);
+  for (unsigned int i=0; i<in_situ_callbacks.size(); ++i)
+    in_situ_callbacks[i] (in_situ_data);
+}
+
 template <int dim, int spacedim>
 void DataOutBase::write_filtered_data (const std::vector<Patch<dim,spacedim> > &patches,
                                        const std::vector<std::string>          &data_names,
@@ -6651,6 +7189,111 @@ void DataOutBase::write_filtered_data (const std::vector<Patch<dim,spacedim> > &
 
 
 
+
+DataOutBase::FlatData::FlatData ()
+  :
+  dimension (0),
+  vertices_per_cell (0),
+  vtk_cell_type (0),
+  n_mesh_updates (0)
+{}
+
+
+
+unsigned int
+DataOutBase::FlatData::n_points () const
+{
+  return points.size() / 3;
+}
+
+
+
+unsigned int
+DataOutBase::FlatData::n_cells () const
+{
+  return (vertices_per_cell > 0 ? connectivity.size() / vertices_per_cell : 0);
+}
+
+
+
+std::size_t
+DataOutBase::FlatData::memory_consumption () const
+{
+  return (sizeof (*this) +
+          MemoryConsumption::memory_consumption (points) +
+          MemoryConsumption::memory_consumption (connectivity) +
+          MemoryConsumption::memory_consumption (data_names) +
+          MemoryConsumption::memory_consumption (data));
+}
+
+
+
+template <int dim, int spacedim>
+void DataOutBase::write_flat_data (const std::vector<Patch<dim,spacedim> > &patches,
+                                   const std::vector<std::string>          &data_names,
+                                   const std::vector<std_cxx11::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
+                                   const bool                               update_mesh,
+                                   DataOutBase::FlatData                   &flat_data)
+{
+  unsigned int n_nodes = 0, n_cells = 0;
+  if (patches.size() > 0)
+    compute_sizes<dim,spacedim>(patches, n_nodes, n_cells);
+  const unsigned int n_data_sets = data_names.size();
+
+  flat_data.data_names = data_names;
+  flat_data.vector_data_ranges = vector_data_ranges;
+  flat_data.data.reinit (n_data_sets, n_nodes);
+
+  // copy the data sets into their rows on a separate task while the mesh
+  // is written
+  Threads::TaskGroup<> tasks;
+  if ((patches.size() > 0) && (n_data_sets > 0))
+    {
+      if (patches[0].points_are_available)
+        {
+          AssertDimension (n_data_sets + spacedim, patches[0].data.n_rows());
+        }
+      else
+        {
+          AssertDimension (n_data_sets, patches[0].data.n_rows());
+        }
+
+      void (*fun_ptr) (const std::vector<Patch<dim,spacedim> > &,
+                       Table<2,double> &)
+        = &write_gmv_reorder_data_vectors<dim,spacedim>;
+      tasks += Threads::new_task (fun_ptr, patches, flat_data.data);
+    }
+
+  if (update_mesh)
+    {
+      flat_data.dimension         = dim;
+      flat_data.vertices_per_cell = GeometryInfo<dim>::vertices_per_cell;
+      flat_data.vtk_cell_type     = vtk_cell_type[dim];
+
+      flat_data.points.assign (3*n_nodes, 0.);
+      flat_data.connectivity.resize (n_cells*GeometryInfo<dim>::vertices_per_cell);
+
+      FlatDataStream flat_data_stream (flat_data);
+      write_nodes (patches, flat_data_stream);
+      write_cells (patches, flat_data_stream);
+
+      ++flat_data.n_mesh_updates;
+    }
+  else
+    {
+      Assert ((flat_data.n_points() == n_nodes)
+              &&
+              (flat_data.n_cells() == n_cells),
+              ExcMessage ("The mesh can only be left untouched if the patches "
+                          "have the same number of points and cells as at "
+                          "the time the mesh was last written."));
+    }
+
+  tasks.join_all ();
+}
+
+
+
 template <int dim, int spacedim>
 void DataOutInterface<dim,spacedim>::
 write_hdf5_parallel (const DataOutBase::DataOutFilter &data_filter,
@@ -7192,7 +7835,8 @@ DataOutInterface<dim,spacedim>::memory_consumption () const
           MemoryConsumption::memory_consumption (tecplot_flags) +
           MemoryConsumption::memory_consumption (vtk_flags) +
           MemoryConsumption::memory_consumption (svg_flags) +
-          MemoryConsumption::memory_consumption (deal_II_intermediate_flags));
+          MemoryConsumption::memory_consumption (deal_II_intermediate_flags) +
+          in_situ_data.memory_consumption());
 }
 
 
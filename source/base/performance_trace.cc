@@ -0,0 +1,565 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/performance_trace.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/thread_local_storage.h>
+#include <deal.II/base/thread_management.h>
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <limits>
+
+#if defined(DEAL_II_HAVE_SYS_TIME_H)
+#  include <sys/time.h>
+#endif
+
+#ifdef DEAL_II_MSVC
+#  include <windows.h>
+#endif
+
+#if defined(__linux__)
+#  include <linux/perf_event.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  include <cstring>
+#endif
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+bool PerformanceTrace::enabled = false;
+
+
+namespace
+{
+  /**
+   * A region that has been entered, but not yet left, on some thread.
+   */
+  struct ActiveRegion
+  {
+    std::string            name;
+    std::string            path;
+    double                 start_time;
+    unsigned long long int start_counters[2];
+  };
+
+
+  /**
+   * A single execution of a region, as written by write_chrome_trace().
+   */
+  struct Event
+  {
+    std::string name;
+    std::string path;
+    double      start_time;
+    double      duration;
+  };
+
+
+  /**
+   * All data recorded on one thread. The file descriptors refer to the
+   * hardware counters for cycles and instructions, and are negative if the
+   * counters are not (or could not be) opened.
+   */
+  struct ThreadData
+  {
+    ThreadData ()
+      :
+      thread_index (numbers::invalid_unsigned_int),
+      counters_opened (false)
+    {
+      counter_fd[0] = counter_fd[1] = -1;
+    }
+
+    unsigned int                                            thread_index;
+    std::vector<ActiveRegion>                               stack;
+    std::map<std::string, PerformanceTrace::SectionData>    sections;
+    std::vector<Event>                                      events;
+    bool                                                    counters_opened;
+    int                                                     counter_fd[2];
+  };
+
+
+  /**
+   * The per-thread data, and the variables that are only changed by
+   * enable(), disable() and clear().
+   */
+  Threads::ThreadLocalStorage<ThreadData> thread_data;
+  Threads::Mutex                          mutex;
+  unsigned int                            n_threads = 0;
+  bool                                    record_events = true;
+  bool                                    use_hardware_counters = false;
+  double                                  time_origin = 0;
+
+
+
+  double wall_clock ()
+  {
+#if defined(DEAL_II_HAVE_SYS_TIME_H)
+    struct timeval wall_timer;
+    gettimeofday(&wall_timer, NULL);
+    return wall_timer.tv_sec + 1.e-6 * wall_timer.tv_usec;
+#elif defined(DEAL_II_MSVC)
+    LARGE_INTEGER freq, time;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&time);
+    return (double) time.QuadPart / freq.QuadPart;
+#else
+#  error Unsupported platform. Porting not finished.
+#endif
+  }
+
+
+
+  /**
+   * Try to open the hardware counters for the calling thread. Failure (for
+   * example because the kernel does not allow unprivileged access) is not an
+   * error; the counters then simply read as zero.
+   */
+  void open_counters (ThreadData &data)
+  {
+    data.counters_opened = true;
+#if defined(__linux__)
+    const unsigned long long int configs[2] = { PERF_COUNT_HW_CPU_CYCLES,
+                                                PERF_COUNT_HW_INSTRUCTIONS
+                                              };
+    for (unsigned int c=0; c<2; ++c)
+      {
+        struct perf_event_attr attributes;
+        std::memset (&attributes, 0, sizeof(attributes));
+        attributes.type           = PERF_TYPE_HARDWARE;
+        attributes.size           = sizeof(attributes);
+        attributes.config         = configs[c];
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv     = 1;
+
+        // count events of the calling thread on whatever CPU it runs
+        data.counter_fd[c] = syscall (__NR_perf_event_open, &attributes,
+                                      0, -1, -1, 0);
+      }
+#endif
+  }
+
+
+
+  void close_counters (ThreadData &data)
+  {
+#if defined(__linux__)
+    for (unsigned int c=0; c<2; ++c)
+      if (data.counter_fd[c] >= 0)
+        close (data.counter_fd[c]);
+#endif
+    data.counter_fd[0] = data.counter_fd[1] = -1;
+    data.counters_opened = false;
+  }
+
+
+
+  unsigned long long int read_counter (const int fd)
+  {
+#if defined(__linux__)
+    if (fd >= 0)
+      {
+        unsigned long long int value = 0;
+        if (read (fd, &value, sizeof(value)) == sizeof(value))
+          return value;
+      }
+#else
+    (void)fd;
+#endif
+    return 0;
+  }
+
+
+
+  /**
+   * Return the data of the calling thread, and assign an index to the thread
+   * if this is the first time it records something.
+   */
+  ThreadData &get_thread_data ()
+  {
+    ThreadData &data = thread_data.get();
+    if (data.thread_index == numbers::invalid_unsigned_int)
+      {
+        Threads::Mutex::ScopedLock lock (mutex);
+        data.thread_index = n_threads++;
+      }
+    return data;
+  }
+
+
+
+  /**
+   * Return pointers to the data of all threads that have recorded
+   * something.
+   */
+  std::vector<ThreadData *> get_all_thread_data ()
+  {
+    std::vector<ThreadData *> result;
+#ifdef DEAL_II_WITH_THREADS
+    for (tbb::enumerable_thread_specific<ThreadData>::iterator
+         p = thread_data.get_implementation().begin();
+         p != thread_data.get_implementation().end(); ++p)
+      if (p->thread_index != numbers::invalid_unsigned_int)
+        result.push_back (&*p);
+#else
+    if (thread_data.get_implementation().thread_index
+        != numbers::invalid_unsigned_int)
+      result.push_back (&thread_data.get_implementation());
+#endif
+    return result;
+  }
+
+
+
+  /**
+   * Write a string in the form required by JSON, i.e., in quotes and with
+   * special characters escaped.
+   */
+  void write_json_string (std::ostream      &out,
+                          const std::string &s)
+  {
+    out << '"';
+    for (unsigned int i=0; i<s.size(); ++i)
+      switch (s[i])
+        {
+        case '"':
+          out << "\\\"";
+          break;
+        case '\\':
+          out << "\\\\";
+          break;
+        case '\n':
+          out << "\\n";
+          break;
+        case '\t':
+          out << "\\t";
+          break;
+        default:
+          if (static_cast<unsigned char>(s[i]) < 0x20)
+            out << ' ';
+          else
+            out << s[i];
+        }
+    out << '"';
+  }
+}
+
+
+
+PerformanceTrace::SectionData::SectionData ()
+  :
+  n_calls (0),
+  total_wall_time (0),
+  min_wall_time (0),
+  max_wall_time (0),
+  n_cycles (0),
+  n_instructions (0)
+{}
+
+
+
+void
+PerformanceTrace::enable (const bool record_events_,
+                          const bool hardware_counters)
+{
+  Threads::Mutex::ScopedLock lock (mutex);
+  record_events = record_events_;
+  use_hardware_counters = hardware_counters;
+  if (time_origin == 0)
+    time_origin = wall_clock();
+  enabled = true;
+}
+
+
+
+void
+PerformanceTrace::disable ()
+{
+  enabled = false;
+}
+
+
+
+void
+PerformanceTrace::clear ()
+{
+  Threads::Mutex::ScopedLock lock (mutex);
+
+  const std::vector<ThreadData *> all_data = get_all_thread_data();
+  for (unsigned int t=0; t<all_data.size(); ++t)
+    {
+      Assert (all_data[t]->stack.empty(),
+              ExcMessage ("PerformanceTrace::clear() must not be called "
+                          "while regions are active."));
+      close_counters (*all_data[t]);
+      *all_data[t] = ThreadData();
+    }
+
+  thread_data.clear();
+  n_threads = 0;
+  time_origin = (enabled ? wall_clock() : 0.);
+}
+
+
+
+void
+PerformanceTrace::begin_region (const std::string &name)
+{
+  ThreadData &data = get_thread_data();
+
+  data.stack.push_back (ActiveRegion());
+  ActiveRegion &region = data.stack.back();
+  region.name = name;
+  if (data.stack.size() > 1)
+    region.path = data.stack[data.stack.size()-2].path + '/' + name;
+  else
+    region.path = name;
+
+  if (use_hardware_counters)
+    {
+      if (data.counters_opened == false)
+        open_counters (data);
+      for (unsigned int c=0; c<2; ++c)
+        region.start_counters[c] = read_counter (data.counter_fd[c]);
+    }
+  else
+    region.start_counters[0] = region.start_counters[1] = 0;
+
+  // read the clock last so that the work above is not attributed to the
+  // region
+  region.start_time = wall_clock();
+}
+
+
+
+void
+PerformanceTrace::end_region (const std::string &name)
+{
+  const double end_time = wall_clock();
+
+  bool exists = false;
+  ThreadData &data = thread_data.get (exists);
+  if (exists == false || data.stack.empty())
+    {
+      Assert (name.size() > 0,
+              ExcMessage ("Cannot leave a region because none has been entered "
+                          "on the current thread."));
+      return;
+    }
+
+  // find the region to leave, which is the last one unless a name is given
+  unsigned int index = data.stack.size()-1;
+  if (name.size() > 0)
+    {
+      while (data.stack[index].name != name)
+        if (index == 0)
+          return;
+        else
+          --index;
+    }
+  const ActiveRegion &region = data.stack[index];
+
+  const double duration = end_time - region.start_time;
+  SectionData &section = data.sections[region.path];
+  if (section.n_calls == 0 || duration < section.min_wall_time)
+    section.min_wall_time = duration;
+  if (duration > section.max_wall_time)
+    section.max_wall_time = duration;
+  section.total_wall_time += duration;
+  ++section.n_calls;
+
+  if (data.counters_opened)
+    {
+      const unsigned long long int cycles = read_counter (data.counter_fd[0]);
+      const unsigned long long int instructions = read_counter (data.counter_fd[1]);
+      if (cycles >= region.start_counters[0])
+        section.n_cycles += cycles - region.start_counters[0];
+      if (instructions >= region.start_counters[1])
+        section.n_instructions += instructions - region.start_counters[1];
+    }
+
+  if (record_events)
+    {
+      Event event;
+      event.name       = region.name;
+      event.path       = region.path;
+      event.start_time = region.start_time - time_origin;
+      event.duration   = duration;
+      data.events.push_back (event);
+    }
+
+  data.stack.erase (data.stack.begin() + index);
+}
+
+
+
+std::map<std::string, PerformanceTrace::SectionData>
+PerformanceTrace::get_section_data ()
+{
+  Threads::Mutex::ScopedLock lock (mutex);
+
+  std::map<std::string, SectionData> result;
+  const std::vector<ThreadData *> all_data = get_all_thread_data();
+  for (unsigned int t=0; t<all_data.size(); ++t)
+    for (std::map<std::string, SectionData>::const_iterator
+         p = all_data[t]->sections.begin(); p != all_data[t]->sections.end(); ++p)
+      {
+        SectionData &section = result[p->first];
+        if (section.n_calls == 0 || p->second.min_wall_time < section.min_wall_time)
+          section.min_wall_time = p->second.min_wall_time;
+        if (p->second.max_wall_time > section.max_wall_time)
+          section.max_wall_time = p->second.max_wall_time;
+        section.n_calls         += p->second.n_calls;
+        section.total_wall_time += p->second.total_wall_time;
+        section.n_cycles        += p->second.n_cycles;
+        section.n_instructions  += p->second.n_instructions;
+      }
+
+  return result;
+}
+
+
+
+void
+PerformanceTrace::print_summary (std::ostream   &out,
+                                 const MPI_Comm &mpi_communicator)
+{
+  const std::map<std::string, SectionData> sections = get_section_data();
+
+  const bool parallel = (Utilities::MPI::n_mpi_processes(mpi_communicator) > 1);
+  const bool print = (Utilities::MPI::this_mpi_process(mpi_communicator) == 0);
+
+  Assert (parallel == false ||
+          Utilities::MPI::max (static_cast<unsigned int>(sections.size()),
+                               mpi_communicator) ==
+          Utilities::MPI::min (static_cast<unsigned int>(sections.size()),
+                               mpi_communicator),
+          ExcMessage ("All processes must have recorded the same regions."));
+
+  bool have_counters = false;
+  for (std::map<std::string, SectionData>::const_iterator
+       p = sections.begin(); p != sections.end(); ++p)
+    if (p->second.n_cycles > 0)
+      have_counters = true;
+  if (parallel)
+    have_counters = false;
+
+  // determine the width of the first column
+  std::size_t name_width = 6;
+  for (std::map<std::string, SectionData>::const_iterator
+       p = sections.begin(); p != sections.end(); ++p)
+    name_width = std::max (name_width, p->first.size());
+
+  std::ostringstream buffer;
+  buffer << std::left << std::setw(name_width) << "Region"
+         << std::right << " | " << std::setw(9) << "no. calls";
+  if (parallel)
+    buffer << " | " << std::setw(10) << "min time"
+           << " | " << std::setw(10) << "avg time"
+           << " | " << std::setw(10) << "max time";
+  else
+    buffer << " | " << std::setw(10) << "wall time"
+           << " | " << std::setw(10) << "min/call"
+           << " | " << std::setw(10) << "max/call";
+  if (have_counters)
+    buffer << " | " << std::setw(14) << "cycles"
+           << " | " << std::setw(14) << "instructions"
+           << " | " << std::setw(5) << "IPC";
+  buffer << '\n' << std::string(buffer.str().size()-1, '-') << '\n';
+
+  for (std::map<std::string, SectionData>::const_iterator
+       p = sections.begin(); p != sections.end(); ++p)
+    {
+      buffer << std::left << std::setw(name_width) << p->first
+             << std::right << " | " << std::setw(9) << p->second.n_calls
+             << std::setprecision(3);
+      if (parallel)
+        {
+          const Utilities::MPI::MinMaxAvg data
+            = Utilities::MPI::min_max_avg (p->second.total_wall_time,
+                                           mpi_communicator);
+          buffer << " | " << std::setw(9) << data.min << 's'
+                 << " | " << std::setw(9) << data.avg << 's'
+                 << " | " << std::setw(9) << data.max << 's';
+        }
+      else
+        buffer << " | " << std::setw(9) << p->second.total_wall_time << 's'
+               << " | " << std::setw(9) << p->second.min_wall_time << 's'
+               << " | " << std::setw(9) << p->second.max_wall_time << 's';
+      if (have_counters)
+        buffer << " | " << std::setw(14) << p->second.n_cycles
+               << " | " << std::setw(14) << p->second.n_instructions
+               << " | " << std::setw(5)
+               << (p->second.n_cycles > 0 ?
+                   static_cast<double>(p->second.n_instructions) / p->second.n_cycles :
+                   0.);
+      buffer << '\n';
+    }
+
+  if (print)
+    out << buffer.str() << std::flush;
+}
+
+
+
+void
+PerformanceTrace::write_chrome_trace (std::ostream &out)
+{
+  Threads::Mutex::ScopedLock lock (mutex);
+
+  unsigned int process = 0;
+#ifdef DEAL_II_WITH_MPI
+  if (Utilities::MPI::job_supports_mpi())
+    process = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+#endif
+
+  const std::ios::fmtflags old_flags = out.flags();
+  const std::streamsize old_precision = out.precision();
+  out << std::fixed << std::setprecision(3);
+
+  out << "{\"traceEvents\":[";
+  bool first = true;
+  const std::vector<ThreadData *> all_data = get_all_thread_data();
+  for (unsigned int t=0; t<all_data.size(); ++t)
+    for (unsigned int e=0; e<all_data[t]->events.size(); ++e)
+      {
+        const Event &event = all_data[t]->events[e];
+        out << (first ? "\n" : ",\n") << "{\"name\":";
+        write_json_string (out, event.name);
+        out << ",\"cat\":\"deal.II\",\"ph\":\"X\""
+            << ",\"ts\":" << event.start_time * 1e6
+            << ",\"dur\":" << event.duration * 1e6
+            << ",\"pid\":" << process
+            << ",\"tid\":" << all_data[t]->thread_index
+            << ",\"args\":{\"path\":";
+        write_json_string (out, event.path);
+        out << "}}";
+        first = false;
+      }
+  out << "\n]}\n";
+
+  out.flags (old_flags);
+  out.precision (old_precision);
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
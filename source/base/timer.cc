@@ -15,6 +15,7 @@
 
 #include <deal.II/base/timer.h>
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/performance_trace.h>
 #include <deal.II/base/mpi.h>
 #include <deal.II/base/utilities.h>
 #include <sstream>
@@ -376,6 +377,9 @@ TimerOutput::enter_subsection (const std::string &section_name)
   sections[section_name].n_calls++;
 
   active_sections.push_back (section_name);
+
+  if (PerformanceTrace::is_enabled())
+    PerformanceTrace::begin_region (section_name);
 }
 
 
@@ -383,11 +387,11 @@ TimerOutput::enter_subsection (const std::string &section_name)
 void
 TimerOutput::leave_subsection (const std::string &section_name)
 {
+  Threads::Mutex::ScopedLock lock (mutex);
+
   Assert (!active_sections.empty(),
           ExcMessage("Cannot exit any section because none has been entered!"));
 
-  Threads::Mutex::ScopedLock lock (mutex);
-
   if (section_name != "")
     {
       Assert (sections.find (section_name) != sections.end(),
@@ -404,6 +408,8 @@ TimerOutput::leave_subsection (const std::string &section_name)
                                            section_name);
 
   sections[actual_section_name].timer.stop();
+  if (PerformanceTrace::is_enabled())
+    PerformanceTrace::end_region (actual_section_name);
   sections[actual_section_name].total_wall_time
   += sections[actual_section_name].timer.wall_time();
 
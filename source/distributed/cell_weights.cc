@@ -0,0 +1,370 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/distributed/cell_weights.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/hp/dof_handler.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  /**
+   * The weight given to a cell of average cost. The triangulation adds a
+   * constant weight of 1000 to every cell, so this value makes the cost
+   * model dominate the partitioning while keeping the sum of the weights
+   * of all locally owned cells far away from overflow.
+   */
+  const double average_cell_weight = 10000.;
+
+  /**
+   * The largest weight of a single cell.
+   */
+  const double max_cell_weight = 1e8;
+
+
+  /**
+   * Return the communicator of the given triangulation if it is a parallel
+   * one, and MPI_COMM_SELF otherwise.
+   */
+  template <int dim, int spacedim>
+  MPI_Comm
+  get_mpi_communicator (const Triangulation<dim,spacedim> &triangulation)
+  {
+    if (const parallel::Triangulation<dim,spacedim> *parallel_triangulation
+        = dynamic_cast<const parallel::Triangulation<dim,spacedim> *>(&triangulation))
+      return parallel_triangulation->get_communicator();
+    else
+      return MPI_COMM_SELF;
+  }
+
+
+  /**
+   * Repartition the given triangulation if it is a
+   * parallel::distributed::Triangulation, and return whether this has
+   * happened. Distributed triangulations in 1d can not be repartitioned.
+   */
+  template <int dim, int spacedim>
+  bool
+  repartition (Triangulation<dim,spacedim> &triangulation)
+  {
+#ifdef DEAL_II_WITH_P4EST
+    if (parallel::distributed::Triangulation<dim,spacedim> *distributed_triangulation
+        = dynamic_cast<parallel::distributed::Triangulation<dim,spacedim> *>(&triangulation))
+      {
+        distributed_triangulation->repartition ();
+        return true;
+      }
+#else
+    (void)triangulation;
+#endif
+    return false;
+  }
+
+
+  template <int spacedim>
+  bool
+  repartition (Triangulation<1,spacedim> &)
+  {
+    return false;
+  }
+}
+
+
+
+namespace parallel
+{
+  namespace distributed
+  {
+    template <int dim, int spacedim>
+    CellWeights<dim,spacedim>::CellWeights (dealii::Triangulation<dim,spacedim> &triangulation)
+      :
+      triangulation (&triangulation, typeid(*this).name()),
+      mpi_communicator (get_mpi_communicator (triangulation)),
+      dof_handler (0, typeid(*this).name()),
+      fe_cost_exponent (1.),
+      fe_cost_coefficient (1.),
+      has_local_measurements (false),
+      use_measured_costs (false),
+      average_measured_cost (0.),
+      average_cost (1.)
+    {
+      reset ();
+
+      tria_listeners.push_back
+      (triangulation.signals.cell_weight.connect
+       (std_cxx11::bind (&CellWeights<dim,spacedim>::weight,
+                         std_cxx11::cref(*this),
+                         std_cxx11::_1,
+                         std_cxx11::_2)));
+      tria_listeners.push_back
+      (triangulation.signals.pre_distributed_repartition.connect
+       (std_cxx11::bind (&CellWeights<dim,spacedim>::update_scaling,
+                         std_cxx11::ref(*this))));
+      tria_listeners.push_back
+      (triangulation.signals.any_change.connect
+       (std_cxx11::bind (&CellWeights<dim,spacedim>::reset,
+                         std_cxx11::ref(*this))));
+    }
+
+
+
+    template <int dim, int spacedim>
+    CellWeights<dim,spacedim>::~CellWeights ()
+    {
+      for (unsigned int i=0; i<tria_listeners.size(); ++i)
+        tria_listeners[i].disconnect ();
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    CellWeights<dim,spacedim>::set_fe_cost_model (const hp::DoFHandler<dim,spacedim> &dof_handler,
+                                                  const double                        exponent,
+                                                  const double                        coefficient)
+    {
+      Assert (&dof_handler.get_tria() == &*triangulation,
+              ExcMessage ("The DoFHandler must be based on the triangulation "
+                          "whose cells this object weights."));
+      Assert (coefficient > 0,
+              ExcMessage ("The cost of a cell must be positive."));
+
+      this->dof_handler = &dof_handler;
+      fe_cost_exponent = exponent;
+      fe_cost_coefficient = coefficient;
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    CellWeights<dim,spacedim>::add_measured_cost (const active_cell_iterator &cell,
+                                                  const double                cost)
+    {
+      Assert (cell->is_locally_owned(),
+              ExcMessage ("Costs can only be measured on locally owned cells."));
+      Assert (cost >= 0,
+              ExcMessage ("The cost of a cell must not be negative."));
+      AssertIndexRange (cell->active_cell_index(), measured_costs.size());
+
+      Threads::Mutex::ScopedLock lock (mutex);
+      double &measured_cost = measured_costs[cell->active_cell_index()];
+      if (measured_cost < 0)
+        measured_cost = 0;
+      measured_cost += cost;
+      has_local_measurements = true;
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    CellWeights<dim,spacedim>::clear_measured_costs ()
+    {
+      Threads::Mutex::ScopedLock lock (mutex);
+      std::fill (measured_costs.begin(), measured_costs.end(), -1.);
+      has_local_measurements = false;
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    CellWeights<dim,spacedim>::reset ()
+    {
+      Threads::Mutex::ScopedLock lock (mutex);
+      measured_costs.clear ();
+      measured_costs.resize (triangulation->n_active_cells(), -1.);
+      has_local_measurements = false;
+    }
+
+
+
+    template <int dim, int spacedim>
+    double
+    CellWeights<dim,spacedim>::cost (const active_cell_iterator &cell) const
+    {
+      if (use_measured_costs)
+        {
+          const double measured_cost = measured_costs[cell->active_cell_index()];
+          return (measured_cost >= 0 ? measured_cost : average_measured_cost);
+        }
+      else if (dof_handler != 0)
+        {
+          const typename hp::DoFHandler<dim,spacedim>::active_cell_iterator
+          dof_cell (&*triangulation, cell->level(), cell->index(), &*dof_handler);
+          return fe_cost_coefficient *
+                 std::pow (static_cast<double>(dof_cell->get_fe().dofs_per_cell),
+                           fe_cost_exponent);
+        }
+      else
+        return 1.;
+    }
+
+
+
+    template <int dim, int spacedim>
+    unsigned int
+    CellWeights<dim,spacedim>::weight (const cell_iterator                                          &cell,
+                                       const typename dealii::Triangulation<dim,spacedim>::CellStatus status) const
+    {
+      // the weight is an estimate of the cost of the cell(s) after
+      // refinement. each child of a cell that is going to be refined is
+      // assumed to cost as much as its parent, i.e., refinement increases
+      // the total cost of the mesh, while a cell that is going to be
+      // coarsened is assumed to cost as much as its children do on average
+      double cell_cost = 0;
+      switch (status)
+        {
+        case dealii::Triangulation<dim,spacedim>::CELL_PERSIST:
+        case dealii::Triangulation<dim,spacedim>::CELL_REFINE:
+          cell_cost = cost (cell);
+          break;
+
+        case dealii::Triangulation<dim,spacedim>::CELL_COARSEN:
+          for (unsigned int c=0; c<cell->n_children(); ++c)
+            cell_cost += cost (cell->child(c));
+          cell_cost /= cell->n_children();
+          break;
+
+        default:
+          Assert (false, ExcInternalError());
+        }
+
+      if (average_cost <= 0)
+        return static_cast<unsigned int>(average_cell_weight);
+      return static_cast<unsigned int>
+             (std::min (average_cell_weight * cell_cost / average_cost,
+                        max_cell_weight) + 0.5);
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    CellWeights<dim,spacedim>::update_scaling ()
+    {
+      Assert (measured_costs.size() == triangulation->n_active_cells(),
+              ExcInternalError());
+
+      // first find out whether costs have been measured anywhere, and what
+      // their average is
+      // use the std::vector variants of Utilities::MPI::sum(), the ones for
+      // arrays of fixed size are not available without MPI
+      std::vector<double> local_measurements (3, 0.);
+      local_measurements[0] = (has_local_measurements ? 1. : 0.);
+      if (has_local_measurements)
+        for (active_cell_iterator cell = triangulation->begin_active();
+             cell != triangulation->end(); ++cell)
+          if (cell->is_locally_owned() &&
+              measured_costs[cell->active_cell_index()] >= 0)
+            {
+              local_measurements[1] += measured_costs[cell->active_cell_index()];
+              local_measurements[2] += 1.;
+            }
+      std::vector<double> global_measurements (3);
+      Utilities::MPI::sum (local_measurements, mpi_communicator, global_measurements);
+
+      use_measured_costs = (global_measurements[0] > 0);
+      average_measured_cost = (global_measurements[2] > 0 ?
+                               global_measurements[1] / global_measurements[2] :
+                               0.);
+
+      // then compute the average cost of all cells with the selected model
+      std::vector<double> local_costs (2, 0.);
+      for (active_cell_iterator cell = triangulation->begin_active();
+           cell != triangulation->end(); ++cell)
+        if (cell->is_locally_owned())
+          {
+            local_costs[0] += cost (cell);
+            local_costs[1] += 1.;
+          }
+      std::vector<double> global_costs (2);
+      Utilities::MPI::sum (local_costs, mpi_communicator, global_costs);
+
+      average_cost = (global_costs[1] > 0 ? global_costs[0] / global_costs[1] : 1.);
+    }
+
+
+
+    template <int dim, int spacedim>
+    double
+    CellWeights<dim,spacedim>::compute_imbalance ()
+    {
+      update_scaling ();
+
+      // use the same weights as the triangulation does for the partitioning
+      double local_weight = 0;
+      for (active_cell_iterator cell = triangulation->begin_active();
+           cell != triangulation->end(); ++cell)
+        if (cell->is_locally_owned())
+          local_weight += 1000 + weight (cell, dealii::Triangulation<dim,spacedim>::CELL_PERSIST);
+
+      const double max_weight = Utilities::MPI::max (local_weight, mpi_communicator);
+      const double average_weight = Utilities::MPI::sum (local_weight, mpi_communicator) /
+                                    Utilities::MPI::n_mpi_processes (mpi_communicator);
+
+      if (average_weight == 0)
+        return 0.;
+      return max_weight / average_weight - 1.;
+    }
+
+
+
+    template <int dim, int spacedim>
+    bool
+    CellWeights<dim,spacedim>::repartition_if_imbalanced (const double threshold)
+    {
+      Assert (threshold >= 0,
+              ExcMessage ("The threshold for the imbalance must not be negative."));
+
+      if (compute_imbalance() <= threshold)
+        return false;
+
+      return repartition (*triangulation);
+    }
+
+
+
+    template <int dim, int spacedim>
+    std::size_t
+    CellWeights<dim,spacedim>::memory_consumption () const
+    {
+      return (sizeof(*this) +
+              MemoryConsumption::memory_consumption (measured_costs) +
+              tria_listeners.capacity() * sizeof(boost::signals2::connection));
+    }
+  }
+}
+
+
+// explicit instantiations
+#include "cell_weights.inst"
+
+DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,604 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/distributed/fully_distributed_tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <algorithm>
+#include <set>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  /**
+   * The MPI tag used for the exchange of refinement flags.
+   */
+  const int mpi_tag_refinement_flags = 4301;
+
+
+  /**
+   * Encodings of the refinement and coarsening flags of an active cell.
+   */
+  const char no_flag      = 0;
+  const char refine_flag  = 1;
+  const char coarsen_flag = 2;
+
+
+  /**
+   * Append the flags of the active descendants of @p cell to @p flags.
+   */
+  template <int dim, int spacedim>
+  void
+  collect_flags (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                 std::vector<char>                                          &flags)
+  {
+    if (cell->has_children())
+      for (unsigned int c=0; c<cell->n_children(); ++c)
+        collect_flags<dim,spacedim> (cell->child(c), flags);
+    else if (cell->refine_flag_set())
+      flags.push_back (refine_flag);
+    else if (cell->coarsen_flag_set())
+      flags.push_back (coarsen_flag);
+    else
+      flags.push_back (no_flag);
+  }
+
+
+  /**
+   * Set the flags of the active descendants of @p cell to the ones stored
+   * in @p flags, starting at the given position.
+   */
+  template <int dim, int spacedim>
+  void
+  apply_flags (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+               const std::vector<char>                                    &flags,
+               unsigned int                                               &position)
+  {
+    if (cell->has_children())
+      for (unsigned int c=0; c<cell->n_children(); ++c)
+        apply_flags<dim,spacedim> (cell->child(c), flags, position);
+    else
+      {
+        AssertIndexRange (position, flags.size());
+        cell->clear_refine_flag ();
+        cell->clear_coarsen_flag ();
+        if (flags[position] == refine_flag)
+          cell->set_refine_flag ();
+        else if (flags[position] == coarsen_flag)
+          cell->set_coarsen_flag ();
+        ++position;
+      }
+  }
+
+
+  /**
+   * Return the number of active descendants of @p cell.
+   */
+  template <int dim, int spacedim>
+  unsigned int
+  n_active_descendants (const typename Triangulation<dim,spacedim>::cell_iterator &cell)
+  {
+    if (cell->has_children() == false)
+      return 1;
+
+    unsigned int n = 0;
+    for (unsigned int c=0; c<cell->n_children(); ++c)
+      n += n_active_descendants<dim,spacedim> (cell->child(c));
+    return n;
+  }
+
+
+  /**
+   * Set the subdomain id of the active descendants of @p cell.
+   */
+  template <int dim, int spacedim>
+  void
+  set_subdomain_id_recursively (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                const types::subdomain_id                                   subdomain_id)
+  {
+    if (cell->has_children())
+      for (unsigned int c=0; c<cell->n_children(); ++c)
+        set_subdomain_id_recursively<dim,spacedim> (cell->child(c), subdomain_id);
+    else
+      cell->set_subdomain_id (subdomain_id);
+  }
+
+
+  /**
+   * Add the boundary and manifold indicators of the faces, and in 3d the
+   * edges, of @p cell that lie on the boundary to @p boundary_data, with
+   * the vertex indices translated by @p vertex_map. Nothing is to be done
+   * in 1d, where the faces are vertices.
+   */
+  template <int spacedim>
+  void
+  add_boundary_data (const TriaIterator<CellAccessor<1,spacedim> > &,
+                     const std::vector<unsigned int>                &,
+                     SubCellData                                    &)
+  {}
+
+
+  template <int spacedim>
+  void
+  add_boundary_data (const TriaIterator<CellAccessor<2,spacedim> > &cell,
+                     const std::vector<unsigned int>                &vertex_map,
+                     SubCellData                                    &boundary_data)
+  {
+    for (unsigned int f=0; f<GeometryInfo<2>::faces_per_cell; ++f)
+      if (cell->face(f)->at_boundary() &&
+          ((cell->face(f)->boundary_id() != 0) ||
+           (cell->face(f)->manifold_id() != numbers::flat_manifold_id)))
+        {
+          CellData<1> line;
+          for (unsigned int v=0; v<2; ++v)
+            line.vertices[v] = vertex_map[cell->face(f)->vertex_index(v)];
+          line.boundary_id = cell->face(f)->boundary_id();
+          line.manifold_id = cell->face(f)->manifold_id();
+          boundary_data.boundary_lines.push_back (line);
+        }
+  }
+
+
+  template <int spacedim>
+  void
+  add_boundary_data (const TriaIterator<CellAccessor<3,spacedim> > &cell,
+                     const std::vector<unsigned int>                &vertex_map,
+                     SubCellData                                    &boundary_data)
+  {
+    for (unsigned int f=0; f<GeometryInfo<3>::faces_per_cell; ++f)
+      if (cell->face(f)->at_boundary())
+        {
+          if ((cell->face(f)->boundary_id() != 0) ||
+              (cell->face(f)->manifold_id() != numbers::flat_manifold_id))
+            {
+              CellData<2> quad;
+              for (unsigned int v=0; v<4; ++v)
+                quad.vertices[v] = vertex_map[cell->face(f)->vertex_index(v)];
+              quad.boundary_id = cell->face(f)->boundary_id();
+              quad.manifold_id = cell->face(f)->manifold_id();
+              boundary_data.boundary_quads.push_back (quad);
+            }
+
+          // edges shared by several boundary faces are listed several
+          // times, which is allowed as long as their indicators agree
+          for (unsigned int l=0; l<GeometryInfo<2>::lines_per_cell; ++l)
+            if ((cell->face(f)->line(l)->boundary_id() != 0) ||
+                (cell->face(f)->line(l)->manifold_id() != numbers::flat_manifold_id))
+              {
+                CellData<1> line;
+                for (unsigned int v=0; v<2; ++v)
+                  line.vertices[v] = vertex_map[cell->face(f)->line(l)->vertex_index(v)];
+                line.boundary_id = cell->face(f)->line(l)->boundary_id();
+                line.manifold_id = cell->face(f)->line(l)->manifold_id();
+                boundary_data.boundary_lines.push_back (line);
+              }
+        }
+  }
+}
+
+
+
+namespace parallel
+{
+  namespace fullydistributed
+  {
+    template <int dim, int spacedim>
+    std::size_t
+    ConstructionData<dim,spacedim>::memory_consumption () const
+    {
+      return (MemoryConsumption::memory_consumption (vertices) +
+              cells.capacity() * sizeof(CellData<dim>) +
+              MemoryConsumption::memory_consumption (coarse_cell_ids) +
+              MemoryConsumption::memory_consumption (coarse_cell_owners) +
+              boundary_data.boundary_lines.capacity() * sizeof(CellData<1>) +
+              boundary_data.boundary_quads.capacity() * sizeof(CellData<2>));
+    }
+
+
+
+    template <int dim, int spacedim>
+    ConstructionData<dim,spacedim>
+    create_construction_data (const dealii::Triangulation<dim,spacedim> &triangulation,
+                              const types::subdomain_id                  subdomain)
+    {
+      Assert (triangulation.n_levels() == 1,
+              ExcMessage ("The triangulation from which the description of the "
+                          "coarse mesh is extracted must not be refined."));
+
+      // find the vertices of the cells owned by the given subdomain. all
+      // cells that share one of these vertices are stored as well
+      std::vector<bool> vertex_is_owned (triangulation.n_vertices(), false);
+      for (typename dealii::Triangulation<dim,spacedim>::active_cell_iterator
+           cell = triangulation.begin_active(); cell != triangulation.end(); ++cell)
+        if (cell->subdomain_id() == subdomain)
+          for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+            vertex_is_owned[cell->vertex_index(v)] = true;
+
+      ConstructionData<dim,spacedim> construction_data;
+      std::vector<unsigned int> vertex_map (triangulation.n_vertices(),
+                                            numbers::invalid_unsigned_int);
+      for (typename dealii::Triangulation<dim,spacedim>::active_cell_iterator
+           cell = triangulation.begin_active(); cell != triangulation.end(); ++cell)
+        {
+          bool is_stored = (cell->subdomain_id() == subdomain);
+          for (unsigned int v=0; (v<GeometryInfo<dim>::vertices_per_cell) && !is_stored; ++v)
+            if (vertex_is_owned[cell->vertex_index(v)])
+              is_stored = true;
+          if (is_stored == false)
+            continue;
+
+          CellData<dim> cell_data;
+          for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+            {
+              const unsigned int vertex_index = cell->vertex_index(v);
+              if (vertex_map[vertex_index] == numbers::invalid_unsigned_int)
+                {
+                  vertex_map[vertex_index] = construction_data.vertices.size();
+                  construction_data.vertices.push_back (cell->vertex(v));
+                }
+              cell_data.vertices[v] = vertex_map[vertex_index];
+            }
+          cell_data.material_id = cell->material_id();
+          cell_data.manifold_id = cell->manifold_id();
+          construction_data.cells.push_back (cell_data);
+          construction_data.coarse_cell_ids.push_back (cell->index());
+          construction_data.coarse_cell_owners.push_back (cell->subdomain_id());
+
+          add_boundary_data (typename dealii::Triangulation<dim,spacedim>::cell_iterator(cell),
+                             vertex_map,
+                             construction_data.boundary_data);
+        }
+
+      return construction_data;
+    }
+
+
+
+    template <int dim, int spacedim>
+    Triangulation<dim,spacedim>::Triangulation (MPI_Comm mpi_communicator)
+      :
+      dealii::parallel::Triangulation<dim,spacedim> (mpi_communicator,
+                                                     dealii::Triangulation<dim,spacedim>::none,
+                                                     false)
+    {}
+
+
+
+    template <int dim, int spacedim>
+    Triangulation<dim,spacedim>::~Triangulation ()
+    {}
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    create_triangulation (const ConstructionData<dim,spacedim> &construction_data)
+    {
+      const unsigned int n_coarse_cells = construction_data.cells.size();
+      AssertDimension (construction_data.coarse_cell_ids.size(), n_coarse_cells);
+      AssertDimension (construction_data.coarse_cell_owners.size(), n_coarse_cells);
+
+      coarse_cell_ids = construction_data.coarse_cell_ids;
+      coarse_cell_id_to_index.resize (n_coarse_cells);
+      for (unsigned int c=0; c<n_coarse_cells; ++c)
+        coarse_cell_id_to_index[c] = std::make_pair (coarse_cell_ids[c], c);
+      std::sort (coarse_cell_id_to_index.begin(), coarse_cell_id_to_index.end());
+      for (unsigned int c=1; c<n_coarse_cells; ++c)
+        AssertThrow (coarse_cell_id_to_index[c].first != coarse_cell_id_to_index[c-1].first,
+                     ExcMessage ("The global indices of the coarse cells must be unique."));
+
+      // coarse cells of other processors that do not share a vertex with a
+      // locally owned cell are not part of the ghost layer. they are not
+      // kept in sync with their owners and are marked as artificial
+      std::vector<bool> vertex_is_owned (construction_data.vertices.size(), false);
+      for (unsigned int c=0; c<n_coarse_cells; ++c)
+        if (construction_data.coarse_cell_owners[c] == this->my_subdomain)
+          for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+            vertex_is_owned[construction_data.cells[c].vertices[v]] = true;
+
+      coarse_cell_subdomain_ids.resize (n_coarse_cells);
+      for (unsigned int c=0; c<n_coarse_cells; ++c)
+        {
+          AssertIndexRange (construction_data.coarse_cell_owners[c], this->n_subdomains);
+          bool is_in_ghost_layer = false;
+          for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+            if (vertex_is_owned[construction_data.cells[c].vertices[v]])
+              is_in_ghost_layer = true;
+          coarse_cell_subdomain_ids[c] = (is_in_ghost_layer ?
+                                          construction_data.coarse_cell_owners[c] :
+                                          numbers::artificial_subdomain_id);
+        }
+
+      // the owners of the ghost cells that share each vertex
+      std::vector<std::pair<unsigned int, types::subdomain_id> > vertex_ghost_owners;
+      for (unsigned int c=0; c<n_coarse_cells; ++c)
+        if ((coarse_cell_subdomain_ids[c] != this->my_subdomain) &&
+            (coarse_cell_subdomain_ids[c] != numbers::artificial_subdomain_id))
+          for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+            vertex_ghost_owners.push_back (std::make_pair (construction_data.cells[c].vertices[v],
+                                                           coarse_cell_subdomain_ids[c]));
+      std::sort (vertex_ghost_owners.begin(), vertex_ghost_owners.end());
+      vertex_ghost_owners.erase (std::unique (vertex_ghost_owners.begin(),
+                                              vertex_ghost_owners.end()),
+                                 vertex_ghost_owners.end());
+
+      // a locally owned coarse cell is in the ghost layer of every processor
+      // that owns a ghost cell sharing one of its vertices. the lists of
+      // cells to send and to receive are sorted by the global indices, so
+      // that both sides visit the same cells in the same order
+      send_coarse_cells.clear ();
+      receive_coarse_cells.clear ();
+      for (unsigned int i=0; i<n_coarse_cells; ++i)
+        {
+          const unsigned int c = coarse_cell_id_to_index[i].second;
+          if (coarse_cell_subdomain_ids[c] == this->my_subdomain)
+            {
+              std::set<types::subdomain_id> neighbors;
+              for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+                {
+                  const unsigned int vertex = construction_data.cells[c].vertices[v];
+                  for (std::vector<std::pair<unsigned int, types::subdomain_id> >::const_iterator
+                       p = std::lower_bound (vertex_ghost_owners.begin(),
+                                             vertex_ghost_owners.end(),
+                                             std::make_pair (vertex, types::subdomain_id(0)));
+                       (p != vertex_ghost_owners.end()) && (p->first == vertex); ++p)
+                    neighbors.insert (p->second);
+                }
+              for (std::set<types::subdomain_id>::const_iterator
+                   neighbor = neighbors.begin(); neighbor != neighbors.end(); ++neighbor)
+                send_coarse_cells[*neighbor].push_back (c);
+            }
+          else if (coarse_cell_subdomain_ids[c] != numbers::artificial_subdomain_id)
+            receive_coarse_cells[coarse_cell_subdomain_ids[c]].push_back (c);
+        }
+
+      dealii::Triangulation<dim,spacedim>::create_triangulation (construction_data.vertices,
+                                                                 construction_data.cells,
+                                                                 construction_data.boundary_data);
+      update_subdomain_ids ();
+      this->update_number_cache ();
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    create_triangulation (const std::vector<Point<spacedim> > &,
+                          const std::vector<CellData<dim> >   &,
+                          const SubCellData                   &)
+    {
+      AssertThrow (false,
+                   ExcMessage ("A parallel::fullydistributed::Triangulation can only be "
+                               "created from a description of the local part of the "
+                               "coarse mesh, see the ConstructionData class."));
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    copy_triangulation (const dealii::Triangulation<dim,spacedim> &)
+    {
+      AssertThrow (false, ExcNotImplemented());
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::update_subdomain_ids ()
+    {
+      for (unsigned int c=0; c<coarse_cell_subdomain_ids.size(); ++c)
+        set_subdomain_id_recursively<dim,spacedim> (cell_iterator (this, 0, c),
+                                                    coarse_cell_subdomain_ids[c]);
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::exchange_refinement_flags ()
+    {
+#ifdef DEAL_II_WITH_MPI
+      std::vector<std::vector<char> > send_buffers (send_coarse_cells.size());
+      std::vector<MPI_Request> requests (send_coarse_cells.size());
+      unsigned int index = 0;
+      for (typename std::map<types::subdomain_id, std::vector<unsigned int> >::const_iterator
+           neighbor = send_coarse_cells.begin(); neighbor != send_coarse_cells.end();
+           ++neighbor, ++index)
+        {
+          for (unsigned int i=0; i<neighbor->second.size(); ++i)
+            collect_flags<dim,spacedim> (cell_iterator (this, 0, neighbor->second[i]),
+                                         send_buffers[index]);
+          MPI_Isend (&send_buffers[index][0], send_buffers[index].size(), MPI_CHAR,
+                     neighbor->first, mpi_tag_refinement_flags,
+                     this->mpi_communicator, &requests[index]);
+        }
+
+      // the sender visits the same cells as we do, so we know how many
+      // flags to expect
+      std::vector<char> receive_buffer;
+      for (typename std::map<types::subdomain_id, std::vector<unsigned int> >::const_iterator
+           neighbor = receive_coarse_cells.begin(); neighbor != receive_coarse_cells.end();
+           ++neighbor)
+        {
+          unsigned int n_flags = 0;
+          for (unsigned int i=0; i<neighbor->second.size(); ++i)
+            n_flags += n_active_descendants<dim,spacedim> (cell_iterator (this, 0, neighbor->second[i]));
+          receive_buffer.resize (n_flags);
+          MPI_Recv (&receive_buffer[0], n_flags, MPI_CHAR,
+                    neighbor->first, mpi_tag_refinement_flags,
+                    this->mpi_communicator, MPI_STATUS_IGNORE);
+
+          unsigned int position = 0;
+          for (unsigned int i=0; i<neighbor->second.size(); ++i)
+            apply_flags<dim,spacedim> (cell_iterator (this, 0, neighbor->second[i]),
+                                       receive_buffer, position);
+          Assert (position == n_flags, ExcInternalError());
+        }
+
+      if (requests.size() > 0)
+        MPI_Waitall (requests.size(), &requests[0], MPI_STATUSES_IGNORE);
+#endif
+    }
+
+
+
+    template <int dim, int spacedim>
+    bool
+    Triangulation<dim,spacedim>::prepare_coarsening_and_refinement ()
+    {
+      // the flags of artificial cells are never looked at by their owners,
+      // so do not let them influence the smoothing of the mesh
+      for (active_cell_iterator cell = this->begin_active(); cell != this->end(); ++cell)
+        if (cell->is_artificial())
+          {
+            cell->clear_refine_flag ();
+            cell->clear_coarsen_flag ();
+          }
+#ifdef DEBUG
+        else if (cell->is_locally_owned())
+          Assert (!cell->refine_flag_set() ||
+                  (cell->refine_flag_set() == RefinementCase<dim>::isotropic_refinement),
+                  ExcMessage ("A parallel::fullydistributed::Triangulation only "
+                              "supports isotropic refinement."));
+#endif
+
+      std::vector<char> initial_flags, old_flags, new_flags;
+      for (active_cell_iterator cell = this->begin_active(); cell != this->end(); ++cell)
+        if (cell->is_locally_owned())
+          collect_flags<dim,spacedim> (cell, initial_flags);
+
+      // the smoothing of the mesh on one processor may add flags to cells
+      // next to ghost cells on other processors, so iterate until no
+      // processor changes the flags of its cells anymore
+      new_flags = initial_flags;
+      bool changed = true;
+      while (changed)
+        {
+          exchange_refinement_flags ();
+          dealii::Triangulation<dim,spacedim>::prepare_coarsening_and_refinement ();
+
+          old_flags.swap (new_flags);
+          new_flags.clear ();
+          for (active_cell_iterator cell = this->begin_active(); cell != this->end(); ++cell)
+            if (cell->is_locally_owned())
+              collect_flags<dim,spacedim> (cell, new_flags);
+
+          changed = (Utilities::MPI::max (old_flags != new_flags ? 1U : 0U,
+                                          this->mpi_communicator) == 1);
+        }
+
+      // the smoothing may also have changed the flags of ghost cells, so
+      // overwrite them once more with the ones of their owners
+      exchange_refinement_flags ();
+
+      return (new_flags != initial_flags);
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::execute_coarsening_and_refinement ()
+    {
+      // the function in the base class calls prepare_coarsening_and_refinement()
+      dealii::Triangulation<dim,spacedim>::execute_coarsening_and_refinement ();
+      update_subdomain_ids ();
+      this->update_number_cache ();
+    }
+
+
+
+    template <int dim, int spacedim>
+    unsigned int
+    Triangulation<dim,spacedim>::
+    coarse_cell_index_to_coarse_cell_id (const unsigned int coarse_cell_index) const
+    {
+      AssertIndexRange (coarse_cell_index, coarse_cell_ids.size());
+      return coarse_cell_ids[coarse_cell_index];
+    }
+
+
+
+    template <int dim, int spacedim>
+    unsigned int
+    Triangulation<dim,spacedim>::
+    coarse_cell_id_to_coarse_cell_index (const unsigned int coarse_cell_id) const
+    {
+      const std::vector<std::pair<unsigned int, unsigned int> >::const_iterator
+      p = std::lower_bound (coarse_cell_id_to_index.begin(),
+                            coarse_cell_id_to_index.end(),
+                            std::make_pair (coarse_cell_id, 0U));
+      if ((p != coarse_cell_id_to_index.end()) && (p->first == coarse_cell_id))
+        return p->second;
+      else
+        return numbers::invalid_unsigned_int;
+    }
+
+
+
+    template <int dim, int spacedim>
+    const std::map<types::subdomain_id, std::vector<unsigned int> > &
+    Triangulation<dim,spacedim>::coarse_cells_in_ghost_layers () const
+    {
+      return send_coarse_cells;
+    }
+
+
+
+    template <int dim, int spacedim>
+    const std::map<types::subdomain_id, std::vector<unsigned int> > &
+    Triangulation<dim,spacedim>::coarse_cells_of_ghost_owners () const
+    {
+      return receive_coarse_cells;
+    }
+
+
+
+    template <int dim, int spacedim>
+    std::size_t
+    Triangulation<dim,spacedim>::memory_consumption () const
+    {
+      std::size_t memory
+        = (dealii::parallel::Triangulation<dim,spacedim>::memory_consumption() +
+           MemoryConsumption::memory_consumption (coarse_cell_ids) +
+           MemoryConsumption::memory_consumption (coarse_cell_id_to_index) +
+           MemoryConsumption::memory_consumption (coarse_cell_subdomain_ids));
+      for (typename std::map<types::subdomain_id, std::vector<unsigned int> >::const_iterator
+           p = send_coarse_cells.begin(); p != send_coarse_cells.end(); ++p)
+        memory += MemoryConsumption::memory_consumption (p->second);
+      for (typename std::map<types::subdomain_id, std::vector<unsigned int> >::const_iterator
+           p = receive_coarse_cells.begin(); p != receive_coarse_cells.end(); ++p)
+        memory += MemoryConsumption::memory_consumption (p->second);
+      return memory;
+    }
+  }
+}
+
+
+// explicit instantiations
+#include "fully_distributed_tria.inst"
+
+DEAL_II_NAMESPACE_CLOSE
@@ -31,9 +31,12 @@
 #include <deal.II/distributed/tria.h>
 #include <deal.II/dofs/dof_tools.h>
 #include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe.h>
 #include <deal.II/grid/tria_accessor.h>
 #include <deal.II/grid/tria_iterator.h>
 
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/work_stream.h>
 #include <deal.II/base/std_cxx11/bind.h>
 
 DEAL_II_NAMESPACE_OPEN
@@ -42,6 +45,308 @@ namespace parallel
 {
   namespace distributed
   {
+    namespace
+    {
+      /**
+       * Set up pointers to the restriction or prolongation matrices of the
+       * given element for all children of an isotropically refined cell, so
+       * that they need not be looked up for every cell anew.
+       */
+      template <int dim, int spacedim>
+      void
+      get_transfer_matrices (const FiniteElement<dim,spacedim>       &fe,
+                             const bool                               restriction,
+                             std::vector<const FullMatrix<double> *> &matrices)
+      {
+        if (matrices.size() == GeometryInfo<dim>::max_children_per_cell)
+          return;
+
+        matrices.resize (GeometryInfo<dim>::max_children_per_cell);
+        for (unsigned int child=0; child<GeometryInfo<dim>::max_children_per_cell; ++child)
+          matrices[child] = (restriction
+                             ?
+                             &fe.get_restriction_matrix (child, RefinementCase<dim>::isotropic_refinement)
+                             :
+                             &fe.get_prolongation_matrix (child, RefinementCase<dim>::isotropic_refinement));
+      }
+
+
+
+      /**
+       * Multiply the given matrix with the values of several vectors at once,
+       * i.e., compute <tt>dst[v*n+i] = sum_j matrix(i,j) src[v*n+j]</tt> for
+       * all vectors @p v, where @p n is the size of the matrix. Since
+       * restriction and prolongation matrices are usually sparse, zero
+       * entries of the matrix are skipped.
+       */
+      template <typename Number>
+      void
+      mmult_all_vectors (const FullMatrix<double> &matrix,
+                         const Number             *src,
+                         const unsigned int        n_vectors,
+                         Number                   *dst)
+      {
+        const unsigned int n = matrix.m();
+        std::fill (dst, dst+n_vectors*n, Number());
+        for (unsigned int i=0; i<n; ++i)
+          for (unsigned int j=0; j<n; ++j)
+            {
+              const double entry = matrix(i,j);
+              if (entry != 0.)
+                for (unsigned int v=0; v<n_vectors; ++v)
+                  dst[v*n+i] += entry * src[v*n+j];
+            }
+      }
+
+
+
+      /**
+       * Get the values of all given vectors on a cell, where the values of
+       * vector @p v are stored at <tt>values[v*dofs_per_cell]</tt>. On cells
+       * that are not active, the values are interpolated from the children
+       * in the same way as DoFCellAccessor::get_interpolated_dof_values()
+       * does it, but for all vectors at once.
+       */
+      template <typename CellIterator, typename VectorType>
+      void
+      get_interpolated_dof_values (const CellIterator                            &cell,
+                                   const std::vector<const VectorType *>         &vectors,
+                                   const std::vector<const FullMatrix<double> *> &restriction_matrices,
+                                   std::vector<types::global_dof_index>          &dof_indices,
+                                   typename VectorType::value_type               *values)
+      {
+        typedef typename VectorType::value_type Number;
+
+        const FiniteElement<CellIterator::AccessorType::dimension,
+              CellIterator::AccessorType::space_dimension> &fe = cell->get_fe();
+        const unsigned int dofs_per_cell = fe.dofs_per_cell;
+        if (dofs_per_cell == 0)
+          return;
+
+        if (cell->has_children() == false)
+          {
+            dof_indices.resize (dofs_per_cell);
+            cell->get_dof_indices (dof_indices);
+            for (unsigned int v=0; v<vectors.size(); ++v)
+              for (unsigned int i=0; i<dofs_per_cell; ++i)
+                values[v*dofs_per_cell+i] = (*vectors[v])(dof_indices[i]);
+            return;
+          }
+
+        Assert (cell->refinement_case() == RefinementCase<CellIterator::AccessorType::dimension>::isotropic_refinement,
+                ExcNotImplemented());
+
+        const unsigned int n_values = vectors.size() * dofs_per_cell;
+        std::fill (values, values+n_values, Number());
+        std::vector<Number> child_values (n_values);
+        std::vector<Number> restricted_values (n_values);
+        for (unsigned int child=0; child<cell->n_children(); ++child)
+          {
+            get_interpolated_dof_values (cell->child(child), vectors,
+                                         restriction_matrices, dof_indices,
+                                         &child_values[0]);
+            mmult_all_vectors (*restriction_matrices[child], &child_values[0],
+                               vectors.size(), &restricted_values[0]);
+
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              if (fe.restriction_is_additive(i))
+                for (unsigned int v=0; v<vectors.size(); ++v)
+                  values[v*dofs_per_cell+i] += restricted_values[v*dofs_per_cell+i];
+              else
+                for (unsigned int v=0; v<vectors.size(); ++v)
+                  if (restricted_values[v*dofs_per_cell+i] != Number())
+                    values[v*dofs_per_cell+i] = restricted_values[v*dofs_per_cell+i];
+          }
+      }
+
+
+
+      /**
+       * Whether several threads may read from a vector of the given type at
+       * the same time. Reading an element of a PETSc vector goes through
+       * VecGetArray() and VecRestoreArray(), which modify the state of the
+       * vector, so the values of PETSc vectors are packed on a single thread.
+       */
+      template <typename VectorType>
+      struct AllowsConcurrentReads
+      {
+        static const bool value = true;
+      };
+
+#ifdef DEAL_II_WITH_PETSC
+      template <>
+      struct AllowsConcurrentReads<PETScWrappers::Vector>
+      {
+        static const bool value = false;
+      };
+
+      template <>
+      struct AllowsConcurrentReads<PETScWrappers::BlockVector>
+      {
+        static const bool value = false;
+      };
+
+      template <>
+      struct AllowsConcurrentReads<PETScWrappers::MPI::Vector>
+      {
+        static const bool value = false;
+      };
+
+      template <>
+      struct AllowsConcurrentReads<PETScWrappers::MPI::BlockVector>
+      {
+        static const bool value = false;
+      };
+#endif
+
+
+
+      /**
+       * Compute the values of all vectors on the cells with numbers in the
+       * half open range <tt>[begin,end)</tt> of the given list, and store
+       * them at the given offsets.
+       */
+      template <typename CellIterator, typename VectorType>
+      void
+      pack_values_on_range (const unsigned int                                       begin,
+                            const unsigned int                                       end,
+                            const std::vector<CellIterator>                         &cells,
+                            const std::vector<std::vector<types::global_dof_index> > &offsets,
+                            const std::vector<const VectorType *>                    &vectors,
+                            const std::vector<const FullMatrix<double> *>            &restriction_matrices,
+                            typename VectorType::value_type                         *packed_values)
+      {
+        std::vector<types::global_dof_index> dof_indices;
+        for (unsigned int c=begin; c<end; ++c)
+          get_interpolated_dof_values (cells[c], vectors, restriction_matrices,
+                                       dof_indices,
+                                       packed_values + offsets[cells[c]->level()][cells[c]->index()]);
+      }
+
+
+
+      /**
+       * Scratch and copy data for the interpolation of unpacked data to the
+       * new cells.
+       */
+      struct UnpackScratchData
+      {
+        std::vector<types::global_dof_index> dof_indices;
+      };
+
+      template <typename Number>
+      struct UnpackCopyData
+      {
+        UnpackCopyData ()
+          :
+          dofs_per_cell (0)
+        {}
+
+        /**
+         * The degrees of freedom of all active cells that the data of a cell
+         * of the old mesh was interpolated to, and the values of all vectors
+         * on these cells, stored cell by cell and, for each cell, vector by
+         * vector.
+         */
+        std::vector<types::global_dof_index> dof_indices;
+        std::vector<Number>                  values;
+
+        /**
+         * The number of degrees of freedom per cell. Since this class only
+         * works on DoFHandler objects, this is the same on all cells.
+         */
+        unsigned int                         dofs_per_cell;
+      };
+
+
+
+      /**
+       * Interpolate the values of all vectors on a cell to its active
+       * descendants, in the same way as
+       * DoFCellAccessor::set_dof_values_by_interpolation() does it, but for
+       * all vectors at once, and add the result to @p copy_data.
+       */
+      template <typename CellIterator, typename Number>
+      void
+      interpolate_to_active_cells (const CellIterator                            &cell,
+                                   const Number                                  *values,
+                                   const unsigned int                             n_vectors,
+                                   const std::vector<const FullMatrix<double> *> &prolongation_matrices,
+                                   UnpackScratchData                             &scratch_data,
+                                   UnpackCopyData<Number>                        &copy_data)
+      {
+        const unsigned int dofs_per_cell = cell->get_fe().dofs_per_cell;
+        if (dofs_per_cell == 0)
+          return;
+
+        if (cell->has_children() == false)
+          {
+            scratch_data.dof_indices.resize (dofs_per_cell);
+            cell->get_dof_indices (scratch_data.dof_indices);
+            copy_data.dof_indices.insert (copy_data.dof_indices.end(),
+                                          scratch_data.dof_indices.begin(),
+                                          scratch_data.dof_indices.end());
+            copy_data.values.insert (copy_data.values.end(),
+                                     values, values + n_vectors*dofs_per_cell);
+            return;
+          }
+
+        Assert (cell->refinement_case() == RefinementCase<CellIterator::AccessorType::dimension>::isotropic_refinement,
+                ExcNotImplemented());
+
+        std::vector<Number> child_values (n_vectors*dofs_per_cell);
+        for (unsigned int child=0; child<cell->n_children(); ++child)
+          {
+            mmult_all_vectors (*prolongation_matrices[child], values,
+                               n_vectors, &child_values[0]);
+            interpolate_to_active_cells (cell->child(child), &child_values[0],
+                                         n_vectors, prolongation_matrices,
+                                         scratch_data, copy_data);
+          }
+      }
+
+
+
+      template <typename CellIterator, typename Number>
+      void
+      unpack_one_cell (const std::pair<CellIterator, std::size_t>    *cell_and_offset,
+                       UnpackScratchData                             &scratch_data,
+                       UnpackCopyData<Number>                        &copy_data,
+                       const std::vector<Number>                     &unpacked_values,
+                       const unsigned int                             n_vectors,
+                       const std::vector<const FullMatrix<double> *> &prolongation_matrices)
+      {
+        copy_data.dof_indices.clear ();
+        copy_data.values.clear ();
+        copy_data.dofs_per_cell = cell_and_offset->first->get_fe().dofs_per_cell;
+
+        if (copy_data.dofs_per_cell > 0)
+          interpolate_to_active_cells (cell_and_offset->first,
+                                       &unpacked_values[cell_and_offset->second],
+                                       n_vectors, prolongation_matrices,
+                                       scratch_data, copy_data);
+      }
+
+
+
+      template <typename VectorType>
+      void
+      copy_unpacked_values (const UnpackCopyData<typename VectorType::value_type> &copy_data,
+                            const std::vector<VectorType *>                       &all_out)
+      {
+        const unsigned int dofs_per_cell = copy_data.dofs_per_cell;
+        Assert (copy_data.values.size() == copy_data.dof_indices.size() * all_out.size(),
+                ExcInternalError());
+
+        for (std::size_t cell=0; cell*dofs_per_cell<copy_data.dof_indices.size(); ++cell)
+          for (unsigned int v=0; v<all_out.size(); ++v)
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              (*all_out[v])(copy_data.dof_indices[cell*dofs_per_cell+i])
+                = copy_data.values[(cell*all_out.size()+v)*dofs_per_cell+i];
+      }
+    }
+
+
 
     template<int dim, typename VectorType, typename DoFHandlerType>
     SolutionTransfer<dim, VectorType, DoFHandlerType>::SolutionTransfer (const DoFHandlerType &dof)
@@ -67,11 +372,90 @@ namespace parallel
     prepare_for_coarsening_and_refinement (const std::vector<const VectorType *> &all_in)
     {
       input_vectors = all_in;
+      compute_packed_values ();
       register_data_attach( get_data_size() * input_vectors.size() );
     }
 
 
 
+    template<int dim, typename VectorType, typename DoFHandlerType>
+    void
+    SolutionTransfer<dim, VectorType, DoFHandlerType>::compute_packed_values ()
+    {
+      const dealii::Triangulation<dim,DoFHandlerType::space_dimension> &tria
+        = dof_handler->get_triangulation();
+      const unsigned int dofs_per_cell = dof_handler->get_fe().dofs_per_cell;
+
+      // the triangulation will ask for the values on all locally owned
+      // active cells, except for those that are coarsened, for which it
+      // asks for the values on the parent instead. whether a cell is
+      // coarsened is only decided by p4est, so we also compute the values on
+      // the cells themselves. should p4est decide differently, pack_callback()
+      // computes the values it does not find here
+      std::vector<typename DoFHandlerType::cell_iterator> cells;
+      packed_value_offsets.resize (tria.n_levels());
+      for (unsigned int level=0; level<tria.n_levels(); ++level)
+        packed_value_offsets[level].assign (tria.n_raw_cells(level),
+                                            numbers::invalid_dof_index);
+
+      types::global_dof_index n_values = 0;
+      for (typename DoFHandlerType::active_cell_iterator
+           cell = dof_handler->begin_active(); cell != dof_handler->end(); ++cell)
+        if (cell->is_locally_owned())
+          {
+            packed_value_offsets[cell->level()][cell->index()] = n_values;
+            n_values += dofs_per_cell * input_vectors.size();
+            cells.push_back (cell);
+
+            if (cell->coarsen_flag_set()
+                &&
+                (cell->level() > 0)
+                &&
+                (packed_value_offsets[cell->level()-1][cell->parent()->index()]
+                 == numbers::invalid_dof_index))
+              {
+                const typename DoFHandlerType::cell_iterator parent = cell->parent();
+                bool coarsen_parent = true;
+                for (unsigned int child=0; child<parent->n_children(); ++child)
+                  if (parent->child(child)->has_children()
+                      ||
+                      !parent->child(child)->coarsen_flag_set())
+                    coarsen_parent = false;
+
+                if (coarsen_parent)
+                  {
+                    packed_value_offsets[parent->level()][parent->index()] = n_values;
+                    n_values += dofs_per_cell * input_vectors.size();
+                    cells.push_back (parent);
+                    get_transfer_matrices (dof_handler->get_fe(), true,
+                                           restriction_matrices);
+                  }
+              }
+          }
+
+      packed_values.resize (n_values);
+      if (n_values == 0)
+        return;
+
+      if (AllowsConcurrentReads<VectorType>::value == false)
+        pack_values_on_range (0U, static_cast<unsigned int>(cells.size()),
+                              cells, packed_value_offsets, input_vectors,
+                              restriction_matrices, &packed_values[0]);
+      else
+        parallel::apply_to_subranges (0U, static_cast<unsigned int>(cells.size()),
+                                      std_cxx11::bind (&pack_values_on_range<typename DoFHandlerType::cell_iterator, VectorType>,
+                                                       std_cxx11::_1,
+                                                       std_cxx11::_2,
+                                                       std_cxx11::cref(cells),
+                                                       std_cxx11::cref(packed_value_offsets),
+                                                       std_cxx11::cref(input_vectors),
+                                                       std_cxx11::cref(restriction_matrices),
+                                                       &packed_values[0]),
+                                      32);
+    }
+
+
+
     template<int dim, typename VectorType, typename DoFHandlerType>
     void
     SolutionTransfer<dim, VectorType, DoFHandlerType>::register_data_attach (const std::size_t size)
@@ -124,7 +508,21 @@ namespace parallel
     SolutionTransfer<dim, VectorType, DoFHandlerType>::prepare_serialization
     (const std::vector<const VectorType *> &all_in)
     {
-      prepare_for_coarsening_and_refinement (all_in);
+      input_vectors = all_in;
+
+//TODO: casting away constness is bad
+      parallel::distributed::Triangulation<dim,DoFHandlerType::space_dimension> *tria
+        = (dynamic_cast<parallel::distributed::Triangulation<dim,DoFHandlerType::space_dimension>*>
+           (const_cast<dealii::Triangulation<dim,DoFHandlerType::space_dimension>*>
+            (&dof_handler->get_triangulation())));
+      Assert (tria != 0, ExcInternalError());
+
+      offset
+        = tria->register_data_attach_variable_size(std_cxx11::bind(&SolutionTransfer<dim, VectorType,
+                                                                   DoFHandlerType>::pack_callback_variable_size,
+                                                                   this,
+                                                                   std_cxx11::_1,
+                                                                   std_cxx11::_2));
     }
 
 
@@ -143,12 +541,51 @@ namespace parallel
     void
     SolutionTransfer<dim, VectorType, DoFHandlerType>::deserialize (std::vector<VectorType *> &all_in)
     {
-      register_data_attach( get_data_size() * all_in.size() );
+//TODO: casting away constness is bad
+      parallel::distributed::Triangulation<dim,DoFHandlerType::space_dimension> *tria
+        = (dynamic_cast<parallel::distributed::Triangulation<dim,DoFHandlerType::space_dimension>*>
+           (const_cast<dealii::Triangulation<dim,DoFHandlerType::space_dimension>*>
+            (&dof_handler->get_triangulation())));
+      Assert (tria != 0, ExcInternalError());
 
-      // this makes interpolate() happy
-      input_vectors.resize(all_in.size());
+      // checkpoints written before records of variable size existed store
+      // the values of all cells in slots of fixed size alongside the p4est
+      // forest. they are unpacked in the same way as after refinement
+      if (tria->n_variable_size_data_to_unpack() == 0)
+        {
+          register_data_attach (get_data_size() * all_in.size());
+
+          // this makes interpolate() happy
+          input_vectors.resize (all_in.size());
 
-      interpolate(all_in);
+          interpolate (all_in);
+          return;
+        }
+
+      // register in the same order as before save() so that we get the
+      // handle of the records that belong to this object
+      offset
+        = tria->register_data_attach_variable_size(std_cxx11::bind(&SolutionTransfer<dim, VectorType,
+                                                                   DoFHandlerType>::pack_callback_variable_size,
+                                                                   this,
+                                                                   std_cxx11::_1,
+                                                                   std_cxx11::_2));
+
+      tria->notify_ready_to_unpack_variable_size(offset,
+                                                 std_cxx11::bind(&SolutionTransfer<dim, VectorType,
+                                                                 DoFHandlerType>::unpack_callback_variable_size,
+                                                                 this,
+                                                                 std_cxx11::_1,
+                                                                 std_cxx11::_2,
+                                                                 std_cxx11::_3,
+                                                                 std_cxx11::_4,
+                                                                 std_cxx11::ref(all_in)));
+      interpolate_unpacked_values (all_in);
+
+      for (typename std::vector<VectorType *>::iterator it=all_in.begin();
+           it !=all_in.end();
+           ++it)
+        (*it)->compress(::dealii::VectorOperation::insert);
     }
 
 
@@ -174,7 +611,7 @@ namespace parallel
                                                    std_cxx11::_2,
                                                    std_cxx11::_3,
                                                    std_cxx11::ref(all_out)));
-
+      interpolate_unpacked_values (all_out);
 
       for (typename std::vector<VectorType *>::iterator it=all_out.begin();
            it !=all_out.end();
@@ -182,6 +619,8 @@ namespace parallel
         (*it)->compress(::dealii::VectorOperation::insert);
 
       input_vectors.clear();
+      std::vector<typename VectorType::value_type>().swap (packed_values);
+      std::vector<std::vector<types::global_dof_index> >().swap (packed_value_offsets);
     }
 
 
@@ -211,20 +650,31 @@ namespace parallel
                   const typename Triangulation<dim,DoFHandlerType::space_dimension>::CellStatus /*status*/,
                   void *data)
     {
-      typename VectorType::value_type *data_store = reinterpret_cast<typename VectorType::value_type *>(data);
-
       typename DoFHandlerType::cell_iterator cell(*cell_, dof_handler);
 
-      const unsigned int dofs_per_cell=cell->get_fe().dofs_per_cell;
-      ::dealii::Vector<typename VectorType::value_type> dofvalues(dofs_per_cell);
-      for (typename std::vector<const VectorType *>::iterator it=input_vectors.begin();
-           it !=input_vectors.end();
-           ++it)
+      const unsigned int n_values = cell->get_fe().dofs_per_cell * input_vectors.size();
+      if (n_values == 0)
+        return;
+
+      // usually, the values have already been computed by
+      // prepare_for_coarsening_and_refinement(), and we only need to copy
+      // them
+      if ((static_cast<unsigned int>(cell->level()) < packed_value_offsets.size())
+          &&
+          (packed_value_offsets[cell->level()][cell->index()] != numbers::invalid_dof_index))
         {
-          cell->get_interpolated_dof_values(*(*it), dofvalues);
-          std::memcpy(data_store, &dofvalues(0), sizeof(typename VectorType::value_type)*dofs_per_cell);
-          data_store += dofs_per_cell;
+          std::memcpy(data, &packed_values[packed_value_offsets[cell->level()][cell->index()]],
+                      sizeof(typename VectorType::value_type)*n_values);
+          return;
         }
+
+      std::vector<typename VectorType::value_type> values (n_values);
+      std::vector<types::global_dof_index>         dof_indices;
+      if (cell->has_children())
+        get_transfer_matrices (dof_handler->get_fe(), true, restriction_matrices);
+      get_interpolated_dof_values (cell, input_vectors, restriction_matrices,
+                                   dof_indices, &values[0]);
+      std::memcpy(data, &values[0], sizeof(typename VectorType::value_type)*n_values);
     }
 
 
@@ -239,18 +689,109 @@ namespace parallel
       typename DoFHandlerType::cell_iterator
       cell(*cell_, dof_handler);
 
-      const unsigned int dofs_per_cell=cell->get_fe().dofs_per_cell;
-      ::dealii::Vector<typename VectorType::value_type> dofvalues(dofs_per_cell);
+      // only collect the data here. it is interpolated to the new cells by
+      // interpolate_unpacked_values() once the triangulation has handed out
+      // the data of all cells
+      const unsigned int n_values = cell->get_fe().dofs_per_cell * all_out.size();
       const typename VectorType::value_type *data_store = reinterpret_cast<const typename VectorType::value_type *>(data);
 
-      for (typename std::vector<VectorType *>::iterator it = all_out.begin();
-           it != all_out.end();
-           ++it)
-        {
-          std::memcpy(&dofvalues(0), data_store, sizeof(typename VectorType::value_type)*dofs_per_cell);
-          cell->set_dof_values_by_interpolation(dofvalues, *(*it));
-          data_store += dofs_per_cell;
-        }
+      unpacked_cells.push_back (std::make_pair (cell, unpacked_values.size()));
+      unpacked_values.resize (unpacked_values.size() + n_values);
+      if (n_values > 0)
+        std::memcpy(&unpacked_values[unpacked_cells.back().second], data_store,
+                    sizeof(typename VectorType::value_type)*n_values);
+    }
+
+
+
+    template<int dim, typename VectorType, typename DoFHandlerType>
+    void
+    SolutionTransfer<dim, VectorType, DoFHandlerType>::
+    interpolate_unpacked_values (std::vector<VectorType *> &all_out)
+    {
+      for (unsigned int i=0; i<unpacked_cells.size(); ++i)
+        if (unpacked_cells[i].first->has_children())
+          {
+            get_transfer_matrices (dof_handler->get_fe(), false, prolongation_matrices);
+            break;
+          }
+
+      // interpolate the data in parallel, but write the results into the
+      // output vectors sequentially, since neighboring cells share degrees
+      // of freedom
+      if (unpacked_cells.size() > 0)
+        WorkStream::run (&unpacked_cells[0],
+                         &unpacked_cells[0]+unpacked_cells.size(),
+                         std_cxx11::bind (&unpack_one_cell<typename DoFHandlerType::cell_iterator,
+                                          typename VectorType::value_type>,
+                                          std_cxx11::_1,
+                                          std_cxx11::_2,
+                                          std_cxx11::_3,
+                                          std_cxx11::cref(unpacked_values),
+                                          static_cast<unsigned int>(all_out.size()),
+                                          std_cxx11::cref(prolongation_matrices)),
+                         std_cxx11::bind (&copy_unpacked_values<VectorType>,
+                                          std_cxx11::_1,
+                                          std_cxx11::cref(all_out)),
+                         UnpackScratchData(),
+                         UnpackCopyData<typename VectorType::value_type>());
+
+      std::vector<std::pair<typename DoFHandlerType::cell_iterator, std::size_t> >().swap (unpacked_cells);
+      std::vector<typename VectorType::value_type>().swap (unpacked_values);
+    }
+
+
+
+
+    template<int dim, typename VectorType, typename DoFHandlerType>
+    std::vector<char>
+    SolutionTransfer<dim, VectorType, DoFHandlerType>::
+    pack_callback_variable_size(const typename Triangulation<dim,DoFHandlerType::space_dimension>::cell_iterator &cell_,
+                                const typename Triangulation<dim,DoFHandlerType::space_dimension>::CellStatus /*status*/)
+    {
+      typename DoFHandlerType::cell_iterator cell(*cell_, dof_handler);
+
+      // only store as many values as the finite element on this cell has
+      // degrees of freedom
+      const unsigned int dofs_per_cell=cell->get_fe().dofs_per_cell;
+      std::vector<char> data(sizeof(typename VectorType::value_type)*dofs_per_cell*input_vectors.size());
+      if (data.size() == 0)
+        return data;
+
+      std::vector<typename VectorType::value_type> values (dofs_per_cell*input_vectors.size());
+      std::vector<types::global_dof_index>         dof_indices;
+      if (cell->has_children())
+        get_transfer_matrices (dof_handler->get_fe(), true, restriction_matrices);
+      get_interpolated_dof_values (cell, input_vectors, restriction_matrices,
+                                   dof_indices, &values[0]);
+      std::memcpy(&data[0], &values[0], data.size());
+      return data;
+    }
+
+
+    template<int dim, typename VectorType, typename DoFHandlerType>
+    void
+    SolutionTransfer<dim, VectorType, DoFHandlerType>::unpack_callback_variable_size
+    (const typename Triangulation<dim,DoFHandlerType::space_dimension>::cell_iterator &cell_,
+     const typename Triangulation<dim,DoFHandlerType::space_dimension>::CellStatus    /*status*/,
+     const void                                           *data,
+     const std::size_t                                     size,
+     std::vector<VectorType *>                            &all_out)
+    {
+      typename DoFHandlerType::cell_iterator
+      cell(*cell_, dof_handler);
+
+      const unsigned int dofs_per_cell=cell->get_fe().dofs_per_cell;
+      AssertThrow (size == sizeof(typename VectorType::value_type)*dofs_per_cell*all_out.size(),
+                   ExcMessage ("The number of values stored for a cell does not match the "
+                               "finite element and the number of vectors to deserialize."));
+      if (size == 0)
+        return;
+
+      // as in unpack_callback(), only collect the data here
+      unpacked_cells.push_back (std::make_pair (cell, unpacked_values.size()));
+      unpacked_values.resize (unpacked_values.size() + dofs_per_cell*all_out.size());
+      std::memcpy(&unpacked_values[unpacked_cells.back().second], data, size);
     }
 
 
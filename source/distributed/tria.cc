@@ -1169,6 +1169,81 @@ namespace
   }
 
 
+  template <int dim, int spacedim>
+  void
+  add_locally_owned_leaves (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                            std::vector<typename Triangulation<dim,spacedim>::cell_iterator> &leaves)
+  {
+    // the children of a deal.II cell are numbered in the same way as p4est
+    // numbers the children of a quadrant, so a depth-first traversal visits
+    // the leaves in the order of the space filling curve
+    if (cell->has_children())
+      for (unsigned int c=0; c<cell->n_children(); ++c)
+        add_locally_owned_leaves<dim,spacedim> (cell->child(c), leaves);
+    else if (cell->is_locally_owned())
+      leaves.push_back (cell);
+  }
+
+
+
+  // MPI-IO takes the number of elements to be written or read as an int, so
+  // large buffers need to be split into several calls. Since the calls are
+  // collective, every process needs to make as many calls as the process
+  // with the largest buffer.
+  const uint64_t mpi_io_chunk_size = (1U<<30);
+
+  void
+  write_at_all (MPI_File          fh,
+                const MPI_Offset  offset,
+                const char       *data,
+                const uint64_t    size,
+                MPI_Comm          mpi_communicator)
+  {
+    const unsigned int n_chunks
+      = Utilities::MPI::max (static_cast<unsigned int>((size + mpi_io_chunk_size - 1) /
+                                                       mpi_io_chunk_size),
+                             mpi_communicator);
+    for (unsigned int c=0; c<n_chunks; ++c)
+      {
+        const uint64_t begin = std::min (c*mpi_io_chunk_size, size);
+        const uint64_t end   = std::min (begin+mpi_io_chunk_size, size);
+        const int ierr = MPI_File_write_at_all (fh, offset+begin,
+                                                const_cast<char *>(data)+begin,
+                                                end-begin, MPI_BYTE,
+                                                MPI_STATUS_IGNORE);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+        (void)ierr;
+      }
+  }
+
+
+
+  void
+  read_at_all (MPI_File          fh,
+               const MPI_Offset  offset,
+               char             *data,
+               const uint64_t    size,
+               MPI_Comm          mpi_communicator)
+  {
+    const unsigned int n_chunks
+      = Utilities::MPI::max (static_cast<unsigned int>((size + mpi_io_chunk_size - 1) /
+                                                       mpi_io_chunk_size),
+                             mpi_communicator);
+    for (unsigned int c=0; c<n_chunks; ++c)
+      {
+        const uint64_t begin = std::min (c*mpi_io_chunk_size, size);
+        const uint64_t end   = std::min (begin+mpi_io_chunk_size, size);
+        const int ierr = MPI_File_read_at_all (fh, offset+begin,
+                                               data+begin,
+                                               end-begin, MPI_BYTE,
+                                               MPI_STATUS_IGNORE);
+        AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+        (void)ierr;
+      }
+  }
+
+
+
   template <int dim, int spacedim>
   void
   delete_all_children_and_self (const typename Triangulation<dim,spacedim>::cell_iterator &cell)
@@ -2216,7 +2291,9 @@ namespace parallel
       refinement_in_progress (false),
       attached_data_size(0),
       n_attached_datas(0),
-      n_attached_deserialize(0)
+      n_attached_deserialize(0),
+      n_variable_size_datas_loaded(0),
+      n_variable_size_deserialize(0)
     {
       // initialize p4est. do this in a separate function since it has to
       // happen only once, even if we have triangulation objects for several
@@ -2691,6 +2768,8 @@ namespace parallel
     {
       Assert(n_attached_deserialize==0,
              ExcMessage ("not all SolutionTransfer's got deserialized after the last load()"));
+      Assert(n_variable_size_deserialize==0,
+             ExcMessage ("not all data of variable size got unpacked after the last load()"));
       int real_data_size = 0;
       if (attached_data_size>0)
         real_data_size = attached_data_size+sizeof(CellStatus);
@@ -2701,15 +2780,19 @@ namespace parallel
         {
           std::string fname=std::string(filename)+".info";
           std::ofstream f(fname.c_str());
-          f << "version nproc attached_bytes n_attached_objs n_coarse_cells" << std::endl
-            << 2 << " "
+          f << "version nproc attached_bytes n_attached_objs n_coarse_cells n_variable_size_objs" << std::endl
+            << 3 << " "
             << Utilities::MPI::n_mpi_processes (this->mpi_communicator) << " "
             << real_data_size << " "
             << attached_data_pack_callbacks.size() << " "
-            << this->n_cells(0)
+            << this->n_cells(0) << " "
+            << variable_size_pack_callbacks.size()
             << std::endl;
         }
 
+      if (variable_size_pack_callbacks.size() > 0)
+        save_variable_size_data (filename);
+
       if (attached_data_size>0)
         {
           const_cast<dealii::parallel::distributed::Triangulation<dim, spacedim>*>(this)
@@ -2724,6 +2807,7 @@ namespace parallel
       tria->n_attached_datas = 0;
       tria->attached_data_size = 0;
       tria->attached_data_pack_callbacks.clear();
+      tria->variable_size_pack_callbacks.clear();
 
       // and release the data
       void *userptr = parallel_forest->user_pointer;
@@ -2753,15 +2837,20 @@ namespace parallel
       connectivity = 0;
 
       unsigned int version, numcpus, attached_size, attached_count, n_coarse_cells;
+      unsigned int n_variable_size_objects = 0;
       {
         std::string fname=std::string(filename)+".info";
         std::ifstream f(fname.c_str());
         std::string firstline;
         getline(f, firstline); //skip first line
         f >> version >> numcpus >> attached_size >> attached_count >> n_coarse_cells;
+        // files written before version 3 contain no data of variable size
+        if (version >= 3)
+          f >> n_variable_size_objects;
       }
 
-      Assert(version == 2, ExcMessage("Incompatible version found in .info file."));
+      AssertThrow(version == 2 || version == 3,
+                  ExcMessage("Incompatible version found in .info file."));
       Assert(this->n_cells(0) == n_coarse_cells, ExcMessage("Number of coarse cells differ!"));
 #if DEAL_II_P4EST_VERSION_GTE(0,3,4,3)
 #else
@@ -2813,6 +2902,157 @@ namespace parallel
 
       this->update_number_cache ();
       this->update_periodic_face_map();
+
+      // the records of variable size are read only now that the final
+      // partition is known, so that each process reads exactly the parts of
+      // the file that belong to its cells
+      variable_size_pack_callbacks.clear ();
+      variable_size_data.clear ();
+      variable_size_offsets.clear ();
+      n_variable_size_datas_loaded = n_variable_size_objects;
+      n_variable_size_deserialize  = n_variable_size_objects;
+      if (n_variable_size_objects > 0)
+        load_variable_size_data (filename, n_variable_size_objects);
+    }
+
+
+
+    template <int dim, int spacedim>
+    std::vector<typename Triangulation<dim,spacedim>::cell_iterator>
+    Triangulation<dim,spacedim>::locally_owned_cells_in_p4est_order () const
+    {
+      std::vector<cell_iterator> cells;
+      cells.reserve (parallel_forest->local_num_quadrants);
+
+      // processes without cells have last_local_tree < first_local_tree
+      for (typename dealii::internal::p4est::types<dim>::topidx
+           tree = parallel_forest->first_local_tree;
+           tree <= parallel_forest->last_local_tree; ++tree)
+        {
+          const cell_iterator coarse_cell (this, 0,
+                                           p4est_tree_to_coarse_cell_permutation[tree]);
+          add_locally_owned_leaves<dim,spacedim> (coarse_cell, cells);
+        }
+
+      Assert (cells.size() == static_cast<std::size_t>(parallel_forest->local_num_quadrants),
+              ExcInternalError());
+      return cells;
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::save_variable_size_data (const char *filename) const
+    {
+      const unsigned int n_objects = variable_size_pack_callbacks.size();
+      const std::vector<cell_iterator> cells = locally_owned_cells_in_p4est_order ();
+
+      // pack the records of all locally owned cells into one buffer and
+      // remember where each of them ends
+      std::vector<char>     buffer;
+      std::vector<uint64_t> offsets (cells.size() * n_objects);
+      for (unsigned int c=0; c<cells.size(); ++c)
+        for (unsigned int j=0; j<n_objects; ++j)
+          {
+            const std::vector<char> record
+              = variable_size_pack_callbacks[j] (cells[c], this->CELL_PERSIST);
+            buffer.insert (buffer.end(), record.begin(), record.end());
+            offsets[c*n_objects+j] = buffer.size();
+          }
+
+      // the offsets stored in the file are relative to the beginning of the
+      // data section, so shift them by the number of bytes written by the
+      // processes that precede this one along the space filling curve. the
+      // result of MPI_Exscan is undefined on the first process
+      uint64_t local_size = buffer.size();
+      uint64_t preceding_size = 0;
+      const int ierr = MPI_Exscan (&local_size, &preceding_size, 1, MPI_UINT64_T,
+                                   MPI_SUM, this->mpi_communicator);
+      AssertThrow (ierr == MPI_SUCCESS, ExcInternalError());
+      (void)ierr;
+      if (this->my_subdomain == 0)
+        preceding_size = 0;
+      for (unsigned int i=0; i<offsets.size(); ++i)
+        offsets[i] += preceding_size;
+
+      const uint64_t first_entry
+        = parallel_forest->global_first_quadrant[this->my_subdomain] * n_objects;
+      const uint64_t table_size
+        = parallel_forest->global_num_quadrants * n_objects * sizeof(uint64_t);
+
+      const std::string fname = std::string(filename)+".variable";
+      MPI_File fh;
+      const int err = MPI_File_open (this->mpi_communicator, const_cast<char *>(fname.c_str()),
+                                     MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+      AssertThrow (err == MPI_SUCCESS,
+                   ExcMessage ("Unable to open file <" + fname +
+                               "> for writing the data of variable size."));
+      MPI_File_set_size (fh, 0); // delete the file contents
+
+      write_at_all (fh, first_entry * sizeof(uint64_t),
+                    (offsets.size() > 0 ? reinterpret_cast<const char *>(&offsets[0]) : 0),
+                    offsets.size() * sizeof(uint64_t),
+                    this->mpi_communicator);
+      write_at_all (fh, table_size + preceding_size,
+                    (buffer.size() > 0 ? &buffer[0] : 0),
+                    buffer.size(),
+                    this->mpi_communicator);
+
+      MPI_File_close (&fh);
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::load_variable_size_data (const char *filename,
+                                                          const unsigned int n_objects)
+    {
+      const uint64_t n_local_entries
+        = static_cast<uint64_t>(parallel_forest->local_num_quadrants) * n_objects;
+      const uint64_t first_entry
+        = parallel_forest->global_first_quadrant[this->my_subdomain] * n_objects;
+      const uint64_t table_size
+        = parallel_forest->global_num_quadrants * n_objects * sizeof(uint64_t);
+
+      const std::string fname = std::string(filename)+".variable";
+      MPI_File fh;
+      const int err = MPI_File_open (this->mpi_communicator, const_cast<char *>(fname.c_str()),
+                                     MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);
+      AssertThrow (err == MPI_SUCCESS,
+                   ExcMessage ("Unable to open file <" + fname +
+                               "> for reading the data of variable size."));
+
+      // read the ends of the records of the locally owned cells, along with
+      // the end of the last record of the preceding cell, which is where the
+      // first local record starts
+      variable_size_offsets.resize (n_local_entries + 1);
+      variable_size_offsets[0] = 0;
+      if (first_entry > 0)
+        read_at_all (fh, (first_entry - 1) * sizeof(uint64_t),
+                     reinterpret_cast<char *>(&variable_size_offsets[0]),
+                     (n_local_entries + 1) * sizeof(uint64_t),
+                     this->mpi_communicator);
+      else
+        read_at_all (fh, 0,
+                     reinterpret_cast<char *>(&variable_size_offsets[0]) + sizeof(uint64_t),
+                     n_local_entries * sizeof(uint64_t),
+                     this->mpi_communicator);
+
+      // then read exactly the range of records that belongs to this process
+      const uint64_t begin = variable_size_offsets[0];
+      const uint64_t end   = variable_size_offsets.back();
+      variable_size_data.resize (end - begin);
+      read_at_all (fh, table_size + begin,
+                   (variable_size_data.size() > 0 ? &variable_size_data[0] : 0),
+                   variable_size_data.size(),
+                   this->mpi_communicator);
+
+      MPI_File_close (&fh);
+
+      for (unsigned int i=0; i<variable_size_offsets.size(); ++i)
+        variable_size_offsets[i] -= begin;
     }
 
 
@@ -3855,7 +4095,9 @@ namespace parallel
                        /* weight_callback */ NULL);
           else
             {
-              // get cell weights for a weighted repartitioning.
+              // get cell weights for a weighted repartitioning, after
+              // letting the objects that provide them prepare themselves
+              this->signals.pre_distributed_repartition();
               const std::vector<unsigned int> cell_weights = get_cell_weights();
 
               PartitionWeights<dim,spacedim> partition_weights (cell_weights);
@@ -3983,7 +4225,9 @@ namespace parallel
         }
       else
         {
-          // get cell weights for a weighted repartitioning.
+          // get cell weights for a weighted repartitioning, after letting
+          // the objects that provide them prepare themselves
+          this->signals.pre_distributed_repartition();
           const std::vector<unsigned int> cell_weights = get_cell_weights();
 
           PartitionWeights<dim,spacedim> partition_weights (cell_weights);
@@ -4196,6 +4440,70 @@ namespace parallel
 
 
 
+    template <int dim, int spacedim>
+    unsigned int
+    Triangulation<dim,spacedim>::
+    register_data_attach_variable_size
+    (const std_cxx11::function<std::vector<char> (const cell_iterator &,
+                                                  const CellStatus)> &pack_callback)
+    {
+      variable_size_pack_callbacks.push_back (pack_callback);
+      return variable_size_pack_callbacks.size() - 1;
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    notify_ready_to_unpack_variable_size
+    (const unsigned int handle,
+     const std_cxx11::function<void (const cell_iterator &,
+                                     const CellStatus,
+                                     const void *,
+                                     const std::size_t)> &unpack_callback)
+    {
+      Assert (n_variable_size_deserialize > 0,
+              ExcMessage ("notify_ready_to_unpack_variable_size() called too often"));
+      Assert (handle < n_variable_size_datas_loaded,
+              ExcMessage ("invalid handle in notify_ready_to_unpack_variable_size()"));
+
+      const unsigned int n_objects = n_variable_size_datas_loaded;
+      const std::vector<cell_iterator> cells = locally_owned_cells_in_p4est_order ();
+      Assert (variable_size_offsets.size() == cells.size()*n_objects + 1,
+              ExcInternalError());
+
+      for (unsigned int c=0; c<cells.size(); ++c)
+        {
+          const uint64_t begin = variable_size_offsets[c*n_objects+handle];
+          const uint64_t end   = variable_size_offsets[c*n_objects+handle+1];
+          unpack_callback (cells[c], this->CELL_PERSIST,
+                           (end > begin ? &variable_size_data[begin] : 0),
+                           end - begin);
+        }
+
+      --n_variable_size_deserialize;
+      if (n_variable_size_deserialize == 0)
+        {
+          // everybody got their data, release the buffers
+          n_variable_size_datas_loaded = 0;
+          variable_size_pack_callbacks.clear ();
+          std::vector<char>().swap (variable_size_data);
+          std::vector<uint64_t>().swap (variable_size_offsets);
+        }
+    }
+
+
+
+    template <int dim, int spacedim>
+    unsigned int
+    Triangulation<dim,spacedim>::n_variable_size_data_to_unpack () const
+    {
+      return n_variable_size_deserialize;
+    }
+
+
+
     template <int dim, int spacedim>
     void
     Triangulation<dim,spacedim>::
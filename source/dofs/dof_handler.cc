@@ -14,6 +14,7 @@
 // ---------------------------------------------------------------------
 
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/performance_trace.h>
 #include <deal.II/dofs/dof_handler.h>
 #include <deal.II/dofs/dof_handler_policy.h>
 #include <deal.II/dofs/dof_levels.h>
@@ -27,6 +28,7 @@
 #include <deal.II/fe/fe.h>
 #include <deal.II/distributed/shared_tria.h>
 #include <deal.II/distributed/tria.h>
+#include <deal.II/distributed/fully_distributed_tria.h>
 
 #include <set>
 #include <algorithm>
@@ -665,6 +667,10 @@ DoFHandler<dim,spacedim>::DoFHandler (const Triangulation<dim,spacedim> &tria)
       (&tria)
       != 0)
     policy.reset (new internal::DoFHandler::Policy::ParallelShared<dim,spacedim>());
+  else if (dynamic_cast<const parallel::fullydistributed::Triangulation< dim, spacedim>*>
+           (&tria)
+           != 0)
+    policy.reset (new internal::DoFHandler::Policy::ParallelFullyDistributed<dim,spacedim>());
   else if (dynamic_cast<const parallel::distributed::Triangulation< dim, spacedim >*>
            (&tria)
            == 0)
@@ -709,6 +715,10 @@ DoFHandler<dim,spacedim>::initialize(
       (&t)
       != 0)
     policy.reset (new internal::DoFHandler::Policy::ParallelShared<dim,spacedim>());
+  else if (dynamic_cast<const parallel::fullydistributed::Triangulation< dim, spacedim>*>
+           (&t)
+           != 0)
+    policy.reset (new internal::DoFHandler::Policy::ParallelFullyDistributed<dim,spacedim>());
   else if (dynamic_cast<const parallel::distributed::Triangulation< dim, spacedim >*>
            (&t)
            == 0)
@@ -1113,6 +1123,8 @@ DoFHandler<dim,spacedim>::memory_consumption () const
 template<int dim, int spacedim>
 void DoFHandler<dim,spacedim>::distribute_dofs (const FiniteElement<dim,spacedim> &ff)
 {
+  PerformanceTrace::Scope trace_scope ("DoFHandler::distribute_dofs");
+
   selected_fe = &ff;
 
   // delete all levels and set them
@@ -1141,7 +1153,8 @@ void DoFHandler<dim,spacedim>::distribute_dofs (const FiniteElement<dim,spacedim
   // only if this is a sequential
   // triangulation. it doesn't work
   // correctly yet if it is parallel
-  if (dynamic_cast<const parallel::distributed::Triangulation<dim,spacedim>*>(&*tria) == 0)
+  if ((dynamic_cast<const parallel::distributed::Triangulation<dim,spacedim>*>(&*tria) == 0) &&
+      (dynamic_cast<const parallel::fullydistributed::Triangulation<dim,spacedim>*>(&*tria) == 0))
     block_info_object.initialize(*this, false, true);
 }
 
@@ -1171,7 +1184,8 @@ void DoFHandler<dim, spacedim>::distribute_mg_dofs (const FiniteElement<dim, spa
   // only if this is a sequential
   // triangulation. it doesn't work
   // correctly yet if it is parallel
-  if (dynamic_cast<const parallel::distributed::Triangulation<dim,spacedim>*>(&*tria) == 0)
+  if ((dynamic_cast<const parallel::distributed::Triangulation<dim,spacedim>*>(&*tria) == 0) &&
+      (dynamic_cast<const parallel::fullydistributed::Triangulation<dim,spacedim>*>(&*tria) == 0))
     block_info_object.initialize (*this, true, false);
 }
 
@@ -27,6 +27,7 @@
 #include <deal.II/fe/fe.h>
 #include <deal.II/distributed/shared_tria.h>
 #include <deal.II/distributed/tria.h>
+#include <deal.II/distributed/fully_distributed_tria.h>
 
 #include <set>
 #include <algorithm>
@@ -2756,6 +2757,413 @@ namespace internal
 
         number_cache_current = number_cache;
       }
+
+
+
+      /* --------------------- class ParallelFullyDistributed ---------------- */
+
+#ifdef DEAL_II_WITH_MPI
+      namespace
+      {
+        /**
+         * Append the active descendants of the locally stored coarse cell
+         * with index @p coarse_cell_index to @p cells, in the order of a
+         * depth-first traversal of the children.
+         */
+        template <int dim, int spacedim>
+        void
+        add_active_descendants (const typename DoFHandler<dim,spacedim>::cell_iterator           &cell,
+                                std::vector<typename DoFHandler<dim,spacedim>::active_cell_iterator> &cells)
+        {
+          if (cell->has_children())
+            for (unsigned int c=0; c<cell->n_children(); ++c)
+              add_active_descendants<dim,spacedim> (cell->child(c), cells);
+          else
+            cells.push_back (cell);
+        }
+
+
+
+        template <int dim, int spacedim>
+        void
+        get_active_cells_of_coarse_cells (const DoFHandler<dim,spacedim>                                   &dof_handler,
+                                          const std::vector<unsigned int>                                  &coarse_cell_indices,
+                                          std::vector<typename DoFHandler<dim,spacedim>::active_cell_iterator> &cells)
+        {
+          cells.clear ();
+          for (unsigned int i=0; i<coarse_cell_indices.size(); ++i)
+            add_active_descendants<dim,spacedim>
+            (typename DoFHandler<dim,spacedim>::cell_iterator (&dof_handler.get_triangulation(),
+                                                               0, coarse_cell_indices[i],
+                                                               &dof_handler),
+             cells);
+        }
+
+
+
+        /**
+         * Send the dof indices of the locally owned cells in the ghost
+         * layers of other processors to these processors, and set the dof
+         * indices of the ghost cells to the ones received from their owners.
+         * Dof indices that are invalid on the sending side do not overwrite
+         * the ones of the receiving side.
+         *
+         * Since both sides know the ghost layer, no cell ids need to be sent
+         * along with the indices, and the size of each message is known in
+         * advance.
+         */
+        template <int dim, int spacedim>
+        void
+        communicate_dof_indices_on_ghost_layers (DoFHandler<dim,spacedim>                                      &dof_handler,
+                                                 const parallel::fullydistributed::Triangulation<dim,spacedim> &tr,
+                                                 const int                                                      mpi_tag)
+        {
+          typedef std::map<dealii::types::subdomain_id, std::vector<unsigned int> > CoarseCellMap;
+          const CoarseCellMap &send_coarse_cells = tr.coarse_cells_in_ghost_layers();
+          const CoarseCellMap &receive_coarse_cells = tr.coarse_cells_of_ghost_owners();
+
+          std::vector<typename DoFHandler<dim,spacedim>::active_cell_iterator> cells;
+          std::vector<dealii::types::global_dof_index> local_dof_indices;
+
+          std::vector<std::vector<dealii::types::global_dof_index> > send_buffers (send_coarse_cells.size());
+          std::vector<MPI_Request> requests (send_coarse_cells.size());
+          unsigned int index = 0;
+          for (typename CoarseCellMap::const_iterator neighbor = send_coarse_cells.begin();
+               neighbor != send_coarse_cells.end(); ++neighbor, ++index)
+            {
+              get_active_cells_of_coarse_cells (dof_handler, neighbor->second, cells);
+              for (unsigned int c=0; c<cells.size(); ++c)
+                {
+                  local_dof_indices.resize (cells[c]->get_fe().dofs_per_cell);
+                  cells[c]->get_dof_indices (local_dof_indices);
+                  send_buffers[index].insert (send_buffers[index].end(),
+                                              local_dof_indices.begin(),
+                                              local_dof_indices.end());
+                }
+              MPI_Isend (send_buffers[index].size() > 0 ? &send_buffers[index][0] : 0,
+                         send_buffers[index].size(), DEAL_II_DOF_INDEX_MPI_TYPE,
+                         neighbor->first, mpi_tag,
+                         tr.get_communicator(), &requests[index]);
+            }
+
+          std::vector<dealii::types::global_dof_index> receive_buffer;
+          for (typename CoarseCellMap::const_iterator neighbor = receive_coarse_cells.begin();
+               neighbor != receive_coarse_cells.end(); ++neighbor)
+            {
+              get_active_cells_of_coarse_cells (dof_handler, neighbor->second, cells);
+              unsigned int n_indices = 0;
+              for (unsigned int c=0; c<cells.size(); ++c)
+                n_indices += cells[c]->get_fe().dofs_per_cell;
+              receive_buffer.resize (n_indices);
+              MPI_Recv (n_indices > 0 ? &receive_buffer[0] : 0,
+                        n_indices, DEAL_II_DOF_INDEX_MPI_TYPE,
+                        neighbor->first, mpi_tag,
+                        tr.get_communicator(), MPI_STATUS_IGNORE);
+
+              const dealii::types::global_dof_index *dofs = n_indices > 0 ? &receive_buffer[0] : 0;
+              for (unsigned int c=0; c<cells.size(); ++c)
+                {
+                  Assert (cells[c]->is_ghost(), ExcInternalError());
+
+                  // the indices of this cell may have changed through the
+                  // ones set on a neighbor
+                  cells[c]->update_cell_dof_indices_cache ();
+                  local_dof_indices.resize (cells[c]->get_fe().dofs_per_cell);
+                  cells[c]->get_dof_indices (local_dof_indices);
+                  for (unsigned int i=0; i<local_dof_indices.size(); ++i, ++dofs)
+                    if (*dofs != DoFHandler<dim,spacedim>::invalid_dof_index)
+                      {
+                        Assert ((local_dof_indices[i] == DoFHandler<dim,spacedim>::invalid_dof_index)
+                                ||
+                                (local_dof_indices[i] == *dofs),
+                                ExcInternalError());
+                        local_dof_indices[i] = *dofs;
+                      }
+                  cells[c]->set_dof_indices (local_dof_indices);
+                }
+            }
+
+          if (requests.size() > 0)
+            MPI_Waitall (requests.size(), &requests[0], MPI_STATUSES_IGNORE);
+
+          for (typename DoFHandler<dim,spacedim>::active_cell_iterator
+               cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+            if (!cell->is_artificial())
+              cell->update_cell_dof_indices_cache ();
+        }
+
+
+
+        /**
+         * Exchange the dof indices twice: after the first round, all dof
+         * indices on the locally owned cells are known, including the ones
+         * owned by other processors, and the second round then completes the
+         * ghost cells.
+         */
+        template <int dim, int spacedim>
+        void
+        communicate_dof_indices (DoFHandler<dim,spacedim> &dof_handler)
+        {
+          const parallel::fullydistributed::Triangulation<dim,spacedim> *tr
+            = (dynamic_cast<const parallel::fullydistributed::Triangulation<dim,spacedim>*>
+               (&dof_handler.get_triangulation()));
+          Assert (tr != 0, ExcInternalError());
+
+          communicate_dof_indices_on_ghost_layers (dof_handler, *tr, 4311);
+          communicate_dof_indices_on_ghost_layers (dof_handler, *tr, 4312);
+
+#ifdef DEBUG
+          std::vector<dealii::types::global_dof_index> local_dof_indices;
+          for (typename DoFHandler<dim,spacedim>::active_cell_iterator
+               cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+            if (!cell->is_artificial())
+              {
+                local_dof_indices.resize (cell->get_fe().dofs_per_cell);
+                cell->get_dof_indices (local_dof_indices);
+                Assert (std::find (local_dof_indices.begin(),
+                                   local_dof_indices.end(),
+                                   DoFHandler<dim,spacedim>::invalid_dof_index)
+                        == local_dof_indices.end(),
+                        ExcMessage ("Not all dof indices on the locally owned "
+                                    "and ghost cells have been set."));
+              }
+#endif
+        }
+      }
+#endif // DEAL_II_WITH_MPI
+
+
+
+      template <int dim, int spacedim>
+      void
+      ParallelFullyDistributed<dim, spacedim>::
+      distribute_dofs (DoFHandler<dim,spacedim> &dof_handler,
+                       NumberCache &number_cache_current) const
+      {
+        NumberCache number_cache;
+
+#ifndef DEAL_II_WITH_MPI
+        (void)dof_handler;
+        Assert (false, ExcNotImplemented());
+#else
+        const parallel::fullydistributed::Triangulation<dim,spacedim> *tr
+          = (dynamic_cast<const parallel::fullydistributed::Triangulation<dim,spacedim>*>
+             (&dof_handler.get_triangulation()));
+        Assert (tr != 0, ExcInternalError());
+
+        const unsigned int n_cpus = Utilities::MPI::n_mpi_processes (tr->get_communicator());
+
+        // the first steps are the same as for a
+        // parallel::distributed::Triangulation: number the dofs on the
+        // locally owned cells, drop the ones that are owned by a processor
+        // with lower subdomain id, and shift the rest
+        const dealii::types::global_dof_index n_initial_local_dofs =
+          Implementation::distribute_dofs (0, tr->locally_owned_subdomain(),
+                                           dof_handler);
+
+        std::vector<dealii::types::global_dof_index> renumbering(n_initial_local_dofs);
+        for (unsigned int i=0; i<renumbering.size(); ++i)
+          renumbering[i] = i;
+
+        {
+          std::vector<dealii::types::global_dof_index> local_dof_indices;
+
+          for (typename DoFHandler<dim,spacedim>::active_cell_iterator
+               cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+            if (cell->is_ghost() &&
+                (cell->subdomain_id() < tr->locally_owned_subdomain()))
+              {
+                local_dof_indices.resize (cell->get_fe().dofs_per_cell);
+                cell->get_dof_indices (local_dof_indices);
+                for (unsigned int i=0; i<cell->get_fe().dofs_per_cell; ++i)
+                  if (local_dof_indices[i] != DoFHandler<dim,spacedim>::invalid_dof_index)
+                    renumbering[local_dof_indices[i]]
+                      = DoFHandler<dim,spacedim>::invalid_dof_index;
+              }
+        }
+
+        number_cache.n_locally_owned_dofs = 0;
+        for (std::vector<dealii::types::global_dof_index>::iterator it=renumbering.begin();
+             it!=renumbering.end(); ++it)
+          if (*it != DoFHandler<dim,spacedim>::invalid_dof_index)
+            *it = number_cache.n_locally_owned_dofs++;
+
+        number_cache.n_locally_owned_dofs_per_processor.resize(n_cpus);
+        MPI_Allgather ( &number_cache.n_locally_owned_dofs,
+                        1, DEAL_II_DOF_INDEX_MPI_TYPE,
+                        &number_cache.n_locally_owned_dofs_per_processor[0],
+                        1, DEAL_II_DOF_INDEX_MPI_TYPE,
+                        tr->get_communicator());
+
+        const dealii::types::global_dof_index
+        shift = std::accumulate (number_cache
+                                 .n_locally_owned_dofs_per_processor.begin(),
+                                 number_cache
+                                 .n_locally_owned_dofs_per_processor.begin()
+                                 + tr->locally_owned_subdomain(),
+                                 static_cast<dealii::types::global_dof_index>(0));
+        for (std::vector<dealii::types::global_dof_index>::iterator it=renumbering.begin();
+             it!=renumbering.end(); ++it)
+          if (*it != DoFHandler<dim,spacedim>::invalid_dof_index)
+            (*it) += shift;
+
+        Implementation::renumber_dofs (renumbering, IndexSet(0),
+                                       dof_handler, false);
+
+        number_cache.n_global_dofs
+          = std::accumulate (number_cache
+                             .n_locally_owned_dofs_per_processor.begin(),
+                             number_cache
+                             .n_locally_owned_dofs_per_processor.end(),
+                             static_cast<dealii::types::global_dof_index>(0));
+
+        number_cache.locally_owned_dofs = IndexSet(number_cache.n_global_dofs);
+        number_cache.locally_owned_dofs
+        .add_range(shift,
+                   shift+number_cache.n_locally_owned_dofs);
+        number_cache.locally_owned_dofs.compress();
+
+        number_cache.locally_owned_dofs_per_processor.resize(n_cpus);
+        {
+          dealii::types::global_dof_index lshift = 0;
+          for (unsigned int i=0; i<n_cpus; ++i)
+            {
+              number_cache.locally_owned_dofs_per_processor[i]
+                = IndexSet(number_cache.n_global_dofs);
+              number_cache.locally_owned_dofs_per_processor[i]
+              .add_range(lshift,
+                         lshift +
+                         number_cache.n_locally_owned_dofs_per_processor[i]);
+              lshift += number_cache.n_locally_owned_dofs_per_processor[i];
+            }
+        }
+
+        // then get the indices of the ghost cells from their owners. the
+        // ghost layer is given by the coarse cells, so in contrast to
+        // parallel::distributed::Triangulation no cell ids need to be sent
+        communicate_dof_indices (dof_handler);
+#endif // DEAL_II_WITH_MPI
+
+        number_cache_current = number_cache;
+      }
+
+
+
+      template <int dim, int spacedim>
+      void
+      ParallelFullyDistributed<dim, spacedim>::
+      distribute_mg_dofs (DoFHandler<dim,spacedim> &,
+                          std::vector<NumberCache> &) const
+      {
+        AssertThrow (false, ExcNotImplemented());
+      }
+
+
+
+      template <int dim, int spacedim>
+      void
+      ParallelFullyDistributed<dim, spacedim>::
+      renumber_dofs (const std::vector<dealii::types::global_dof_index> &new_numbers,
+                     dealii::DoFHandler<dim,spacedim> &dof_handler,
+                     NumberCache &number_cache_current) const
+      {
+        (void)new_numbers;
+        (void)dof_handler;
+
+        Assert (new_numbers.size() == dof_handler.locally_owned_dofs().n_elements(),
+                ExcInternalError());
+
+        NumberCache number_cache;
+
+#ifndef DEAL_II_WITH_MPI
+        Assert (false, ExcNotImplemented());
+#else
+        const parallel::fullydistributed::Triangulation<dim,spacedim> *tr
+          = (dynamic_cast<const parallel::fullydistributed::Triangulation<dim,spacedim>*>
+             (&dof_handler.get_triangulation()));
+        Assert (tr != 0, ExcInternalError());
+
+        number_cache.locally_owned_dofs = IndexSet (dof_handler.n_dofs());
+        {
+          std::vector<dealii::types::global_dof_index> new_numbers_sorted (new_numbers);
+          std::sort (new_numbers_sorted.begin(), new_numbers_sorted.end());
+          number_cache.locally_owned_dofs.add_indices (new_numbers_sorted.begin(),
+                                                       new_numbers_sorted.end());
+        }
+        number_cache.locally_owned_dofs.compress();
+        Assert (number_cache.locally_owned_dofs.n_elements() == new_numbers.size(),
+                ExcInternalError());
+        number_cache.n_locally_owned_dofs = dof_handler.n_locally_owned_dofs();
+
+        // mark the dofs that are not locally owned as invalid, and get their
+        // new indices from their owners after renumbering
+        {
+          std::vector<dealii::types::global_dof_index> local_dof_indices;
+
+          for (typename DoFHandler<dim,spacedim>::active_cell_iterator
+               cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+            if (!cell->is_artificial())
+              {
+                local_dof_indices.resize (cell->get_fe().dofs_per_cell);
+                cell->get_dof_indices (local_dof_indices);
+                for (unsigned int i=0; i<cell->get_fe().dofs_per_cell; ++i)
+                  if ((local_dof_indices[i] != DoFHandler<dim,spacedim>::invalid_dof_index) &&
+                      !dof_handler.locally_owned_dofs().is_element(local_dof_indices[i]))
+                    local_dof_indices[i] = DoFHandler<dim,spacedim>::invalid_dof_index;
+
+                cell->set_dof_indices (local_dof_indices);
+              }
+        }
+
+        if (dof_handler.locally_owned_dofs().n_elements() > 0)
+          Implementation::renumber_dofs (new_numbers,
+                                         dof_handler.locally_owned_dofs(),
+                                         dof_handler,
+                                         false);
+
+        communicate_dof_indices (dof_handler);
+
+        // create the index sets of all processors by sending our own one to
+        // every other processor
+        const unsigned int n_cpus = Utilities::MPI::n_mpi_processes (tr->get_communicator());
+
+        std::ostringstream oss;
+        number_cache.locally_owned_dofs.block_write(oss);
+        std::string oss_str=oss.str();
+        std::vector<char> my_data(oss_str.begin(), oss_str.end());
+        unsigned int my_size = oss_str.size();
+
+        const unsigned int max_size
+          = Utilities::MPI::max (my_size, tr->get_communicator());
+        my_data.resize(max_size);
+
+        std::vector<char> buffer(max_size*n_cpus);
+        MPI_Allgather(&my_data[0], max_size, MPI_BYTE,
+                      &buffer[0], max_size, MPI_BYTE,
+                      tr->get_communicator());
+
+        number_cache.locally_owned_dofs_per_processor.resize (n_cpus);
+        number_cache.n_locally_owned_dofs_per_processor.resize (n_cpus);
+        for (unsigned int i=0; i<n_cpus; ++i)
+          {
+            std::stringstream strstr;
+            strstr.write(&buffer[i*max_size],max_size);
+            number_cache.locally_owned_dofs_per_processor[i]
+            .block_read(strstr);
+            number_cache.n_locally_owned_dofs_per_processor[i]
+              = number_cache.locally_owned_dofs_per_processor[i].n_elements();
+          }
+
+        number_cache.n_global_dofs
+          = std::accumulate (number_cache
+                             .n_locally_owned_dofs_per_processor.begin(),
+                             number_cache
+                             .n_locally_owned_dofs_per_processor.end(),
+                             static_cast<dealii::types::global_dof_index>(0));
+#endif // DEAL_II_WITH_MPI
+
+        number_cache_current = number_cache;
+      }
     }
   }
 }
@@ -22,6 +22,8 @@
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/std_cxx11/array.h>
 #include <deal.II/base/std_cxx11/unique_ptr.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/base/aligned_vector.h>
 #include <deal.II/lac/full_matrix.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_iterator.h>
@@ -36,6 +38,7 @@
 #include <cmath>
 #include <algorithm>
 #include <numeric>
+#include <limits>
 
 
 DEAL_II_NAMESPACE_OPEN
@@ -1574,6 +1577,344 @@ namespace
 
 
 
+namespace
+{
+  /**
+   * Evaluate the Lagrange polynomials for the given @p nodes and their
+   * derivatives at the points @p x. The polynomials are given in the form
+   * $w_i \prod_{j\neq i} (x-x_j)$ with the @p weights $w_i = 1/\prod_{j\neq
+   * i} (x_i-x_j)$, and the derivatives are computed by the product rule
+   * while the product is built up.
+   */
+  void
+  evaluate_lagrange_polynomials (const std::vector<Point<1> >  &nodes,
+                                 const std::vector<double>     &weights,
+                                 const VectorizedArray<double> &x,
+                                 VectorizedArray<double>       *values,
+                                 VectorizedArray<double>       *derivatives)
+  {
+    for (unsigned int i=0; i<nodes.size(); ++i)
+      {
+        VectorizedArray<double> value = make_vectorized_array (weights[i]);
+        VectorizedArray<double> derivative = make_vectorized_array (0.);
+        for (unsigned int j=0; j<nodes.size(); ++j)
+          if (j != i)
+            {
+              const VectorizedArray<double> difference = x - nodes[j][0];
+              derivative = derivative * difference + value;
+              value = value * difference;
+            }
+        values[i]      = value;
+        derivatives[i] = derivative;
+      }
+  }
+
+
+
+  /**
+   * Compute the image of the unit points @p p_unit (one per vector lane)
+   * under the tensor product polynomial mapping given by the @p
+   * support_points in lexicographic numbering, together with the Jacobian
+   * of the mapping at these points.
+   */
+  template <int dim>
+  void
+  compute_mapped_points_and_jacobians
+  (const std::vector<Point<1> >                        &nodes,
+   const std::vector<double>                           &weights,
+   const std::vector<Point<dim> >                      &support_points,
+   const Tensor<1,dim,VectorizedArray<double> >        &p_unit,
+   AlignedVector<VectorizedArray<double> >             &scratch,
+   Tensor<1,dim,VectorizedArray<double> >              &p_real,
+   Tensor<2,dim,VectorizedArray<double> >              &jacobian)
+  {
+    const unsigned int n = nodes.size();
+    scratch.resize (2*dim*n);
+    for (unsigned int d=0; d<dim; ++d)
+      evaluate_lagrange_polynomials (nodes, weights, p_unit[d],
+                                     &scratch[2*d*n], &scratch[2*d*n+n]);
+
+    for (unsigned int i=0; i<dim; ++i)
+      {
+        p_real[i] = 0.;
+        for (unsigned int j=0; j<dim; ++j)
+          jacobian[i][j] = 0.;
+      }
+
+    unsigned int index[dim];
+    for (unsigned int d=0; d<dim; ++d)
+      index[d] = 0;
+    for (unsigned int k=0; k<support_points.size(); ++k)
+      {
+        // value and gradient of the k-th tensor product shape function
+        VectorizedArray<double> value = scratch[index[0]];
+        for (unsigned int d=1; d<dim; ++d)
+          value = value * scratch[2*d*n+index[d]];
+
+        VectorizedArray<double> gradient[dim];
+        for (unsigned int e=0; e<dim; ++e)
+          {
+            gradient[e] = scratch[2*e*n+n+index[e]];
+            for (unsigned int d=0; d<dim; ++d)
+              if (d != e)
+                gradient[e] = gradient[e] * scratch[2*d*n+index[d]];
+          }
+
+        for (unsigned int i=0; i<dim; ++i)
+          {
+            p_real[i] += value * support_points[k][i];
+            for (unsigned int j=0; j<dim; ++j)
+              jacobian[i][j] += gradient[j] * support_points[k][i];
+          }
+
+        // go to the next index in lexicographic order
+        for (unsigned int d=0; d<dim; ++d)
+          if (++index[d] < n)
+            break;
+          else
+            index[d] = 0;
+      }
+  }
+
+
+
+  /**
+   * Implementation of MappingQGeneric::transform_points_real_to_unit_cell()
+   * for dim<spacedim, for which the accelerated algorithm is not available.
+   */
+  template <int dim, int spacedim>
+  void
+  do_transform_points_real_to_unit_cell
+  (const MappingQGeneric<dim,spacedim>                         &,
+   const typename Triangulation<dim,spacedim>::cell_iterator   &,
+   const std::vector<Point<spacedim> >                         &,
+   const std::vector<Point<1> >                                &,
+   const ArrayView<const Point<spacedim> >                     &,
+   const ArrayView<Point<dim> >                                &)
+  {
+    Assert (false, ExcInternalError());
+  }
+
+
+
+  /**
+   * Implementation of MappingQGeneric::transform_points_real_to_unit_cell()
+   * for dim==spacedim. The @p support_points are the mapping support points
+   * of the cell in hierarchic numbering, and @p nodes the support points of
+   * the mapping on the unit interval.
+   */
+  template <int dim>
+  void
+  do_transform_points_real_to_unit_cell
+  (const MappingQGeneric<dim,dim>                              &mapping,
+   const typename Triangulation<dim,dim>::cell_iterator        &cell,
+   const std::vector<Point<dim> >                              &support_points,
+   const std::vector<Point<1> >                                &nodes,
+   const ArrayView<const Point<dim> >                          &real_points,
+   const ArrayView<Point<dim> >                                &unit_points)
+  {
+    const unsigned int n_lanes = VectorizedArray<double>::n_array_elements;
+    const unsigned int degree = nodes.size() - 1;
+
+    // the size of the cell, used to make the tolerances below relative
+    double diameter = 0;
+    for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+      for (unsigned int w=v+1; w<GeometryInfo<dim>::vertices_per_cell; ++w)
+        diameter = std::max (diameter,
+                             support_points[v].distance (support_points[w]));
+
+    // bring the support points into lexicographic order, in which they are
+    // the images of the tensor product of the nodes
+    const std::vector<unsigned int> renumber
+      = FETools::lexicographic_to_hierarchic_numbering
+        (FiniteElementData<dim> (get_dpo_vector<dim>(degree), 1, degree));
+    std::vector<Point<dim> > lexicographic_points (support_points.size());
+    for (unsigned int k=0; k<support_points.size(); ++k)
+      lexicographic_points[k] = support_points[renumber[k]];
+
+    // check whether the mapping is affine on this cell. the columns of the
+    // Jacobian are the edges from vertex 0 in the coordinate directions
+    Tensor<2,dim> affine_jacobian;
+    for (unsigned int i=0; i<dim; ++i)
+      for (unsigned int d=0; d<dim; ++d)
+        affine_jacobian[i][d] = support_points[1<<d][i] - support_points[0][i];
+
+    bool is_affine = (std::abs(determinant(affine_jacobian)) >
+                      1e-12 * std::pow(diameter, 1.*dim));
+    for (unsigned int k=0; (k<lexicographic_points.size()) && is_affine; ++k)
+      {
+        Point<dim> p = support_points[0];
+        unsigned int index = k;
+        for (unsigned int d=0; d<dim; ++d, index /= nodes.size())
+          for (unsigned int i=0; i<dim; ++i)
+            p[i] += affine_jacobian[i][d] * nodes[index % nodes.size()][0];
+        if (p.distance (lexicographic_points[k]) > 1e-12 * diameter)
+          is_affine = false;
+      }
+
+    if (is_affine)
+      {
+        const Tensor<2,dim> inverse_jacobian = invert (affine_jacobian);
+        for (unsigned int i=0; i<real_points.size(); ++i)
+          unit_points[i] = Point<dim>(inverse_jacobian * (real_points[i] - support_points[0]));
+        return;
+      }
+
+    // the weights of the Lagrange polynomials for the nodes
+    std::vector<double> weights (nodes.size(), 1.);
+    for (unsigned int i=0; i<nodes.size(); ++i)
+      for (unsigned int j=0; j<nodes.size(); ++j)
+        if (j != i)
+          weights[i] /= (nodes[i][0] - nodes[j][0]);
+
+    // the initial guess is the one of transform_real_to_unit_cell(), i.e.,
+    // the inverse of the affine approximation A x + b of the cell given by
+    // its vertices
+    Tensor<2,dim> A;
+    Tensor<1,dim> b;
+    for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+      for (unsigned int i=0; i<dim; ++i)
+        {
+          b[i] += support_points[v][i] *
+                  internal::MappingQ1::TransformR2UInitialGuess<dim>::Kb[v];
+          for (unsigned int j=0; j<dim; ++j)
+            A[i][j] += support_points[v][i] *
+                       internal::MappingQ1::TransformR2UInitialGuess<dim>::KA[v][j];
+        }
+    const bool A_is_invertible = (std::abs(determinant(A)) >
+                                  1e-12 * std::pow(diameter, 1.*dim));
+    const Tensor<2,dim> A_inverse = A_is_invertible ? invert(A) : Tensor<2,dim>();
+
+    // then run the Newton iteration on n_lanes points at once. the last
+    // batch is filled up with copies of the last point. unlike
+    // transform_real_to_unit_cell(), no line search is done: lanes in which
+    // a full Newton step does not reduce the residual are instead given to
+    // transform_real_to_unit_cell() below, as are lanes that do not converge
+    // or in which the Jacobian becomes singular
+    const double eps = 1.e-11;
+    const unsigned int newton_iteration_limit = 20;
+    std::vector<bool> needs_fallback (real_points.size(), false);
+    AlignedVector<VectorizedArray<double> > scratch;
+
+    for (unsigned int start=0; start<real_points.size(); start+=n_lanes)
+      {
+        Tensor<1,dim,VectorizedArray<double> > p, p_unit, p_real, f, delta;
+        Tensor<2,dim,VectorizedArray<double> > jacobian;
+        for (unsigned int v=0; v<n_lanes; ++v)
+          {
+            const unsigned int i = std::min (start+v,
+                                             static_cast<unsigned int>(real_points.size()-1));
+            Point<dim> initial_p_unit;
+            if (A_is_invertible)
+              initial_p_unit = Point<dim>(A_inverse * (real_points[i] - b));
+            else
+              for (unsigned int d=0; d<dim; ++d)
+                initial_p_unit[d] = 0.5;
+            if (degree > 1)
+              initial_p_unit = GeometryInfo<dim>::project_to_unit_cell (initial_p_unit);
+
+            for (unsigned int d=0; d<dim; ++d)
+              {
+                p[d][v]      = real_points[i][d];
+                p_unit[d][v] = initial_p_unit[d];
+              }
+          }
+
+        bool   lane_done[VectorizedArray<double>::n_array_elements];
+        double last_residual[VectorizedArray<double>::n_array_elements];
+        for (unsigned int v=0; v<n_lanes; ++v)
+          {
+            lane_done[v]     = (start+v >= real_points.size());
+            last_residual[v] = std::numeric_limits<double>::max();
+          }
+
+        unsigned int n_lanes_done = 0;
+        for (unsigned int v=0; v<n_lanes; ++v)
+          n_lanes_done += lane_done[v];
+
+        for (unsigned int newton_iteration=0;
+             (newton_iteration<=newton_iteration_limit) && (n_lanes_done<n_lanes);
+             ++newton_iteration)
+          {
+            compute_mapped_points_and_jacobians (nodes, weights, lexicographic_points,
+                                                 p_unit, scratch, p_real, jacobian);
+            f = p_real - p;
+
+            // replace singular Jacobians by the identity to keep all lanes
+            // finite, and give up on these lanes
+            const VectorizedArray<double> det = determinant (jacobian);
+            for (unsigned int v=0; v<n_lanes; ++v)
+              if (std::abs(det[v]) <= 1e-12 * std::pow(diameter, 1.*dim))
+                {
+                  for (unsigned int i=0; i<dim; ++i)
+                    for (unsigned int j=0; j<dim; ++j)
+                      jacobian[i][j][v] = (i == j ? 1. : 0.);
+                  if (lane_done[v] == false)
+                    {
+                      lane_done[v] = true;
+                      needs_fallback[start+v] = true;
+                      ++n_lanes_done;
+                    }
+                }
+
+            delta = invert (jacobian) * f;
+
+            for (unsigned int v=0; v<n_lanes; ++v)
+              if (lane_done[v] == false)
+                {
+                  double delta_norm_square = 0, residual = 0;
+                  for (unsigned int d=0; d<dim; ++d)
+                    {
+                      delta_norm_square += delta[d][v] * delta[d][v];
+                      residual += f[d][v] * f[d][v];
+                    }
+
+                  if (delta_norm_square < eps*eps)
+                    {
+                      for (unsigned int d=0; d<dim; ++d)
+                        unit_points[start+v][d] = p_unit[d][v];
+                      lane_done[v] = true;
+                      ++n_lanes_done;
+                    }
+                  else if ((residual >= last_residual[v])
+                           ||
+                           (newton_iteration == newton_iteration_limit))
+                    {
+                      lane_done[v] = true;
+                      needs_fallback[start+v] = true;
+                      ++n_lanes_done;
+                    }
+                  last_residual[v] = residual;
+                }
+
+            p_unit -= delta;
+
+            // keep the lanes that are done from running away
+            for (unsigned int v=0; v<n_lanes; ++v)
+              if (lane_done[v])
+                for (unsigned int d=0; d<dim; ++d)
+                  p_unit[d][v] = 0.5;
+          }
+      }
+
+    for (unsigned int i=0; i<real_points.size(); ++i)
+      if (needs_fallback[i])
+        {
+          try
+            {
+              unit_points[i] = mapping.transform_real_to_unit_cell (cell, real_points[i]);
+            }
+          catch (const typename Mapping<dim,dim>::ExcTransformationFailed &)
+            {
+              unit_points[i] = Point<dim>();
+              unit_points[i][0] = std::numeric_limits<double>::infinity();
+            }
+        }
+  }
+}
+
+
+
 // visual studio freaks out when trying to determine if
 // do_transform_real_to_unit_cell_internal with dim=3 and spacedim=4 is a good
 // candidate. So instead of letting the compiler pick the correct overload, we
@@ -1878,6 +2219,31 @@ transform_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_it
 
 
 
+template<int dim, int spacedim>
+void
+MappingQGeneric<dim,spacedim>::
+transform_points_real_to_unit_cell (const typename Triangulation<dim,spacedim>::cell_iterator &cell,
+                                    const ArrayView<const Point<spacedim> >                   &real_points,
+                                    const ArrayView<Point<dim> >                              &unit_points) const
+{
+  AssertDimension (real_points.size(), unit_points.size());
+
+  if ((dim != spacedim) || (real_points.size() == 0))
+    {
+      Mapping<dim,spacedim>::transform_points_real_to_unit_cell (cell, real_points,
+                                                                 unit_points);
+      return;
+    }
+
+  // compute the support points only once for all points
+  do_transform_points_real_to_unit_cell (*this, cell,
+                                         this->compute_mapping_support_points (cell),
+                                         line_support_points.get_points(),
+                                         real_points, unit_points);
+}
+
+
+
 template<int dim, int spacedim>
 UpdateFlags
 MappingQGeneric<dim,spacedim>::requires_update_flags (const UpdateFlags in) const
@@ -0,0 +1,378 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx11/array.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/grid/cell_locator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+
+#include <algorithm>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  /**
+   * The maximal number of cells stored in a leaf of the tree.
+   */
+  const unsigned int max_items_per_leaf = 8;
+
+
+  /**
+   * Compare two objects with bounding boxes by the coordinate of the
+   * centers of their boxes in the given direction.
+   */
+  template <class Item>
+  struct CompareCenters
+  {
+    CompareCenters (const unsigned int direction)
+      :
+      direction (direction)
+    {}
+
+    bool operator () (const Item &a, const Item &b) const
+    {
+      return (a.lower_corner[direction] + a.upper_corner[direction]
+              <
+              b.lower_corner[direction] + b.upper_corner[direction]);
+    }
+
+    const unsigned int direction;
+  };
+
+
+  /**
+   * Return whether the point @p p lies in the box with the given corners.
+   */
+  template <int spacedim>
+  inline
+  bool
+  box_contains (const Point<spacedim> &lower_corner,
+                const Point<spacedim> &upper_corner,
+                const Point<spacedim> &p)
+  {
+    for (unsigned int d=0; d<spacedim; ++d)
+      if ((p[d] < lower_corner[d]) || (p[d] > upper_corner[d]))
+        return false;
+    return true;
+  }
+}
+
+
+
+template <int dim, int spacedim>
+CellLocator<dim,spacedim>::CellLocator (const Triangulation<dim,spacedim> &triangulation,
+                                        const Mapping<dim,spacedim>       &mapping,
+                                        const double                       relative_tolerance)
+  :
+  triangulation (&triangulation, typeid(*this).name()),
+  mapping (&mapping, typeid(*this).name()),
+  relative_tolerance (relative_tolerance)
+{
+  Assert (relative_tolerance >= 0,
+          ExcMessage ("The enlargement of the bounding boxes of the cells "
+                      "must not be negative."));
+
+  rebuild ();
+  tria_listener = triangulation.signals.any_change.connect
+                  (std_cxx11::bind (&CellLocator<dim,spacedim>::rebuild,
+                                    std_cxx11::ref(*this)));
+}
+
+
+
+template <int dim, int spacedim>
+CellLocator<dim,spacedim>::~CellLocator ()
+{
+  tria_listener.disconnect ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+CellLocator<dim,spacedim>::rebuild ()
+{
+  items.clear ();
+  nodes.clear ();
+
+  // collect the active cells and compute their bounding boxes
+  items.resize (triangulation->n_active_cells());
+  unsigned int n_items = 0;
+  for (active_cell_iterator cell = triangulation->begin_active();
+       cell != triangulation->end(); ++cell, ++n_items)
+    {
+      Item &item = items[n_items];
+      item.level = cell->level();
+      item.index = cell->index();
+
+      const std_cxx11::array<Point<spacedim>, GeometryInfo<dim>::vertices_per_cell>
+      vertices = mapping->get_vertices (cell);
+      item.lower_corner = item.upper_corner = vertices[0];
+      for (unsigned int v=1; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        for (unsigned int d=0; d<spacedim; ++d)
+          {
+            item.lower_corner[d] = std::min (item.lower_corner[d], vertices[v][d]);
+            item.upper_corner[d] = std::max (item.upper_corner[d], vertices[v][d]);
+          }
+
+      double extent = 0;
+      for (unsigned int d=0; d<spacedim; ++d)
+        extent = std::max (extent, item.upper_corner[d] - item.lower_corner[d]);
+      for (unsigned int d=0; d<spacedim; ++d)
+        {
+          item.lower_corner[d] -= relative_tolerance * extent;
+          item.upper_corner[d] += relative_tolerance * extent;
+        }
+    }
+  Assert (n_items == items.size(), ExcInternalError());
+
+  if (items.size() == 0)
+    return;
+
+  // nodes are split at the median, so every leaf has more than
+  // max_items_per_leaf/2 items, which bounds the number of nodes
+  nodes.reserve (4 * (items.size()/max_items_per_leaf + 1));
+  nodes.resize (1);
+  build_node (0, 0, items.size());
+}
+
+
+
+template <int dim, int spacedim>
+void
+CellLocator<dim,spacedim>::build_node (const unsigned int node,
+                                       const unsigned int begin,
+                                       const unsigned int end)
+{
+  Point<spacedim> lower_corner = items[begin].lower_corner;
+  Point<spacedim> upper_corner = items[begin].upper_corner;
+  for (unsigned int i=begin+1; i<end; ++i)
+    for (unsigned int d=0; d<spacedim; ++d)
+      {
+        lower_corner[d] = std::min (lower_corner[d], items[i].lower_corner[d]);
+        upper_corner[d] = std::max (upper_corner[d], items[i].upper_corner[d]);
+      }
+
+  nodes[node].lower_corner = lower_corner;
+  nodes[node].upper_corner = upper_corner;
+  nodes[node].begin        = begin;
+  nodes[node].end          = end;
+  nodes[node].first_child  = numbers::invalid_unsigned_int;
+
+  if (end - begin <= max_items_per_leaf)
+    return;
+
+  // split the items at the median of the centers of their boxes in the
+  // direction in which the node is largest. the children are stored next
+  // to each other at the end of the array
+  unsigned int direction = 0;
+  for (unsigned int d=1; d<spacedim; ++d)
+    if (upper_corner[d] - lower_corner[d] >
+        upper_corner[direction] - lower_corner[direction])
+      direction = d;
+
+  const unsigned int middle = begin + (end - begin) / 2;
+  std::nth_element (items.begin() + begin,
+                    items.begin() + middle,
+                    items.begin() + end,
+                    CompareCenters<Item> (direction));
+
+  const unsigned int first_child = nodes.size();
+  nodes[node].first_child = first_child;
+  nodes.resize (nodes.size() + 2);
+  build_node (first_child,   begin,  middle);
+  build_node (first_child+1, middle, end);
+}
+
+
+
+template <int dim, int spacedim>
+void
+CellLocator<dim,spacedim>::find_candidates (const Point<spacedim>     &p,
+                                            std::vector<unsigned int> &node_stack,
+                                            std::vector<unsigned int> &candidates) const
+{
+  candidates.clear ();
+  if (nodes.size() == 0)
+    return;
+
+  node_stack.clear ();
+  node_stack.push_back (0);
+  while (node_stack.size() > 0)
+    {
+      const Node &node = nodes[node_stack.back()];
+      node_stack.pop_back ();
+      if (box_contains (node.lower_corner, node.upper_corner, p) == false)
+        continue;
+
+      if (node.first_child != numbers::invalid_unsigned_int)
+        {
+          node_stack.push_back (node.first_child+1);
+          node_stack.push_back (node.first_child);
+        }
+      else
+        for (unsigned int i=node.begin; i<node.end; ++i)
+          if (box_contains (items[i].lower_corner, items[i].upper_corner, p))
+            candidates.push_back (i);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+bool
+CellLocator<dim,spacedim>::find_cell (const Point<spacedim>                        &p,
+                                      std::pair<active_cell_iterator, Point<dim> > &result,
+                                      std::vector<unsigned int>                    &node_stack,
+                                      std::vector<unsigned int>                    &candidates) const
+{
+  find_candidates (p, node_stack, candidates);
+
+  // select the cell in the same way as
+  // GridTools::find_active_cell_around_point: accept points at most 1e-10
+  // outside the reference cell, and prefer more refined cells
+  double best_distance = 1e-10;
+  int    best_level = -1;
+  for (unsigned int c=0; c<candidates.size(); ++c)
+    {
+      const Item &item = items[candidates[c]];
+      const active_cell_iterator cell (&*triangulation, item.level, item.index);
+      try
+        {
+          const Point<dim> p_cell = mapping->transform_real_to_unit_cell (cell, p);
+          const double dist = GeometryInfo<dim>::distance_to_unit_cell (p_cell);
+          if ((dist < best_distance)
+              ||
+              ((dist == best_distance) && (item.level > best_level)))
+            {
+              best_distance = dist;
+              best_level    = item.level;
+              result        = std::make_pair (cell, p_cell);
+            }
+        }
+      catch (typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+        {
+          // the point lies outside the cell, so go on with the next one
+        }
+    }
+
+  return (best_level != -1);
+}
+
+
+
+template <int dim, int spacedim>
+std::pair<typename CellLocator<dim,spacedim>::active_cell_iterator, Point<dim> >
+CellLocator<dim,spacedim>::find_active_cell_around_point (const Point<spacedim> &p) const
+{
+  std::pair<active_cell_iterator, Point<dim> > result;
+  std::vector<unsigned int> node_stack, candidates;
+  const bool found = find_cell (p, result, node_stack, candidates);
+
+  AssertThrow (found, GridTools::ExcPointNotFound<spacedim>(p));
+  return result;
+}
+
+
+
+template <int dim, int spacedim>
+void
+CellLocator<dim,spacedim>::
+find_all_active_cells_around_point (const Point<spacedim>                                      &p,
+                                    std::vector<std::pair<active_cell_iterator, Point<dim> > > &cells_and_reference_points) const
+{
+  std::vector<unsigned int> node_stack, candidates;
+  find_candidates (p, node_stack, candidates);
+
+  // use the same tolerance as find_cell()
+  cells_and_reference_points.clear ();
+  for (unsigned int c=0; c<candidates.size(); ++c)
+    {
+      const Item &item = items[candidates[c]];
+      const active_cell_iterator cell (&*triangulation, item.level, item.index);
+      try
+        {
+          const Point<dim> p_cell = mapping->transform_real_to_unit_cell (cell, p);
+          if (GeometryInfo<dim>::distance_to_unit_cell (p_cell) < 1e-10)
+            cells_and_reference_points.push_back (std::make_pair (cell, p_cell));
+        }
+      catch (typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+        {
+        }
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+CellLocator<dim,spacedim>::
+find_cells_on_range (const std::vector<Point<spacedim> >                        &points,
+                     std::vector<std::pair<active_cell_iterator, Point<dim> > > &cells_and_reference_points,
+                     const unsigned int                                          begin,
+                     const unsigned int                                          end) const
+{
+  std::vector<unsigned int> node_stack, candidates;
+  for (unsigned int i=begin; i<end; ++i)
+    if (find_cell (points[i], cells_and_reference_points[i],
+                   node_stack, candidates) == false)
+      cells_and_reference_points[i]
+        = std::make_pair (active_cell_iterator(triangulation->end()), Point<dim>());
+}
+
+
+
+template <int dim, int spacedim>
+void
+CellLocator<dim,spacedim>::
+find_active_cells_around_points (const std::vector<Point<spacedim> > &points,
+                                 std::vector<std::pair<active_cell_iterator, Point<dim> > > &cells_and_reference_points) const
+{
+  cells_and_reference_points.resize (points.size());
+  parallel::apply_to_subranges (0U, points.size(),
+                                std_cxx11::bind (&CellLocator<dim,spacedim>::find_cells_on_range,
+                                                 std_cxx11::cref(*this),
+                                                 std_cxx11::cref(points),
+                                                 std_cxx11::ref(cells_and_reference_points),
+                                                 std_cxx11::_1,
+                                                 std_cxx11::_2),
+                                64);
+}
+
+
+
+template <int dim, int spacedim>
+std::size_t
+CellLocator<dim,spacedim>::memory_consumption () const
+{
+  return (sizeof(*this) +
+          items.capacity() * sizeof(Item) +
+          nodes.capacity() * sizeof(Node));
+}
+
+
+
+// explicit instantiations
+#include "cell_locator.inst"
+
+DEAL_II_NAMESPACE_CLOSE
@@ -17,6 +17,8 @@
 #include <deal.II/base/path_search.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/std_cxx11/bind.h>
 
 #include <deal.II/grid/grid_in.h>
 #include <deal.II/grid/tria.h>
@@ -28,6 +30,10 @@
 #include <fstream>
 #include <functional>
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <locale>
 
 
 #ifdef DEAL_II_WITH_NETCDF
@@ -78,6 +84,870 @@ namespace
     // vertices except in 1d
     Assert (dim != 1, ExcInternalError());
   }
+
+
+  /**
+   * Read everything that is left in the stream @p in into @p buffer. If the
+   * stream can report its size, this is done with a single read operation.
+   */
+  void
+  read_stream_into_buffer (std::istream &in,
+                           std::string  &buffer)
+  {
+    const std::streampos start = in.tellg();
+    if (start != std::streampos(-1))
+      {
+        in.seekg (0, std::ios::end);
+        const std::streampos end = in.tellg();
+        in.seekg (start);
+        if (in && (end != std::streampos(-1)) && (end >= start))
+          {
+            buffer.resize (static_cast<std::size_t>(end - start));
+            if (buffer.size() > 0)
+              {
+                in.read (&buffer[0], buffer.size());
+                buffer.resize (static_cast<std::size_t>(in.gcount()));
+              }
+            return;
+          }
+        in.clear ();
+      }
+
+    std::ostringstream stream;
+    stream << in.rdbuf();
+    buffer = stream.str();
+  }
+
+
+
+  /**
+   * Functions that read tokens from a null-terminated character buffer. The
+   * position is advanced past the token if one could be read.
+   */
+  inline
+  bool
+  is_space (const char c)
+  {
+    return ((c == ' ') || (c == '\t') || (c == '\n') ||
+            (c == '\r') || (c == '\v') || (c == '\f'));
+  }
+
+
+
+  /**
+   * std::strtol() and std::strtod() interpret numbers according to the
+   * locale selected through setlocale(), which may for example use a comma
+   * as decimal separator. Mesh files always use the format of the "C"
+   * locale, so numbers are instead read through the num_get facet of the
+   * classic locale. An object of this class is only used through const
+   * member functions after its construction and can therefore be shared by
+   * the threads that parse records in parallel.
+   */
+  class ClassicNumberParser
+  {
+  public:
+    ClassicNumberParser ()
+      :
+      locale (std::locale::classic(), new std::num_get<char, const char *>()),
+      facet (&std::use_facet<std::num_get<char, const char *> >(locale))
+    {
+      format.imbue (locale);
+
+      // parse a number once so that the facet has set up all of its
+      // internal data before several threads use it
+      const char *position = "0.5";
+      double value;
+      read (position, value);
+    }
+
+    template <typename Number>
+    bool read (const char *&position,
+               Number      &value) const
+    {
+      while (is_space (*position))
+        ++position;
+      const char *end = position;
+      while ((*end != '\0') && !is_space (*end))
+        ++end;
+
+      std::ios_base::iostate state = std::ios_base::goodbit;
+      const char *const last = facet->get (position, end, format, state, value);
+      if ((last == position) || (state & std::ios_base::failbit))
+        return false;
+      position = last;
+      return true;
+    }
+
+  private:
+    std::locale                                locale;
+    const std::num_get<char, const char *>    *facet;
+    mutable std::istringstream                 format;
+  };
+
+
+
+  const ClassicNumberParser &
+  get_number_parser ()
+  {
+    static const ClassicNumberParser parser;
+    return parser;
+  }
+
+
+
+  inline
+  bool
+  read_integer (const char *&position,
+                long int    &value)
+  {
+    return get_number_parser().read (position, value);
+  }
+
+
+
+  inline
+  bool
+  read_double (const char *&position,
+               double      &value)
+  {
+    return get_number_parser().read (position, value);
+  }
+
+
+
+  std::string
+  read_word (const char *&position)
+  {
+    while (is_space (*position))
+      ++position;
+    const char *begin = position;
+    while ((*position != '\0') && !is_space (*position))
+      ++position;
+    return std::string (begin, position);
+  }
+
+
+
+  /**
+   * Return the position after the next newline character, or zero if there
+   * is none.
+   */
+  const char *
+  skip_to_next_line (const char *position,
+                     const char *end)
+  {
+    const char *newline
+      = static_cast<const char *>(std::memchr (position, '\n', end - position));
+    return (newline != 0 ? newline + 1 : 0);
+  }
+
+
+
+  /**
+   * Return the rest of the current line, without the newline character, and
+   * advance the position to the beginning of the next line.
+   */
+  std::string
+  read_line (const char *&position,
+             const char  *end)
+  {
+    const char *begin = position;
+    const char *next_line = skip_to_next_line (position, end);
+    position = (next_line != 0 ? next_line : end);
+    return std::string (begin, next_line != 0 ? next_line - 1 : end);
+  }
+
+
+
+  template <typename T>
+  void
+  swap_bytes (T &value)
+  {
+    char *bytes = reinterpret_cast<char *>(&value);
+    std::reverse (bytes, bytes + sizeof(T));
+  }
+
+
+
+  /**
+   * Copy an object of type @p T from its binary representation at @p
+   * position and advance the position.
+   */
+  template <typename T>
+  T
+  read_binary (const char *&position,
+               const bool   swap)
+  {
+    T value;
+    std::memcpy (&value, position, sizeof(T));
+    if (swap)
+      swap_bytes (value);
+    position += sizeof(T);
+    return value;
+  }
+
+
+
+  /**
+   * A vertex as it is given in a mesh file, with the number that the cells
+   * use to refer to it.
+   */
+  struct VertexRecord
+  {
+    long int number;
+    double   coordinates[3];
+    bool     valid;
+  };
+
+
+
+  /**
+   * A cell or boundary object as it is given in a mesh file. The dimension
+   * of the object is numbers::invalid_unsigned_int if the file format
+   * specific type is not supported. The vertices are the numbers used in
+   * the file.
+   */
+  struct ElementRecord
+  {
+    long int     type;
+    unsigned int object_dim;
+    long int     tag;
+    unsigned int n_vertices;
+    long int     vertices[GeometryInfo<3>::vertices_per_cell];
+    const char  *position;
+    bool         valid;
+  };
+
+
+
+  /**
+   * Read the numbers of the @p n_vertices vertices of an element.
+   */
+  bool
+  read_element_vertices (const char    *&position,
+                         const long int  n_vertices,
+                         ElementRecord  &element)
+  {
+    if (n_vertices < 0)
+      return false;
+    element.n_vertices = n_vertices;
+    for (long int v=0; v<n_vertices; ++v)
+      {
+        long int vertex;
+        if (!read_integer (position, vertex))
+          return false;
+        if (v < static_cast<long int>(GeometryInfo<3>::vertices_per_cell))
+          element.vertices[v] = vertex;
+      }
+    return true;
+  }
+
+
+
+  /**
+   * Skip the rest of the line of an element of a type that is not supported
+   * and whose number of vertices is not known. Such elements make the
+   * reader fail with a suitable error message later on.
+   */
+  bool
+  skip_unsupported_element (const char    *&position,
+                            ElementRecord  &element)
+  {
+    element.object_dim = numbers::invalid_unsigned_int;
+    element.n_vertices = 0;
+    while ((*position != '\0') && (*position != '\n'))
+      ++position;
+    return true;
+  }
+
+
+
+  bool
+  parse_vertex (const char   *&position,
+                VertexRecord  &vertex)
+  {
+    return (read_integer (position, vertex.number) &&
+            read_double (position, vertex.coordinates[0]) &&
+            read_double (position, vertex.coordinates[1]) &&
+            read_double (position, vertex.coordinates[2]));
+  }
+
+
+
+  /**
+   * Return the dimension of the objects with the given Gmsh element type,
+   * or numbers::invalid_unsigned_int for types deal.II does not support.
+   */
+  unsigned int
+  msh_object_dim (const long int type)
+  {
+    switch (type)
+      {
+      case 15:
+        return 0;
+      case 1:
+        return 1;
+      case 3:
+        return 2;
+      case 5:
+        return 3;
+      default:
+        return numbers::invalid_unsigned_int;
+      }
+  }
+
+
+
+  /**
+   * Parse an element in the format of version 1 of the Gmsh format:
+   *   elm-number elm-type reg-phys reg-elem number-of-nodes node-number-list
+   * The physical region is used as the material or boundary id.
+   */
+  bool
+  parse_msh_1_element (const char    *&position,
+                       ElementRecord  &element)
+  {
+    element.position = position;
+    long int dummy, n_vertices;
+    if (!(read_integer (position, dummy) &&
+          read_integer (position, element.type) &&
+          read_integer (position, element.tag) &&
+          read_integer (position, dummy) &&
+          read_integer (position, n_vertices)))
+      return false;
+    element.object_dim = msh_object_dim (element.type);
+    return read_element_vertices (position, n_vertices, element);
+  }
+
+
+
+  /**
+   * Parse an element in the format of version 2 of the Gmsh format:
+   *   elm-number elm-type number-of-tags < tag > ... node-number-list
+   * The first tag, if any, is used as the material or boundary id.
+   */
+  bool
+  parse_msh_2_element (const char    *&position,
+                       ElementRecord  &element)
+  {
+    element.position = position;
+    long int dummy, n_tags;
+    if (!(read_integer (position, dummy) &&
+          read_integer (position, element.type) &&
+          read_integer (position, n_tags)))
+      return false;
+
+    element.tag = 0;
+    for (long int t=0; t<n_tags; ++t)
+      {
+        if (!read_integer (position, dummy))
+          return false;
+        if (t == 0)
+          element.tag = dummy;
+      }
+
+    element.object_dim = msh_object_dim (element.type);
+    if (element.object_dim == numbers::invalid_unsigned_int)
+      return skip_unsupported_element (position, element);
+    return read_element_vertices (position, 1 << element.object_dim, element);
+  }
+
+
+
+  /**
+   * Parse an element in the UCD format:
+   *   cell-number material-id cell-type node-number-list
+   */
+  bool
+  parse_ucd_element (const char    *&position,
+                     ElementRecord  &element)
+  {
+    element.position = position;
+    long int dummy;
+    if (!(read_integer (position, dummy) &&
+          read_integer (position, element.tag)))
+      return false;
+
+    while (is_space (*position))
+      ++position;
+    const char *type = position;
+    while ((*position != '\0') && !is_space (*position))
+      ++position;
+    const std::size_t length = position - type;
+
+    element.type = -1;
+    if ((length == 4) && (std::strncmp (type, "line", 4) == 0))
+      element.object_dim = 1;
+    else if ((length == 4) && (std::strncmp (type, "quad", 4) == 0))
+      element.object_dim = 2;
+    else if ((length == 3) && (std::strncmp (type, "hex", 3) == 0))
+      element.object_dim = 3;
+    else
+      return skip_unsupported_element (position, element);
+
+    return read_element_vertices (position, 1 << element.object_dim, element);
+  }
+
+
+
+  /**
+   * Return the cell type of a UCD element that parse_ucd_element() did not
+   * recognize, for the error message.
+   */
+  std::string
+  ucd_cell_type (const ElementRecord &element)
+  {
+    const char *position = element.position;
+    long int dummy;
+    read_integer (position, dummy);
+    read_integer (position, dummy);
+    return read_word (position);
+  }
+
+
+
+  /**
+   * Parse a point in the legacy VTK format, which consists of its three
+   * coordinates only. The caller has to number the points.
+   */
+  bool
+  parse_vtk_point (const char   *&position,
+                   VertexRecord  &vertex)
+  {
+    vertex.number = 0;
+    return (read_double (position, vertex.coordinates[0]) &&
+            read_double (position, vertex.coordinates[1]) &&
+            read_double (position, vertex.coordinates[2]));
+  }
+
+
+
+  /**
+   * Parse a cell in the legacy VTK format:
+   *   number-of-points point-index-list
+   * The dimension of the cell is deduced from the number of its points.
+   */
+  bool
+  parse_vtk_cell (const char    *&position,
+                  ElementRecord  &element)
+  {
+    element.position = position;
+    element.tag = 0;
+    long int n_vertices;
+    if (!read_integer (position, n_vertices))
+      return false;
+
+    element.type = n_vertices;
+    switch (n_vertices)
+      {
+      case 2:
+        element.object_dim = 1;
+        break;
+      case 4:
+        element.object_dim = 2;
+        break;
+      case 8:
+        element.object_dim = 3;
+        break;
+      default:
+        element.object_dim = numbers::invalid_unsigned_int;
+      }
+    return read_element_vertices (position, n_vertices, element);
+  }
+
+
+
+  /**
+   * Parse the records on the lines with indices in the range
+   * <code>[begin,end)</code>. A line is only considered valid if it contains
+   * exactly one record.
+   */
+  template <typename Record>
+  void
+  parse_records_on_lines (const unsigned int                 begin,
+                          const unsigned int                 end,
+                          bool (*parse) (const char *&, Record &),
+                          const std::vector<const char *>   &line_starts,
+                          const char                        *section_end,
+                          std::vector<Record>               &records)
+  {
+    for (unsigned int i=begin; i<end; ++i)
+      {
+        const char *position = line_starts[i];
+        const char *line_end = (i+1 < line_starts.size() ?
+                                line_starts[i+1] :
+                                section_end);
+        Record &record = records[i];
+        record.valid = (parse (position, record) && (position <= line_end));
+        for (; record.valid && (position != line_end); ++position)
+          if (!is_space (*position))
+            record.valid = false;
+      }
+  }
+
+
+
+  /**
+   * Parse @p n_records records, for example the vertices or the elements of
+   * a mesh file, starting at @p position. Mesh files usually have one record
+   * per line, so the beginnings of the lines are determined first and the
+   * lines are then parsed in parallel. If this fails because the file uses
+   * a different layout, the records are parsed again one after the other,
+   * without regard to line breaks.
+   *
+   * Return the position after the last record, or zero if the records could
+   * not be read.
+   */
+  template <typename Record>
+  const char *
+  parse_records (const char          *position,
+                 const char          *end,
+                 const unsigned int   n_records,
+                 bool (*parse) (const char *&, Record &),
+                 std::vector<Record> &records)
+  {
+    records.resize (n_records);
+
+    std::vector<const char *> line_starts (n_records);
+    const char *section_end = position;
+    for (unsigned int i=0; (i<n_records) && (section_end != 0); ++i)
+      {
+        while ((section_end != end) && is_space (*section_end))
+          ++section_end;
+        if (section_end == end)
+          section_end = 0;
+        else
+          {
+            line_starts[i] = section_end;
+            section_end = skip_to_next_line (section_end, end);
+            if (section_end == 0)
+              section_end = end;
+          }
+      }
+
+    if (section_end != 0)
+      {
+        parallel::apply_to_subranges (0U, n_records,
+                                      std_cxx11::bind (&parse_records_on_lines<Record>,
+                                                       std_cxx11::_1,
+                                                       std_cxx11::_2,
+                                                       parse,
+                                                       std_cxx11::cref(line_starts),
+                                                       section_end,
+                                                       std_cxx11::ref(records)),
+                                      1000);
+
+        bool all_valid = true;
+        for (unsigned int i=0; (i<n_records) && all_valid; ++i)
+          all_valid = records[i].valid;
+        if (all_valid)
+          return section_end;
+      }
+
+    for (unsigned int i=0; i<n_records; ++i)
+      {
+        records[i].valid = parse (position, records[i]);
+        if (!records[i].valid)
+          return 0;
+      }
+    return position;
+  }
+
+
+
+  /**
+   * Read the vertices of a Gmsh file in binary format. Each vertex is given
+   * by its number as an int, followed by its three coordinates as doubles.
+   */
+  const char *
+  read_binary_msh_vertices (const char                *position,
+                            const char                *end,
+                            const unsigned int         n_vertices,
+                            const bool                 swap,
+                            std::vector<VertexRecord> &vertices)
+  {
+    // the binary data starts on the line after the number of vertices
+    position = skip_to_next_line (position, end);
+    const std::size_t record_size = sizeof(int) + 3*sizeof(double);
+    if ((position == 0) ||
+        (static_cast<std::size_t>(end - position) < n_vertices * record_size))
+      return 0;
+
+    vertices.resize (n_vertices);
+    for (unsigned int i=0; i<n_vertices; ++i)
+      {
+        vertices[i].number = read_binary<int> (position, swap);
+        for (unsigned int d=0; d<3; ++d)
+          vertices[i].coordinates[d] = read_binary<double> (position, swap);
+        vertices[i].valid = true;
+      }
+    return position;
+  }
+
+
+
+  /**
+   * Read the elements of a Gmsh file in binary format. The elements are
+   * given in blocks of elements of the same type: each block starts with the
+   * element type, the number of elements in the block, and the number of
+   * tags per element, followed by the number, the tags, and the vertices of
+   * each element, all as ints.
+   *
+   * Since the number of vertices of element types that deal.II does not
+   * support is not known, the reading stops at the first such element,
+   * which is then the last one returned.
+   */
+  const char *
+  read_binary_msh_elements (const char                 *position,
+                            const char                 *end,
+                            const unsigned int          n_elements,
+                            const bool                  swap,
+                            std::vector<ElementRecord> &elements)
+  {
+    position = skip_to_next_line (position, end);
+    if (position == 0)
+      return 0;
+
+    elements.clear ();
+    elements.reserve (n_elements);
+    while (elements.size() < n_elements)
+      {
+        if (static_cast<std::size_t>(end - position) < 3*sizeof(int))
+          return 0;
+        const int type       = read_binary<int> (position, swap);
+        const int n_in_block = read_binary<int> (position, swap);
+        const int n_tags     = read_binary<int> (position, swap);
+
+        ElementRecord element;
+        element.type = type;
+        element.object_dim = msh_object_dim (type);
+        element.position = position;
+        element.valid = true;
+        if (element.object_dim == numbers::invalid_unsigned_int)
+          {
+            element.n_vertices = 0;
+            elements.push_back (element);
+            return position;
+          }
+        element.n_vertices = 1 << element.object_dim;
+
+        if ((n_in_block < 0) || (n_tags < 0) ||
+            (elements.size() + n_in_block > n_elements) ||
+            (static_cast<std::size_t>(end - position) <
+             n_in_block * (1 + n_tags + element.n_vertices) * sizeof(int)))
+          return 0;
+
+        for (int e=0; e<n_in_block; ++e)
+          {
+            read_binary<int> (position, swap);
+            element.tag = 0;
+            for (int t=0; t<n_tags; ++t)
+              {
+                const int tag = read_binary<int> (position, swap);
+                if (t == 0)
+                  element.tag = tag;
+              }
+            for (unsigned int v=0; v<element.n_vertices; ++v)
+              element.vertices[v] = read_binary<int> (position, swap);
+            elements.push_back (element);
+          }
+      }
+    return position;
+  }
+
+
+
+  /**
+   * A map from the numbers of the vertices in a mesh file to their indices
+   * in the array of vertices. Since mesh generators usually number the
+   * vertices consecutively, the map is stored as an array if the numbers are
+   * dense enough, and as a sorted array of pairs otherwise. If a number
+   * appears more than once, the last vertex with this number is used.
+   */
+  class VertexNumbering
+  {
+  public:
+    VertexNumbering (const std::vector<VertexRecord> &vertices);
+
+    /**
+     * Return the index of the vertex with the given number, or
+     * numbers::invalid_unsigned_int if there is none.
+     */
+    unsigned int index (const long int number) const;
+
+  private:
+    long int                                        min_number;
+    std::vector<unsigned int>                       dense_indices;
+    std::vector<std::pair<long int,unsigned int> >  sorted_indices;
+  };
+
+
+
+  VertexNumbering::VertexNumbering (const std::vector<VertexRecord> &vertices)
+    :
+    min_number (0)
+  {
+    if (vertices.size() == 0)
+      return;
+
+    min_number = vertices[0].number;
+    long int max_number = vertices[0].number;
+    for (unsigned int i=1; i<vertices.size(); ++i)
+      {
+        min_number = std::min (min_number, vertices[i].number);
+        max_number = std::max (max_number, vertices[i].number);
+      }
+
+    if (static_cast<unsigned long int>(max_number - min_number) < 2 * vertices.size() + 1000)
+      {
+        dense_indices.resize (max_number - min_number + 1, numbers::invalid_unsigned_int);
+        for (unsigned int i=0; i<vertices.size(); ++i)
+          dense_indices[vertices[i].number - min_number] = i;
+      }
+    else
+      {
+        sorted_indices.resize (vertices.size());
+        for (unsigned int i=0; i<vertices.size(); ++i)
+          sorted_indices[i] = std::make_pair (vertices[i].number, i);
+        std::sort (sorted_indices.begin(), sorted_indices.end());
+      }
+  }
+
+
+
+  unsigned int
+  VertexNumbering::index (const long int number) const
+  {
+    if (dense_indices.size() > 0)
+      {
+        if ((number < min_number) ||
+            (number - min_number >= static_cast<long int>(dense_indices.size())))
+          return numbers::invalid_unsigned_int;
+        return dense_indices[number - min_number];
+      }
+
+    // find the last entry with this number
+    const std::vector<std::pair<long int,unsigned int> >::const_iterator
+    p = std::upper_bound (sorted_indices.begin(), sorted_indices.end(),
+                          std::make_pair (number, numbers::invalid_unsigned_int));
+    if ((p == sorted_indices.begin()) || ((p-1)->first != number))
+      return numbers::invalid_unsigned_int;
+    return (p-1)->second;
+  }
+
+
+
+  /**
+   * Create the array of vertices from the records read from a file.
+   */
+  template <int spacedim>
+  void
+  create_vertices (const std::vector<VertexRecord> &vertex_records,
+                   std::vector<Point<spacedim> >   &vertices)
+  {
+    vertices.resize (vertex_records.size());
+    for (unsigned int i=0; i<vertex_records.size(); ++i)
+      for (unsigned int d=0; d<spacedim; ++d)
+        vertices[i](d) = vertex_records[i].coordinates[d];
+  }
+
+
+
+  /**
+   * Sort the elements read from a file into cells and boundary objects, and
+   * translate the vertex numbers of the file to indices into the array of
+   * vertices. The caller has to make sure that the dimensions of all
+   * elements are supported. Indicators given on vertices are only used in
+   * 1d, where they are stored in @p boundary_ids_1d.
+   */
+  template <int dim, int spacedim>
+  void
+  create_cell_data (const std::vector<ElementRecord>           &elements,
+                    const VertexNumbering                      &vertex_numbering,
+                    const bool                                  apply_all_indicators_to_manifolds,
+                    std::vector<CellData<dim> >                &cells,
+                    SubCellData                                &subcelldata,
+                    std::map<unsigned int, types::boundary_id> &boundary_ids_1d)
+  {
+    typedef typename GridIn<dim,spacedim>::ExcInvalidVertexIndex ExcInvalidVertexIndex;
+
+    unsigned int n_cells = 0;
+    for (unsigned int e=0; e<elements.size(); ++e)
+      if (elements[e].object_dim == dim)
+        ++n_cells;
+    cells.reserve (n_cells);
+
+    unsigned int vertices[GeometryInfo<3>::vertices_per_cell];
+    for (unsigned int e=0; e<elements.size(); ++e)
+      {
+        const ElementRecord &element = elements[e];
+        Assert (element.object_dim <= dim, ExcInternalError());
+        Assert (element.n_vertices == (1U << element.object_dim), ExcInternalError());
+
+        for (unsigned int v=0; v<element.n_vertices; ++v)
+          {
+            vertices[v] = vertex_numbering.index (element.vertices[v]);
+            AssertThrow (vertices[v] != numbers::invalid_unsigned_int,
+                         ExcInvalidVertexIndex (e, element.vertices[v]));
+          }
+
+        if (element.object_dim == dim)
+          {
+            // to make sure that the cast wont fail
+            Assert(element.tag <= std::numeric_limits<types::material_id>::max(),
+                   ExcIndexRange(element.tag,0,std::numeric_limits<types::material_id>::max()));
+            // we use only material_ids in the range from 0 to numbers::invalid_material_id-1
+            Assert(element.tag < numbers::invalid_material_id,
+                   ExcIndexRange(element.tag,0,numbers::invalid_material_id));
+
+            cells.push_back (CellData<dim>());
+            for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+              cells.back().vertices[v] = vertices[v];
+            cells.back().material_id = static_cast<types::material_id>(element.tag);
+          }
+        else if (element.object_dim == 0)
+          {
+            // we only care about boundary indicators assigned to individual
+            // vertices in 1d (because otherwise the vertices are not faces)
+            if (dim == 1)
+              boundary_ids_1d[vertices[0]] = element.tag;
+          }
+        else
+          {
+            // to make sure that the cast wont fail
+            Assert(element.tag <= std::numeric_limits<types::boundary_id>::max(),
+                   ExcIndexRange(element.tag,0,std::numeric_limits<types::boundary_id>::max()));
+            // we use only boundary_ids in the range from 0 to numbers::internal_face_boundary_id-1
+            Assert(element.tag < numbers::internal_face_boundary_id,
+                   ExcIndexRange(element.tag,0,numbers::internal_face_boundary_id));
+
+            if (element.object_dim == 1)
+              {
+                subcelldata.boundary_lines.push_back (CellData<1>());
+                for (unsigned int v=0; v<2; ++v)
+                  subcelldata.boundary_lines.back().vertices[v] = vertices[v];
+                if (apply_all_indicators_to_manifolds)
+                  subcelldata.boundary_lines.back().manifold_id
+                    = static_cast<types::manifold_id>(element.tag);
+                else
+                  subcelldata.boundary_lines.back().boundary_id
+                    = static_cast<types::boundary_id>(element.tag);
+              }
+            else
+              {
+                subcelldata.boundary_quads.push_back (CellData<2>());
+                for (unsigned int v=0; v<4; ++v)
+                  subcelldata.boundary_quads.back().vertices[v] = vertices[v];
+                if (apply_all_indicators_to_manifolds)
+                  subcelldata.boundary_quads.back().manifold_id
+                    = static_cast<types::manifold_id>(element.tag);
+                else
+                  subcelldata.boundary_quads.back().boundary_id
+                    = static_cast<types::boundary_id>(element.tag);
+              }
+          }
+      }
+  }
 }
 
 template <int dim, int spacedim>
@@ -121,261 +991,152 @@ void GridIn<dim, spacedim>::read_vtk(std::istream &in)
       }
   }
 
-  ///////////////////Declaring storage and mappings//////////////////
-
-  std::vector< Point<spacedim> > vertices;//vector of vertices
-  std::vector< CellData<dim> > cells;//vector of cells
-  SubCellData subcelldata;//subcell data that includes bounds and material IDs.
-  std::map<int, int> vertex_indices; // # vert in unv (key) ---> # vert in deal.II (value)
-  std::map<int, int> cell_indices; // # cell in unv (key) ---> # cell in deal.II (value)
-  std::map<int, int> quad_indices; // # quad in unv (key) ---> # quad in deal.II (value)
-  std::map<int, int> line_indices; // # line in unv(key) ---> # line in deal.II (value)
-
-  unsigned int no_vertices, no_quads=0, no_lines=0;
-
-  std::string keyword;
+  // read the rest of the file into memory at once. the points and cells,
+  // which make up almost all of the file, are then parsed in parallel
+  std::string buffer;
+  read_stream_into_buffer (in, buffer);
+  const char *position = buffer.c_str();
+  const char *const end = position + buffer.size();
 
-  in >> keyword;
+  std::string keyword = read_word (position);
 
   //////////////////Processing the POINTS section///////////////
 
-  if (keyword == "POINTS")
-    {
-      in>>no_vertices;// taking the no. of vertices
-      in.ignore(256, '\n');//ignoring the number beside the total no. of points.
-
-      for (unsigned int count = 0; count < no_vertices; count++) //loop to read three values till the no . vertices is satisfied
-        {
-          // VTK format always specifies vertex coordinates with 3 components
-          Point<3> x;
-          in >> x(0) >> x(1) >> x(2);
+  AssertThrow (keyword == "POINTS",
+               ExcMessage ("While reading VTK file, failed to find POINTS section"));
+
+  long int n_vertices = 0;
+  AssertThrow (read_integer (position, n_vertices) && (n_vertices >= 0),
+               ExcIO());
+  // ignore the data type given after the number of points
+  position = skip_to_next_line (position, end);
+  AssertThrow (position != 0, ExcIO());
+
+  // VTK format always specifies vertex coordinates with 3 components, and
+  // the points are referred to by their index
+  std::vector<VertexRecord> vertex_records;
+  position = parse_records (position, end, n_vertices, &parse_vtk_point,
+                            vertex_records);
+  AssertThrow (position != 0, ExcIO());
+  for (unsigned int i=0; i<vertex_records.size(); ++i)
+    vertex_records[i].number = i;
 
-          vertices.push_back(Point<spacedim>());
-          for (unsigned int d=0; d<spacedim; ++d)
-            vertices.back()(d) = x(d);
+  ///////////////////Processing the CELLS section that contains cells(cells) and bound_quads(subcelldata)///////////////////////
 
-          vertex_indices[count] = count;
-        }
-    }
+  keyword = read_word (position);
+  AssertThrow (keyword == "CELLS",
+               ExcMessage ("While reading VTK file, failed to find CELLS section"));
+
+  long int total_cells = 0;
+  AssertThrow (read_integer (position, total_cells) && (total_cells >= 0),
+               ExcIO());
+  // ignore the total number of integers given after the number of cells
+  position = skip_to_next_line (position, end);
+  AssertThrow (position != 0, ExcIO());
+
+  std::vector<ElementRecord> elements;
+  position = parse_records (position, end, total_cells, &parse_vtk_cell,
+                            elements);
+  AssertThrow (position != 0, ExcIO());
+
+  // hexahedra (in 3d) and quadrilaterals (in 2d) are cells, the objects of
+  // one dimension less are boundary objects
+  for (unsigned int e=0; e<elements.size(); ++e)
+    AssertThrow ((elements[e].object_dim != numbers::invalid_unsigned_int) &&
+                 (elements[e].object_dim + 1 >= dim) &&
+                 (elements[e].object_dim <= dim),
+                 ExcMessage ("While reading VTK file, unknown file type encountered"));
+
+  std::vector< Point<spacedim> >             vertices;
+  std::vector< CellData<dim> >               cells;
+  SubCellData                                subcelldata;
+  std::map<unsigned int, types::boundary_id> boundary_ids_1d;
+  create_vertices (vertex_records, vertices);
+  create_cell_data<dim,spacedim> (elements, VertexNumbering (vertex_records), false,
+                                  cells, subcelldata, boundary_ids_1d);
 
-  else
-    AssertThrow (false,
-                 ExcMessage ("While reading VTK file, failed to find POINTS section"));
+  /////////////////////Processing the CELL_TYPES section////////////////////////
 
+  keyword = read_word (position);
 
-  //////////////////ignoring space between points and cells sections////////////////////
-  std::string checkline;
-  int no;
-  in.ignore(256, '\n');//this move pointer to the next line ignoring unwanted no.
-  no = in.tellg();
-  getline(in,checkline);
-  if (checkline.compare("") != 0)
+  if (keyword == "CELL_TYPES")//Entering the cell_types section and ignoring data.
     {
-      in.seekg(no);
-    }
+      long int n_cell_types = 0;
+      read_integer (position, n_cell_types);
 
-  in >> keyword;
-
-  unsigned int total_cells, no_cells = 0, type;// declaring counters, refer to the order of declaring variables for an idea of what is what!
+      do
+        keyword = read_word (position);
+      while (keyword == "12" || keyword == "9");
+    }
 
-  ///////////////////Processing the CELLS section that contains cells(cells) and bound_quads(subcelldata)///////////////////////
+  ////////////////////////Processing the CELL_DATA section/////////////////////////////
 
-  if (keyword == "CELLS")
+  if (keyword == "CELL_DATA")
     {
-      in>>total_cells;
-      in.ignore(256,'\n');
-
-      if (dim == 3)
-        {
-          for (unsigned int count = 0; count < total_cells; count++)
-            {
-              in>>type;
-
-              if (type == 8)
-                {
-
-                  cells.push_back(CellData<dim>());
-
-                  for (unsigned int j = 0; j < type; j++) //loop to feed data
-                    in >> cells.back().vertices[j];
-
-
-                  cells.back().material_id = 0;
-
-                  for (unsigned int j = 0; j < type; j++) //loop to feed the data of the vertices to the cell
-                    {
-                      cells.back().vertices[j] = vertex_indices[cells.back().vertices[j]];
-                    }
-                  cell_indices[count] = count;
-                  no_cells++;
-                }
-
-              else if ( type == 4)
-                {
+      long int n_ids = 0;
+      AssertThrow (read_integer (position, n_ids), ExcIO());
+      position = skip_to_next_line (position, end);
+      AssertThrow (position != 0, ExcIO());
 
-                  subcelldata.boundary_quads.push_back(CellData<2>());
-
-                  for (unsigned int j = 0; j < type; j++) //loop to feed the data to the boundary
-                    {
-                      in >> subcelldata.boundary_quads.back().vertices[j];
-                    }
-                  subcelldata.boundary_quads.back().material_id = 0;
-                  for (unsigned int j = 0; j < type; j++)
-                    {
-                      subcelldata.boundary_quads.back().vertices[j] = vertex_indices[subcelldata.boundary_quads.back().vertices[j]];
-                    }
-                  quad_indices[no_quads] = no_quads + 1;
-                  no_quads++;
-                }
+      std::string textnew[2];
+      textnew[0] = "SCALARS MaterialID double";
+      textnew[1] = "LOOKUP_TABLE default";
 
-              else
-                AssertThrow (false,
-                             ExcMessage ("While reading VTK file, unknown file type encountered"));
-            }
+      for (unsigned int i = 0; i < 2; i++)
+        {
+          std::string linenew = read_line (position, end);
+          if (i == 0)
+            if (linenew.size() > textnew[0].size())
+              linenew.resize(textnew[0].size());
+
+          AssertThrow (linenew.compare(textnew[i]) == 0,
+                       ExcMessage (std::string("While reading VTK file, failed to find <") +
+                                   textnew[i] + "> section"));
         }
 
-      else if (dim == 2)
+      // the ids of the cells are followed by the ones of the boundary
+      // objects, in the order in which they are listed in the CELLS section
+      for (unsigned int i = 0; i < cells.size(); i++) //assigning IDs to cells.
         {
-          for (unsigned int count = 0; count < total_cells; count++)
-            {
-              in>>type;
-
-              if (type == 4)
-                {
-                  cells.push_back(CellData<dim>());
-
-                  for (unsigned int j = 0; j < type; j++) //loop to feed data
-                    in >> cells.back().vertices[j];
-
-                  cells.back().material_id = 0;
-
-                  for (unsigned int j = 0; j < type; j++) //loop to feed the data of the vertices to the cell
-                    {
-                      cells.back().vertices[j] = vertex_indices[cells.back().vertices[j]];
-                    }
-                  cell_indices[count] = count;
-                  no_cells++;
-                }
-
-              else if (type == 2)
-                {
-                  //If this is encountered, the pointer comes out of the loop
-                  //and starts processing boundaries.
-                  subcelldata.boundary_lines.push_back(CellData<1>());
-
-                  for (unsigned int j = 0; j < type; j++) //loop to feed the data to the boundary
-                    {
-                      in >> subcelldata.boundary_lines.back().vertices[j];
-                    }
-                  subcelldata.boundary_lines.back().material_id = 0;
-                  for (unsigned int j = 0; j < type; j++)
-                    {
-                      subcelldata.boundary_lines.back().vertices[j] = vertex_indices[subcelldata.boundary_lines.back().vertices[j]];
-                    }
-                  line_indices[no_lines] = no_lines + 1;
-                  no_lines++;
-                }
-
-              else
-                AssertThrow (false,
-                             ExcMessage ("While reading VTK file, unknown file type encountered"));
-            }
+          double id;
+          AssertThrow (read_double (position, id), ExcIO());
+          cells[i].material_id = static_cast<types::material_id>(id);
         }
-      else
-        AssertThrow (false,
-                     ExcMessage ("While reading VTK file, failed to find CELLS section"));
-
-      /////////////////////Processing the CELL_TYPES section////////////////////////
 
-      in >> keyword;
-
-      if (keyword == "CELL_TYPES")//Entering the cell_types section and ignoring data.
+      if (dim == 3)
         {
-          in.ignore(256, '\n');
-
-          while (!in.eof())
+          for (unsigned int i = 0; i < subcelldata.boundary_quads.size(); i++) //assigning IDs to bounds.
             {
-              in>>keyword;
-              if (keyword != "12" && keyword != "9")
-                {
-                  break;
-                }
+              double id;
+              AssertThrow (read_double (position, id), ExcIO());
+              subcelldata.boundary_quads[i].material_id = static_cast<types::material_id>(id);
             }
         }
-
-      ////////////////////////Processing the CELL_DATA section/////////////////////////////
-
-      if (keyword == "CELL_DATA")
+      else if (dim == 2)
         {
-          int no_ids;
-          in>>no_ids;
-
-          std::string linenew;
-          std::string textnew[2];
-          textnew[0] = "SCALARS MaterialID double";
-          textnew[1] = "LOOKUP_TABLE default";
-
-          in.ignore(256, '\n');
-
-          for (unsigned int i = 0; i < 2; i++)
-            {
-              getline(in, linenew);
-              if (i == 0)
-                if (linenew.size() > textnew[0].size())
-                  linenew.resize(textnew[0].size());
-
-              AssertThrow (linenew.compare(textnew[i]) == 0,
-                           ExcMessage (std::string("While reading VTK file, failed to find <") +
-                                       textnew[i] + "> section"));
-            }
-
-          for (unsigned int i = 0; i < no_cells; i++) //assigning IDs to cells.
-            {
-              int id;
-              in>>id;
-              cells[cell_indices[i]].material_id = id;
-            }
-
-          if (dim == 3)
-            {
-              for (unsigned int i = 0; i < no_quads; i++) //assigning IDs to bounds.
-                {
-                  int id;
-                  in>>id;
-                  subcelldata.boundary_quads[quad_indices[i]].material_id = id;
-                }
-            }
-          else if (dim == 2)
+          for (unsigned int i = 0; i < subcelldata.boundary_lines.size(); i++) //assigning IDs to bounds.
             {
-              for (unsigned int i = 0; i < no_lines; i++) //assigning IDs to bounds.
-                {
-                  int id;
-                  in>>id;
-                  subcelldata.boundary_lines[line_indices[i]].material_id = id;
-                }
+              double id;
+              AssertThrow (read_double (position, id), ExcIO());
+              subcelldata.boundary_lines[i].material_id = static_cast<types::material_id>(id);
             }
         }
+    }
 
-      Assert(subcelldata.check_consistency(dim), ExcInternalError());
-
-      GridTools::delete_unused_vertices(vertices,
-                                        cells,
-                                        subcelldata);
+  Assert(subcelldata.check_consistency(dim), ExcInternalError());
 
-      if (dim == spacedim)
-        GridReordering<dim, spacedim>::invert_all_cells_of_negative_grid(vertices,
-            cells);
+  GridTools::delete_unused_vertices(vertices,
+                                    cells,
+                                    subcelldata);
 
-      GridReordering<dim, spacedim>::reorder_cells(cells);
-      tria->create_triangulation_compatibility(vertices,
-                                               cells,
-                                               subcelldata);
+  if (dim == spacedim)
+    GridReordering<dim, spacedim>::invert_all_cells_of_negative_grid(vertices,
+        cells);
 
-      return;
-    }
-  else
-    AssertThrow (false,
-                 ExcMessage ("While reading VTK file, failed to find CELLS section"));
+  GridReordering<dim, spacedim>::reorder_cells(cells);
+  tria->create_triangulation_compatibility(vertices,
+                                           cells,
+                                           subcelldata);
 }
 
 
@@ -619,193 +1380,56 @@ void GridIn<dim, spacedim>::read_ucd (std::istream                            &i
   // skip comments at start of file
   skip_comment_lines (in, '#');
 
+  // read the rest of the file into memory at once. the vertices and cells,
+  // which make up almost all of the file, are then parsed in parallel
+  std::string buffer;
+  read_stream_into_buffer (in, buffer);
+  const char *position = buffer.c_str();
+  const char *const end = position + buffer.size();
+
+  long int n_vertices = 0;
+  long int n_cells = 0;
+  long int dummy = 0;
+
+  AssertThrow (read_integer (position, n_vertices) &&
+               read_integer (position, n_cells) &&
+               read_integer (position, dummy) &&     // number of data vectors
+               read_integer (position, dummy) &&     // cell data
+               read_integer (position, dummy) &&     // model data
+               (n_vertices >= 0) && (n_cells >= 0),
+               ExcIO());
+
+  std::vector<VertexRecord> vertex_records;
+  position = parse_records (position, end, n_vertices, &parse_vertex, vertex_records);
+  AssertThrow (position != 0, ExcIO());
+
+  std::vector<ElementRecord> elements;
+  position = parse_records (position, end, n_cells, &parse_ucd_element, elements);
+  AssertThrow (position != 0, ExcIO());
+
+  // lines are cells in 1d and boundary lines otherwise, quads are cells in
+  // 2d and boundary quads in 3d, and hexes are cells in 3d
+  for (unsigned int e=0; e<elements.size(); ++e)
+    AssertThrow ((elements[e].object_dim != numbers::invalid_unsigned_int) &&
+                 (elements[e].object_dim <= dim),
+                 ExcUnknownIdentifier(ucd_cell_type (elements[e])));
+
+  // set up array of vertices and cells, and the mapping between the
+  // numbering in the ucd-file and in the vertices vector
+  std::vector<Point<spacedim> > vertices;
+  create_vertices (vertex_records, vertices);
+  const VertexNumbering vertex_numbering (vertex_records);
 
-  unsigned int n_vertices;
-  unsigned int n_cells;
-  int dummy;
-
-  in >> n_vertices
-     >> n_cells
-     >> dummy         // number of data vectors
-     >> dummy         // cell data
-     >> dummy;        // model data
-  AssertThrow (in, ExcIO());
-
-  // set up array of vertices
-  std::vector<Point<spacedim> >     vertices (n_vertices);
-  // set up mapping between numbering
-  // in ucd-file (key) and in the
-  // vertices vector
-  std::map<int,int> vertex_indices;
-
-  for (unsigned int vertex=0; vertex<n_vertices; ++vertex)
-    {
-      int vertex_number;
-      double x[3];
-
-      // read vertex
-      AssertThrow (in, ExcIO());
-      in >> vertex_number
-         >> x[0] >> x[1] >> x[2];
-
-      // store vertex
-      for (unsigned int d=0; d<spacedim; ++d)
-        vertices[vertex](d) = x[d];
-      // store mapping; note that
-      // vertices_indices[i] is automatically
-      // created upon first usage
-      vertex_indices[vertex_number] = vertex;
-    };
-
-  // set up array of cells
-  std::vector<CellData<dim> > cells;
-  SubCellData                 subcelldata;
-
-  for (unsigned int cell=0; cell<n_cells; ++cell)
-    {
-      // note that since in the input
-      // file we found the number of
-      // cells at the top, there
-      // should still be input here,
-      // so check this:
-      AssertThrow (in, ExcIO());
-
-      std::string cell_type;
-
-      // we use an unsigned int because we
-      // fill this variable through an read-in process
-      unsigned int material_id;
-
-      in >> dummy          // cell number
-         >> material_id;
-      in >> cell_type;
-
-      if (((cell_type == "line") && (dim == 1)) ||
-          ((cell_type == "quad") && (dim == 2)) ||
-          ((cell_type == "hex" ) && (dim == 3)))
-        // found a cell
-        {
-          // allocate and read indices
-          cells.push_back (CellData<dim>());
-          for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
-            in >> cells.back().vertices[i];
-
-          // to make sure that the cast wont fail
-          Assert(material_id<= std::numeric_limits<types::material_id>::max(),
-                 ExcIndexRange(material_id,0,std::numeric_limits<types::material_id>::max()));
-          // we use only material_ids in the range from 0 to numbers::invalid_material_id-1
-          Assert(material_id < numbers::invalid_material_id,
-                 ExcIndexRange(material_id,0,numbers::invalid_material_id));
-
-          cells.back().material_id = static_cast<types::material_id>(material_id);
-
-          // transform from ucd to
-          // consecutive numbering
-          for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
-            if (vertex_indices.find (cells.back().vertices[i]) != vertex_indices.end())
-              // vertex with this index exists
-              cells.back().vertices[i] = vertex_indices[cells.back().vertices[i]];
-            else
-              {
-                // no such vertex index
-                AssertThrow (false,
-                             ExcInvalidVertexIndex(cell, cells.back().vertices[i]));
-
-                cells.back().vertices[i] = numbers::invalid_unsigned_int;
-              }
-        }
-      else if ((cell_type == "line") && ((dim == 2) || (dim == 3)))
-        // boundary info
-        {
-          subcelldata.boundary_lines.push_back (CellData<1>());
-          in >> subcelldata.boundary_lines.back().vertices[0]
-             >> subcelldata.boundary_lines.back().vertices[1];
-
-          // to make sure that the cast wont fail
-          Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
-                 ExcIndexRange(material_id,0,std::numeric_limits<types::boundary_id>::max()));
-          // we use only boundary_ids in the range from 0 to numbers::internal_face_boundary_id-1
-          Assert(material_id < numbers::internal_face_boundary_id,
-                 ExcIndexRange(material_id,0,numbers::internal_face_boundary_id));
-
-          if (apply_all_indicators_to_manifolds)
-            subcelldata.boundary_lines.back().manifold_id
-              = static_cast<types::manifold_id>(material_id);
-          else
-            subcelldata.boundary_lines.back().boundary_id
-              = static_cast<types::boundary_id>(material_id);
-
-          // transform from ucd to
-          // consecutive numbering
-          for (unsigned int i=0; i<2; ++i)
-            if (vertex_indices.find (subcelldata.boundary_lines.back().vertices[i]) !=
-                vertex_indices.end())
-              // vertex with this index exists
-              subcelldata.boundary_lines.back().vertices[i]
-                = vertex_indices[subcelldata.boundary_lines.back().vertices[i]];
-            else
-              {
-                // no such vertex index
-                AssertThrow (false,
-                             ExcInvalidVertexIndex(cell,
-                                                   subcelldata.boundary_lines.back().vertices[i]));
-                subcelldata.boundary_lines.back().vertices[i]
-                  = numbers::invalid_unsigned_int;
-              };
-        }
-      else if ((cell_type == "quad") && (dim == 3))
-        // boundary info
-        {
-          subcelldata.boundary_quads.push_back (CellData<2>());
-          in >> subcelldata.boundary_quads.back().vertices[0]
-             >> subcelldata.boundary_quads.back().vertices[1]
-             >> subcelldata.boundary_quads.back().vertices[2]
-             >> subcelldata.boundary_quads.back().vertices[3];
-
-          // to make sure that the cast wont fail
-          Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
-                 ExcIndexRange(material_id,0,std::numeric_limits<types::boundary_id>::max()));
-          // we use only boundary_ids in the range from 0 to numbers::internal_face_boundary_id-1
-          Assert(material_id < numbers::internal_face_boundary_id,
-                 ExcIndexRange(material_id,0,numbers::internal_face_boundary_id));
-
-          if (apply_all_indicators_to_manifolds)
-            subcelldata.boundary_quads.back().manifold_id
-              = static_cast<types::manifold_id>(material_id);
-          else
-            subcelldata.boundary_quads.back().boundary_id
-              = static_cast<types::boundary_id>(material_id);
-
-          // transform from ucd to
-          // consecutive numbering
-          for (unsigned int i=0; i<4; ++i)
-            if (vertex_indices.find (subcelldata.boundary_quads.back().vertices[i]) !=
-                vertex_indices.end())
-              // vertex with this index exists
-              subcelldata.boundary_quads.back().vertices[i]
-                = vertex_indices[subcelldata.boundary_quads.back().vertices[i]];
-            else
-              {
-                // no such vertex index
-                Assert (false,
-                        ExcInvalidVertexIndex(cell,
-                                              subcelldata.boundary_quads.back().vertices[i]));
-                subcelldata.boundary_quads.back().vertices[i] =
-                  numbers::invalid_unsigned_int;
-              };
-
-        }
-      else
-        // cannot read this
-        AssertThrow (false, ExcUnknownIdentifier(cell_type));
-    };
-
+  std::vector<CellData<dim> >                cells;
+  SubCellData                                subcelldata;
+  std::map<unsigned int, types::boundary_id> boundary_ids_1d;
+  create_cell_data<dim,spacedim> (elements, vertex_numbering,
+                                  apply_all_indicators_to_manifolds,
+                                  cells, subcelldata, boundary_ids_1d);
 
   // check that no forbidden arrays are used
   Assert (subcelldata.check_consistency(dim), ExcInternalError());
 
-  AssertThrow (in, ExcIO());
-
   // do some clean-up on vertices...
   GridTools::delete_unused_vertices (vertices, cells, subcelldata);
   // ... and cells
@@ -1206,12 +1830,16 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
   Assert (tria != 0, ExcNoTriangulationSelected());
   AssertThrow (in, ExcIO());
 
-  unsigned int n_vertices;
-  unsigned int n_cells;
-  unsigned int dummy;
-  std::string line;
+  // read the whole file into memory at once. the vertices and elements,
+  // which make up almost all of the file, are then parsed in parallel
+  std::string buffer;
+  read_stream_into_buffer (in, buffer);
+  const char *position = buffer.c_str();
+  const char *const end = position + buffer.size();
 
-  in >> line;
+  long int n_vertices = 0;
+  long int n_cells = 0;
+  std::string line = read_word (position);
 
   // first determine file format
   unsigned int gmsh_file_format = 0;
@@ -1225,38 +1853,64 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
   // if file format is 2 or greater
   // then we also have to read the
   // rest of the header
+  bool binary = false;
+  bool swap_byte_order = false;
   if (gmsh_file_format == 2)
     {
       double version;
-      unsigned int file_type, data_size;
+      long int file_type = 0, data_size = 0;
 
-      in >> version >> file_type >> data_size;
+      AssertThrow (read_double (position, version) &&
+                   read_integer (position, file_type) &&
+                   read_integer (position, data_size),
+                   ExcIO());
 
       Assert ( (version >= 2.0) &&
                (version <= 2.2), ExcNotImplemented());
-      Assert (file_type == 0, ExcNotImplemented());
+      Assert ((file_type == 0) || (file_type == 1), ExcNotImplemented());
       Assert (data_size == sizeof(double), ExcNotImplemented());
 
+      // binary files store the integer one after the header line, from
+      // which we can tell whether the byte order of the file is the same
+      // as ours
+      if (file_type == 1)
+        {
+          binary = true;
+          position = skip_to_next_line (position, end);
+          AssertThrow ((position != 0) &&
+                       (static_cast<std::size_t>(end - position) >= sizeof(int)),
+                       ExcIO());
+          int one = read_binary<int> (position, false);
+          if (one != 1)
+            {
+              swap_bytes (one);
+              swap_byte_order = true;
+            }
+          AssertThrow (one == 1,
+                       ExcMessage ("The byte order of the binary Gmsh file "
+                                   "could not be determined."));
+        }
+
       // read the end of the header
       // and the first line of the
       // nodes description to synch
       // ourselves with the format 1
       // handling above
-      in >> line;
+      line = read_word (position);
       AssertThrow (line == "$EndMeshFormat",
                    ExcInvalidGMSHInput(line));
 
-      in >> line;
+      line = read_word (position);
       // if the next block is of kind
       // $PhysicalNames, ignore it
       if (line == "$PhysicalNames")
         {
           do
             {
-              in >> line;
+              line = read_word (position);
             }
-          while (line != "$EndPhysicalNames");
-          in >> line;
+          while ((line != "$EndPhysicalNames") && (line.size() > 0));
+          line = read_word (position);
         }
 
       // but the next thing should,
@@ -1267,292 +1921,123 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
     }
 
   // now read the nodes list
-  in >> n_vertices;
-  std::vector<Point<spacedim> >     vertices (n_vertices);
-  // set up mapping between numbering
-  // in msh-file (nod) and in the
-  // vertices vector
-  std::map<int,int> vertex_indices;
-
-  for (unsigned int vertex=0; vertex<n_vertices; ++vertex)
-    {
-      int vertex_number;
-      double x[3];
-
-      // read vertex
-      in >> vertex_number
-         >> x[0] >> x[1] >> x[2];
-
-      for (unsigned int d=0; d<spacedim; ++d)
-        vertices[vertex](d) = x[d];
-      // store mapping
-      vertex_indices[vertex_number] = vertex;
-    }
+  AssertThrow (read_integer (position, n_vertices) && (n_vertices >= 0),
+               ExcIO());
+  std::vector<VertexRecord> vertex_records;
+  if (binary)
+    position = read_binary_msh_vertices (position, end, n_vertices,
+                                         swap_byte_order, vertex_records);
+  else
+    position = parse_records (position, end, n_vertices, &parse_vertex,
+                              vertex_records);
+  AssertThrow (position != 0, ExcIO());
 
   // Assert we reached the end of the block
-  in >> line;
+  line = read_word (position);
   static const std::string end_nodes_marker[] = {"$ENDNOD", "$EndNodes" };
   AssertThrow (line==end_nodes_marker[gmsh_file_format-1],
                ExcInvalidGMSHInput(line));
 
   // Now read in next bit
-  in >> line;
+  line = read_word (position);
   static const std::string begin_elements_marker[] = {"$ELM", "$Elements" };
   AssertThrow (line==begin_elements_marker[gmsh_file_format-1],
                ExcInvalidGMSHInput(line));
 
-  in >> n_cells;
-
-  // set up array of cells and subcells (faces). In 1d, there is currently no
-  // standard way in deal.II to pass boundary indicators attached to individual
-  // vertices, so do this by hand via the boundary_ids_1d array
-  std::vector<CellData<dim> >                cells;
-  SubCellData                                subcelldata;
-  std::map<unsigned int, types::boundary_id> boundary_ids_1d;
-
-  for (unsigned int cell=0; cell<n_cells; ++cell)
-    {
-      // note that since in the input
-      // file we found the number of
-      // cells at the top, there
-      // should still be input here,
-      // so check this:
-      AssertThrow (in, ExcIO());
-
-      unsigned int cell_type;
-      unsigned int material_id;
-      unsigned int nod_num;
-
-      /*
-        For file format version 1, the format of each cell is as follows:
-          elm-number elm-type reg-phys reg-elem number-of-nodes node-number-list
-
-        However, for version 2, the format reads like this:
-          elm-number elm-type number-of-tags < tag > ... node-number-list
-
-        In the following, we will ignore the element number (we simply enumerate
-        them in the order in which we read them, and we will take reg-phys
-        (version 1) or the first tag (version 2, if any tag is given at all) as
-        material id.
-      */
-
-      in >> dummy          // ELM-NUMBER
-         >> cell_type;     // ELM-TYPE
-
-      switch (gmsh_file_format)
-        {
-        case 1:
-        {
-          in >> material_id  // REG-PHYS
-             >> dummy        // reg_elm
-             >> nod_num;
-          break;
-        }
-
-        case 2:
-        {
-          // read the tags; ignore all but the first one which we will
-          // interpret as the material_id (for cells) or boundary_id
-          // (for faces)
-          unsigned int n_tags;
-          in >> n_tags;
-          if (n_tags > 0)
-            in >> material_id;
-          else
-            material_id = 0;
-
-          for (unsigned int i=1; i<n_tags; ++i)
-            in >> dummy;
-
-          nod_num = GeometryInfo<dim>::vertices_per_cell;
-
-          break;
-        }
-
-        default:
-          AssertThrow (false, ExcNotImplemented());
-        }
-
-
-      /*       `ELM-TYPE'
-               defines the geometrical type of the N-th element:
-               `1'
-               Line (2 nodes, 1 edge).
-
-               `3'
-               Quadrangle (4 nodes, 4 edges).
-
-               `5'
-               Hexahedron (8 nodes, 12 edges, 6 faces).
+  AssertThrow (read_integer (position, n_cells) && (n_cells >= 0),
+               ExcIO());
+
+  /*
+    For file format version 1, the format of each cell is as follows:
+      elm-number elm-type reg-phys reg-elem number-of-nodes node-number-list
+
+    However, for version 2, the format reads like this:
+      elm-number elm-type number-of-tags < tag > ... node-number-list
+
+    In the following, we will ignore the element number (we simply enumerate
+    them in the order in which we read them, and we will take reg-phys
+    (version 1) or the first tag (version 2, if any tag is given at all) as
+    material id.
+  */
+  std::vector<ElementRecord> elements;
+  if (binary)
+    position = read_binary_msh_elements (position, end, n_cells,
+                                         swap_byte_order, elements);
+  else if (gmsh_file_format == 1)
+    position = parse_records (position, end, n_cells, &parse_msh_1_element,
+                              elements);
+  else
+    position = parse_records (position, end, n_cells, &parse_msh_2_element,
+                              elements);
+  AssertThrow (position != 0, ExcIO());
 
-               `15'
-               Point (1 node).
-      */
+  /*       `ELM-TYPE'
+           defines the geometrical type of the N-th element:
+           `1'
+           Line (2 nodes, 1 edge).
 
-      if (((cell_type == 1) && (dim == 1)) ||
-          ((cell_type == 3) && (dim == 2)) ||
-          ((cell_type == 5) && (dim == 3)))
-        // found a cell
-        {
-          AssertThrow (nod_num == GeometryInfo<dim>::vertices_per_cell,
-                       ExcMessage ("Number of nodes does not coincide with the "
-                                   "number required for this object"));
-
-          // allocate and read indices
-          cells.push_back (CellData<dim>());
-          for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
-            in >> cells.back().vertices[i];
-
-          // to make sure that the cast wont fail
-          Assert(material_id<= std::numeric_limits<types::material_id>::max(),
-                 ExcIndexRange(material_id,0,std::numeric_limits<types::material_id>::max()));
-          // we use only material_ids in the range from 0 to numbers::invalid_material_id-1
-          Assert(material_id < numbers::invalid_material_id,
-                 ExcIndexRange(material_id,0,numbers::invalid_material_id));
-
-          cells.back().material_id = static_cast<types::material_id>(material_id);
-
-          // transform from ucd to
-          // consecutive numbering
-          for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
-            {
-              AssertThrow (vertex_indices.find (cells.back().vertices[i]) !=
-                           vertex_indices.end(),
-                           ExcInvalidVertexIndex(cell, cells.back().vertices[i]));
+           `3'
+           Quadrangle (4 nodes, 4 edges).
 
-              // vertex with this index exists
-              cells.back().vertices[i] = vertex_indices[cells.back().vertices[i]];
-            }
-        }
-      else if ((cell_type == 1) && ((dim == 2) || (dim == 3)))
-        // boundary info
-        {
-          subcelldata.boundary_lines.push_back (CellData<1>());
-          in >> subcelldata.boundary_lines.back().vertices[0]
-             >> subcelldata.boundary_lines.back().vertices[1];
-
-          // to make sure that the cast wont fail
-          Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
-                 ExcIndexRange(material_id,0,std::numeric_limits<types::boundary_id>::max()));
-          // we use only boundary_ids in the range from 0 to numbers::internal_face_boundary_id-1
-          Assert(material_id < numbers::internal_face_boundary_id,
-                 ExcIndexRange(material_id,0,numbers::internal_face_boundary_id));
-
-          subcelldata.boundary_lines.back().boundary_id
-            = static_cast<types::boundary_id>(material_id);
-
-          // transform from ucd to
-          // consecutive numbering
-          for (unsigned int i=0; i<2; ++i)
-            if (vertex_indices.find (subcelldata.boundary_lines.back().vertices[i]) !=
-                vertex_indices.end())
-              // vertex with this index exists
-              subcelldata.boundary_lines.back().vertices[i]
-                = vertex_indices[subcelldata.boundary_lines.back().vertices[i]];
-            else
-              {
-                // no such vertex index
-                AssertThrow (false,
-                             ExcInvalidVertexIndex(cell,
-                                                   subcelldata.boundary_lines.back().vertices[i]));
-                subcelldata.boundary_lines.back().vertices[i] =
-                  numbers::invalid_unsigned_int;
-              };
-        }
-      else if ((cell_type == 3) && (dim == 3))
-        // boundary info
-        {
-          subcelldata.boundary_quads.push_back (CellData<2>());
-          in >> subcelldata.boundary_quads.back().vertices[0]
-             >> subcelldata.boundary_quads.back().vertices[1]
-             >> subcelldata.boundary_quads.back().vertices[2]
-             >> subcelldata.boundary_quads.back().vertices[3];
-
-          // to make sure that the cast wont fail
-          Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
-                 ExcIndexRange(material_id,0,std::numeric_limits<types::boundary_id>::max()));
-          // we use only boundary_ids in the range from 0 to numbers::internal_face_boundary_id-1
-          Assert(material_id < numbers::internal_face_boundary_id,
-                 ExcIndexRange(material_id,0,numbers::internal_face_boundary_id));
-
-          subcelldata.boundary_quads.back().boundary_id
-            = static_cast<types::boundary_id>(material_id);
-
-          // transform from gmsh to
-          // consecutive numbering
-          for (unsigned int i=0; i<4; ++i)
-            if (vertex_indices.find (subcelldata.boundary_quads.back().vertices[i]) !=
-                vertex_indices.end())
-              // vertex with this index exists
-              subcelldata.boundary_quads.back().vertices[i]
-                = vertex_indices[subcelldata.boundary_quads.back().vertices[i]];
-            else
-              {
-                // no such vertex index
-                Assert (false,
-                        ExcInvalidVertexIndex(cell,
-                                              subcelldata.boundary_quads.back().vertices[i]));
-                subcelldata.boundary_quads.back().vertices[i] =
-                  numbers::invalid_unsigned_int;
-              }
+           `5'
+           Hexahedron (8 nodes, 12 edges, 6 faces).
 
-        }
-      else if (cell_type == 15)
-        {
-          // read the indices of nodes given
-          unsigned int node_index;
-          switch (gmsh_file_format)
-            {
-            case 1:
-            {
-              for (unsigned int i=0; i<nod_num; ++i)
-                in >> node_index;
-              break;
-            }
-            case 2:
-            {
-              in >> node_index;
-              break;
-            }
-            }
+           `15'
+           Point (1 node).
 
-          // we only care about boundary indicators assigned to individual
-          // vertices in 1d (because otherwise the vertices are not faces)
-          if (dim == 1)
-            boundary_ids_1d[vertex_indices[node_index]] = material_id;
-        }
-      else
-        // cannot read this, so throw
-        // an exception. treat
-        // triangles and tetrahedra
-        // specially since this
-        // deserves a more explicit
-        // error message
+     Elements of higher dimension than the mesh can not be read, so
+     throw an exception. treat triangles and tetrahedra specially since
+     this deserves a more explicit error message
+  */
+  for (unsigned int e=0; e<elements.size(); ++e)
+    {
+      const ElementRecord &element = elements[e];
+      if ((element.object_dim == numbers::invalid_unsigned_int) ||
+          (element.object_dim > dim))
         {
-          AssertThrow (cell_type != 2,
+          AssertThrow (element.type != 2,
                        ExcMessage("Found triangles while reading a file "
                                   "in gmsh format. deal.II does not "
                                   "support triangles"));
-          AssertThrow (cell_type != 11,
+          AssertThrow (element.type != 11,
                        ExcMessage("Found tetrahedra while reading a file "
                                   "in gmsh format. deal.II does not "
                                   "support tetrahedra"));
 
-          AssertThrow (false, ExcGmshUnsupportedGeometry(cell_type));
+          AssertThrow (false, ExcGmshUnsupportedGeometry(element.type));
         }
+
+      AssertThrow (element.n_vertices == (1U << element.object_dim),
+                   ExcMessage ("Number of nodes does not coincide with the "
+                               "number required for this object"));
     }
+  Assert (elements.size() == static_cast<std::size_t>(n_cells),
+          ExcInternalError());
 
   // Assert we reached the end of the block
-  in >> line;
+  line = read_word (position);
   static const std::string end_elements_marker[] = {"$ENDELM", "$EndElements" };
   AssertThrow (line==end_elements_marker[gmsh_file_format-1],
                ExcInvalidGMSHInput(line));
 
+  // set up array of vertices, cells and subcells (faces), and the mapping
+  // between the numbering in the msh-file and in the vertices vector. In
+  // 1d, there is currently no standard way in deal.II to pass boundary
+  // indicators attached to individual vertices, so do this by hand via the
+  // boundary_ids_1d array
+  std::vector<Point<spacedim> > vertices;
+  create_vertices (vertex_records, vertices);
+  const VertexNumbering vertex_numbering (vertex_records);
+
+  std::vector<CellData<dim> >                cells;
+  SubCellData                                subcelldata;
+  std::map<unsigned int, types::boundary_id> boundary_ids_1d;
+  create_cell_data<dim,spacedim> (elements, vertex_numbering, false,
+                                  cells, subcelldata, boundary_ids_1d);
+
   // check that no forbidden arrays are used
   Assert (subcelldata.check_consistency(dim), ExcInternalError());
 
-  AssertThrow (in, ExcIO());
-
   // check that we actually read some
   // cells.
   AssertThrow(cells.size() > 0, ExcGmshNoCellInformation());
@@ -2735,8 +3220,6 @@ void GridIn<dim, spacedim>::read (const std::string &filename,
   else
     name = search.find(filename, default_suffix(format));
 
-  std::ifstream in(name.c_str());
-
   if (format == Default)
     {
       const std::string::size_type slashpos = name.find_last_of('/');
@@ -2751,7 +3234,14 @@ void GridIn<dim, spacedim>::read (const std::string &filename,
   if (format == netcdf)
     read_netcdf(filename);
   else
-    read(in, format);
+    {
+      // Gmsh files may contain binary data
+      std::ifstream in(name.c_str(),
+                       (format == msh) ?
+                       std::ios::in | std::ios::binary :
+                       std::ios::in);
+      read(in, format);
+    }
 }
 
 
@@ -18,6 +18,7 @@
 #include <deal.II/grid/grid_reordering_internal.h>
 #include <deal.II/grid/grid_tools.h>
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/std_cxx11/bind.h>
 
 #include <algorithm>
@@ -888,28 +889,6 @@ namespace internal
     }
 
 
-    CheapEdge::CheapEdge (const unsigned int n0,
-                          const unsigned int n1)
-      :
-      // sort the
-      // entries so
-      // that
-      // node0<node1
-      node0(std::min (n0, n1)),
-      node1(std::max (n0, n1))
-    {}
-
-
-
-    bool CheapEdge::operator< (const CheapEdge &e2) const
-    {
-      if (node0 < e2.node0) return true;
-      if (node0 > e2.node0) return false;
-      if (node1 < e2.node1) return true;
-      return false;
-    }
-
-
     Edge::Edge (const unsigned int n0,
                 const unsigned int n1)
       :
@@ -932,8 +911,6 @@ namespace internal
 
       for (unsigned int i=0; i<GeometryInfo<3>::vertices_per_cell; ++i)
         nodes[i] = numbers::invalid_unsigned_int;
-
-      waiting_to_be_processed = false;
     }
 
 
@@ -943,6 +920,7 @@ namespace internal
       // copy the cells into our own
       // internal data format.
       const unsigned int numelems = incubes.size();
+      cell_list.reserve (numelems);
       for (unsigned int i=0; i<numelems; ++i)
         {
           Cell the_cell;
@@ -1023,110 +1001,69 @@ namespace internal
     {
       const unsigned int n_cells = cell_list.size();
 
-      unsigned int n_edges = 0;
-      // Correctly build the edge
-      // list
+      unsigned int n_vertices = 0;
+      for (unsigned int c=0; c<n_cells; ++c)
+        for (unsigned int v=0; v<GeometryInfo<3>::vertices_per_cell; ++v)
+          n_vertices = std::max (n_vertices, cell_list[c].nodes[v]+1);
+
+      // sort the edges of all cells into buckets according to their vertex
+      // with the smaller index. within each bucket, the edges are stored in
+      // the order of the cells, so the first cell that contains an edge
+      // determines the direction in which the edge stores its vertices,
+      // just like when the edges are numbered while running over the cells
+      std::vector<unsigned int> bucket_start (n_vertices+1, 0);
+      for (unsigned int c=0; c<n_cells; ++c)
+        for (unsigned int e=0; e<GeometryInfo<3>::lines_per_cell; ++e)
+          ++bucket_start[std::min (cell_list[c].nodes[ElementInfo::nodes_on_edge[e][0]],
+                                   cell_list[c].nodes[ElementInfo::nodes_on_edge[e][1]]) + 1];
+      for (unsigned int v=0; v<n_vertices; ++v)
+        bucket_start[v+1] += bucket_start[v];
+
+      std::vector<unsigned int> bucket_entries (bucket_start[n_vertices]);
       {
-        // edge_map stores the
-        // edge_number associated
-        // with a given CheapEdge
-        std::map<CheapEdge,unsigned int> edge_map;
-        unsigned int ctr = 0;
-        for (unsigned int cur_cell_id = 0;
-             cur_cell_id<n_cells;
-             ++cur_cell_id)
-          {
-            // Get the local node
-            // numbers on edge
-            // edge_num
-            const Cell &cur_cell = cell_list[cur_cell_id];
-
-            for (unsigned short int edge_num = 0;
-                 edge_num<12;
-                 ++edge_num)
-              {
-                unsigned int gl_edge_num = 0;
-                EdgeOrientation l_edge_orient = forward_edge;
-
-                // Construct the
-                // CheapEdge
-                const unsigned int
-                node0 = cur_cell.nodes[ElementInfo::nodes_on_edge[edge_num][0]],
-                node1 = cur_cell.nodes[ElementInfo::nodes_on_edge[edge_num][1]];
-                const CheapEdge cur_edge (node0, node1);
-
-                if (edge_map.count(cur_edge) == 0)
-                  // Edge not in map
-                  {
-                    // put edge in
-                    // hash map with
-                    // ctr value;
-                    edge_map[cur_edge] = ctr;
-                    gl_edge_num = ctr;
-
-                    // put the edge
-                    // into the
-                    // global edge
-                    // list
-                    edge_list.push_back(Edge(node0,node1));
-                    ctr++;
-                  }
-                else
-                  {
-                    // get edge_num
-                    // from hash_map
-                    gl_edge_num = edge_map[cur_edge];
-                    if (edge_list[gl_edge_num].nodes[0] != node0)
-                      l_edge_orient = backward_edge;
-                  }
-                // set edge number to
-                // edgenum
-                cell_list[cur_cell_id].edges[edge_num] = gl_edge_num;
-                cell_list[cur_cell_id].local_orientation_flags[edge_num]
-                  = l_edge_orient;
-              }
-          }
-        n_edges = ctr;
+        std::vector<unsigned int> next_entry (bucket_start.begin(), bucket_start.end()-1);
+        for (unsigned int c=0; c<n_cells; ++c)
+          for (unsigned int e=0; e<GeometryInfo<3>::lines_per_cell; ++e)
+            bucket_entries[next_entry[std::min (cell_list[c].nodes[ElementInfo::nodes_on_edge[e][0]],
+                                                cell_list[c].nodes[ElementInfo::nodes_on_edge[e][1]])]++]
+              = c * GeometryInfo<3>::lines_per_cell + e;
       }
 
-      // Count each of the edges.
-      {
-        std::vector<int> edge_count(n_edges,0);
-
-
-        // Count every time an edge
-        // occurs in a cube.
-        for (unsigned int cur_cell_id=0; cur_cell_id<n_cells; ++cur_cell_id)
-          for (unsigned short int edge_num = 0; edge_num<12; ++edge_num)
-            ++edge_count[cell_list[cur_cell_id].edges[edge_num]];
-
-        // So we now know how many
-        // cubes contain a given
-        // edge. Just need to store
-        // the list of cubes in the
-        // edge
-
-        // Allocate the space for the
-        // neighbor list
-        for (unsigned int cur_edge_id=0; cur_edge_id<n_edges; ++cur_edge_id)
-          edge_list[cur_edge_id].neighboring_cubes
-          .resize (edge_count[cur_edge_id]);
-
-        // Store the position of the
-        // current neighbor in the
-        // edge's neighbor list
-        std::vector<int> cur_cell_edge_list_posn(n_edges,0);
-        for (unsigned int cur_cell_id=0; cur_cell_id<n_cells; ++cur_cell_id)
-          for (unsigned short int edge_num=0; edge_num<12; ++edge_num)
+      // now number the edges. an edge is identified by its other vertex
+      // among the edges that have already been created for the present
+      // bucket, of which there are only a few
+      edge_list.clear ();
+      edge_list.reserve (3 * n_cells);
+      for (unsigned int v=0; v<n_vertices; ++v)
+        {
+          const unsigned int first_edge_of_bucket = edge_list.size();
+          for (unsigned int i=bucket_start[v]; i<bucket_start[v+1]; ++i)
             {
+              Cell &cur_cell = cell_list[bucket_entries[i] / GeometryInfo<3>::lines_per_cell];
+              const unsigned int edge_num = bucket_entries[i] % GeometryInfo<3>::lines_per_cell;
+
               const unsigned int
-              gl_edge_id = cell_list[cur_cell_id].edges[edge_num];
-              Edge &cur_edge = edge_list[gl_edge_id];
-              cur_edge.neighboring_cubes[cur_cell_edge_list_posn[gl_edge_id]]
-                = cur_cell_id;
-              cur_cell_edge_list_posn[gl_edge_id]++;
+              node0 = cur_cell.nodes[ElementInfo::nodes_on_edge[edge_num][0]],
+              node1 = cur_cell.nodes[ElementInfo::nodes_on_edge[edge_num][1]];
+              const unsigned int other_node = std::max (node0, node1);
+
+              unsigned int gl_edge_num = first_edge_of_bucket;
+              while ((gl_edge_num < edge_list.size()) &&
+                     (std::max (edge_list[gl_edge_num].nodes[0],
+                                edge_list[gl_edge_num].nodes[1]) != other_node))
+                ++gl_edge_num;
+
+              EdgeOrientation l_edge_orient = forward_edge;
+              if (gl_edge_num == edge_list.size())
+                // a new edge
+                edge_list.push_back (Edge(node0,node1));
+              else if (edge_list[gl_edge_num].nodes[0] != node0)
+                l_edge_orient = backward_edge;
+
+              cur_cell.edges[edge_num] = gl_edge_num;
+              cur_cell.local_orientation_flags[edge_num] = l_edge_orient;
             }
-      }
+        }
     }
 
 
@@ -1150,14 +1087,8 @@ namespace internal
 
     Orienter::Orienter (const std::vector<CellData<3> > &incubes)
       :
-      mesh (incubes),
-      cur_posn (0),
-      marker_cube (0),
-      cur_edge_group  (0)
-    {
-      for (unsigned int i = 0; i<12; ++i)
-        edge_orient_array[i] = false;
-    }
+      mesh (incubes)
+    {}
 
 
 
@@ -1190,329 +1121,164 @@ namespace internal
       return true;
     }
 
-    /**
-     * This assigns an orientation
-     * to each edge so that every
-     * cube is a rotated Deal.II
-     * cube.
-     */
-    bool Orienter::orient_edges ()
-    {
-      // While there are still cubes
-      // to orient
-      while (get_next_unoriented_cube())
-        // And there are edges in
-        // the cube to orient
-        while (orient_next_unoriented_edge())
-          {
-            // Make all the sides
-            // in the current set
-            // match
-            orient_edges_in_current_cube();
-
-            // Add the adjacent
-            // cubes to the list
-            // for processing
-            get_adjacent_cubes();
-            // Start working on
-            // this list of cubes
-            while (get_next_active_cube())
-              {
-                // Make sure the
-                // Cube doesn't
-                // have a
-                // contradiction
-                if (!cell_is_consistent(cur_posn))
-                  return false;
-
-                // If we needed to
-                // orient any edges
-                // in the current
-                // cube then we may
-                // have to process
-                // the neighbor.
-                if (orient_edges_in_current_cube())
-                  get_adjacent_cubes();
-              }
-
-            // start the next sheet
-            // (equivalence class
-            // of edges)
-            ++cur_edge_group;
-          }
-      return true;
-    }
-
 
 
-    bool Orienter::get_next_unoriented_cube ()
+    namespace
     {
-      // The last cube in the list
-      const unsigned int n_cubes = mesh.cell_list.size();
-      // Keep shifting along the list
-      // until we find a cube which
-      // is not fully oriented or the
-      // end.
-      while ( (marker_cube<n_cubes) &&
-              (is_oriented(marker_cube)) )
-        ++marker_cube;
-      cur_posn = marker_cube;
-      // Return true if we now point
-      // at a valid cube.
-      return (cur_posn < n_cubes);
-    }
-
+      /**
+       * Return the edge that represents the sheet that @p edge belongs to,
+       * and in @p flipped_to_root whether @p edge points in the opposite
+       * direction of it. The path from @p edge to the representative is
+       * compressed on the way, so that all edges on it point directly to
+       * the representative afterwards.
+       */
+      unsigned int
+      find_sheet (const unsigned int         edge,
+                  std::vector<unsigned int> &parent,
+                  std::vector<bool>         &flipped,
+                  bool                      &flipped_to_root)
+      {
+        unsigned int root = edge;
+        flipped_to_root = false;
+        while (parent[root] != root)
+          {
+            flipped_to_root = (flipped_to_root != flipped[root]);
+            root = parent[root];
+          }
 
+        unsigned int current = edge;
+        bool current_flipped = flipped_to_root;
+        while (parent[current] != root && parent[current] != current)
+          {
+            const unsigned int next = parent[current];
+            const bool next_flipped = (current_flipped != flipped[current]);
+            parent[current] = root;
+            flipped[current] = current_flipped;
+            current = next;
+            current_flipped = next_flipped;
+          }
 
-    bool Orienter::is_oriented (const unsigned int cell_num) const
-    {
-      for (unsigned int i=0; i<12; ++i)
-        if (mesh.edge_list[mesh.cell_list[cell_num].edges[i]].orientation_flag
-            == unoriented_edge)
-          return false;
-      return true;
+        return root;
+      }
     }
 
 
 
-    bool
-    Orienter::cell_is_consistent(const unsigned int cell_num) const
+    bool Orienter::orient_edges ()
     {
-
-      const Cell &c = mesh.cell_list[cell_num];
-
-      // Checks that all oriented
-      // edges in the group are
-      // oriented consistently.
-      for (unsigned int group=0; group<3; ++group)
+      const unsigned int n_edges = mesh.edge_list.size();
+
+      // every edge starts out as a sheet of its own. flipped[e] states
+      // whether edge e points in the opposite direction of parent[e]
+      std::vector<unsigned int> parent (n_edges);
+      std::vector<unsigned int> sheet_size (n_edges, 1);
+      std::vector<bool>         flipped (n_edges, false);
+      for (unsigned int e=0; e<n_edges; ++e)
+        parent[e] = e;
+
+      // the four parallel edges of each cell need to point in the same
+      // direction relative to the cell, so merge their sheets. if two of
+      // them are already in the same sheet, check that their directions
+      // agree
+      for (unsigned int c=0; c<mesh.cell_list.size(); ++c)
         {
-          // When a nonzero
-          // orientation is first
-          // encountered in the group
-          // it is stored in this
-          EdgeOrientation value = unoriented_edge;
-          // Loop over all parallel
-          // edges
-          for (unsigned int i=4*group; i<4*(group+1); ++i)
+          const Cell &cell = mesh.cell_list[c];
+          for (unsigned int group=0; group<3; ++group)
             {
-              // If the edge has
-              // orientation
-              if ((c.local_orientation_flags[i] !=
-                   unoriented_edge)
-                  &&
-                  (mesh.edge_list[c.edges[i]].orientation_flag !=
-                   unoriented_edge))
+              const unsigned int first = 4*group;
+              bool first_flipped;
+              unsigned int first_root = find_sheet (cell.edges[first], parent,
+                                                    flipped, first_flipped);
+              for (unsigned int i=first+1; i<4*(group+1); ++i)
                 {
-                  const EdgeOrientation this_edge_direction
-                    = (c.local_orientation_flags[i]
-                       == mesh.edge_list[c.edges[i]].orientation_flag  ?
-                       forward_edge : backward_edge);
-
-                  // If we haven't
-                  // seen an oriented
-                  // edge before,
-                  // then store its
-                  // value:
-                  if (value == unoriented_edge)
-                    value = this_edge_direction;
+                  // edge i points in the opposite direction of the first
+                  // edge if their vertices are stored differently
+                  const bool relative_flip = (cell.local_orientation_flags[i] !=
+                                              cell.local_orientation_flags[first]);
+
+                  bool this_flipped;
+                  const unsigned int root = find_sheet (cell.edges[i], parent,
+                                                        flipped, this_flipped);
+                  const bool flip = (first_flipped != this_flipped) != relative_flip;
+                  if (root == first_root)
+                    {
+                      if (flip)
+                        return false;
+                    }
+                  else if (sheet_size[root] <= sheet_size[first_root])
+                    {
+                      parent[root] = first_root;
+                      flipped[root] = flip;
+                      sheet_size[first_root] += sheet_size[root];
+                    }
                   else
-                    // If we have
-                    // seen an
-                    // oriented edge
-                    // in this group
-                    // we'd better
-                    // have the same
-                    // orientation.
-                    if (value != this_edge_direction)
-                      return false;
+                    {
+                      parent[first_root] = root;
+                      flipped[first_root] = flip;
+                      sheet_size[root] += sheet_size[first_root];
+                      first_flipped = (this_flipped != relative_flip);
+                      first_root = root;
+                    }
                 }
             }
         }
-      return true;
-    }
-
-
-
-    bool Orienter::orient_next_unoriented_edge ()
-    {
-      cur_posn = marker_cube;
-      const Cell &c = mesh.cell_list[cur_posn];
-      unsigned int edge = 0;
-
-      // search for the unoriented
-      // side
-      while ((edge<12) &&
-             (mesh.edge_list[c.edges[edge]].orientation_flag !=
-              unoriented_edge))
-        ++edge;
-
-      // if we found none then return
-      // false
-      if (edge == 12)
-        return false;
-
-      // Which edge group we're in.
-      const unsigned int edge_group = edge/4;
-
-      // A sanity check that none of
-      // the other edges in the group
-      // have been oriented yet Each
-      // of the edges in the group
-      // should be un-oriented
-      for (unsigned int j = edge_group*4; j<edge_group*4+4; ++j)
-        Assert (mesh.edge_list[c.edges[j]].orientation_flag ==
-                unoriented_edge,
-                ExcGridOrientError("Tried to orient edge when other edges "
-                                   "in group are already oriented!"));
-
-      // Make the edge alignment
-      // match that of the local
-      // cube.
-      mesh.edge_list[c.edges[edge]].orientation_flag
-        = c.local_orientation_flags[edge];
-      mesh.edge_list[c.edges[edge]].group = cur_edge_group;
-
-      // Remember that we have oriented
-      // this edge in the current cell.
-      edge_orient_array[edge] = true;
-
-      return true;
-    }
-
-
-
-    bool Orienter::orient_edges_in_current_cube ()
-    {
-      for (unsigned int edge_group=0; edge_group<3; ++edge_group)
-        if (orient_edge_set_in_current_cube(edge_group) == true)
-          return true;
-
-      return false;
-    }
-
-
-
-    bool
-    Orienter::orient_edge_set_in_current_cube (const unsigned int n)
-    {
-      const Cell &c = mesh.cell_list[cur_posn];
-
-      // Check if any edge is
-      // oriented
-      unsigned int n_oriented = 0;
-      EdgeOrientation glorient   = unoriented_edge;
-      unsigned int edge_flags = 0;
-      unsigned int cur_flag   = 1;
-      for (unsigned int i = 4*n; i<4*(n+1); ++i, cur_flag<<=1)
-        {
-          if ((mesh.edge_list[c.edges[i]].orientation_flag !=
-               unoriented_edge)
-              &&
-              (c.local_orientation_flags[i] !=
-               unoriented_edge))
-            {
-              ++n_oriented;
-
-              const EdgeOrientation orient
-                = (mesh.edge_list[c.edges[i]].orientation_flag ==
-                   c.local_orientation_flags[i] ?
-                   forward_edge : backward_edge);
-
-              if (glorient == unoriented_edge)
-                glorient = orient;
-              else
-                AssertThrow(orient == glorient,
-                            ExcGridOrientError("Attempted to Orient Misaligned cube"));
-            }
-          else
-            edge_flags |= cur_flag;
-        }
-
-      // were any of the sides
-      // oriented?  were they all
-      // already oriented?
-      if ((glorient == unoriented_edge) || (n_oriented == 4))
-        return false;
-
-      // If so orient all edges
-      // consistently.
-      cur_flag = 1;
-      for (unsigned int i=4*n; i<4*(n+1); ++i, cur_flag<<=1)
-        if ((edge_flags & cur_flag) != 0)
-          {
-            mesh.edge_list[c.edges[i]].orientation_flag
-              = (c.local_orientation_flags[i] == glorient ?
-                 forward_edge : backward_edge);
-
-            mesh.edge_list[c.edges[i]].group = cur_edge_group;
-            // Remember that we have oriented
-            // this edge in the current cell.
-            edge_orient_array[i] = true;
-          }
-
-      return true;
-    }
 
-
-
-    void Orienter::get_adjacent_cubes ()
-    {
-      const Cell &c = mesh.cell_list[cur_posn];
-      for (unsigned int e=0; e<12; ++e)
-        // Only need to add the adjacent
-        // cubes for edges we recently
-        // oriented
-        if (edge_orient_array[e] == true)
+      // choose the direction of each sheet such that its edges point in
+      // the direction of the first cell in which it appears. this is the
+      // orientation an advancing front through the cells would produce,
+      // and it leaves this cell unchanged. in the course of this loop,
+      // all paths to the representatives of the sheets are compressed
+      std::vector<char>         sheet_direction (n_edges, 'u');
+      std::vector<unsigned int> sheet_number (n_edges, numbers::invalid_unsigned_int);
+      unsigned int n_sheets = 0;
+      for (unsigned int c=0; c<mesh.cell_list.size(); ++c)
+        for (unsigned int e=0; e<GeometryInfo<3>::lines_per_cell; ++e)
           {
-            const Edge &the_edge = mesh.edge_list[c.edges[e]];
-            for (unsigned int local_cube_num = 0;
-                 local_cube_num < the_edge.neighboring_cubes.size();
-                 ++local_cube_num)
+            const Cell &cell = mesh.cell_list[c];
+            bool edge_flipped;
+            const unsigned int root = find_sheet (cell.edges[e], parent,
+                                                  flipped, edge_flipped);
+            if (sheet_direction[root] == 'u')
               {
-                const unsigned int
-                global_cell_num = the_edge.neighboring_cubes[local_cube_num];
-                Cell &ncell = mesh.cell_list[global_cell_num];
-
-                // If the cell is waiting to be
-                // processed we dont want to add
-                // it to the list a second time.
-                if (!ncell.waiting_to_be_processed)
-                  {
-                    sheet_to_process.push_back(global_cell_num);
-                    ncell.waiting_to_be_processed = true;
-                  }
+                const bool edge_backward = (cell.local_orientation_flags[e] == backward_edge);
+                sheet_direction[root] = ((edge_backward != edge_flipped) ? 'b' : 'f');
+                sheet_number[root] = n_sheets++;
               }
           }
-      // we're done with this cube so
-      // clear its processing flags.
-      for (unsigned int e=0; e<12; ++e)
-        edge_orient_array[e] = false;
 
-    }
-
-
-
-    bool Orienter::get_next_active_cube ()
-    {
-      // Mark the curent Cube as
-      // finished with.
-      Cell &c = mesh.cell_list[cur_posn];
-      c.waiting_to_be_processed = false;
-      if (sheet_to_process.empty() == false)
+      for (unsigned int e=0; e<n_edges; ++e)
         {
-          cur_posn = sheet_to_process.back();
-          sheet_to_process.pop_back();
-          return true;
+          Assert ((parent[e] == e) || (parent[parent[e]] == parent[e]),
+                  ExcInternalError());
+          const unsigned int root = parent[e];
+          const bool backward = ((sheet_direction[root] == 'b') != flipped[e]);
+          mesh.edge_list[e].orientation_flag = (backward ? backward_edge : forward_edge);
+          mesh.edge_list[e].group = sheet_number[root];
         }
-      return false;
+
+      return true;
     }
 
 
+
     void Orienter::orient_cubes ()
     {
       // We assume that the mesh has
-      // all edges oriented already.
+      // all edges oriented already,
+      // so the cubes can be rotated
+      // independently of each other
+      parallel::apply_to_subranges (0U, static_cast<unsigned int>(mesh.cell_list.size()),
+                                    std_cxx11::bind (&Orienter::orient_cubes_in_range,
+                                                     this,
+                                                     std_cxx11::_1,
+                                                     std_cxx11::_2),
+                                    1000);
+    }
+
 
+    void Orienter::orient_cubes_in_range (const unsigned int begin,
+                                          const unsigned int end)
+    {
       // This is a list of
       // permutations that take node
       // 0 to node i but only rotate
@@ -1540,7 +1306,7 @@ namespace internal
       // that should be the local
       // zero node has three edges
       // coming into it.
-      for (unsigned int i=0; i<mesh.cell_list.size(); ++i)
+      for (unsigned int i=begin; i<end; ++i)
         {
           Cell &the_cell = mesh.cell_list[i];
 
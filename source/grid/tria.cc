@@ -15,6 +15,8 @@
 
 
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/performance_trace.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/geometry_info.h>
 #include <deal.II/base/std_cxx11/bind.h>
@@ -726,6 +728,45 @@ namespace
   }
 
 
+  /**
+   * Set the neighbors of the used cells with indices in the range
+   * [begin,end) on the given level, from the list of the cells adjacent to
+   * each face that update_neighbors() has built. Note, that we have to use
+   * the opposite of the left_right_offset in this case as we want the
+   * offset of the neighbor, not our own.
+   */
+  template <int dim, int spacedim>
+  void
+  set_neighbors_on_level (Triangulation<dim,spacedim> &triangulation,
+                          const unsigned int           level,
+                          const std::vector<typename Triangulation<dim,spacedim>::cell_iterator> &adjacent_cells,
+                          const unsigned int (*left_right_offset)[2],
+                          const unsigned int           begin,
+                          const unsigned int           end)
+  {
+    for (unsigned int index=begin; index<end; ++index)
+      {
+        const TriaRawIterator<CellAccessor<dim,spacedim> >
+        cell (&triangulation, level, index);
+        if (cell->used() == false)
+          continue;
+
+        for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+          {
+            const unsigned int
+            offset = (cell->direction_flag()
+                      ?
+                      left_right_offset[f][cell->face_orientation(f)]
+                      :
+                      1-left_right_offset[f][cell->face_orientation(f)]);
+            cell->set_neighbor(f,
+                               adjacent_cells[2*cell->face(f)->index() + 1 - offset]);
+          }
+      }
+  }
+
+
+
   template <int dim, int spacedim>
   void
   update_neighbors (Triangulation<dim,spacedim> &triangulation)
@@ -889,22 +930,43 @@ namespace
         } // for all faces of all cells
 
     // now loop again over all cells and set the
-    // corresponding neighbor cell. Note, that we
-    // have to use the opposite of the
-    // left_right_offset in this case as we want
-    // the offset of the neighbor, not our own.
-    for (cell=triangulation.begin(); cell != endc; ++cell)
-      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
-        {
-          const unsigned int
-          offset = (cell->direction_flag()
-                    ?
-                    left_right_offset[dim-2][f][cell->face_orientation(f)]
-                    :
-                    1-left_right_offset[dim-2][f][cell->face_orientation(f)]);
-          cell->set_neighbor(f,
-                             adjacent_cells[2*cell->face(f)->index() + 1 - offset]);
-        }
+    // corresponding neighbor cell. every cell
+    // only writes its own neighbor information,
+    // so we can do this in parallel
+    for (unsigned int level=0; level<triangulation.n_levels(); ++level)
+      parallel::apply_to_subranges (0U, triangulation.n_raw_cells(level),
+                                    std_cxx11::bind (&set_neighbors_on_level<dim,spacedim>,
+                                                     std_cxx11::ref(triangulation),
+                                                     level,
+                                                     std_cxx11::cref(adjacent_cells),
+                                                     &left_right_offset[dim-2][0],
+                                                     std_cxx11::_1,
+                                                     std_cxx11::_2),
+                                    512);
+  }
+
+
+  /**
+   * Store the vertex indices of the cells with indices in the range
+   * [begin,end) on the given level in @p vertex_indices, with the layout of
+   * TriaLevel::cell_vertex_indices_cache. Unused cells get invalid indices.
+   */
+  template <int dim, int spacedim>
+  void
+  get_cell_vertex_indices_on_level (const Triangulation<dim,spacedim> &triangulation,
+                                    const unsigned int                 level,
+                                    std::vector<unsigned int>         &vertex_indices,
+                                    const unsigned int                 begin,
+                                    const unsigned int                 end)
+  {
+    for (unsigned int index=begin; index<end; ++index)
+      {
+        const TriaRawIterator<CellAccessor<dim,spacedim> >
+        cell (&triangulation, level, index);
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          vertex_indices[index*GeometryInfo<dim>::vertices_per_cell+v]
+            = (cell->used() ? cell->vertex_index(v) : numbers::invalid_unsigned_int);
+      }
   }
 
 
@@ -4367,6 +4429,95 @@ namespace internal
 
 
 
+      /**
+       * Compute the new vertices at the midpoints of the lines with indices
+       * [begin,end) in the given list. The lines must already have been
+       * refined, i.e., the index of the new vertex is stored as the second
+       * vertex of the first child, and the vertex must have been marked as
+       * used. The computation of the new points, which may involve
+       * expensive calls into the Manifold objects, is independent for
+       * every line, so the refinement functions call this function in
+       * parallel once all lines have been split.
+       */
+      template <int dim, int spacedim>
+      static
+      void
+      compute_new_vertices_on_lines (Triangulation<dim,spacedim> &triangulation,
+                                     const std::vector<typename Triangulation<dim,spacedim>::line_iterator> &lines,
+                                     const unsigned int begin,
+                                     const unsigned int end)
+      {
+        for (unsigned int i=begin; i<end; ++i)
+          {
+            const typename Triangulation<dim,spacedim>::line_iterator &line = lines[i];
+            const unsigned int new_vertex = line->child(0)->vertex_index(1);
+
+            // for the case of a domain in an equal-dimensional space, or if
+            // a manifold_id has been set on this very line, we ask the
+            // manifold of the line. however, if spacedim>dim, we use the
+            // object of the adjacent cell, which was stored in
+            // line->user_index() before.
+            if ((spacedim == dim) ||
+                (line->manifold_id() != numbers::invalid_manifold_id))
+              triangulation.vertices[new_vertex] = line->center(true);
+            else
+              triangulation.vertices[new_vertex]
+                = triangulation.get_manifold(line->user_index()).get_new_point_on_line (line);
+          }
+      }
+
+
+
+      /**
+       * Check the children of the cells with indices [begin,end) in the
+       * given list for distortion and store the result in the respective
+       * entries of @p is_distorted. We use a vector of chars rather than of
+       * bools since the latter does not allow concurrent writes to
+       * different entries.
+       */
+      template <int dim, int spacedim>
+      static
+      void
+      check_children_for_distortion (const std::vector<typename Triangulation<dim,spacedim>::cell_iterator> &cells,
+                                     std::vector<unsigned char> &is_distorted,
+                                     const unsigned int begin,
+                                     const unsigned int end)
+      {
+        for (unsigned int i=begin; i<end; ++i)
+          is_distorted[i] = has_distorted_children (cells[i],
+                                                    internal::int2type<dim>(),
+                                                    internal::int2type<spacedim>());
+      }
+
+
+
+      /**
+       * Check the children of all given cells, which have just been
+       * refined, for distortion in parallel, and add the cells with
+       * distorted children to the given list, in the order in which they
+       * appear in @p refined_cells.
+       */
+      template <int dim, int spacedim>
+      static
+      void
+      collect_cells_with_distorted_children (const std::vector<typename Triangulation<dim,spacedim>::cell_iterator> &refined_cells,
+                                             typename Triangulation<dim,spacedim>::DistortedCellList &cells_with_distorted_children)
+      {
+        std::vector<unsigned char> is_distorted (refined_cells.size(), 0);
+        parallel::apply_to_subranges (0U, refined_cells.size(),
+                                      std_cxx11::bind (&check_children_for_distortion<dim,spacedim>,
+                                                       std_cxx11::cref(refined_cells),
+                                                       std_cxx11::ref(is_distorted),
+                                                       std_cxx11::_1,
+                                                       std_cxx11::_2),
+                                      64);
+        for (unsigned int i=0; i<refined_cells.size(); ++i)
+          if (is_distorted[i])
+            cells_with_distorted_children.distorted_cells.push_back (refined_cells[i]);
+      }
+
+
+
       /**
        * A function that performs the
        * refinement of a triangulation in 1d.
@@ -4796,6 +4947,7 @@ namespace internal
 
         // first the refinement of lines.  children are stored
         // pairwise
+        std::vector<typename Triangulation<dim,spacedim>::line_iterator> refined_lines;
         if (true)
           {
             // only active objects can be refined further
@@ -4818,32 +4970,12 @@ namespace internal
                           ExcMessage("Internal error: During refinement, the triangulation wants to access an element of the 'vertices' array but it turns out that the array is not large enough."));
                   triangulation.vertices_used[next_unused_vertex] = true;
 
-                  if (spacedim == dim)
-                    {
-                      // for the case of a domain in an
-                      // equal-dimensional space we only have to treat
-                      // boundary lines differently; for interior
-                      // lines we can compute the midpoint as the mean
-                      // of the two vertices: if (line->at_boundary())
-                      triangulation.vertices[next_unused_vertex]
-                        = line->center(true);
-                    }
-                  else
-                    // however, if spacedim>dim, we always have to ask
-                    // the boundary object for its answer. We use the
-                    // same object of the cell (which was stored in
-                    // line->user_index() before) unless a manifold_id
-                    // has been set on this very line.
-                    if (line->manifold_id() == numbers::invalid_manifold_id)
-                      triangulation.vertices[next_unused_vertex]
-                        = triangulation.get_manifold(line->user_index()).get_new_point_on_line (line);
-                    else
-                      triangulation.vertices[next_unused_vertex]
-                        = line->center(true);
+                  // the location of the new vertex is computed below,
+                  // once all lines have been split
+                  refined_lines.push_back (line);
 
-                  // now that we created the right point, make up the
-                  // two child lines.  To this end, find a pair of
-                  // unused lines
+                  // make up the two child lines.  To this end, find a
+                  // pair of unused lines
                   bool pair_found=false;
                   (void)pair_found;
                   for (; next_unused_line!=endl; ++next_unused_line)
@@ -4901,6 +5033,15 @@ namespace internal
                 }
           }
 
+        // compute the new vertices on the refined lines
+        parallel::apply_to_subranges (0U, refined_lines.size(),
+                                      std_cxx11::bind (&compute_new_vertices_on_lines<dim,spacedim>,
+                                                       std_cxx11::ref(triangulation),
+                                                       std_cxx11::cref(refined_lines),
+                                                       std_cxx11::_1,
+                                                       std_cxx11::_2),
+                                      64);
+
 
         // Now set up the new cells
 
@@ -4911,6 +5052,7 @@ namespace internal
 
         typename Triangulation<2,spacedim>::DistortedCellList
         cells_with_distorted_children;
+        std::vector<typename Triangulation<dim,spacedim>::cell_iterator> refined_cells;
 
         // reset next_unused_line, as now also single empty places in
         // the vector can be used
@@ -4949,17 +5091,18 @@ namespace internal
                                    next_unused_cell,
                                    cell);
 
-                  if ((check_for_distorted_cells == true)
-                      &&
-                      has_distorted_children (cell,
-                                              internal::int2type<dim>(),
-                                              internal::int2type<spacedim>()))
-                    cells_with_distorted_children.distorted_cells.push_back (cell);
+                  if (check_for_distorted_cells == true)
+                    refined_cells.push_back (cell);
                   // inform all listeners that cell refinement is done
                   triangulation.signals.post_refinement_on_cell(cell);
                 }
           }
 
+        // now see if we have created cells that are distorted and if so
+        // add them to our list
+        collect_cells_with_distorted_children<dim,spacedim> (refined_cells,
+                                                             cells_with_distorted_children);
+
         return cells_with_distorted_children;
       }
 
@@ -5264,6 +5407,7 @@ namespace internal
         unsigned int next_unused_vertex = 0;
 
         // first for lines
+        std::vector<typename Triangulation<dim,spacedim>::line_iterator> refined_lines;
         if (true)
           {
             // only active objects can be refined further
@@ -5286,12 +5430,12 @@ namespace internal
                           ExcMessage("Internal error: During refinement, the triangulation wants to access an element of the 'vertices' array but it turns out that the array is not large enough."));
                   triangulation.vertices_used[next_unused_vertex] = true;
 
-                  triangulation.vertices[next_unused_vertex]
-                    = line->center(true);
+                  // the location of the new vertex is computed below,
+                  // once all lines have been split
+                  refined_lines.push_back (line);
 
-                  // now that we created the right point, make up the
-                  // two child lines (++ takes care of the end of the
-                  // vector)
+                  // make up the two child lines (++ takes care of the
+                  // end of the vector)
                   next_unused_line=triangulation.faces->lines.next_free_pair_object(triangulation);
                   Assert(next_unused_line.state() == IteratorState::valid,
                          ExcInternalError());
@@ -5341,6 +5485,17 @@ namespace internal
                 }
           }
 
+        // compute the new vertices on the refined lines. they are needed
+        // below when computing the new vertices at the centers of the
+        // quads
+        parallel::apply_to_subranges (0U, refined_lines.size(),
+                                      std_cxx11::bind (&compute_new_vertices_on_lines<dim,spacedim>,
+                                                       std_cxx11::ref(triangulation),
+                                                       std_cxx11::cref(refined_lines),
+                                                       std_cxx11::_1,
+                                                       std_cxx11::_2),
+                                      64);
+
 
         ///////////////////////////////////////
         // now refine marked quads
@@ -6109,6 +6264,7 @@ namespace internal
 
         typename Triangulation<3,spacedim>::DistortedCellList
         cells_with_distorted_children;
+        std::vector<typename Triangulation<dim,spacedim>::cell_iterator> refined_cells;
 
         for (unsigned int level=0; level!=triangulation.levels.size()-1; ++level)
           {
@@ -8558,14 +8714,10 @@ namespace internal
                         new_hexes[current_child]->set_face_rotation    (f, f_ro[f]);
                       }
 
-                  // now see if we have created cells that are
-                  // distorted and if so add them to our list
-                  if ((check_for_distorted_cells == true)
-                      &&
-                      has_distorted_children (hex,
-                                              internal::int2type<dim>(),
-                                              internal::int2type<spacedim>()))
-                    cells_with_distorted_children.distorted_cells.push_back (hex);
+                  // remember the cell, so that we can check later
+                  // whether we have created cells that are distorted
+                  if (check_for_distorted_cells == true)
+                    refined_cells.push_back (hex);
 
                   // note that the refinement flag was already cleared
                   // at the beginning of this loop
@@ -8582,6 +8734,11 @@ namespace internal
         // enable the user to use whichever he likes later on.
         triangulation.faces->quads.clear_user_data();
 
+        // now see if we have created cells that are distorted and if so
+        // add them to our list
+        collect_cells_with_distorted_children<dim,spacedim> (refined_cells,
+                                                             cells_with_distorted_children);
+
         // return the list with distorted children
         return cells_with_distorted_children;
       }
@@ -8958,6 +9115,7 @@ Triangulation (const MeshSmoothing smooth_grid,
   faces(NULL),
   anisotropic_refinement(false),
   check_for_distorted_cells(check_for_distorted_cells),
+  cache_cell_vertex_indices (false),
   vertex_to_boundary_id_map_1d (0),
   vertex_to_manifold_id_map_1d (0)
 {
@@ -8973,6 +9131,16 @@ Triangulation (const MeshSmoothing smooth_grid,
   signals.create.connect (signals.any_change);
   signals.post_refinement.connect (signals.any_change);
   signals.clear.connect (signals.any_change);
+
+  // keep the cached vertex indices of cells up to date. these slots are
+  // connected first, so that the cache is valid in all slots connected
+  // later on by the user
+  signals.pre_refinement.connect
+  (std_cxx11::bind (&Triangulation<dim,spacedim>::clear_cell_vertex_index_cache,
+                    std_cxx11::ref(*this)));
+  signals.any_change.connect
+  (std_cxx11::bind (&Triangulation<dim,spacedim>::update_cell_vertex_index_cache,
+                    std_cxx11::ref(*this)));
 }
 
 
@@ -8985,6 +9153,7 @@ Triangulation (const Triangulation<dim, spacedim> &other)
   :
   Subscriptor(),
   check_for_distorted_cells(other.check_for_distorted_cells),
+  cache_cell_vertex_indices (other.cache_cell_vertex_indices),
   vertex_to_boundary_id_map_1d (0),
   vertex_to_manifold_id_map_1d (0)
 {
@@ -9043,6 +9212,25 @@ Triangulation<dim, spacedim>::set_mesh_smoothing(const MeshSmoothing mesh_smooth
 
 
 
+template <int dim, int spacedim>
+void
+Triangulation<dim, spacedim>::set_cell_vertex_index_caching (const bool enable)
+{
+  cache_cell_vertex_indices = enable;
+  update_cell_vertex_index_cache ();
+}
+
+
+
+template <int dim, int spacedim>
+bool
+Triangulation<dim, spacedim>::cell_vertex_indices_are_cached () const
+{
+  return cache_cell_vertex_indices;
+}
+
+
+
 template <int dim, int spacedim>
 void
 Triangulation<dim, spacedim>::set_boundary (const types::manifold_id m_number,
@@ -11784,6 +11972,30 @@ Triangulation<dim,spacedim>::locally_owned_subdomain () const
 
 
 
+template <int dim, int spacedim>
+unsigned int
+Triangulation<dim,spacedim>::
+coarse_cell_index_to_coarse_cell_id (const unsigned int coarse_cell_index) const
+{
+  AssertIndexRange (coarse_cell_index, n_cells(0));
+  return coarse_cell_index;
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+Triangulation<dim,spacedim>::
+coarse_cell_id_to_coarse_cell_index (const unsigned int coarse_cell_id) const
+{
+  if (coarse_cell_id < n_cells(0))
+    return coarse_cell_id;
+  else
+    return numbers::invalid_unsigned_int;
+}
+
+
+
 template <int dim, int spacedim>
 Triangulation<dim,spacedim> &
 Triangulation<dim,spacedim>::get_triangulation ()
@@ -11829,6 +12041,8 @@ template <int dim, int spacedim>
 void
 Triangulation<dim, spacedim>::execute_coarsening_and_refinement ()
 {
+  PerformanceTrace::Scope trace_scope ("Triangulation::execute_coarsening_and_refinement");
+
   prepare_coarsening_and_refinement ();
 
   // verify a case with which we have had
@@ -11887,6 +12101,44 @@ Triangulation<dim,spacedim>::reset_active_cell_indices ()
 }
 
 
+
+template <int dim, int spacedim>
+void
+Triangulation<dim,spacedim>::update_cell_vertex_index_cache ()
+{
+  clear_cell_vertex_index_cache ();
+  if (cache_cell_vertex_indices == false)
+    return;
+
+  for (unsigned int level=0; level<levels.size(); ++level)
+    {
+      // fill a separate array first since the accessors already use the
+      // cache as soon as it is not empty
+      std::vector<unsigned int>
+      vertex_indices (n_raw_cells(level) * GeometryInfo<dim>::vertices_per_cell);
+      parallel::apply_to_subranges (0U, n_raw_cells(level),
+                                    std_cxx11::bind (&get_cell_vertex_indices_on_level<dim,spacedim>,
+                                                     std_cxx11::cref(*this),
+                                                     level,
+                                                     std_cxx11::ref(vertex_indices),
+                                                     std_cxx11::_1,
+                                                     std_cxx11::_2),
+                                    512);
+      levels[level]->cell_vertex_indices_cache.swap (vertex_indices);
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void
+Triangulation<dim,spacedim>::clear_cell_vertex_index_cache ()
+{
+  for (unsigned int level=0; level<levels.size(); ++level)
+    std::vector<unsigned int>().swap (levels[level]->cell_vertex_indices_cache);
+}
+
+
 template <int dim, int spacedim>
 void
 Triangulation<dim,spacedim>::update_periodic_face_map ()
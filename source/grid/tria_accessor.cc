@@ -1614,21 +1614,25 @@ void CellAccessor<dim, spacedim>::set_neighbor (const unsigned int i,
 
   if (pointer.state() == IteratorState::valid)
     {
+      AssertThrow (pointer->present_level <
+                   internal::Triangulation::TriaLevel<dim>::invalid_neighbor_level,
+                   ExcMessage ("The triangulation can only store neighbor "
+                               "information for cells on less than 65535 levels."));
       this->tria->levels[this->present_level]->
-      neighbors[this->present_index*GeometryInfo<dim>::faces_per_cell+i].first
+      neighbor_levels[this->present_index*GeometryInfo<dim>::faces_per_cell+i]
         = pointer->present_level;
       this->tria->levels[this->present_level]->
-      neighbors[this->present_index*GeometryInfo<dim>::faces_per_cell+i].second
+      neighbor_indices[this->present_index*GeometryInfo<dim>::faces_per_cell+i]
         = pointer->present_index;
     }
   else
     {
       this->tria->levels[this->present_level]->
-      neighbors[this->present_index*GeometryInfo<dim>::faces_per_cell+i].first
-        = -1;
+      neighbor_levels[this->present_index*GeometryInfo<dim>::faces_per_cell+i]
+        = internal::Triangulation::TriaLevel<dim>::invalid_neighbor_level;
       this->tria->levels[this->present_level]->
-      neighbors[this->present_index*GeometryInfo<dim>::faces_per_cell+i].second
-        = -1;
+      neighbor_indices[this->present_index*GeometryInfo<dim>::faces_per_cell+i]
+        = numbers::invalid_unsigned_int;
     };
 }
 
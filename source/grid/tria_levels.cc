@@ -23,6 +23,13 @@ namespace internal
 {
   namespace Triangulation
   {
+    template <int dim>
+    const unsigned short int TriaLevel<dim>::invalid_neighbor_level;
+
+    const unsigned short int TriaLevel<3>::invalid_neighbor_level;
+
+
+
     template <int dim>
     void
     TriaLevel<dim>::reserve_space (const unsigned int total_cells,
@@ -77,10 +84,14 @@ namespace internal
                           (total_cells + 1) / 2 - parents.size (),
                           -1);
 
-          neighbors.reserve (total_cells*(2*dimension));
-          neighbors.insert (neighbors.end(),
-                            total_cells*(2*dimension) - neighbors.size(),
-                            std::make_pair(-1,-1));
+          neighbor_indices.reserve (total_cells*(2*dimension));
+          neighbor_indices.insert (neighbor_indices.end(),
+                                   total_cells*(2*dimension) - neighbor_indices.size(),
+                                   numbers::invalid_unsigned_int);
+          neighbor_levels.reserve (total_cells*(2*dimension));
+          neighbor_levels.insert (neighbor_levels.end(),
+                                  total_cells*(2*dimension) - neighbor_levels.size(),
+                                  invalid_neighbor_level);
         };
     }
 
@@ -90,10 +101,12 @@ namespace internal
     TriaLevel<dim>::monitor_memory (const unsigned int true_dimension) const
     {
       (void)true_dimension;
-      Assert (2*true_dimension*refine_flags.size() == neighbors.size(),
-              ExcMemoryInexact (refine_flags.size(), neighbors.size()));
-      Assert (2*true_dimension*coarsen_flags.size() == neighbors.size(),
-              ExcMemoryInexact (coarsen_flags.size(), neighbors.size()));
+      Assert (2*true_dimension*refine_flags.size() == neighbor_indices.size(),
+              ExcMemoryInexact (refine_flags.size(), neighbor_indices.size()));
+      Assert (2*true_dimension*coarsen_flags.size() == neighbor_indices.size(),
+              ExcMemoryInexact (coarsen_flags.size(), neighbor_indices.size()));
+      Assert (neighbor_levels.size() == neighbor_indices.size(),
+              ExcMemoryInexact (neighbor_levels.size(), neighbor_indices.size()));
     }
 
 
@@ -104,7 +117,9 @@ namespace internal
       return (MemoryConsumption::memory_consumption (refine_flags) +
               MemoryConsumption::memory_consumption (coarsen_flags) +
               MemoryConsumption::memory_consumption (active_cell_indices) +
-              MemoryConsumption::memory_consumption (neighbors) +
+              MemoryConsumption::memory_consumption (neighbor_indices) +
+              MemoryConsumption::memory_consumption (neighbor_levels) +
+              MemoryConsumption::memory_consumption (cell_vertex_indices_cache) +
               MemoryConsumption::memory_consumption (subdomain_ids) +
               MemoryConsumption::memory_consumption (level_subdomain_ids) +
               MemoryConsumption::memory_consumption (parents) +
@@ -169,10 +184,14 @@ namespace internal
                           (total_cells + 1) / 2 - parents.size (),
                           -1);
 
-          neighbors.reserve (total_cells*(2*dimension));
-          neighbors.insert (neighbors.end(),
-                            total_cells*(2*dimension) - neighbors.size(),
-                            std::make_pair(-1,-1));
+          neighbor_indices.reserve (total_cells*(2*dimension));
+          neighbor_indices.insert (neighbor_indices.end(),
+                                   total_cells*(2*dimension) - neighbor_indices.size(),
+                                   numbers::invalid_unsigned_int);
+          neighbor_levels.reserve (total_cells*(2*dimension));
+          neighbor_levels.insert (neighbor_levels.end(),
+                                  total_cells*(2*dimension) - neighbor_levels.size(),
+                                  invalid_neighbor_level);
         };
     }
 
@@ -181,10 +200,12 @@ namespace internal
     TriaLevel<3>::monitor_memory (const unsigned int true_dimension) const
     {
       (void)true_dimension;
-      Assert (2*true_dimension*refine_flags.size() == neighbors.size(),
-              ExcMemoryInexact (refine_flags.size(), neighbors.size()));
-      Assert (2*true_dimension*coarsen_flags.size() == neighbors.size(),
-              ExcMemoryInexact (coarsen_flags.size(), neighbors.size()));
+      Assert (2*true_dimension*refine_flags.size() == neighbor_indices.size(),
+              ExcMemoryInexact (refine_flags.size(), neighbor_indices.size()));
+      Assert (2*true_dimension*coarsen_flags.size() == neighbor_indices.size(),
+              ExcMemoryInexact (coarsen_flags.size(), neighbor_indices.size()));
+      Assert (neighbor_levels.size() == neighbor_indices.size(),
+              ExcMemoryInexact (neighbor_levels.size(), neighbor_indices.size()));
     }
 
 
@@ -194,7 +215,9 @@ namespace internal
       return (MemoryConsumption::memory_consumption (refine_flags) +
               MemoryConsumption::memory_consumption (coarsen_flags) +
               MemoryConsumption::memory_consumption (active_cell_indices) +
-              MemoryConsumption::memory_consumption (neighbors) +
+              MemoryConsumption::memory_consumption (neighbor_indices) +
+              MemoryConsumption::memory_consumption (neighbor_levels) +
+              MemoryConsumption::memory_consumption (cell_vertex_indices_cache) +
               MemoryConsumption::memory_consumption (subdomain_ids) +
               MemoryConsumption::memory_consumption (parents) +
               MemoryConsumption::memory_consumption (direction_flags) +
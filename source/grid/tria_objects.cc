@@ -119,8 +119,12 @@ namespace internal
           boundary_or_material_id.reserve (new_size);
           boundary_or_material_id.resize (new_size);
 
-          user_data.reserve (new_size);
-          user_data.resize (new_size);
+          // the user data is only allocated once it is used
+          if (user_data.size() > 0)
+            {
+              user_data.reserve (new_size);
+              user_data.resize (new_size);
+            }
 
           manifold_id.reserve (new_size);
           manifold_id.insert (manifold_id.end(),
@@ -207,8 +211,12 @@ namespace internal
                               new_size-manifold_id.size(),
                               numbers::flat_manifold_id);
 
-          user_data.reserve (new_size);
-          user_data.resize (new_size);
+          // the user data is only allocated once it is used
+          if (user_data.size() > 0)
+            {
+              user_data.reserve (new_size);
+              user_data.resize (new_size);
+            }
 
           face_orientations.reserve (new_size * GeometryInfo<3>::faces_per_cell);
           face_orientations.insert (face_orientations.end(),
@@ -321,7 +329,7 @@ namespace internal
               ExcMemoryInexact (cells.size(), boundary_or_material_id.size()));
       Assert (cells.size() == manifold_id.size(),
               ExcMemoryInexact (cells.size(), manifold_id.size()));
-      Assert (cells.size() == user_data.size(),
+      Assert (user_data.size() == 0 || cells.size() == user_data.size(),
               ExcMemoryInexact (cells.size(), user_data.size()));
     }
 
@@ -342,7 +350,7 @@ namespace internal
               ExcMemoryInexact (cells.size(), boundary_or_material_id.size()));
       Assert (cells.size() == manifold_id.size(),
               ExcMemoryInexact (cells.size(), manifold_id.size()));
-      Assert (cells.size() == user_data.size(),
+      Assert (user_data.size() == 0 || cells.size() == user_data.size(),
               ExcMemoryInexact (cells.size(), user_data.size()));
     }
 
@@ -360,7 +368,7 @@ namespace internal
               ExcMemoryInexact (cells.size(), boundary_or_material_id.size()));
       Assert (cells.size() == manifold_id.size(),
               ExcMemoryInexact (cells.size(), manifold_id.size()));
-      Assert (cells.size() == user_data.size(),
+      Assert (user_data.size() == 0 || cells.size() == user_data.size(),
               ExcMemoryInexact (cells.size(), user_data.size()));
       Assert (cells.size() * GeometryInfo<3>::faces_per_cell
               == face_orientations.size(),
@@ -15,6 +15,9 @@
 
 #include <deal.II/hp/fe_values.h>
 #include <deal.II/fe/mapping_q1.h>
+#include <deal.II/base/thread_management.h>
+
+#include <algorithm>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -23,6 +26,24 @@ namespace internal
 
   namespace hp
   {
+    namespace
+    {
+      /**
+       * Create a new FE*Values object. This function exists so that we can
+       * create several of these objects concurrently as tasks.
+       */
+      template <class FEValuesType, int dim, int q_dim>
+      FEValuesType *
+      create_fe_values (const dealii::Mapping<dim,FEValuesType::space_dimension>       &mapping,
+                        const dealii::FiniteElement<dim,FEValuesType::space_dimension> &fe,
+                        const dealii::Quadrature<q_dim>                                &quadrature,
+                        const UpdateFlags                                               update_flags)
+      {
+        return new FEValuesType (mapping, fe, quadrature, update_flags);
+      }
+    }
+
+
 // -------------------------- FEValuesBase -------------------------
 
     template <int dim, int q_dim, class FEValuesType>
@@ -103,6 +124,73 @@ namespace internal
       // now there definitely is one!
       return *fe_values_table(present_fe_values_index);
     }
+
+
+
+    template <int dim, int q_dim, class FEValuesType>
+    void
+    FEValuesBase<dim,q_dim,FEValuesType>::precalculate_fe_values
+    (const std::vector<unsigned int> &fe_indices,
+     const std::vector<unsigned int> &mapping_indices,
+     const std::vector<unsigned int> &q_indices)
+    {
+      AssertDimension (fe_indices.size(), mapping_indices.size());
+      AssertDimension (fe_indices.size(), q_indices.size());
+
+      // start a task for each object that does not exist yet. the same
+      // combination of indices may appear more than once in the input
+      // arrays, so mark the entries we already take care of
+      std::vector<TableIndices<3> > indices;
+      std::vector<Threads::Task<FEValuesType *> > tasks;
+      for (unsigned int i=0; i<fe_indices.size(); ++i)
+        {
+          Assert (fe_indices[i] < fe_collection->size(),
+                  ExcIndexRange (fe_indices[i], 0, fe_collection->size()));
+          Assert (mapping_indices[i] < mapping_collection->size(),
+                  ExcIndexRange (mapping_indices[i], 0, mapping_collection->size()));
+          Assert (q_indices[i] < q_collection.size(),
+                  ExcIndexRange (q_indices[i], 0, q_collection.size()));
+
+          const TableIndices<3> index (fe_indices[i],
+                                       mapping_indices[i],
+                                       q_indices[i]);
+          if (fe_values_table(index).get() != 0 ||
+              std::find (indices.begin(), indices.end(), index) != indices.end())
+            continue;
+
+          indices.push_back (index);
+          tasks.push_back (Threads::new_task (&create_fe_values<FEValuesType,dim,q_dim>,
+                                              (*mapping_collection)[mapping_indices[i]],
+                                              (*fe_collection)[fe_indices[i]],
+                                              q_collection[q_indices[i]],
+                                              update_flags));
+        }
+
+      // then collect the results
+      for (unsigned int i=0; i<tasks.size(); ++i)
+        fe_values_table(indices[i])
+          = std_cxx11::shared_ptr<FEValuesType> (tasks[i].return_value());
+    }
+
+
+
+    template <int dim, int q_dim, class FEValuesType>
+    void
+    FEValuesBase<dim,q_dim,FEValuesType>::precalculate_fe_values ()
+    {
+      const unsigned int n_fes = fe_collection->size();
+
+      std::vector<unsigned int> fe_indices (n_fes), mapping_indices (n_fes),
+          q_indices (n_fes);
+      for (unsigned int i=0; i<n_fes; ++i)
+        {
+          fe_indices[i]      = i;
+          mapping_indices[i] = (mapping_collection->size() > 1 ? i : 0);
+          q_indices[i]       = (q_collection.size() > 1 ? i : 0);
+        }
+
+      precalculate_fe_values (fe_indices, mapping_indices, q_indices);
+    }
   }
 }
 
@@ -14,6 +14,9 @@
 // ---------------------------------------------------------------------
 
 #include <deal.II/base/work_stream.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/quadrature_lib.h>
 #include <deal.II/numerics/data_out.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/dofs/dof_handler.h>
@@ -26,6 +29,7 @@
 #include <deal.II/hp/fe_values.h>
 #include <deal.II/fe/mapping_q1.h>
 
+#include <limits>
 #include <sstream>
 
 DEAL_II_NAMESPACE_OPEN
@@ -59,6 +63,153 @@ namespace internal
 
 
 
+namespace
+{
+  /**
+   * Get the values of the given data vector at the degrees of freedom of the
+   * given element on a cell. On cells that are not active, the values are
+   * interpolated from the children the same way as
+   * DoFCellAccessor::get_interpolated_dof_values() does it.
+   */
+  template <typename DoFHandlerType>
+  void
+  get_interpolated_dof_values (const internal::DataOut::DataEntryBase<DoFHandlerType>                             &data,
+                               const typename DoFHandlerType::cell_iterator                                         &cell,
+                               const FiniteElement<DoFHandlerType::dimension,DoFHandlerType::space_dimension>       &fe,
+                               std::vector<types::global_dof_index>                                                 &dof_indices,
+                               Vector<double>                                                                       &values)
+  {
+    values.reinit (fe.dofs_per_cell);
+
+    if (cell->has_children() == false)
+      {
+        Assert (&cell->get_fe() == &fe, ExcNotImplemented());
+        dof_indices.resize (fe.dofs_per_cell);
+        cell->get_dof_indices (dof_indices);
+        data.get_dof_values (dof_indices, values);
+        return;
+      }
+
+    Vector<double> child_values;
+    Vector<double> restricted_values (fe.dofs_per_cell);
+    for (unsigned int child=0; child<cell->n_children(); ++child)
+      {
+        get_interpolated_dof_values (data, cell->child(child), fe, dof_indices,
+                                     child_values);
+        fe.get_restriction_matrix (child, cell->refinement_case())
+        .vmult (restricted_values, child_values);
+
+        for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+          if (fe.restriction_is_additive(i))
+            values(i) += restricted_values(i);
+          else if (restricted_values(i) != 0)
+            values(i) = restricted_values(i);
+      }
+  }
+
+
+
+  /**
+   * Return the active index and the measure of all active cells below the
+   * given cell.
+   */
+  template <typename CellIterator>
+  void
+  get_active_descendants (const CellIterator                               &cell,
+                          std::vector<std::pair<unsigned int, double> >    &descendants)
+  {
+    if (cell->has_children() == false)
+      descendants.push_back (std::make_pair (cell->active_cell_index(),
+                                             cell->measure()));
+    else
+      for (unsigned int child=0; child<cell->n_children(); ++child)
+        get_active_descendants (cell->child(child), descendants);
+  }
+
+
+
+  /**
+   * How many of the active cells below a given cell are locally owned.
+   */
+  enum Ownership
+  {
+    owns_none,
+    owns_some,
+    owns_all
+  };
+
+
+
+  /**
+   * Select the cells below the given one that should be turned into patches
+   * by DataOut::build_coarsened_patches(), i.e., the coarsest cells of which
+   * the current processor owns all active descendants. If this is the case
+   * for the given cell itself, it is not added to @p selected_cells but the
+   * function returns owns_all and it is up to the caller to add the cell.
+   */
+  template <typename CellIterator>
+  Ownership
+  select_coarsened_cells (const CellIterator          &cell,
+                          std::vector<CellIterator>   &selected_cells)
+  {
+    if (cell->has_children() == false)
+      return (cell->is_locally_owned() ? owns_all : owns_none);
+
+    std::vector<Ownership> child_ownership (cell->n_children());
+    bool owns_all_children  = true;
+    bool owns_some_children = false;
+    for (unsigned int child=0; child<cell->n_children(); ++child)
+      {
+        child_ownership[child] = select_coarsened_cells (cell->child(child),
+                                                         selected_cells);
+        if (child_ownership[child] != owns_all)
+          owns_all_children = false;
+        if (child_ownership[child] != owns_none)
+          owns_some_children = true;
+      }
+
+    if (owns_all_children)
+      return owns_all;
+
+    // the children of which we own everything will not be represented by
+    // this cell, so add them here
+    for (unsigned int child=0; child<cell->n_children(); ++child)
+      if (child_ownership[child] == owns_all)
+        selected_cells.push_back (cell->child(child));
+
+    return (owns_some_children ? owns_some : owns_none);
+  }
+
+
+
+  /**
+   * Return whether the bounding box of the vertices of a cell intersects the
+   * box with the given corners.
+   */
+  template <typename CellIterator, int spacedim>
+  bool
+  cell_intersects_box (const CellIterator     &cell,
+                       const Point<spacedim>  &lower_corner,
+                       const Point<spacedim>  &upper_corner)
+  {
+    for (unsigned int d=0; d<spacedim; ++d)
+      {
+        double min_coordinate = cell->vertex(0)[d];
+        double max_coordinate = cell->vertex(0)[d];
+        for (unsigned int v=1; v<GeometryInfo<CellIterator::AccessorType::dimension>::vertices_per_cell; ++v)
+          {
+            min_coordinate = std::min (min_coordinate, cell->vertex(v)[d]);
+            max_coordinate = std::max (max_coordinate, cell->vertex(v)[d]);
+          }
+        if ((max_coordinate < lower_corner[d]) || (min_coordinate > upper_corner[d]))
+          return false;
+      }
+    return true;
+  }
+}
+
+
+
 template <int dim, typename DoFHandlerType>
 void
 DataOut<dim,DoFHandlerType>::
@@ -471,6 +622,274 @@ void DataOut<dim,DoFHandlerType>::build_patches
                      // @ref workstream_paper, on 32 cores) and if
                      8*MultithreadInfo::n_threads(),
                      64);
+
+  // keep the list of cells around for later calls to update_patch_data().
+  // the interpolation matrices are computed once they are needed
+  patch_cells.swap (all_cells);
+  interpolation_matrices.clear ();
+}
+
+
+
+template <int dim, typename DoFHandlerType>
+void DataOut<dim,DoFHandlerType>::update_patch_data ()
+{
+  Assert (this->triangulation != 0,
+          Exceptions::DataOut::ExcNoTriangulationSelected());
+  Assert (this->patches.size() == patch_cells.size(),
+          ExcMessage ("The patches need to be built by build_patches() "
+                      "before they can be updated."));
+  for (unsigned int dataset=0; dataset<this->dof_data.size(); ++dataset)
+    Assert (this->dof_data[dataset]->postprocessor == 0,
+            ExcMessage ("The data of patches can not be updated for data "
+                        "vectors with a DataPostprocessor attached."));
+
+  if (patch_cells.size() == 0)
+    return;
+
+  // the evaluation points are the same on all patches, so we need to
+  // compute the values of the shape functions at these points only once
+  // for each finite element
+  if (interpolation_matrices.size() != this->dof_data.size())
+    {
+      const QIterated<DoFHandlerType::dimension> quadrature (QTrapez<1>(),
+                                                             this->patches[0].n_subdivisions);
+      const std::vector<std_cxx11::shared_ptr<dealii::hp::FECollection<DoFHandlerType::dimension,DoFHandlerType::space_dimension> > >
+      finite_elements = this->get_finite_elements();
+
+      interpolation_matrices.resize (this->dof_data.size());
+      for (unsigned int dataset=0; dataset<this->dof_data.size(); ++dataset)
+        {
+          interpolation_matrices[dataset].resize (finite_elements[dataset]->size());
+          for (unsigned int f=0; f<finite_elements[dataset]->size(); ++f)
+            {
+              const FiniteElement<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &fe
+                = (*finite_elements[dataset])[f];
+              Assert (fe.is_primitive(),
+                      ExcMessage ("The data of patches can only be updated for "
+                                  "primitive finite elements, whose shape "
+                                  "functions do not depend on the mapping."));
+
+              FullMatrix<double> &matrix = interpolation_matrices[dataset][f];
+              matrix.reinit (fe.n_components()*quadrature.size(), fe.dofs_per_cell);
+              for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+                for (unsigned int q=0; q<quadrature.size(); ++q)
+                  matrix(fe.system_to_component_index(i).first*quadrature.size()+q, i)
+                    = fe.shape_value (i, quadrature.point(q));
+            }
+        }
+    }
+
+  parallel::apply_to_subranges (0U, static_cast<unsigned int>(patch_cells.size()),
+                                std_cxx11::bind (&DataOut<dim,DoFHandlerType>::update_patch_data_on_range,
+                                                 this,
+                                                 std_cxx11::_1,
+                                                 std_cxx11::_2),
+                                64);
+}
+
+
+
+template <int dim, typename DoFHandlerType>
+void
+DataOut<dim,DoFHandlerType>::
+update_patch_data_on_range (const unsigned int begin,
+                            const unsigned int end)
+{
+  std::vector<types::global_dof_index>          dof_indices;
+  Vector<double>                                dof_values;
+  Vector<double>                                point_values;
+  std::vector<std::pair<unsigned int, double> > descendants;
+
+  for (unsigned int patch_index=begin; patch_index<end; ++patch_index)
+    {
+      DataOutBase::Patch<DoFHandlerType::dimension, DoFHandlerType::space_dimension> &patch
+        = this->patches[patch_index];
+      const cell_iterator &cell = patch_cells[patch_index].first;
+      const unsigned int n_points = patch.data.n_cols();
+
+      Assert (patch.points_are_available == false,
+              ExcMessage ("The data of patches can not be updated if the "
+                          "patches were built with curved cells."));
+
+      unsigned int offset = 0;
+      for (unsigned int dataset=0; dataset<this->dof_data.size(); ++dataset)
+        {
+          // cells that are not active have no finite element of their own,
+          // so the data is interpolated into the first element of the
+          // collection there
+          const typename DoFHandlerType::cell_iterator
+          dh_cell (&cell->get_triangulation(),
+                   cell->level(),
+                   cell->index(),
+                   this->dof_data[dataset]->dof_handler);
+          const unsigned int fe_index = (dh_cell->has_children()
+                                         ?
+                                         0
+                                         :
+                                         dh_cell->active_fe_index());
+          const FiniteElement<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &fe
+            = this->dof_data[dataset]->dof_handler->get_fe()[fe_index];
+          const FullMatrix<double> &matrix
+            = interpolation_matrices[dataset][fe_index];
+          const unsigned int n_components = fe.n_components();
+          Assert (matrix.m() == n_components*n_points, ExcInternalError());
+          Assert (n_components == this->dof_data[dataset]->n_output_variables,
+                  ExcInternalError());
+
+          get_interpolated_dof_values (*this->dof_data[dataset], dh_cell, fe,
+                                       dof_indices, dof_values);
+
+          point_values.reinit (matrix.m());
+          if (dof_values.size() > 0)
+            matrix.vmult (point_values, dof_values);
+
+          for (unsigned int component=0; component<n_components; ++component)
+            for (unsigned int q=0; q<n_points; ++q)
+              patch.data(offset+component,q) = point_values(component*n_points+q);
+
+          offset += this->dof_data[dataset]->n_output_variables;
+        }
+
+      // on cells that are not active, average the cell data over the active
+      // descendants
+      descendants.clear ();
+      if (this->cell_data.size() > 0)
+        {
+          if (cell->has_children() == false)
+            descendants.push_back (std::make_pair (patch_cells[patch_index].second,
+                                                   1.));
+          else
+            get_active_descendants (cell, descendants);
+        }
+
+      for (unsigned int dataset=0; dataset<this->cell_data.size(); ++dataset)
+        {
+          double value = 0, measure = 0;
+          for (unsigned int i=0; i<descendants.size(); ++i)
+            {
+              value += descendants[i].second *
+                       this->cell_data[dataset]->get_cell_data_value (descendants[i].first);
+              measure += descendants[i].second;
+            }
+          value /= measure;
+
+          for (unsigned int q=0; q<n_points; ++q)
+            patch.data(offset+dataset,q) = value;
+        }
+      Assert (offset+this->cell_data.size() == patch.data.n_rows(),
+              ExcInternalError());
+    }
+}
+
+
+
+template <int dim, typename DoFHandlerType>
+void
+DataOut<dim,DoFHandlerType>::build_coarsened_patches (const unsigned int level,
+                                                      const unsigned int n_subdivisions)
+{
+  Point<DoFHandlerType::space_dimension> lower_corner, upper_corner;
+  for (unsigned int d=0; d<DoFHandlerType::space_dimension; ++d)
+    {
+      lower_corner[d] = -std::numeric_limits<double>::max();
+      upper_corner[d] = std::numeric_limits<double>::max();
+    }
+
+  build_coarsened_patches (level, lower_corner, upper_corner, n_subdivisions);
+}
+
+
+
+template <int dim, typename DoFHandlerType>
+void
+DataOut<dim,DoFHandlerType>::
+build_coarsened_patches (const unsigned int                            level,
+                         const Point<DoFHandlerType::space_dimension> &lower_corner,
+                         const Point<DoFHandlerType::space_dimension> &upper_corner,
+                         const unsigned int                            n_subdivisions_)
+{
+  Assert (dim==DoFHandlerType::dimension, ExcDimensionMismatch(dim, DoFHandlerType::dimension));
+  Assert (this->triangulation != 0,
+          Exceptions::DataOut::ExcNoTriangulationSelected());
+  for (unsigned int d=0; d<DoFHandlerType::space_dimension; ++d)
+    Assert (lower_corner[d] <= upper_corner[d],
+            ExcMessage ("The lower corner of the box needs to be below and "
+                        "to the left of its upper corner."));
+
+  const unsigned int n_subdivisions = (n_subdivisions_ != 0)
+                                      ? n_subdivisions_
+                                      : this->default_subdivisions;
+  Assert (n_subdivisions >= 1,
+          Exceptions::DataOut::ExcInvalidNumberOfSubdivisions(n_subdivisions));
+
+  // select the active cells coarser than the given level and the cells on
+  // this level, or the coarsest cells below them that are entirely owned by
+  // the current processor
+  std::vector<cell_iterator> selected_cells;
+  const unsigned int n_levels = std::min (level+1, this->triangulation->n_levels());
+  for (unsigned int l=0; l<n_levels; ++l)
+    for (cell_iterator cell = this->triangulation->begin(l);
+         cell != this->triangulation->end(l); ++cell)
+      if ((l == level) || (cell->has_children() == false))
+        if (select_coarsened_cells (cell, selected_cells) == owns_all)
+          selected_cells.push_back (cell);
+
+  std::vector<std::pair<cell_iterator, unsigned int> > all_cells;
+  all_cells.reserve (selected_cells.size());
+  for (unsigned int i=0; i<selected_cells.size(); ++i)
+    if (cell_intersects_box (selected_cells[i], lower_corner, upper_corner))
+      all_cells.push_back (std::make_pair (selected_cells[i],
+                                           (selected_cells[i]->has_children()
+                                            ?
+                                            numbers::invalid_unsigned_int
+                                            :
+                                            selected_cells[i]->active_cell_index())));
+
+  // create the geometry and connectivity of the patches. as in
+  // build_patches(), neighbors are only recorded if they are on the same
+  // level and have a patch of their own
+  std::vector<std::vector<unsigned int> > cell_to_patch_index_map (this->triangulation->n_levels());
+  for (unsigned int l=0; l<this->triangulation->n_levels(); ++l)
+    cell_to_patch_index_map[l].resize (this->triangulation->n_raw_cells(l),
+                                       DataOutBase::Patch<DoFHandlerType::dimension,
+                                       DoFHandlerType::space_dimension>::no_neighbor);
+  for (unsigned int i=0; i<all_cells.size(); ++i)
+    cell_to_patch_index_map[all_cells[i].first->level()][all_cells[i].first->index()] = i;
+
+  unsigned int n_datasets = this->cell_data.size();
+  for (unsigned int i=0; i<this->dof_data.size(); ++i)
+    n_datasets += this->dof_data[i]->n_output_variables;
+
+  this->patches.clear ();
+  this->patches.resize (all_cells.size());
+  for (unsigned int i=0; i<all_cells.size(); ++i)
+    {
+      DataOutBase::Patch<DoFHandlerType::dimension, DoFHandlerType::space_dimension> &patch
+        = this->patches[i];
+      const cell_iterator &cell = all_cells[i].first;
+
+      patch.n_subdivisions = n_subdivisions;
+      patch.patch_index = i;
+      for (unsigned int v=0; v<GeometryInfo<DoFHandlerType::dimension>::vertices_per_cell; ++v)
+        patch.vertices[v] = cell->vertex(v);
+
+      for (unsigned int f=0; f<GeometryInfo<DoFHandlerType::dimension>::faces_per_cell; ++f)
+        if (!cell->at_boundary(f)
+            &&
+            (cell->neighbor(f)->level() == cell->level()))
+          patch.neighbors[f]
+            = cell_to_patch_index_map[cell->level()][cell->neighbor(f)->index()];
+
+      patch.data.reinit (n_datasets,
+                         Utilities::fixed_power<DoFHandlerType::dimension> (n_subdivisions+1));
+    }
+
+  // then evaluate the data on the patches in parallel, in the same way as
+  // update_patch_data() does for patches that have been created before
+  patch_cells.swap (all_cells);
+  interpolation_matrices.clear ();
+  update_patch_data ();
 }
 
 
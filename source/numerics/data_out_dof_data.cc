@@ -409,6 +409,15 @@ namespace internal
       double
       get_cell_data_value (const unsigned int cell_number) const;
 
+      /**
+       * Assuming that the stored vector is a vector of nodal values, extract
+       * the elements with the given global indices.
+       */
+      virtual
+      void
+      get_dof_values (const std::vector<types::global_dof_index> &dof_indices,
+                      dealii::Vector<double>                     &dof_values) const;
+
       /**
        * Given a FEValuesBase object, extract the values on the present cell
        * from the vector we actually store.
@@ -521,16 +530,16 @@ namespace internal
     {
       template <typename VectorType>
       double
-      get_vector_element (const VectorType   &vector,
-                          const unsigned int  cell_number)
+      get_vector_element (const VectorType                &vector,
+                          const types::global_dof_index  cell_number)
       {
         return vector[cell_number];
       }
 
 
       double
-      get_vector_element (const IndexSet &is,
-                          const unsigned int cell_number)
+      get_vector_element (const IndexSet                &is,
+                          const types::global_dof_index  cell_number)
       {
         return (is.is_element(cell_number) ? 1 : 0);
       }
@@ -548,6 +557,20 @@ namespace internal
 
 
 
+    template <typename DoFHandlerType, typename VectorType>
+    void
+    DataEntry<DoFHandlerType,VectorType>::
+    get_dof_values (const std::vector<types::global_dof_index> &dof_indices,
+                    dealii::Vector<double>                     &dof_values) const
+    {
+      Assert (dof_values.size() == dof_indices.size(),
+              ExcDimensionMismatch (dof_values.size(), dof_indices.size()));
+      for (unsigned int i=0; i<dof_indices.size(); ++i)
+        dof_values(i) = get_vector_element(*vector, dof_indices[i]);
+    }
+
+
+
     template <typename DoFHandlerType, typename VectorType>
     void
     DataEntry<DoFHandlerType,VectorType>::get_function_values
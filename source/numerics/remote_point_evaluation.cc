@@ -0,0 +1,563 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/std_cxx11/array.h>
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/numerics/remote_point_evaluation.h>
+
+#include <algorithm>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  /**
+   * The tags of the messages sent by RemotePointEvaluation.
+   */
+  const int mpi_tag_points  = 4201;
+  const int mpi_tag_replies = 4202;
+  const int mpi_tag_results = 4203;
+
+
+  /**
+   * Return the communicator of the given triangulation if it is a parallel
+   * one, and MPI_COMM_SELF otherwise.
+   */
+  template <int dim, int spacedim>
+  MPI_Comm
+  get_mpi_communicator (const Triangulation<dim,spacedim> &triangulation)
+  {
+    if (const parallel::Triangulation<dim,spacedim> *parallel_triangulation
+        = dynamic_cast<const parallel::Triangulation<dim,spacedim> *>(&triangulation))
+      return parallel_triangulation->get_communicator();
+    else
+      return MPI_COMM_SELF;
+  }
+
+
+  /**
+   * Return whether the point @p p lies in the box with the lower corner
+   * given by the first @p spacedim entries of @p box and the upper corner
+   * given by the next @p spacedim entries.
+   */
+  template <int spacedim>
+  inline
+  bool
+  box_contains (const double          *box,
+                const Point<spacedim> &p)
+  {
+    for (unsigned int d=0; d<spacedim; ++d)
+      if ((p[d] < box[d]) || (p[d] > box[spacedim+d]))
+        return false;
+    return true;
+  }
+
+
+  /**
+   * An entry of the list of points evaluated on this process: the cell
+   * around the point given by its level and index, the reference
+   * coordinates of the point, and its position in the buffer of results.
+   */
+  template <int dim>
+  struct OwnedPoint
+  {
+    std::pair<int,int> cell;
+    Point<dim>         reference_point;
+    unsigned int       position;
+
+    bool operator < (const OwnedPoint<dim> &other) const
+    {
+      return ((cell < other.cell)
+              ||
+              ((cell == other.cell) && (position < other.position)));
+    }
+  };
+}
+
+
+
+template <int dim, int spacedim>
+RemotePointEvaluation<dim,spacedim>::
+RemotePointEvaluation (const Triangulation<dim,spacedim> &triangulation,
+                       const Mapping<dim,spacedim>       &mapping,
+                       const double                       relative_tolerance)
+  :
+  triangulation (&triangulation, typeid(*this).name()),
+  mapping (&mapping, typeid(*this).name()),
+  relative_tolerance (relative_tolerance),
+  mpi_communicator (get_mpi_communicator (triangulation)),
+  cell_locator (triangulation, mapping, relative_tolerance),
+  is_valid (false)
+{
+  tria_listener = triangulation.signals.any_change.connect
+                  (std_cxx11::bind (&RemotePointEvaluation<dim,spacedim>::invalidate,
+                                    std_cxx11::ref(*this)));
+}
+
+
+
+template <int dim, int spacedim>
+RemotePointEvaluation<dim,spacedim>::~RemotePointEvaluation ()
+{
+  tria_listener.disconnect ();
+}
+
+
+
+template <int dim, int spacedim>
+void
+RemotePointEvaluation<dim,spacedim>::invalidate ()
+{
+  is_valid = false;
+}
+
+
+
+template <int dim, int spacedim>
+void
+RemotePointEvaluation<dim,spacedim>::reinit (const std::vector<Point<spacedim> > &points)
+{
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process (mpi_communicator);
+  const unsigned int n_ranks = Utilities::MPI::n_mpi_processes (mpi_communicator);
+
+  // compute the bounding boxes of the locally owned cells within each
+  // coarse cell, enlarged in the same way as the ones of the cell locator.
+  // the boxes are stored as 2*spacedim numbers, the lower corner followed
+  // by the upper corner
+  std::vector<double> my_boxes;
+  {
+    std::vector<bool> coarse_cell_has_box (triangulation->n_cells(0), false);
+    std::vector<double> coarse_cell_boxes (triangulation->n_cells(0) * 2 * spacedim);
+    for (typename Triangulation<dim,spacedim>::active_cell_iterator
+         cell = triangulation->begin_active(); cell != triangulation->end(); ++cell)
+      if (cell->is_locally_owned())
+        {
+          typename Triangulation<dim,spacedim>::cell_iterator coarse_cell = cell;
+          while (coarse_cell->level() > 0)
+            coarse_cell = coarse_cell->parent();
+          double *box = &coarse_cell_boxes[coarse_cell->index() * 2 * spacedim];
+
+          const std_cxx11::array<Point<spacedim>, GeometryInfo<dim>::vertices_per_cell>
+          vertices = mapping->get_vertices (cell);
+          Point<spacedim> lower_corner = vertices[0], upper_corner = vertices[0];
+          for (unsigned int v=1; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+            for (unsigned int d=0; d<spacedim; ++d)
+              {
+                lower_corner[d] = std::min (lower_corner[d], vertices[v][d]);
+                upper_corner[d] = std::max (upper_corner[d], vertices[v][d]);
+              }
+          double extent = 0;
+          for (unsigned int d=0; d<spacedim; ++d)
+            extent = std::max (extent, upper_corner[d] - lower_corner[d]);
+          for (unsigned int d=0; d<spacedim; ++d)
+            {
+              lower_corner[d] -= relative_tolerance * extent;
+              upper_corner[d] += relative_tolerance * extent;
+            }
+
+          for (unsigned int d=0; d<spacedim; ++d)
+            if (coarse_cell_has_box[coarse_cell->index()] == false)
+              {
+                box[d]          = lower_corner[d];
+                box[spacedim+d] = upper_corner[d];
+              }
+            else
+              {
+                box[d]          = std::min (box[d], lower_corner[d]);
+                box[spacedim+d] = std::max (box[spacedim+d], upper_corner[d]);
+              }
+          coarse_cell_has_box[coarse_cell->index()] = true;
+        }
+
+    for (unsigned int c=0; c<coarse_cell_has_box.size(); ++c)
+      if (coarse_cell_has_box[c])
+        my_boxes.insert (my_boxes.end(),
+                         coarse_cell_boxes.begin() + c * 2 * spacedim,
+                         coarse_cell_boxes.begin() + (c+1) * 2 * spacedim);
+  }
+
+  // exchange the boxes between all processes
+  std::vector<double> all_boxes;
+  std::vector<int>    box_offsets (n_ranks+1, 0);
+#ifdef DEAL_II_WITH_MPI
+  if (n_ranks > 1)
+    {
+      int my_size = my_boxes.size();
+      std::vector<int> sizes (n_ranks);
+      MPI_Allgather (&my_size, 1, MPI_INT, &sizes[0], 1, MPI_INT,
+                     mpi_communicator);
+      for (unsigned int r=0; r<n_ranks; ++r)
+        box_offsets[r+1] = box_offsets[r] + sizes[r];
+      all_boxes.resize (box_offsets[n_ranks]);
+      MPI_Allgatherv (my_boxes.size() > 0 ? &my_boxes[0] : NULL, my_size, MPI_DOUBLE,
+                      all_boxes.size() > 0 ? &all_boxes[0] : NULL, &sizes[0],
+                      &box_offsets[0], MPI_DOUBLE, mpi_communicator);
+    }
+  else
+#endif
+    {
+      all_boxes = my_boxes;
+      box_offsets[n_ranks] = my_boxes.size();
+    }
+
+  // send each point to the processes whose boxes contain it
+  std::vector<std::vector<unsigned int> > requested_points (n_ranks);
+  for (unsigned int i=0; i<points.size(); ++i)
+    for (unsigned int r=0; r<n_ranks; ++r)
+      for (int b=box_offsets[r]; b<box_offsets[r+1]; b+=2*spacedim)
+        if (box_contains (&all_boxes[b], points[i]))
+          {
+            requested_points[r].push_back (i);
+            break;
+          }
+
+  std::vector<unsigned int> destinations;
+  for (unsigned int r=0; r<n_ranks; ++r)
+    if ((r != my_rank) && (requested_points[r].size() > 0))
+      destinations.push_back (r);
+
+  // the points to be located on this process, for each of the processes
+  // that asked for points
+  std::vector<unsigned int> source_ranks;
+  std::vector<std::vector<Point<spacedim> > > received_points;
+
+  if (requested_points[my_rank].size() > 0)
+    {
+      source_ranks.push_back (my_rank);
+      received_points.push_back (std::vector<Point<spacedim> >());
+      for (unsigned int i=0; i<requested_points[my_rank].size(); ++i)
+        received_points.back().push_back (points[requested_points[my_rank][i]]);
+    }
+
+#ifdef DEAL_II_WITH_MPI
+  std::vector<std::vector<double> > point_send_buffers (destinations.size());
+  std::vector<MPI_Request> point_requests (destinations.size());
+  if (n_ranks > 1)
+    {
+      const std::vector<unsigned int> sources
+        = Utilities::MPI::compute_point_to_point_communication_pattern (mpi_communicator,
+            destinations);
+
+      for (unsigned int k=0; k<destinations.size(); ++k)
+        {
+          const std::vector<unsigned int> &indices = requested_points[destinations[k]];
+          for (unsigned int i=0; i<indices.size(); ++i)
+            for (unsigned int d=0; d<spacedim; ++d)
+              point_send_buffers[k].push_back (points[indices[i]][d]);
+          MPI_Isend (&point_send_buffers[k][0], point_send_buffers[k].size(),
+                     MPI_DOUBLE, destinations[k], mpi_tag_points,
+                     mpi_communicator, &point_requests[k]);
+        }
+
+      for (unsigned int k=0; k<sources.size(); ++k)
+        {
+          MPI_Status status;
+          int len;
+          MPI_Probe (MPI_ANY_SOURCE, mpi_tag_points, mpi_communicator, &status);
+          MPI_Get_count (&status, MPI_DOUBLE, &len);
+          std::vector<double> buffer (len);
+          MPI_Recv (&buffer[0], len, MPI_DOUBLE, status.MPI_SOURCE,
+                    mpi_tag_points, mpi_communicator, &status);
+
+          source_ranks.push_back (status.MPI_SOURCE);
+          received_points.push_back (std::vector<Point<spacedim> > (len / spacedim));
+          for (int i=0; i<len/static_cast<int>(spacedim); ++i)
+            for (unsigned int d=0; d<spacedim; ++d)
+              received_points.back()[i][d] = buffer[i*spacedim+d];
+        }
+    }
+#endif
+
+  // locate the received points. a point is evaluated by this process if
+  // it lies in a locally owned cell and not in a cell owned by a process
+  // with a lower rank. the processes are treated in increasing order of
+  // their ranks, which is the order in which the results are sent
+  std::vector<std::pair<unsigned int, unsigned int> > order (source_ranks.size());
+  for (unsigned int k=0; k<order.size(); ++k)
+    order[k] = std::make_pair (source_ranks[k], k);
+  std::sort (order.begin(), order.end());
+
+  std::vector<std::vector<unsigned int> > keep (source_ranks.size());
+  std::vector<OwnedPoint<dim> > owned_points;
+  std::vector<std::pair<typename Triangulation<dim,spacedim>::active_cell_iterator, Point<dim> > >
+  cells_and_reference_points;
+
+  send_ranks.clear ();
+  send_offsets.assign (1, 0);
+  for (unsigned int o=0; o<order.size(); ++o)
+    {
+      const unsigned int k = order[o].second;
+      keep[k].resize (received_points[k].size(), 0);
+      for (unsigned int i=0; i<received_points[k].size(); ++i)
+        {
+          cell_locator.find_all_active_cells_around_point (received_points[k][i],
+                                                           cells_and_reference_points);
+
+          // among the cells around the point, select a locally owned one
+          // if no cell of a process with lower rank contains the point. if
+          // there are several, prefer the one in which the point is furthest
+          // inside and then the more refined one, as
+          // GridTools::find_active_cell_around_point does
+          int    best = -1;
+          double best_distance = 0;
+          bool   owned_elsewhere = false;
+          for (unsigned int c=0; c<cells_and_reference_points.size(); ++c)
+            {
+              const typename Triangulation<dim,spacedim>::active_cell_iterator
+              &cell = cells_and_reference_points[c].first;
+              if (cell->is_locally_owned())
+                {
+                  const double distance
+                    = GeometryInfo<dim>::distance_to_unit_cell (cells_and_reference_points[c].second);
+                  if ((best == -1)
+                      ||
+                      (distance < best_distance)
+                      ||
+                      ((distance == best_distance) &&
+                       (cell->level() > cells_and_reference_points[best].first->level())))
+                    {
+                      best = c;
+                      best_distance = distance;
+                    }
+                }
+              else if ((n_ranks > 1) && (cell->is_artificial() == false)
+                       && (cell->subdomain_id() < my_rank))
+                owned_elsewhere = true;
+            }
+
+          if ((best != -1) && (owned_elsewhere == false))
+            {
+              keep[k][i] = 1;
+
+              OwnedPoint<dim> owned_point;
+              owned_point.cell = std::make_pair (cells_and_reference_points[best].first->level(),
+                                                 cells_and_reference_points[best].first->index());
+              owned_point.reference_point = cells_and_reference_points[best].second;
+              owned_point.position = owned_points.size();
+              owned_points.push_back (owned_point);
+            }
+        }
+
+      if (owned_points.size() > send_offsets.back())
+        {
+          send_ranks.push_back (source_ranks[k]);
+          send_offsets.push_back (owned_points.size());
+        }
+    }
+
+  // group the points evaluated here by cells
+  std::sort (owned_points.begin(), owned_points.end());
+  owned_cells.clear ();
+  owned_cell_offsets.clear ();
+  owned_reference_points.resize (owned_points.size());
+  owned_result_positions.resize (owned_points.size());
+  for (unsigned int i=0; i<owned_points.size(); ++i)
+    {
+      if ((i == 0) || (owned_points[i].cell != owned_points[i-1].cell))
+        {
+          owned_cells.push_back (owned_points[i].cell);
+          owned_cell_offsets.push_back (i);
+        }
+      owned_reference_points[i] = owned_points[i].reference_point;
+      owned_result_positions[i] = owned_points[i].position;
+    }
+  owned_cell_offsets.push_back (owned_points.size());
+
+  // tell the processes that sent points which ones are evaluated here, and
+  // receive the same information for the points of this process
+  std::vector<std::vector<unsigned int> > replies (n_ranks);
+  for (unsigned int k=0; k<source_ranks.size(); ++k)
+    if (source_ranks[k] == my_rank)
+      replies[my_rank] = keep[k];
+
+#ifdef DEAL_II_WITH_MPI
+  std::vector<MPI_Request> reply_requests;
+  if (n_ranks > 1)
+    {
+      reply_requests.resize (source_ranks.size());
+      unsigned int n_reply_requests = 0;
+      for (unsigned int k=0; k<source_ranks.size(); ++k)
+        if (source_ranks[k] != my_rank)
+          MPI_Isend (&keep[k][0], keep[k].size(), MPI_UNSIGNED,
+                     source_ranks[k], mpi_tag_replies, mpi_communicator,
+                     &reply_requests[n_reply_requests++]);
+      reply_requests.resize (n_reply_requests);
+
+      for (unsigned int k=0; k<destinations.size(); ++k)
+        {
+          replies[destinations[k]].resize (requested_points[destinations[k]].size());
+          MPI_Recv (&replies[destinations[k]][0], replies[destinations[k]].size(),
+                    MPI_UNSIGNED, destinations[k], mpi_tag_replies,
+                    mpi_communicator, MPI_STATUS_IGNORE);
+        }
+
+      if (point_requests.size() > 0)
+        MPI_Waitall (point_requests.size(), &point_requests[0], MPI_STATUSES_IGNORE);
+      if (reply_requests.size() > 0)
+        MPI_Waitall (reply_requests.size(), &reply_requests[0], MPI_STATUSES_IGNORE);
+    }
+#endif
+
+  // finally set up the information on where the results for the points of
+  // this process come from
+  found.assign (points.size(), false);
+  recv_ranks.clear ();
+  recv_offsets.assign (1, 0);
+  recv_point_indices.clear ();
+  for (unsigned int r=0; r<n_ranks; ++r)
+    {
+      for (unsigned int i=0; i<replies[r].size(); ++i)
+        if (replies[r][i] != 0)
+          {
+            recv_point_indices.push_back (requested_points[r][i]);
+            found[requested_points[r][i]] = true;
+          }
+      if (recv_point_indices.size() > recv_offsets.back())
+        {
+          recv_ranks.push_back (r);
+          recv_offsets.push_back (recv_point_indices.size());
+        }
+    }
+
+  is_valid = true;
+}
+
+
+
+template <int dim, int spacedim>
+unsigned int
+RemotePointEvaluation<dim,spacedim>::n_points () const
+{
+  return found.size();
+}
+
+
+
+template <int dim, int spacedim>
+bool
+RemotePointEvaluation<dim,spacedim>::point_found (const unsigned int i) const
+{
+  AssertIndexRange (i, found.size());
+  return found[i];
+}
+
+
+
+template <int dim, int spacedim>
+bool
+RemotePointEvaluation<dim,spacedim>::all_points_found () const
+{
+  return (std::find (found.begin(), found.end(), false) == found.end());
+}
+
+
+
+template <int dim, int spacedim>
+void
+RemotePointEvaluation<dim,spacedim>::
+communicate_results (const std::vector<double> &owned_results,
+                     const unsigned int         n_values_per_point,
+                     std::vector<double>       &results) const
+{
+  AssertDimension (owned_results.size(),
+                   owned_reference_points.size() * n_values_per_point);
+
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process (mpi_communicator);
+  results.assign (found.size() * n_values_per_point, 0.);
+
+#ifdef DEAL_II_WITH_MPI
+  std::vector<MPI_Request> requests (send_ranks.size());
+  unsigned int n_requests = 0;
+  for (unsigned int k=0; k<send_ranks.size(); ++k)
+    if (send_ranks[k] != my_rank)
+      MPI_Isend (const_cast<double *>(&owned_results[send_offsets[k] * n_values_per_point]),
+                 (send_offsets[k+1] - send_offsets[k]) * n_values_per_point,
+                 MPI_DOUBLE, send_ranks[k], mpi_tag_results, mpi_communicator,
+                 &requests[n_requests++]);
+#endif
+
+  std::vector<double> buffer;
+  for (unsigned int k=0; k<recv_ranks.size(); ++k)
+    {
+      const double *data;
+      if (recv_ranks[k] == my_rank)
+        {
+          // the points of this process evaluated here are the only ones
+          // sent to this process itself, so they take the whole range
+          // reserved for this process in the buffer of results sent
+          const unsigned int s = std::find (send_ranks.begin(), send_ranks.end(),
+                                            my_rank) - send_ranks.begin();
+          Assert (s < send_ranks.size(), ExcInternalError());
+          AssertDimension (send_offsets[s+1] - send_offsets[s],
+                           recv_offsets[k+1] - recv_offsets[k]);
+          data = &owned_results[send_offsets[s] * n_values_per_point];
+        }
+      else
+        {
+#ifdef DEAL_II_WITH_MPI
+          buffer.resize ((recv_offsets[k+1] - recv_offsets[k]) * n_values_per_point);
+          MPI_Recv (&buffer[0], buffer.size(), MPI_DOUBLE, recv_ranks[k],
+                    mpi_tag_results, mpi_communicator, MPI_STATUS_IGNORE);
+          data = &buffer[0];
+#else
+          Assert (false, ExcInternalError());
+          data = 0;
+#endif
+        }
+
+      for (unsigned int i=recv_offsets[k]; i<recv_offsets[k+1]; ++i, data+=n_values_per_point)
+        std::copy (data, data + n_values_per_point,
+                   results.begin() + recv_point_indices[i] * n_values_per_point);
+    }
+
+#ifdef DEAL_II_WITH_MPI
+  if (n_requests > 0)
+    MPI_Waitall (n_requests, &requests[0], MPI_STATUSES_IGNORE);
+#endif
+}
+
+
+
+template <int dim, int spacedim>
+std::size_t
+RemotePointEvaluation<dim,spacedim>::memory_consumption () const
+{
+  return (sizeof(*this) +
+          cell_locator.memory_consumption() +
+          MemoryConsumption::memory_consumption (found) +
+          MemoryConsumption::memory_consumption (recv_ranks) +
+          MemoryConsumption::memory_consumption (recv_offsets) +
+          MemoryConsumption::memory_consumption (recv_point_indices) +
+          MemoryConsumption::memory_consumption (send_ranks) +
+          MemoryConsumption::memory_consumption (send_offsets) +
+          owned_cells.capacity() * sizeof(std::pair<int,int>) +
+          MemoryConsumption::memory_consumption (owned_cell_offsets) +
+          MemoryConsumption::memory_consumption (owned_reference_points) +
+          MemoryConsumption::memory_consumption (owned_result_positions));
+}
+
+
+
+// explicit instantiations
+#include "remote_point_evaluation.inst"
+
+DEAL_II_NAMESPACE_CLOSE
@@ -21,6 +21,8 @@
 #include <deal.II/grid/tria_iterator.h>
 #include <deal.II/fe/fe.h>
 #include <deal.II/lac/vector.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
 #include <deal.II/lac/parallel_vector.h>
 #include <deal.II/lac/petsc_vector.h>
 #include <deal.II/lac/trilinos_vector.h>
@@ -30,6 +32,8 @@
 #include <deal.II/lac/trilinos_block_vector.h>
 #include <deal.II/numerics/solution_transfer.h>
 
+#include <algorithm>
+
 DEAL_II_NAMESPACE_OPEN
 
 
@@ -57,6 +61,7 @@ void SolutionTransfer<dim, VectorType, DoFHandlerType>::clear ()
 {
   indices_on_cell.clear();
   dof_values_on_cell.clear();
+  restriction_matrices_on_cell.clear();
   cell_map.clear();
 
   prepared_for=none;
@@ -70,6 +75,8 @@ void SolutionTransfer<dim, VectorType, DoFHandlerType>::prepare_for_pure_refinem
   Assert(prepared_for!=pure_refinement, ExcAlreadyPrepForRef());
   Assert(prepared_for!=coarsening_and_refinement,
          ExcAlreadyPrepForCoarseAndRef());
+  Assert(prepared_for!=transfer_matrix_preparation,
+         ExcAlreadyPrepForCoarseAndRef());
 
   clear();
 
@@ -223,6 +230,208 @@ namespace internal
           restriction_is_additive[f][i] = fe[f].restriction_is_additive(i);
       }
   }
+
+
+  /**
+   * Return the index of the finite element onto which the values on the
+   * children of @p cell are interpolated if these children are coarsened
+   * away. in the hp context, this is the element of the child with the most
+   * degrees of freedom.
+   */
+  template <typename CellIterator>
+  unsigned int coarsening_target_fe_index (const CellIterator &cell)
+  {
+    bool different_fe_on_children = false;
+    for (unsigned int child=1; child<cell->n_children(); ++child)
+      if (cell->child(child)->active_fe_index()
+          != cell->child(0)->active_fe_index())
+        {
+          different_fe_on_children = true;
+          break;
+        }
+
+    // take FE index from the child with most
+    // degrees of freedom locally
+    unsigned int most_general_child = 0;
+    if (different_fe_on_children == true)
+      for (unsigned int child=1; child<cell->n_children(); ++child)
+        if (cell->child(child)->get_fe().dofs_per_cell >
+            cell->child(most_general_child)->get_fe().dofs_per_cell)
+          most_general_child = child;
+    return cell->child(most_general_child)->active_fe_index();
+  }
+
+
+  /**
+   * Compute the matrix that maps the dof values on all children of @p cell,
+   * taken one child after the other, to the values of the finite element
+   * with index @p fe_index on @p cell, and store the dof indices of the
+   * children in the same order. This is the matrix form of what
+   * DoFCellAccessor::get_interpolated_dof_values() does with vectors: the
+   * contributions of the children are added up for dofs for which the
+   * restriction is additive, and the contribution of the last child that
+   * has one is taken otherwise.
+   */
+  template <typename DoFHandlerType>
+  void
+  get_children_restriction_matrix (const typename DoFHandlerType::cell_iterator &cell,
+                                   const unsigned int                            fe_index,
+                                   std::vector<types::global_dof_index>         &children_indices,
+                                   FullMatrix<double>                           &restriction_matrix)
+  {
+    const FiniteElement<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &fe
+      = cell->get_dof_handler().get_fe()[fe_index];
+    const unsigned int dofs_per_cell = fe.dofs_per_cell;
+
+    unsigned int n_children_dofs = 0;
+    for (unsigned int child=0; child<cell->n_children(); ++child)
+      n_children_dofs += cell->child(child)->get_fe().dofs_per_cell;
+
+    children_indices.resize (n_children_dofs);
+    restriction_matrix.reinit (dofs_per_cell, n_children_dofs);
+
+    std::vector<types::global_dof_index> child_indices;
+    FullMatrix<double> child_matrix, interpolation;
+    unsigned int offset = 0;
+    for (unsigned int child=0; child<cell->n_children(); ++child)
+      {
+        const FiniteElement<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &child_fe
+          = cell->child(child)->get_fe();
+        const unsigned int child_dofs = child_fe.dofs_per_cell;
+
+        child_indices.resize (child_dofs);
+        cell->child(child)->get_dof_indices (child_indices);
+        std::copy (child_indices.begin(), child_indices.end(),
+                   children_indices.begin()+offset);
+
+        // the map from the values on the child to the values on the parent,
+        // if necessary by interpolation from the element on the child to the
+        // one requested here. for historical reasons, matrices are set to
+        // size 0x0 internally if one of their sizes is zero, so we have to
+        // treat this case specially
+        child_matrix.reinit (dofs_per_cell, child_dofs);
+        if ((dofs_per_cell > 0) && (child_dofs > 0))
+          {
+            const FullMatrix<double> &restriction
+              = fe.get_restriction_matrix (child, cell->refinement_case());
+            if (cell->child(child)->active_fe_index() == fe_index)
+              child_matrix = restriction;
+            else
+              {
+                interpolation.reinit (dofs_per_cell, child_dofs);
+                fe.get_interpolation_matrix (child_fe, interpolation);
+                restriction.mmult (child_matrix, interpolation);
+              }
+          }
+
+        for (unsigned int i=0; i<dofs_per_cell; ++i)
+          if (fe.restriction_is_additive(i))
+            for (unsigned int k=0; k<child_dofs; ++k)
+              restriction_matrix(i,offset+k) += child_matrix(i,k);
+          else
+            {
+              bool child_contributes = false;
+              for (unsigned int k=0; k<child_dofs; ++k)
+                if (child_matrix(i,k) != 0)
+                  {
+                    child_contributes = true;
+                    break;
+                  }
+
+              if (child_contributes)
+                {
+                  for (unsigned int j=0; j<n_children_dofs; ++j)
+                    restriction_matrix(i,j) = 0;
+                  for (unsigned int k=0; k<child_dofs; ++k)
+                    restriction_matrix(i,offset+k) = child_matrix(i,k);
+                }
+            }
+
+        offset += child_dofs;
+      }
+  }
+
+
+  /**
+   * Store the rows of @p local_matrix, which maps the old dof values with
+   * indices @p old_indices to the values of the finite element with index
+   * @p fe_index on @p cell, as the rows of the transfer matrix that belong
+   * to the dofs of @p cell or, if the cell has been refined, of its
+   * descendants. This is the matrix form of what
+   * DoFCellAccessor::set_dof_values_by_interpolation() does with vectors,
+   * including the fact that the rows written on a cell overwrite the ones
+   * written on cells visited before.
+   */
+  template <typename DoFHandlerType>
+  void
+  set_transfer_matrix_rows (const typename DoFHandlerType::cell_iterator                          &cell,
+                            const FullMatrix<double>                                              &local_matrix,
+                            const unsigned int                                                     fe_index,
+                            const std::vector<types::global_dof_index>                            &old_indices,
+                            std::vector<std::vector<std::pair<types::global_dof_index,double> > > &rows)
+  {
+    const unsigned int n_old_dofs = old_indices.size();
+    Assert (local_matrix.n() == n_old_dofs || n_old_dofs == 0,
+            ExcDimensionMismatch (local_matrix.n(), n_old_dofs));
+
+    if (!cell->has_children())
+      {
+        const unsigned int dofs_per_cell = cell->get_fe().dofs_per_cell;
+
+        FullMatrix<double> cell_matrix (dofs_per_cell, n_old_dofs);
+        if ((dofs_per_cell > 0) && (n_old_dofs > 0))
+          {
+            if (cell->active_fe_index() == fe_index)
+              cell_matrix = local_matrix;
+            else
+              {
+                const FiniteElement<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &fe
+                  = cell->get_dof_handler().get_fe()[fe_index];
+                FullMatrix<double> interpolation (dofs_per_cell, fe.dofs_per_cell);
+                cell->get_fe().get_interpolation_matrix (fe, interpolation);
+                interpolation.mmult (cell_matrix, local_matrix);
+              }
+          }
+
+        std::vector<types::global_dof_index> dof_indices (dofs_per_cell);
+        cell->get_dof_indices (dof_indices);
+        for (unsigned int i=0; i<dofs_per_cell; ++i)
+          {
+            std::vector<std::pair<types::global_dof_index,double> > &row = rows[dof_indices[i]];
+            row.clear ();
+            for (unsigned int k=0; k<n_old_dofs; ++k)
+              if (cell_matrix(i,k) != 0)
+                row.push_back (std::make_pair (old_indices[k], cell_matrix(i,k)));
+
+            // an old dof appears more than once among the columns if it is
+            // shared by several children of a coarsened cell. merge these
+            // entries
+            std::sort (row.begin(), row.end());
+            unsigned int n_entries = 0;
+            for (unsigned int k=0; k<row.size(); ++k)
+              if ((n_entries > 0) && (row[n_entries-1].first == row[k].first))
+                row[n_entries-1].second += row[k].second;
+              else
+                row[n_entries++] = row[k];
+            row.resize (n_entries);
+          }
+      }
+    else
+      {
+        const FiniteElement<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &fe
+          = cell->get_dof_handler().get_fe()[fe_index];
+
+        FullMatrix<double> child_matrix (fe.dofs_per_cell, n_old_dofs);
+        for (unsigned int child=0; child<cell->n_children(); ++child)
+          {
+            if ((fe.dofs_per_cell > 0) && (n_old_dofs > 0))
+              fe.get_prolongation_matrix(child, cell->refinement_case())
+              .mmult (child_matrix, local_matrix);
+            set_transfer_matrix_rows<DoFHandlerType> (cell->child(child), child_matrix,
+                                                      fe_index, old_indices, rows);
+          }
+      }
+  }
 }
 
 
@@ -235,6 +444,8 @@ prepare_for_coarsening_and_refinement(const std::vector<VectorType> &all_in)
   Assert (prepared_for!=pure_refinement, ExcAlreadyPrepForRef());
   Assert (prepared_for!=coarsening_and_refinement,
           ExcAlreadyPrepForCoarseAndRef());
+  Assert (prepared_for!=transfer_matrix_preparation,
+          ExcAlreadyPrepForCoarseAndRef());
 
   const unsigned int in_size=all_in.size();
   Assert(in_size!=0,
@@ -333,24 +544,7 @@ prepare_for_coarsening_and_refinement(const std::vector<VectorType> &all_in)
           // we need to figure out which finite element space to interpolate
           // to since that is not implied by the global FE as in the non-hp
           // case.
-          bool different_fe_on_children = false;
-          for (unsigned int child=1; child<cell->n_children(); ++child)
-            if (cell->child(child)->active_fe_index()
-                != cell->child(0)->active_fe_index())
-              {
-                different_fe_on_children = true;
-                break;
-              }
-
-          // take FE index from the child with most
-          // degrees of freedom locally
-          unsigned int most_general_child = 0;
-          if (different_fe_on_children == true)
-            for (unsigned int child=1; child<cell->n_children(); ++child)
-              if (cell->child(child)->get_fe().dofs_per_cell >
-                  cell->child(most_general_child)->get_fe().dofs_per_cell)
-                most_general_child = child;
-          const unsigned int target_fe_index = cell->child(most_general_child)->active_fe_index();
+          const unsigned int target_fe_index = internal::coarsening_target_fe_index (cell);
 
           const unsigned int dofs_per_cell=cell->get_dof_handler().get_fe()[target_fe_index].dofs_per_cell;
 
@@ -541,6 +735,142 @@ void SolutionTransfer<dim, VectorType, DoFHandlerType>::interpolate
 
 
 
+template<int dim, typename VectorType, typename DoFHandlerType>
+void
+SolutionTransfer<dim, VectorType, DoFHandlerType>::prepare_for_transfer_matrix ()
+{
+  Assert (prepared_for!=pure_refinement, ExcAlreadyPrepForRef());
+  Assert (prepared_for!=coarsening_and_refinement,
+          ExcAlreadyPrepForCoarseAndRef());
+  Assert (prepared_for!=transfer_matrix_preparation,
+          ExcAlreadyPrepForCoarseAndRef());
+
+  clear();
+
+  n_dofs_old = dof_handler->n_dofs();
+
+  unsigned int n_cells_to_stay_or_refine=0;
+  for (typename DoFHandlerType::active_cell_iterator act_cell = dof_handler->begin_active();
+       act_cell!=dof_handler->end(); ++act_cell)
+    if (!act_cell->coarsen_flag_set())
+      ++n_cells_to_stay_or_refine;
+
+  unsigned int n_coarsen_fathers=0;
+  for (typename DoFHandlerType::cell_iterator cell=dof_handler->begin();
+       cell!=dof_handler->end(); ++cell)
+    if (!cell->active() && cell->child(0)->coarsen_flag_set())
+      ++n_coarsen_fathers;
+
+  // the dof indices of the cells that stay or are refined come first, then
+  // the ones of the children of the coarsen fathers
+  std::vector<std::vector<types::global_dof_index> >(n_cells_to_stay_or_refine+n_coarsen_fathers)
+  .swap(indices_on_cell);
+  std::vector<FullMatrix<double> >(n_coarsen_fathers)
+  .swap(restriction_matrices_on_cell);
+
+  unsigned int n_sr=0, n_cf=0;
+  for (typename DoFHandlerType::cell_iterator cell=dof_handler->begin();
+       cell!=dof_handler->end(); ++cell)
+    {
+      // CASE 1: active cell that remains as it is or is refined
+      if (cell->active() && !cell->coarsen_flag_set())
+        {
+          indices_on_cell[n_sr].resize(cell->get_fe().dofs_per_cell);
+          cell->get_dof_indices(indices_on_cell[n_sr]);
+          cell_map[std::make_pair(cell->level(), cell->index())]
+            = Pointerstruct(&indices_on_cell[n_sr], cell->active_fe_index());
+          ++n_sr;
+        }
+
+      // CASE 2: cell is inactive but will become active. rather than the
+      // restricted values, store the matrix that computes them
+      else if (cell->has_children() && cell->child(0)->coarsen_flag_set())
+        {
+          for (unsigned int i=1; i<cell->n_children(); ++i)
+            Assert(cell->child(i)->coarsen_flag_set(),
+                   ExcMessage("It looks like you didn't call "
+                              "Triangulation::prepare_coarsening_and_refinement before "
+                              "calling the current function. This can't work."));
+
+          const unsigned int target_fe_index = internal::coarsening_target_fe_index (cell);
+          std::vector<types::global_dof_index> &indices
+            = indices_on_cell[n_cells_to_stay_or_refine+n_cf];
+          internal::get_children_restriction_matrix<DoFHandlerType> (cell, target_fe_index,
+                                                                     indices,
+                                                                     restriction_matrices_on_cell[n_cf]);
+          cell_map[std::make_pair(cell->level(), cell->index())]
+            = Pointerstruct(&indices, &restriction_matrices_on_cell[n_cf], target_fe_index);
+          ++n_cf;
+        }
+    }
+  Assert(n_sr==n_cells_to_stay_or_refine, ExcInternalError());
+  Assert(n_cf==n_coarsen_fathers, ExcInternalError());
+
+  prepared_for=transfer_matrix_preparation;
+}
+
+
+
+template<int dim, typename VectorType, typename DoFHandlerType>
+void
+SolutionTransfer<dim, VectorType, DoFHandlerType>::
+build_transfer_matrix (SparsityPattern      &sparsity_pattern,
+                       SparseMatrix<double> &transfer_matrix) const
+{
+  Assert(prepared_for==pure_refinement ||
+         prepared_for==transfer_matrix_preparation, ExcNotPrepared());
+
+  // compute the rows of the matrix cell by cell, in the same order in which
+  // interpolate() and refine_interpolate() set the values of the output
+  // vectors, so that rows of dofs shared between cells end up being the same
+  // as the values set by these functions
+  std::vector<std::vector<std::pair<types::global_dof_index,double> > >
+  rows (dof_handler->n_dofs());
+  FullMatrix<double> identity;
+
+  typename std::map<std::pair<unsigned int, unsigned int>, Pointerstruct>::const_iterator
+  pointerstruct,
+  cell_map_end=cell_map.end();
+
+  typename DoFHandlerType::cell_iterator cell = dof_handler->begin(),
+                                         endc = dof_handler->end();
+  for (; cell!=endc; ++cell)
+    {
+      pointerstruct=cell_map.find(std::make_pair(cell->level(),cell->index()));
+
+      if (pointerstruct!=cell_map_end)
+        {
+          const std::vector<types::global_dof_index> &indices
+            = *pointerstruct->second.indices_ptr;
+
+          // the children of this cell were deleted
+          if (pointerstruct->second.restriction_matrix_ptr != 0)
+            {
+              Assert (!cell->has_children(), ExcInternalError());
+              internal::set_transfer_matrix_rows<DoFHandlerType>
+              (cell, *pointerstruct->second.restriction_matrix_ptr,
+               pointerstruct->second.active_fe_index, indices, rows);
+            }
+          // cell stayed as it was or was refined
+          else
+            {
+              identity.reinit (indices.size(), indices.size());
+              for (unsigned int i=0; i<indices.size(); ++i)
+                identity(i,i) = 1;
+              internal::set_transfer_matrix_rows<DoFHandlerType>
+              (cell, identity, pointerstruct->second.active_fe_index, indices, rows);
+            }
+        }
+    }
+
+  sparsity_pattern.copy_from (dof_handler->n_dofs(), n_dofs_old,
+                              rows.begin(), rows.end());
+  transfer_matrix.reinit (sparsity_pattern);
+  transfer_matrix.copy_from (rows.begin(), rows.end());
+}
+
+
+
 template<int dim, typename VectorType, typename DoFHandlerType>
 std::size_t
 SolutionTransfer<dim, VectorType, DoFHandlerType>::memory_consumption () const
@@ -553,7 +883,8 @@ SolutionTransfer<dim, VectorType, DoFHandlerType>::memory_consumption () const
           MemoryConsumption::memory_consumption (n_dofs_old) +
           sizeof (prepared_for) +
           MemoryConsumption::memory_consumption (indices_on_cell) +
-          MemoryConsumption::memory_consumption (dof_values_on_cell));
+          MemoryConsumption::memory_consumption (dof_values_on_cell) +
+          MemoryConsumption::memory_consumption (restriction_matrices_on_cell));
 }
 
 
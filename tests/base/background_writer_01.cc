@@ -0,0 +1,85 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+
+// check that BackgroundWriter executes many requests in order on its worker
+// thread, and that a failing request is reported by wait() rather than
+// aborting the program
+
+#include "../tests.h"
+#include <deal.II/base/background_writer.h>
+#include <deal.II/base/std_cxx11/bind.h>
+
+#include <fstream>
+#include <sstream>
+
+
+void write_number (const unsigned int i,
+                   std::ostream      &out)
+{
+  out << i;
+}
+
+
+std::string read_file (const std::string &filename)
+{
+  std::ifstream in (filename.c_str(), std::ios::binary);
+  std::ostringstream contents;
+  contents << in.rdbuf();
+  return contents.str();
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  BackgroundWriter writer;
+
+  // all requests go into the same file, so the file contains the number
+  // written by the request submitted last
+  const unsigned int n_requests = 200;
+  for (unsigned int i=0; i<n_requests; ++i)
+    writer.write ("output.dat",
+                  std_cxx11::bind (&write_number, i, std_cxx11::_1),
+                  1);
+  writer.wait ();
+  deallog << "last request: " << read_file ("output.dat") << std::endl;
+  deallog << "staged memory: " << writer.staged_memory() << std::endl;
+
+  // a file in a directory that does not exist can not be opened. the
+  // requests submitted after it are still executed
+  std::vector<char> buffer (3, 'a');
+  writer.write ("does/not/exist.dat", buffer);
+  buffer.assign (3, 'b');
+  writer.write ("output.dat", buffer);
+  try
+    {
+      writer.wait ();
+      deallog << "no error reported" << std::endl;
+    }
+  catch (const BackgroundWriter::ExcWriteFailed &)
+    {
+      deallog << "error reported" << std::endl;
+    }
+  deallog << "after error: " << read_file ("output.dat") << std::endl;
+
+  // the error has been reported, so waiting again succeeds
+  writer.wait ();
+  deallog << "OK" << std::endl;
+}
@@ -0,0 +1,111 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// write a vtu file with the data arrays in a raw appended data section and
+// check that the offsets of the arrays point to the right data
+
+#include "../tests.h"
+#include <deal.II/base/data_out_base.h>
+#include <deal.II/base/logstream.h>
+
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <stdint.h>
+
+
+template <typename T>
+double sum_of_values (const char *data, const uint32_t n_bytes)
+{
+  std::vector<T> values (n_bytes / sizeof(T));
+  std::memcpy (&values[0], data, n_bytes);
+  double sum = 0;
+  for (unsigned int i=0; i<values.size(); ++i)
+    sum += values[i];
+  return sum;
+}
+
+
+
+int main()
+{
+  initlog();
+
+  // a single patch on the unit square with two subdivisions
+  std::vector<DataOutBase::Patch<2,2> > patches (1);
+  patches[0].n_subdivisions = 2;
+  for (unsigned int v=0; v<4; ++v)
+    patches[0].vertices[v] = Point<2> (v%2, v/2);
+  patches[0].data.reinit (1, 9);
+  for (unsigned int i=0; i<9; ++i)
+    patches[0].data(0,i) = i;
+
+  std::vector<std::string> names (1, "index");
+  std::vector<std_cxx11::tuple<unsigned int, unsigned int, std::string> > vectors;
+
+  DataOutBase::VtkFlags flags;
+  flags.print_date_and_time = false;
+  flags.write_raw_appended_data = true;
+
+  std::ostringstream out;
+  DataOutBase::write_vtu (patches, names, vectors, flags, out);
+  const std::string vtu = out.str();
+
+  const std::string begin_tag = "<AppendedData encoding=\"raw\">\n_";
+  const std::size_t appended_begin = vtu.find (begin_tag) + begin_tag.size();
+  const std::size_t appended_end = vtu.rfind ("\n </AppendedData>");
+  deallog << "appended bytes: " << appended_end - appended_begin << std::endl;
+  deallog << "end of file: "
+          << (vtu.substr (appended_end) == "\n </AppendedData>\n</VTKFile>\n")
+          << std::endl;
+
+  std::size_t pos = 0;
+  std::size_t end_of_last_array = 0;
+  while ((pos = vtu.find ("<DataArray", pos)) < appended_begin)
+    {
+      const std::size_t tag_end = vtu.find (">", pos);
+      const std::string tag = vtu.substr (pos, tag_end+1-pos);
+      pos = tag_end;
+      deallog << tag << std::endl;
+
+      const std::size_t offset_pos = tag.find ("offset=\"");
+      if (offset_pos == std::string::npos)
+        continue;
+      const unsigned int offset
+        = Utilities::string_to_int (tag.substr (offset_pos + 8,
+                                                tag.find ("\"", offset_pos+8)
+                                                - offset_pos - 8));
+      AssertThrow (offset == end_of_last_array, ExcInternalError());
+
+      // without compression, every array is preceded by its size
+      uint32_t n_bytes;
+      std::memcpy (&n_bytes, &vtu[appended_begin + offset], sizeof(n_bytes));
+      const char *data = &vtu[appended_begin + offset + sizeof(n_bytes)];
+      end_of_last_array = offset + sizeof(n_bytes) + n_bytes;
+
+      double sum;
+      if (tag.find ("Float64") != std::string::npos)
+        sum = sum_of_values<double> (data, n_bytes);
+      else if (tag.find ("Int32") != std::string::npos)
+        sum = sum_of_values<int32_t> (data, n_bytes);
+      else
+        sum = sum_of_values<uint8_t> (data, n_bytes);
+      deallog << "  bytes: " << n_bytes << ", sum: " << sum << std::endl;
+    }
+  deallog << "end of last array: " << end_of_last_array << std::endl;
+}
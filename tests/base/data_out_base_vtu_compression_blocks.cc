@@ -0,0 +1,151 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// write a patch that is large enough that the data arrays of a vtu file are
+// split into several compressed blocks, then decode and decompress the
+// blocks again and check their contents
+
+#include "../tests.h"
+#include <deal.II/base/data_out_base.h>
+#include <deal.II/base/logstream.h>
+
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <stdint.h>
+
+#include <zlib.h>
+
+
+std::vector<unsigned char> decode_base64 (const std::string &in)
+{
+  const std::string alphabet
+    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::vector<unsigned char> out;
+  unsigned int buffer = 0, n_bits = 0;
+  for (unsigned int i=0; i<in.size(); ++i)
+    {
+      const std::size_t value = alphabet.find (in[i]);
+      if (value == std::string::npos)
+        continue;
+      buffer = (buffer << 6) | value;
+      n_bits += 6;
+      if (n_bits >= 8)
+        {
+          n_bits -= 8;
+          out.push_back ((buffer >> n_bits) & 0xff);
+        }
+    }
+  return out;
+}
+
+
+
+// decode one binary data array and return the uncompressed bytes
+std::vector<unsigned char> decode_array (const std::string &encoded)
+{
+  // the header is encoded separately from the data. its first entry is the
+  // number of blocks, which determines the length of the rest of the header
+  uint32_t n_blocks;
+  std::memcpy (&n_blocks, &decode_base64 (encoded.substr (0, 8))[0], sizeof(n_blocks));
+  const unsigned int header_bytes = (3+n_blocks) * sizeof(uint32_t);
+  const unsigned int header_chars = 4 * ((header_bytes + 2) / 3);
+
+  std::vector<uint32_t> header (3+n_blocks);
+  std::memcpy (&header[0], &decode_base64 (encoded.substr (0, header_chars))[0],
+               header_bytes);
+  const std::vector<unsigned char> compressed
+    = decode_base64 (encoded.substr (header_chars));
+
+  deallog << "  blocks: " << header[0]
+          << ", block size: " << header[1]
+          << ", last block size: " << header[2]
+          << std::endl;
+
+  std::vector<unsigned char> data;
+  std::size_t offset = 0;
+  for (unsigned int b=0; b<n_blocks; ++b)
+    {
+      uLongf size = (b == n_blocks-1 ? header[2] : header[1]);
+      std::vector<unsigned char> block (size);
+      const int err = uncompress (&block[0], &size,
+                                  &compressed[offset], header[3+b]);
+      AssertThrow (err == Z_OK, ExcInternalError());
+      AssertThrow (size == (b == n_blocks-1 ? header[2] : header[1]),
+                   ExcInternalError());
+      data.insert (data.end(), block.begin(), block.end());
+      offset += header[3+b];
+    }
+  AssertThrow (offset == compressed.size(), ExcInternalError());
+
+  return data;
+}
+
+
+
+int main()
+{
+  initlog();
+
+  // a single patch on the unit square with many subdivisions
+  const unsigned int n_subdivisions = 400;
+  const unsigned int n_points = (n_subdivisions+1) * (n_subdivisions+1);
+  std::vector<DataOutBase::Patch<2,2> > patches (1);
+  patches[0].n_subdivisions = n_subdivisions;
+  for (unsigned int v=0; v<4; ++v)
+    patches[0].vertices[v] = Point<2> (v%2, v/2);
+  patches[0].data.reinit (1, n_points);
+  for (unsigned int i=0; i<n_points; ++i)
+    patches[0].data(0,i) = i;
+
+  std::vector<std::string> names (1, "index");
+  std::vector<std_cxx11::tuple<unsigned int, unsigned int, std::string> > vectors;
+
+  std::ostringstream out;
+  DataOutBase::write_vtu (patches, names, vectors, DataOutBase::VtkFlags(), out);
+  const std::string vtu = out.str();
+
+  std::size_t pos = 0;
+  const std::string begin_tag = "format=\"binary\">";
+  while ((pos = vtu.find (begin_tag, pos)) != std::string::npos)
+    {
+      const std::size_t name_begin = vtu.rfind ("<DataArray", pos);
+      // the header has to be decoded on its own, so skip the line break
+      // that precedes the encoded data
+      const std::size_t begin = vtu.find_first_not_of (" \n", pos + begin_tag.size());
+      const std::size_t end = vtu.find ("</DataArray>", begin);
+
+      deallog << vtu.substr (name_begin, pos - 1 - name_begin) << std::endl;
+      const std::vector<unsigned char> data
+        = decode_array (vtu.substr (begin, end-begin));
+      deallog << "  bytes: " << data.size() << std::endl;
+
+      // check the contents of the arrays of floating point numbers
+      if (vtu.substr (name_begin, pos - name_begin).find ("Float64") != std::string::npos)
+        {
+          std::vector<double> values (data.size() / sizeof(double));
+          std::memcpy (&values[0], &data[0], data.size());
+          double sum = 0;
+          for (unsigned int i=0; i<values.size(); ++i)
+            sum += values[i];
+          deallog << "  sum: " << sum << std::endl;
+        }
+
+      pos = end;
+    }
+}
@@ -0,0 +1,98 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check PerformanceTrace: nested regions, the interaction with TimerOutput,
+// and the number of events written to the Chrome trace
+
+#include "../tests.h"
+#include <deal.II/base/performance_trace.h>
+#include <deal.II/base/timer.h>
+
+#include <fstream>
+#include <sstream>
+
+
+void print_sections ()
+{
+  const std::map<std::string,PerformanceTrace::SectionData> data
+    = PerformanceTrace::get_section_data();
+  for (std::map<std::string,PerformanceTrace::SectionData>::const_iterator
+       p = data.begin(); p != data.end(); ++p)
+    {
+      deallog << p->first << ": " << p->second.n_calls << " calls"
+              << std::endl;
+      AssertThrow (p->second.min_wall_time <= p->second.max_wall_time,
+                   ExcInternalError());
+      AssertThrow (p->second.total_wall_time >= 0, ExcInternalError());
+    }
+}
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.threshold_double(1.e-10);
+
+  // nothing is recorded while disabled
+  {
+    PerformanceTrace::Scope scope ("disabled");
+  }
+  deallog << "Enabled: " << PerformanceTrace::is_enabled() << std::endl;
+  print_sections ();
+
+  PerformanceTrace::enable ();
+  deallog << "Enabled: " << PerformanceTrace::is_enabled() << std::endl;
+
+  for (unsigned int i=0; i<3; ++i)
+    {
+      PerformanceTrace::Scope outer ("outer");
+      {
+        PerformanceTrace::Scope inner ("inner");
+      }
+      PerformanceTrace::begin_region ("manual");
+      PerformanceTrace::end_region ();
+    }
+
+  // sections of TimerOutput are recorded as well, and may be left in any
+  // order
+  {
+    std::ostringstream dummy;
+    TimerOutput timer (dummy, TimerOutput::never, TimerOutput::wall_times);
+    timer.enter_subsection ("a");
+    timer.enter_subsection ("b");
+    timer.leave_subsection ("a");
+    timer.leave_subsection ("b");
+  }
+  print_sections ();
+
+  std::ostringstream trace;
+  PerformanceTrace::write_chrome_trace (trace);
+  const std::string s = trace.str();
+  unsigned int n_events = 0;
+  for (std::string::size_type p = s.find("\"ph\":\"X\""); p != std::string::npos;
+       p = s.find("\"ph\":\"X\"", p+1))
+    ++n_events;
+  deallog << "Events: " << n_events << std::endl;
+
+  PerformanceTrace::disable ();
+  {
+    PerformanceTrace::Scope scope ("disabled");
+  }
+  PerformanceTrace::clear ();
+  deallog << "After clear: " << PerformanceTrace::get_section_data().size()
+          << std::endl;
+}
@@ -0,0 +1,75 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+
+// check that PerformanceTrace::Scope leaves its own region even if a section
+// of TimerOutput has been entered after it and is still active, and that
+// TimerOutput does not touch PerformanceTrace while recording is off
+
+#include "../tests.h"
+#include <deal.II/base/performance_trace.h>
+#include <deal.II/base/timer.h>
+
+#include <fstream>
+#include <sstream>
+
+
+void print_sections ()
+{
+  const std::map<std::string,PerformanceTrace::SectionData> data
+    = PerformanceTrace::get_section_data();
+  for (std::map<std::string,PerformanceTrace::SectionData>::const_iterator
+       p = data.begin(); p != data.end(); ++p)
+    deallog << p->first << ": " << p->second.n_calls << " calls"
+            << std::endl;
+}
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.threshold_double(1.e-10);
+
+  std::ostringstream dummy;
+  TimerOutput timer (dummy, TimerOutput::never, TimerOutput::wall_times);
+
+  PerformanceTrace::enable ();
+  for (unsigned int i=0; i<2; ++i)
+    {
+      PerformanceTrace::Scope scope ("scope");
+      timer.enter_subsection ("section");
+      scope.stop ();
+      timer.leave_subsection ("section");
+
+      // the scope must have been left, so this is not nested in it
+      PerformanceTrace::Scope after ("after");
+    }
+  print_sections ();
+
+  // sections entered and left while recording is off are not recorded
+  PerformanceTrace::disable ();
+  timer.enter_subsection ("disabled");
+  timer.leave_subsection ("disabled");
+  PerformanceTrace::enable ();
+  print_sections ();
+
+  PerformanceTrace::disable ();
+  PerformanceTrace::clear ();
+  deallog << "After clear: " << PerformanceTrace::get_section_data().size()
+          << std::endl;
+}
@@ -0,0 +1,195 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check the functions from cmath for VectorizedArray against the respective
+// scalar functions, including special values and arguments whose results
+// are subnormal
+
+#include "../tests.h"
+#include <limits>
+#include <vector>
+#include <fenv.h>
+
+#include <deal.II/base/vectorization.h>
+
+
+// distance between a and b in units of the last place of b
+template <typename Number>
+double ulp_distance (const Number a, const Number b)
+{
+  if (numbers::is_nan(a) || numbers::is_nan(b))
+    return (numbers::is_nan(a) && numbers::is_nan(b)) ? 0. :
+           std::numeric_limits<double>::max();
+  if (a == b)
+    return 0.;
+  if (std::abs(b) == std::numeric_limits<Number>::infinity() ||
+      std::abs(a) == std::numeric_limits<Number>::infinity())
+    return std::numeric_limits<double>::max();
+  const Number ulp =
+    std::max (std::abs(b) * std::numeric_limits<Number>::epsilon(),
+              std::numeric_limits<Number>::denorm_min());
+  return std::abs(double(a)-double(b)) / ulp;
+}
+
+
+
+template <typename Number>
+class Function
+{
+public:
+  virtual ~Function () {}
+  virtual Number scalar (const Number x) const = 0;
+  virtual VectorizedArray<Number> vectorized (const VectorizedArray<Number> &x) const = 0;
+};
+
+#define DECLARE_FUNCTION(name, expression)                              \
+  template <typename Number>                                            \
+  class name : public Function<Number>                                  \
+  {                                                                     \
+  public:                                                               \
+    virtual Number scalar (const Number x) const                        \
+    { return expression; }                                              \
+    virtual VectorizedArray<Number> vectorized (const VectorizedArray<Number> &x) const \
+    { return expression; }                                              \
+  }
+
+DECLARE_FUNCTION (Sin, std::sin(x));
+DECLARE_FUNCTION (Cos, std::cos(x));
+DECLARE_FUNCTION (Tan, std::tan(x));
+DECLARE_FUNCTION (Exp, std::exp(x));
+DECLARE_FUNCTION (Log, std::log(x));
+DECLARE_FUNCTION (PowHalf, std::pow(x, Number(0.5)));
+DECLARE_FUNCTION (PowThree, std::pow(x, Number(3.)));
+DECLARE_FUNCTION (PowMinusTwoPointFive, std::pow(x, Number(-2.5)));
+DECLARE_FUNCTION (PowFortyOne, std::pow(x, Number(41.)));
+
+
+
+template <typename Number>
+void check (const std::string        &name,
+            const Function<Number>   &function,
+            const std::vector<Number> &arguments,
+            const double              tolerance)
+{
+  const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  double max_error = 0;
+  Number worst_argument = 0;
+  for (unsigned int i=0; i<arguments.size(); i+=n_lanes)
+    {
+      VectorizedArray<Number> x;
+      // fill the remaining lanes with the same argument
+      for (unsigned int v=0; v<n_lanes; ++v)
+        x[v] = arguments[std::min<std::size_t>(i+v, arguments.size()-1)];
+      const VectorizedArray<Number> result = function.vectorized(x);
+      for (unsigned int v=0; v<n_lanes; ++v)
+        {
+          const double error = ulp_distance (result[v], function.scalar(x[v]));
+          if (error > max_error)
+            {
+              max_error = error;
+              worst_argument = x[v];
+            }
+        }
+    }
+  deallog << name << ": ";
+  if (max_error <= tolerance)
+    deallog << "OK" << std::endl;
+  else
+    deallog << "error " << max_error << " ulp at " << worst_argument
+            << std::endl;
+}
+
+
+
+template <typename Number>
+void test ()
+{
+  const Number inf = std::numeric_limits<Number>::infinity();
+  const Number nan = std::numeric_limits<Number>::quiet_NaN();
+  const Number max = std::numeric_limits<Number>::max();
+  const Number min = std::numeric_limits<Number>::min();
+  const Number denorm_min = std::numeric_limits<Number>::denorm_min();
+
+  // arguments for the trigonometric functions: a fine sampling of a few
+  // periods, some large arguments, and special values
+  std::vector<Number> trig_args;
+  for (int i=-20000; i<=20000; ++i)
+    trig_args.push_back (Number(i*0.001));
+  for (int i=-100; i<=100; ++i)
+    trig_args.push_back (Number(i*7.1));
+  const Number trig_special[] = { 0., -0., 1e-30, 1e4, -1e6, 1e20, inf, -inf, nan };
+  trig_args.insert (trig_args.end(), trig_special, trig_special+9);
+
+  // arguments for exp: the full range including overflow and subnormal
+  // results
+  std::vector<Number> exp_args;
+  const Number exp_max = sizeof(Number) == 8 ? 750 : 110;
+  for (int i=-20000; i<=20000; ++i)
+    exp_args.push_back (Number(i * exp_max / 20000.));
+  const Number exp_special[] = { 0., 1e-20, -1e-20, inf, -inf, nan, max, -max };
+  exp_args.insert (exp_args.end(), exp_special, exp_special+8);
+
+  // arguments for log and pow: logarithmically spaced over the whole
+  // range of positive numbers, plus negative numbers and special values
+  std::vector<Number> log_args;
+  for (Number x=denorm_min; x<min; x*=Number(2.))
+    log_args.push_back (x);
+  for (Number x=min; x<max/Number(1.37); x*=Number(1.37))
+    log_args.push_back (x);
+  for (int i=1; i<=20000; ++i)
+    log_args.push_back (Number(0.5 + i*1e-4));
+  const Number log_special[] = { 0., -0., -1., -min, min, max, inf, -inf, nan };
+  log_args.insert (log_args.end(), log_special, log_special+9);
+
+  std::vector<Number> pow_args;
+  for (int i=-2000; i<=2000; ++i)
+    pow_args.push_back (Number(i*0.01));
+  for (Number x=Number(1e-10); x<Number(1e10); x*=Number(1.37))
+    pow_args.push_back (x);
+  pow_args.insert (pow_args.end(), log_special, log_special+9);
+
+  check ("sin", Sin<Number>(), trig_args, 2);
+  check ("cos", Cos<Number>(), trig_args, 2);
+  check ("tan", Tan<Number>(), trig_args, 4);
+  check ("exp", Exp<Number>(), exp_args, 2);
+  check ("log", Log<Number>(), log_args, 2);
+  check ("pow(x,0.5)", PowHalf<Number>(), pow_args, 2);
+  check ("pow(x,3)", PowThree<Number>(), pow_args, 2);
+  check ("pow(x,-2.5)", PowMinusTwoPointFive<Number>(), pow_args, 2);
+  check ("pow(x,41)", PowFortyOne<Number>(), pow_args, 8);
+}
+
+
+
+int main()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.threshold_double(1.e-10);
+
+  // the scalar functions we compare against raise floating point exceptions
+  // for some of the special values
+#if defined(DEAL_II_HAVE_FP_EXCEPTIONS)
+  fedisableexcept(FE_INVALID|FE_DIVBYZERO);
+#endif
+
+  deallog.push("double");
+  test<double> ();
+  deallog.pop();
+  deallog.push("float");
+  test<float> ();
+  deallog.pop();
+}
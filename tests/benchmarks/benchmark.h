@@ -0,0 +1,315 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii__benchmarks_benchmark_h
+#define dealii__benchmarks_benchmark_h
+
+// Common infrastructure of the programs in tests/benchmarks. Every program
+// sets up a Benchmark::Suite object from its command line arguments, runs
+// each of its cases Suite::n_repetitions() times between calls to
+// Suite::start() and Suite::stop(), and records the result with
+// Suite::record(). At the end, Suite::finalize() writes all results in JSON
+// format and compares them against a previously stored baseline, which is
+// a results file written by an earlier run of the same program.
+//
+// The following command line arguments are understood:
+//   --output <file>       write the results to this file (default:
+//                         <name>.json)
+//   --baseline <file>     compare against this file; it is read before the
+//                         results are written, so it may be the same file
+//                         as the one given to --output
+//   --tolerance <x>       relative slowdown against the baseline that is
+//                         considered a regression (default: 0.1)
+//   --repetitions <n>     number of timed repetitions of each case
+//                         (default: 10)
+//   --threads <n>         number of threads (default: 1, to make results
+//                         reproducible)
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/revision.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/base/utilities.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace dealii;
+
+
+namespace Benchmark
+{
+  class Suite
+  {
+  public:
+    Suite (const std::string &name,
+           int                argc,
+           char             **argv);
+
+    // The number of timed repetitions every case should run.
+    unsigned int n_repetitions () const;
+
+    // Start and stop timing one repetition of the current case.
+    void start ();
+    void stop ();
+
+    // Record the repetitions timed since the last call of this function as
+    // the case with the given name. n_items is the amount of work done in
+    // one repetition (e.g. the number of degrees of freedom) and is used
+    // to compute a throughput in <item_name>/s. n_bytes is an estimate of
+    // the memory transferred in one repetition, from which a bandwidth in
+    // GB/s is computed; pass zero if this is not meaningful.
+    void record (const std::string &case_name,
+                 const double       n_items,
+                 const double       n_bytes,
+                 const std::string &item_name = "dofs");
+
+    // Write the results and compare them against the baseline. Returns the
+    // exit code of the program, which is nonzero if one of the cases has
+    // become slower than allowed by the tolerance.
+    int finalize ();
+
+  private:
+    struct Result
+    {
+      std::string  name;
+      unsigned int n_repetitions;
+      double       min_time;
+      double       median_time;
+      double       n_items;
+      std::string  item_name;
+      double       n_bytes;
+    };
+
+    const std::string    name;
+    std::string          output_file;
+    std::string          baseline_file;
+    double               tolerance;
+    unsigned int         repetitions;
+    unsigned int         n_threads;
+
+    Timer                timer;
+    std::vector<double>  times;
+    std::vector<Result>  results;
+  };
+
+
+
+  inline
+  Suite::Suite (const std::string &name,
+                int                argc,
+                char             **argv)
+    :
+    name (name),
+    output_file (name + ".json"),
+    tolerance (0.1),
+    repetitions (10),
+    n_threads (1)
+  {
+    for (int i=1; i<argc; ++i)
+      {
+        const std::string arg = argv[i];
+        AssertThrow (i+1 < argc,
+                     ExcMessage ("Missing value for argument " + arg));
+        const std::string value = argv[++i];
+
+        if (arg == "--output")
+          output_file = value;
+        else if (arg == "--baseline")
+          baseline_file = value;
+        else if (arg == "--tolerance")
+          tolerance = Utilities::string_to_double (value);
+        else if (arg == "--repetitions")
+          repetitions = Utilities::string_to_int (value);
+        else if (arg == "--threads")
+          n_threads = Utilities::string_to_int (value);
+        else
+          AssertThrow (false, ExcMessage ("Unknown argument " + arg));
+      }
+
+    AssertThrow (repetitions > 0,
+                 ExcMessage ("At least one repetition is needed"));
+    MultithreadInfo::set_thread_limit (n_threads);
+  }
+
+
+
+  inline
+  unsigned int
+  Suite::n_repetitions () const
+  {
+    return repetitions;
+  }
+
+
+
+  inline
+  void
+  Suite::start ()
+  {
+    timer.reset ();
+    timer.start ();
+  }
+
+
+
+  inline
+  void
+  Suite::stop ()
+  {
+    timer.stop ();
+    times.push_back (timer.wall_time());
+  }
+
+
+
+  inline
+  void
+  Suite::record (const std::string &case_name,
+                 const double       n_items,
+                 const double       n_bytes,
+                 const std::string &item_name)
+  {
+    AssertThrow (times.size() > 0,
+                 ExcMessage ("No repetitions have been timed for case "
+                             + case_name));
+
+    std::sort (times.begin(), times.end());
+
+    Result result;
+    result.name          = case_name;
+    result.n_repetitions = times.size();
+    result.min_time      = times[0];
+    result.median_time   = times[times.size()/2];
+    result.n_items       = n_items;
+    result.item_name     = item_name;
+    result.n_bytes       = n_bytes;
+    results.push_back (result);
+
+    std::cout << std::left << std::setw(40) << (name + "/" + case_name)
+              << std::right << std::scientific << std::setprecision(3)
+              << " min " << result.min_time << " s, "
+              << n_items/result.min_time << " " << item_name << "/s";
+    if (n_bytes > 0)
+      std::cout << ", " << std::fixed << std::setprecision(2)
+                << n_bytes/result.min_time*1e-9 << " GB/s";
+    std::cout << std::endl;
+
+    times.clear ();
+  }
+
+
+
+  inline
+  int
+  Suite::finalize ()
+  {
+    // read the baseline before writing the results, so that the comparison
+    // is still meaningful if both files are the same
+    std::map<std::string,double> baseline;
+    if (!baseline_file.empty())
+      {
+        std::ifstream in (baseline_file.c_str());
+        AssertThrow (in, ExcMessage ("Could not open " + baseline_file));
+
+        std::string line;
+        while (std::getline (in, line))
+          {
+            const std::string name_key = "{\"name\": \"";
+            const std::string time_key = "\"min_time\": ";
+            const std::string::size_type name_pos = line.find (name_key);
+            const std::string::size_type time_pos = line.find (time_key);
+            if (name_pos == std::string::npos || time_pos == std::string::npos)
+              continue;
+
+            const std::string::size_type name_begin = name_pos + name_key.size();
+            const std::string case_name
+              = line.substr (name_begin, line.find ('"', name_begin) - name_begin);
+            baseline[case_name]
+              = std::atof (line.c_str() + time_pos + time_key.size());
+          }
+      }
+
+    // write one result per line so that the files can be compared by line
+    // and read back above without a full JSON parser
+    std::ofstream out (output_file.c_str());
+    AssertThrow (out, ExcMessage ("Could not open " + output_file));
+    out << std::setprecision(6);
+    out << "{\n"
+        << "  \"benchmark\": \"" << name << "\",\n"
+        << "  \"version\": \"" << DEAL_II_PACKAGE_VERSION << "\",\n"
+        << "  \"revision\": \"" << DEAL_II_GIT_SHORTREV << "\",\n"
+        << "  \"n_threads\": " << n_threads << ",\n"
+        << "  \"results\": [\n";
+    for (unsigned int i=0; i<results.size(); ++i)
+      {
+        const Result &r = results[i];
+        out << "    {\"name\": \"" << r.name << "\""
+            << ", \"n_repetitions\": " << r.n_repetitions
+            << ", \"min_time\": " << r.min_time
+            << ", \"median_time\": " << r.median_time
+            << ", \"n_" << r.item_name << "\": " << r.n_items
+            << ", \"" << r.item_name << "_per_second\": " << r.n_items/r.min_time;
+        if (r.n_bytes > 0)
+          out << ", \"gb_per_second\": " << r.n_bytes/r.min_time*1e-9;
+        out << "}" << (i+1 < results.size() ? "," : "") << "\n";
+      }
+    out << "  ]\n"
+        << "}\n";
+    out.close ();
+
+    if (baseline_file.empty())
+      return 0;
+
+    int exit_code = 0;
+    std::cout << std::endl
+              << "Comparison against " << baseline_file
+              << " (tolerance " << std::fixed << std::setprecision(1)
+              << tolerance*100 << "%):" << std::endl;
+    for (unsigned int i=0; i<results.size(); ++i)
+      {
+        const std::map<std::string,double>::const_iterator
+        p = baseline.find (results[i].name);
+        std::cout << std::left << std::setw(40)
+                  << (name + "/" + results[i].name) << std::right;
+        if (p == baseline.end() || !(p->second > 0))
+          {
+            std::cout << " not in baseline" << std::endl;
+            continue;
+          }
+
+        const double ratio = results[i].min_time / p->second;
+        std::cout << " " << std::fixed << std::setprecision(3) << ratio
+                  << " x baseline";
+        if (ratio > 1. + tolerance)
+          {
+            std::cout << "  REGRESSION";
+            exit_code = 1;
+          }
+        std::cout << std::endl;
+      }
+
+    return exit_code;
+  }
+}
+
+#endif
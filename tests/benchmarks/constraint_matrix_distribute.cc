@@ -0,0 +1,92 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// benchmark ConstraintMatrix::distribute() for the hanging node constraints
+// of an adaptively refined mesh
+
+#include "benchmark.h"
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/vector.h>
+
+
+template <int dim>
+void test (Benchmark::Suite  &suite,
+           const unsigned int degree,
+           const unsigned int n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  // refine every other cell in a checkerboard pattern, so that there are
+  // many hanging nodes
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    {
+      unsigned int sum = 0;
+      for (unsigned int d=0; d<dim; ++d)
+        sum += static_cast<unsigned int>(cell->center()[d] *
+                                         (1 << n_refinements));
+      if (sum % 2 == 0)
+        cell->set_refine_flag ();
+    }
+  tria.execute_coarsening_and_refinement ();
+
+  FE_Q<dim>       fe (degree);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  ConstraintMatrix constraints;
+  DoFTools::make_hanging_node_constraints (dof_handler, constraints);
+  constraints.close ();
+
+  Vector<double> vector (dof_handler.n_dofs());
+  for (unsigned int i=0; i<vector.size(); ++i)
+    vector(i) = 1. + 0.001 * (i%100);
+
+  for (unsigned int r=0; r<suite.n_repetitions(); ++r)
+    {
+      suite.start ();
+      for (unsigned int i=0; i<10; ++i)
+        constraints.distribute (vector);
+      suite.stop ();
+    }
+
+  suite.record ("hanging_nodes_q" + Utilities::int_to_string(degree)
+                + "_" + Utilities::int_to_string(dim) + "d",
+                10. * dof_handler.n_dofs(), 0);
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Benchmark::Suite suite ("constraint_matrix_distribute", argc, argv);
+
+  test<2> (suite, 2, 7);
+  test<3> (suite, 1, 4);
+  test<3> (suite, 2, 4);
+
+  return suite.finalize ();
+}
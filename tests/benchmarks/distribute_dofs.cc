@@ -0,0 +1,66 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// benchmark DoFHandler::distribute_dofs() for continuous and discontinuous
+// elements
+
+#include "benchmark.h"
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_system.h>
+
+
+template <int dim>
+void test (Benchmark::Suite              &suite,
+           const FiniteElement<dim>      &fe,
+           const unsigned int             n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  DoFHandler<dim> dof_handler (tria);
+
+  for (unsigned int r=0; r<suite.n_repetitions(); ++r)
+    {
+      dof_handler.clear ();
+      suite.start ();
+      dof_handler.distribute_dofs (fe);
+      suite.stop ();
+    }
+
+  suite.record (fe.get_name(), dof_handler.n_dofs(), 0);
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Benchmark::Suite suite ("distribute_dofs", argc, argv);
+
+  test<2> (suite, FE_Q<2>(2), 8);
+  test<2> (suite, FESystem<2>(FE_Q<2>(2), 2), 8);
+  test<3> (suite, FE_Q<3>(1), 5);
+  test<3> (suite, FE_Q<3>(2), 5);
+  test<3> (suite, FE_DGQ<3>(2), 5);
+  test<3> (suite, FESystem<3>(FE_Q<3>(2), 3), 4);
+
+  return suite.finalize ();
+}
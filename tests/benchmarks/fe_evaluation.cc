@@ -0,0 +1,105 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// benchmark FEEvaluation::evaluate() and FEEvaluation::integrate() for
+// values and gradients on a Cartesian mesh for polynomial degrees one to
+// six. The cell loop also reads the vector entries of each cell, but does
+// not write them back.
+
+#include "benchmark.h"
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/parallel_vector.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+
+
+template <int dim, int fe_degree>
+void test (Benchmark::Suite  &suite,
+           const unsigned int n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  FE_Q<dim>       fe (fe_degree);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  ConstraintMatrix constraints;
+  constraints.close ();
+
+  MatrixFree<dim,double> matrix_free;
+  matrix_free.reinit (dof_handler, constraints, QGauss<1>(fe_degree+1),
+                      typename MatrixFree<dim,double>::AdditionalData());
+
+  parallel::distributed::Vector<double> src;
+  matrix_free.initialize_dof_vector (src);
+  for (unsigned int i=0; i<src.local_size(); ++i)
+    src.local_element(i) = 1. + 0.001 * (i%100);
+
+  FEEvaluation<dim,fe_degree> phi (matrix_free);
+  const unsigned int n_cells = matrix_free.n_macro_cells();
+
+  for (unsigned int r=0; r<=suite.n_repetitions(); ++r)
+    {
+      // the first pass is not timed
+      if (r > 0)
+        suite.start ();
+      for (unsigned int cell=0; cell<n_cells; ++cell)
+        {
+          phi.reinit (cell);
+          phi.read_dof_values (src);
+          phi.evaluate (true, true);
+          phi.integrate (true, true);
+        }
+      if (r > 0)
+        suite.stop ();
+    }
+
+  suite.record ("evaluate_integrate_q" + Utilities::int_to_string(fe_degree)
+                + "_" + Utilities::int_to_string(dim) + "d",
+                1. * tria.n_active_cells() * fe.dofs_per_cell, 0);
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Benchmark::Suite suite ("fe_evaluation", argc, argv);
+
+  // choose the meshes such that the number of unknowns is similar for all
+  // degrees
+  test<2,1> (suite, 9);
+  test<2,2> (suite, 8);
+  test<2,3> (suite, 8);
+  test<2,4> (suite, 7);
+  test<2,5> (suite, 7);
+  test<2,6> (suite, 7);
+  test<3,1> (suite, 6);
+  test<3,2> (suite, 5);
+  test<3,3> (suite, 4);
+  test<3,4> (suite, 4);
+  test<3,5> (suite, 4);
+  test<3,6> (suite, 3);
+
+  return suite.finalize ();
+}
@@ -0,0 +1,130 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// benchmark MatrixFree::cell_loop() with the operator evaluation of the
+// Laplacian, as in step-37, for polynomial degrees two and four
+
+#include "benchmark.h"
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/parallel_vector.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+
+
+template <int dim, int fe_degree>
+class LaplaceOperator
+{
+public:
+  LaplaceOperator (const MatrixFree<dim,double> &data)
+    :
+    data (data)
+  {}
+
+  void vmult (parallel::distributed::Vector<double>       &dst,
+              const parallel::distributed::Vector<double> &src) const
+  {
+    data.cell_loop (&LaplaceOperator::local_apply, this, dst, src);
+  }
+
+private:
+  void local_apply (const MatrixFree<dim,double>                &data,
+                    parallel::distributed::Vector<double>       &dst,
+                    const parallel::distributed::Vector<double> &src,
+                    const std::pair<unsigned int,unsigned int>  &cell_range) const
+  {
+    FEEvaluation<dim,fe_degree> phi (data);
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+      {
+        phi.reinit (cell);
+        phi.read_dof_values (src);
+        phi.evaluate (false, true);
+        for (unsigned int q=0; q<phi.n_q_points; ++q)
+          phi.submit_gradient (phi.get_gradient(q), q);
+        phi.integrate (false, true);
+        phi.distribute_local_to_global (dst);
+      }
+  }
+
+  const MatrixFree<dim,double> &data;
+};
+
+
+
+template <int dim, int fe_degree>
+void test (Benchmark::Suite  &suite,
+           const unsigned int n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  FE_Q<dim>       fe (fe_degree);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  ConstraintMatrix constraints;
+  constraints.close ();
+
+  MatrixFree<dim,double> matrix_free;
+  matrix_free.reinit (dof_handler, constraints, QGauss<1>(fe_degree+1),
+                      typename MatrixFree<dim,double>::AdditionalData());
+
+  parallel::distributed::Vector<double> src, dst;
+  matrix_free.initialize_dof_vector (src);
+  matrix_free.initialize_dof_vector (dst);
+  for (unsigned int i=0; i<src.local_size(); ++i)
+    src.local_element(i) = 1. + 0.001 * (i%100);
+
+  const LaplaceOperator<dim,fe_degree> laplace_operator (matrix_free);
+
+  // warm up
+  laplace_operator.vmult (dst, src);
+
+  for (unsigned int r=0; r<suite.n_repetitions(); ++r)
+    {
+      suite.start ();
+      for (unsigned int i=0; i<10; ++i)
+        laplace_operator.vmult (dst, src);
+      suite.stop ();
+    }
+
+  // the source and destination vectors are read once, and the destination
+  // vector is written once, in each operator evaluation
+  suite.record ("laplace_q" + Utilities::int_to_string(fe_degree)
+                + "_" + Utilities::int_to_string(dim) + "d",
+                10. * dof_handler.n_dofs(),
+                10. * 3 * sizeof(double) * dof_handler.n_dofs());
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Benchmark::Suite suite ("matrix_free_cell_loop", argc, argv);
+
+  test<2,2> (suite, 8);
+  test<2,4> (suite, 7);
+  test<3,2> (suite, 5);
+  test<3,4> (suite, 4);
+
+  return suite.finalize ();
+}
@@ -0,0 +1,96 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// benchmark Triangulation::execute_coarsening_and_refinement() for global
+// and local refinement, and for coarsening
+
+#include "benchmark.h"
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+
+
+template <int dim>
+void test (Benchmark::Suite  &suite,
+           const unsigned int n_refinements)
+{
+  const std::string suffix = "_" + Utilities::int_to_string(dim) + "d";
+
+  // refine all cells of a mesh
+  unsigned int n_cells = 0;
+  for (unsigned int r=0; r<suite.n_repetitions(); ++r)
+    {
+      Triangulation<dim> tria;
+      GridGenerator::hyper_cube (tria);
+      tria.refine_global (n_refinements-1);
+
+      suite.start ();
+      tria.refine_global (1);
+      suite.stop ();
+      n_cells = tria.n_active_cells();
+    }
+  suite.record ("refine_global" + suffix, n_cells, 0, "cells");
+
+  // refine the cells in a ball around the origin, which requires the mesh
+  // to be smoothed afterwards
+  for (unsigned int r=0; r<suite.n_repetitions(); ++r)
+    {
+      Triangulation<dim> tria (Triangulation<dim>::maximum_smoothing);
+      GridGenerator::hyper_cube (tria, -1, 1);
+      tria.refine_global (n_refinements-1);
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell = tria.begin_active(); cell != tria.end(); ++cell)
+        if (cell->center().norm() < 0.5)
+          cell->set_refine_flag ();
+
+      suite.start ();
+      tria.execute_coarsening_and_refinement ();
+      suite.stop ();
+      n_cells = tria.n_active_cells();
+    }
+  suite.record ("refine_local" + suffix, n_cells, 0, "cells");
+
+  // coarsen all cells of a mesh again
+  for (unsigned int r=0; r<suite.n_repetitions(); ++r)
+    {
+      Triangulation<dim> tria;
+      GridGenerator::hyper_cube (tria);
+      tria.refine_global (n_refinements);
+      n_cells = tria.n_active_cells();
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell = tria.begin_active(); cell != tria.end(); ++cell)
+        cell->set_coarsen_flag ();
+
+      suite.start ();
+      tria.execute_coarsening_and_refinement ();
+      suite.stop ();
+    }
+  suite.record ("coarsen_global" + suffix, n_cells, 0, "cells");
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Benchmark::Suite suite ("refinement", argc, argv);
+
+  test<2> (suite, 9);
+  test<3> (suite, 5);
+
+  return suite.finalize ();
+}
@@ -0,0 +1,94 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// benchmark SparseMatrix::vmult for the sparsity patterns of Q1 and Q2
+// elements in 2d and 3d
+
+#include "benchmark.h"
+
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/matrix_tools.h>
+
+
+template <int dim>
+void test (Benchmark::Suite  &suite,
+           const unsigned int degree,
+           const unsigned int n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  FE_Q<dim>       fe (degree);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  DynamicSparsityPattern dsp (dof_handler.n_dofs());
+  DoFTools::make_sparsity_pattern (dof_handler, dsp);
+  SparsityPattern sparsity;
+  sparsity.copy_from (dsp);
+
+  SparseMatrix<double> matrix (sparsity);
+  MatrixCreator::create_laplace_matrix (dof_handler, QGauss<dim>(degree+1),
+                                        matrix);
+
+  Vector<double> src (dof_handler.n_dofs()), dst (dof_handler.n_dofs());
+  for (unsigned int i=0; i<src.size(); ++i)
+    src(i) = 1. + 0.001 * (i%100);
+
+  // warm up
+  matrix.vmult (dst, src);
+
+  for (unsigned int r=0; r<suite.n_repetitions(); ++r)
+    {
+      suite.start ();
+      for (unsigned int i=0; i<10; ++i)
+        matrix.vmult (dst, src);
+      suite.stop ();
+    }
+
+  // matrix entries and column indices, row starts, and the two vectors
+  const double bytes = 10. * (matrix.n_nonzero_elements() *
+                              (sizeof(double) + sizeof(unsigned int)) +
+                              matrix.m() * (sizeof(std::size_t) +
+                                            2*sizeof(double)));
+  suite.record ("vmult_q" + Utilities::int_to_string(degree) +
+                "_" + Utilities::int_to_string(dim) + "d",
+                10. * dof_handler.n_dofs(), bytes);
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Benchmark::Suite suite ("sparse_matrix_vmult", argc, argv);
+
+  test<2> (suite, 1, 9);
+  test<2> (suite, 2, 8);
+  test<3> (suite, 1, 5);
+  test<3> (suite, 2, 4);
+
+  return suite.finalize ();
+}
@@ -0,0 +1,97 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// benchmark DataOut::build_patches() and DataOut::write_vtu() for a scalar
+// and a vector-valued solution
+
+#include "benchmark.h"
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <sstream>
+
+
+template <int dim>
+void test (Benchmark::Suite  &suite,
+           const unsigned int degree,
+           const unsigned int n_refinements)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  FE_Q<dim>       fe (degree);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  Vector<double> solution (dof_handler.n_dofs());
+  for (unsigned int i=0; i<solution.size(); ++i)
+    solution(i) = 1. + 0.001 * (i%100);
+
+  // output the solution and dim copies of it, which are interpreted as a
+  // vector field
+  std::vector<std::string> names (1, "u");
+  std::vector<DataComponentInterpretation::DataComponentInterpretation>
+  interpretation (1, DataComponentInterpretation::component_is_scalar);
+
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler (dof_handler);
+  data_out.add_data_vector (solution, names, DataOut<dim>::type_dof_data,
+                            interpretation);
+  for (unsigned int d=0; d<dim; ++d)
+    data_out.add_data_vector (solution, "v_" + Utilities::int_to_string(d));
+
+  const std::string suffix = "_q" + Utilities::int_to_string(degree) +
+                             "_" + Utilities::int_to_string(dim) + "d";
+
+  for (unsigned int r=0; r<suite.n_repetitions(); ++r)
+    {
+      suite.start ();
+      data_out.build_patches (degree);
+      suite.stop ();
+    }
+  suite.record ("build_patches" + suffix, dof_handler.n_dofs(), 0);
+
+  std::size_t n_bytes = 0;
+  for (unsigned int r=0; r<suite.n_repetitions(); ++r)
+    {
+      std::ostringstream out;
+      suite.start ();
+      data_out.write_vtu (out);
+      suite.stop ();
+      n_bytes = out.str().size();
+    }
+  // the bandwidth refers to the size of the file written
+  suite.record ("write_vtu" + suffix, dof_handler.n_dofs(), n_bytes);
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Benchmark::Suite suite ("write_vtu", argc, argv);
+
+  test<2> (suite, 2, 7);
+  test<3> (suite, 1, 5);
+  test<3> (suite, 2, 4);
+
+  return suite.finalize ();
+}
@@ -0,0 +1,180 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check SolutionTransfer::build_transfer_matrix: applying the matrix to a
+// vector must give the same result as refine_interpolate() and
+// interpolate(), both for DoFHandler and hp::DoFHandler objects
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/hp/dof_handler.h>
+#include <deal.II/hp/fe_collection.h>
+#include <deal.II/numerics/solution_transfer.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <fstream>
+#include <vector>
+
+
+
+template <typename DoFHandlerType>
+void set_fe_indices (DoFHandlerType &,
+                     const unsigned int)
+{}
+
+
+template <int dim>
+void set_fe_indices (hp::DoFHandler<dim> &dof_handler,
+                     const unsigned int   offset)
+{
+  for (typename hp::DoFHandler<dim>::active_cell_iterator
+       cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+    cell->set_active_fe_index ((cell->index()+offset) % 2);
+}
+
+
+
+Vector<double> make_vector (const unsigned int size,
+                            const unsigned int shift)
+{
+  Vector<double> v (size);
+  for (unsigned int i=0; i<size; ++i)
+    v(i) = 1. + std::sin(1.*i+shift);
+  return v;
+}
+
+
+
+template <int dim, typename DoFHandlerType, typename FEType>
+void test (const FEType &fe)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (5-dim);
+
+  DoFHandlerType dof_handler (tria);
+
+  // pure refinement
+  {
+    set_fe_indices (dof_handler, 0);
+    dof_handler.distribute_dofs (fe);
+    for (typename Triangulation<dim>::active_cell_iterator
+         cell = tria.begin_active(); cell != tria.end(); ++cell)
+      if (cell->center()[0] < 0.5)
+        cell->set_refine_flag ();
+    tria.prepare_coarsening_and_refinement ();
+
+    const Vector<double> old_vector = make_vector (dof_handler.n_dofs(), 0);
+
+    SolutionTransfer<dim, Vector<double>, DoFHandlerType> soltrans (dof_handler);
+    soltrans.prepare_for_pure_refinement ();
+    tria.execute_coarsening_and_refinement ();
+    set_fe_indices (dof_handler, 1);
+    dof_handler.distribute_dofs (fe);
+
+    Vector<double> reference (dof_handler.n_dofs());
+    soltrans.refine_interpolate (old_vector, reference);
+
+    SparsityPattern      sparsity;
+    SparseMatrix<double> transfer_matrix;
+    soltrans.build_transfer_matrix (sparsity, transfer_matrix);
+
+    Vector<double> transferred (dof_handler.n_dofs());
+    transfer_matrix.vmult (transferred, old_vector);
+    transferred -= reference;
+
+    deallog << "refinement: " << transfer_matrix.m() << "x" << transfer_matrix.n()
+            << ", difference " << transferred.linfty_norm() << std::endl;
+  }
+
+  // refinement and coarsening, with several vectors
+  {
+    for (typename Triangulation<dim>::active_cell_iterator
+         cell = tria.begin_active(); cell != tria.end(); ++cell)
+      if (cell->center()[0] < 0.25)
+        cell->set_coarsen_flag ();
+      else if (cell->center()[1] > 0.5)
+        cell->set_refine_flag ();
+    tria.prepare_coarsening_and_refinement ();
+
+    const unsigned int n_vectors = 3;
+    std::vector<Vector<double> > old_vectors;
+    for (unsigned int v=0; v<n_vectors; ++v)
+      old_vectors.push_back (make_vector (dof_handler.n_dofs(), v));
+
+    SolutionTransfer<dim, Vector<double>, DoFHandlerType> soltrans (dof_handler);
+    soltrans.prepare_for_coarsening_and_refinement (old_vectors);
+    SolutionTransfer<dim, Vector<double>, DoFHandlerType> matrix_transfer (dof_handler);
+    matrix_transfer.prepare_for_transfer_matrix ();
+    tria.execute_coarsening_and_refinement ();
+    set_fe_indices (dof_handler, 0);
+    dof_handler.distribute_dofs (fe);
+
+    std::vector<Vector<double> > reference (n_vectors,
+                                            Vector<double>(dof_handler.n_dofs()));
+    soltrans.interpolate (old_vectors, reference);
+
+    SparsityPattern      sparsity;
+    SparseMatrix<double> transfer_matrix;
+    matrix_transfer.build_transfer_matrix (sparsity, transfer_matrix);
+
+    for (unsigned int v=0; v<n_vectors; ++v)
+      {
+        Vector<double> transferred (dof_handler.n_dofs());
+        transfer_matrix.vmult (transferred, old_vectors[v]);
+        transferred -= reference[v];
+
+        deallog << "coarsening and refinement: " << transfer_matrix.m() << "x"
+                << transfer_matrix.n() << ", vector " << v << ", difference "
+                << transferred.linfty_norm() << std::endl;
+      }
+  }
+}
+
+
+
+int main()
+{
+  initlog();
+  deallog.threshold_double (1.e-10);
+
+  deallog.push ("2d");
+  test<2, DoFHandler<2> > (FE_Q<2>(2));
+  test<2, DoFHandler<2> > (FE_DGQ<2>(1));
+  deallog.pop ();
+
+  deallog.push ("3d");
+  test<3, DoFHandler<3> > (FE_Q<3>(2));
+  deallog.pop ();
+
+  deallog.push ("hp");
+  hp::FECollection<2> fe_collection;
+  fe_collection.push_back (FE_Q<2>(1));
+  fe_collection.push_back (FE_Q<2>(2));
+  test<2, hp::DoFHandler<2> > (fe_collection);
+  deallog.pop ();
+}
@@ -0,0 +1,130 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check that MappingQGeneric::transform_points_real_to_unit_cell gives the
+// same results as calling transform_real_to_unit_cell for each point, for
+// points inside and outside of curved and affine cells
+
+#include "../tests.h"
+#include <deal.II/base/array_view.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/tria_boundary_lib.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <fstream>
+#include <limits>
+
+
+template <int dim>
+void check (const Triangulation<dim> &tria,
+            const unsigned int        degree)
+{
+  MappingQGeneric<dim> mapping (degree);
+
+  unsigned int n_inside = 0, n_outside = 0, n_failed = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    {
+      // points around the cell, obtained from random points around the
+      // reference cell
+      std::vector<Point<dim> > real_points;
+      for (unsigned int i=0; i<11; ++i)
+        {
+          Point<dim> p_unit;
+          for (unsigned int d=0; d<dim; ++d)
+            p_unit[d] = 2. * Testing::rand() / RAND_MAX - 0.5;
+          real_points.push_back (mapping.transform_unit_to_real_cell (cell, p_unit));
+        }
+
+      std::vector<Point<dim> > unit_points (real_points.size());
+      mapping.transform_points_real_to_unit_cell (cell,
+                                                  make_array_view (real_points),
+                                                  make_array_view (unit_points));
+
+      for (unsigned int i=0; i<real_points.size(); ++i)
+        try
+          {
+            const Point<dim> p_unit
+              = mapping.transform_real_to_unit_cell (cell, real_points[i]);
+            AssertThrow (p_unit.distance (unit_points[i]) < 1e-10,
+                         ExcInternalError());
+            if (GeometryInfo<dim>::is_inside_unit_cell (p_unit))
+              ++n_inside;
+            else
+              ++n_outside;
+          }
+        catch (const typename Mapping<dim>::ExcTransformationFailed &)
+          {
+            AssertThrow (unit_points[i][0] == std::numeric_limits<double>::infinity(),
+                         ExcInternalError());
+            ++n_failed;
+          }
+    }
+
+  deallog << "degree " << degree << ": "
+          << n_inside << " inside, "
+          << n_outside << " outside, "
+          << n_failed << " failed" << std::endl;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  deallog << "dim=" << dim << std::endl;
+
+  {
+    deallog << "hyper_ball" << std::endl;
+    Triangulation<dim> tria;
+    GridGenerator::hyper_ball (tria);
+    static const HyperBallBoundary<dim> boundary;
+    tria.set_boundary (0, boundary);
+    tria.refine_global (1);
+    for (unsigned int degree=1; degree<=3; ++degree)
+      check (tria, degree);
+  }
+
+  {
+    deallog << "parallelogram" << std::endl;
+    Triangulation<dim> tria;
+    Point<dim> corners[dim];
+    for (unsigned int d=0; d<dim; ++d)
+      {
+        corners[d][d] = 1. + d;
+        corners[d][(d+1)%dim] += 0.5;
+      }
+    GridGenerator::parallelepiped (tria, corners);
+    tria.refine_global (1);
+    for (unsigned int degree=1; degree<=3; ++degree)
+      check (tria, degree);
+  }
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.threshold_double(1.e-10);
+
+  test<2> ();
+  test<3> ();
+}
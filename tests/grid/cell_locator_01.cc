@@ -0,0 +1,131 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check that CellLocator finds the same cells and reference points as
+// GridTools::find_active_cell_around_point, for single points and for
+// batches of points, before and after the mesh is refined
+
+#include "../tests.h"
+#include <deal.II/grid/cell_locator.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+
+#include <fstream>
+
+
+template <int dim>
+void check (const Triangulation<dim> &tria,
+            const CellLocator<dim>   &locator)
+{
+  std::vector<Point<dim> > points;
+  for (unsigned int i=0; i<200; ++i)
+    {
+      Point<dim> p;
+      for (unsigned int d=0; d<dim; ++d)
+        p[d] = 2.4 * Testing::rand() / RAND_MAX - 1.2;
+      points.push_back (p);
+    }
+
+  std::vector<std::pair<typename Triangulation<dim>::active_cell_iterator, Point<dim> > >
+  found;
+  locator.find_active_cells_around_points (points, found);
+  AssertThrow (found.size() == points.size(), ExcInternalError());
+
+  unsigned int n_inside = 0, n_outside = 0;
+  for (unsigned int i=0; i<points.size(); ++i)
+    {
+      bool inside = true;
+      std::pair<typename Triangulation<dim>::active_cell_iterator, Point<dim> >
+      expected;
+      try
+        {
+          expected = GridTools::find_active_cell_around_point
+                     (StaticMappingQ1<dim>::mapping, tria, points[i]);
+        }
+      catch (const GridTools::ExcPointNotFound<dim> &)
+        {
+          inside = false;
+        }
+
+      if (inside)
+        {
+          ++n_inside;
+          AssertThrow (found[i].first == expected.first, ExcInternalError());
+          AssertThrow (found[i].second.distance (expected.second) < 1e-12,
+                       ExcInternalError());
+
+          const std::pair<typename Triangulation<dim>::active_cell_iterator, Point<dim> >
+          single = locator.find_active_cell_around_point (points[i]);
+          AssertThrow (single.first == expected.first, ExcInternalError());
+        }
+      else
+        {
+          ++n_outside;
+          AssertThrow (found[i].first == tria.end(), ExcInternalError());
+          try
+            {
+              locator.find_active_cell_around_point (points[i]);
+              AssertThrow (false, ExcInternalError());
+            }
+          catch (const GridTools::ExcPointNotFound<dim> &)
+            {
+            }
+        }
+    }
+
+  deallog << tria.n_active_cells() << " cells: "
+          << n_inside << " points inside, "
+          << n_outside << " points outside" << std::endl;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  deallog << "dim=" << dim << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball (tria);
+  tria.refine_global (1);
+
+  // the locator follows the refinement of the mesh
+  CellLocator<dim> locator (tria);
+  check (tria, locator);
+
+  unsigned int index = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell, ++index)
+    if (index % 3 == 0)
+      cell->set_refine_flag ();
+  tria.execute_coarsening_and_refinement ();
+  check (tria, locator);
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.threshold_double(1.e-10);
+
+  test<2> ();
+  test<3> ();
+}
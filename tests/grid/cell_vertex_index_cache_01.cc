@@ -0,0 +1,127 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check that the cached vertex indices of cells (see
+// Triangulation::set_cell_vertex_index_caching) agree with the ones
+// computed from the faces of the cells, also after refinement and
+// coarsening and in functions connected to the refinement signals
+
+#include "../tests.h"
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <fstream>
+
+
+template <int dim>
+void compare (const Triangulation<dim> &cached,
+              const Triangulation<dim> &uncached)
+{
+  AssertThrow (cached.n_cells() == uncached.n_cells(), ExcInternalError());
+
+  unsigned int n_checked = 0;
+  typename Triangulation<dim>::cell_iterator
+  cell = cached.begin(), other = uncached.begin();
+  for (; cell != cached.end(); ++cell, ++other)
+    for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+      {
+        AssertThrow (cell->vertex_index(v) == other->vertex_index(v),
+                     ExcInternalError());
+        AssertThrow (cell->vertex(v) == other->vertex(v),
+                     ExcInternalError());
+        ++n_checked;
+      }
+  deallog << "Checked " << n_checked << " vertices on "
+          << cached.n_active_cells() << " active cells" << std::endl;
+}
+
+
+
+template <int dim>
+void check_in_signal (const Triangulation<dim> *cached,
+                      const Triangulation<dim> *uncached)
+{
+  deallog << "post_refinement: cached="
+          << cached->cell_vertex_indices_are_cached() << std::endl;
+  compare (*cached, *uncached);
+}
+
+
+
+template <int dim>
+void test ()
+{
+  deallog << "dim=" << dim << std::endl;
+
+  Triangulation<dim> cached, uncached;
+  cached.set_cell_vertex_index_caching (true);
+  GridGenerator::hyper_ball (cached);
+  GridGenerator::hyper_ball (uncached);
+  compare (cached, uncached);
+
+  cached.refine_global (1);
+  uncached.refine_global (1);
+  compare (cached, uncached);
+
+  // refine some cells, and check the cache in a function connected to the
+  // signal of the cached triangulation. this function is called after the
+  // cached one has been refined, but before the other one
+  cached.signals.post_refinement.connect
+  (std_cxx11::bind (&check_in_signal<dim>, &cached, &uncached));
+  uncached.begin_active()->set_refine_flag ();
+  uncached.execute_coarsening_and_refinement ();
+  cached.begin_active()->set_refine_flag ();
+  cached.execute_coarsening_and_refinement ();
+
+  // coarsen again, which leaves unused cells behind, and refine others
+  // that reuse them
+  for (unsigned int round=0; round<2; ++round)
+    {
+      Triangulation<dim> *trias[2] = { &uncached, &cached };
+      for (unsigned int t=0; t<2; ++t)
+        {
+          unsigned int index = 0;
+          for (typename Triangulation<dim>::active_cell_iterator
+               cell = trias[t]->begin_active(); cell != trias[t]->end();
+               ++cell, ++index)
+            if (cell->level() == 2)
+              cell->set_coarsen_flag ();
+            else if (index % 3 == round)
+              cell->set_refine_flag ();
+          trias[t]->execute_coarsening_and_refinement ();
+        }
+    }
+
+  // switching caching off discards the cache
+  cached.set_cell_vertex_index_caching (false);
+  deallog << "cached=" << cached.cell_vertex_indices_are_cached() << std::endl;
+  compare (cached, uncached);
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.threshold_double(1.e-10);
+
+  test<2> ();
+  test<3> ();
+}
@@ -0,0 +1,145 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check the weights that parallel::distributed::CellWeights computes from
+// the finite elements of an hp::DoFHandler and from measured costs, also
+// those passed through MatrixFree, on a serial triangulation
+
+#include "../tests.h"
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/distributed/cell_weights.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/hp/dof_handler.h>
+#include <deal.II/hp/fe_collection.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/matrix_free/matrix_free.h>
+
+#include <fstream>
+
+
+template <int dim>
+void print_weights (const Triangulation<dim> &tria)
+{
+  // let the cost model compute its scaling as the triangulation would do
+  // before a repartitioning
+  tria.signals.pre_distributed_repartition ();
+
+  unsigned int min_weight = numbers::invalid_unsigned_int, max_weight = 0;
+  double sum = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    {
+      const unsigned int weight
+        = tria.signals.cell_weight (cell, Triangulation<dim>::CELL_PERSIST);
+      AssertThrow (weight == tria.signals.cell_weight (cell, Triangulation<dim>::CELL_REFINE),
+                   ExcInternalError());
+      min_weight = std::min (min_weight, weight);
+      max_weight = std::max (max_weight, weight);
+      sum += weight;
+    }
+  deallog << "weights: min " << min_weight
+          << " max " << max_weight
+          << " average " << sum / tria.n_active_cells()
+          << std::endl;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  deallog << "dim=" << dim << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (2);
+
+  hp::FECollection<dim> fe_collection;
+  fe_collection.push_back (FE_Q<dim>(1));
+  fe_collection.push_back (FE_Q<dim>(3));
+  hp::DoFHandler<dim> hp_dof_handler (tria);
+
+  parallel::distributed::CellWeights<dim> cell_weights (tria);
+  print_weights (tria);
+
+  // cells with cubic elements are more expensive than linear ones
+  unsigned int index = 0;
+  for (typename hp::DoFHandler<dim>::active_cell_iterator
+       cell = hp_dof_handler.begin_active(); cell != hp_dof_handler.end(); ++cell, ++index)
+    cell->set_active_fe_index (index % 2);
+  hp_dof_handler.distribute_dofs (fe_collection);
+
+  cell_weights.set_fe_cost_model (hp_dof_handler, 1.);
+  print_weights (tria);
+  cell_weights.set_fe_cost_model (hp_dof_handler, 2.);
+  print_weights (tria);
+  deallog << "imbalance: " << cell_weights.compute_imbalance() << std::endl;
+
+  // a coarsened cell gets the average cost of its children
+  tria.signals.pre_distributed_repartition ();
+  deallog << "weight of coarsened cell: "
+          << tria.signals.cell_weight (tria.begin(1), Triangulation<dim>::CELL_COARSEN)
+          << std::endl;
+
+  // measured costs take precedence over the model. cells without
+  // measurement get the average measured cost
+  cell_weights.add_measured_cost (tria.begin_active(), 4.);
+  cell_weights.add_measured_cost (tria.begin_active(), 4.);
+  cell_weights.add_measured_cost (++tria.begin_active(), 2.);
+  print_weights (tria);
+
+  // costs measured in a matrix-free loop are distributed to the cells
+  cell_weights.clear_measured_costs ();
+  FE_Q<dim> fe (1);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+  ConstraintMatrix constraints;
+  constraints.close ();
+  MatrixFree<dim> matrix_free;
+  matrix_free.reinit (dof_handler, constraints, QGauss<1>(2),
+                      typename MatrixFree<dim>::AdditionalData());
+  cell_weights.add_measured_cost (matrix_free,
+                                  std::make_pair (0U, matrix_free.n_macro_cells()),
+                                  tria.n_active_cells());
+  print_weights (tria);
+
+  // refinement invalidates the measurements, so the weights come from the
+  // finite elements again
+  tria.begin_active()->set_refine_flag ();
+  tria.execute_coarsening_and_refinement ();
+  hp_dof_handler.distribute_dofs (fe_collection);
+  print_weights (tria);
+
+  deallog << "repartitioned: " << cell_weights.repartition_if_imbalanced (0.1)
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.threshold_double(1.e-10);
+
+  test<2> ();
+  test<3> ();
+}
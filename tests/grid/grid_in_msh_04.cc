@@ -0,0 +1,347 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// write the same mesh in the ASCII and binary variants of the Gmsh format,
+// with sparse vertex numbers, with records that span several lines or share
+// a line, and in the UCD format, and check that all of them are read into
+// the same triangulation
+
+#include "../tests.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_in.h>
+#include <deal.II/grid/grid_generator.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+// the order of the vertices of cells and faces in Gmsh and UCD files
+const unsigned int file_vertex_order[] = { 0, 1, 3, 2, 4, 5, 7, 6 };
+
+
+template <int dim>
+struct Element
+{
+  int                       type;
+  int                       tag;
+  std::vector<unsigned int> vertices;
+};
+
+
+
+template <int dim>
+void collect_elements (const Triangulation<dim>    &tria,
+                       std::vector<Element<dim> >  &elements)
+{
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    {
+      Element<dim> element;
+      element.type = (dim == 2 ? 3 : 5);
+      element.tag = cell->material_id();
+      for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        {
+          const unsigned int file_v = (dim == 2 ?
+                                       file_vertex_order[v] :
+                                       (v < 4 ?
+                                        file_vertex_order[v] :
+                                        file_vertex_order[v-4]+4));
+          element.vertices.push_back (cell->vertex_index(file_v));
+        }
+      elements.push_back (element);
+    }
+
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+      if (cell->at_boundary(f))
+        {
+          Element<dim> element;
+          element.type = (dim == 2 ? 1 : 3);
+          element.tag = cell->face(f)->boundary_id() + 1;
+          for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_face; ++v)
+            element.vertices.push_back (cell->face(f)->vertex_index(file_vertex_order[v]));
+          elements.push_back (element);
+        }
+}
+
+
+
+// the number of a vertex in the file
+long int vertex_number (const unsigned int vertex,
+                        const bool         sparse)
+{
+  return (sparse ? 1000003L * vertex + 5 : vertex + 1);
+}
+
+
+
+// write a mesh in the ASCII format of version 1 or 2 of Gmsh, with one
+// record per line unless free_format is set
+template <int dim>
+void write_msh (const Triangulation<dim> &tria,
+                const unsigned int        version,
+                const bool                sparse,
+                const bool                free_format,
+                std::ostream             &out)
+{
+  std::vector<Element<dim> > elements;
+  collect_elements (tria, elements);
+
+  out << std::setprecision (16);
+  if (version == 2)
+    out << "$MeshFormat\n2.2 0 8\n$EndMeshFormat\n"
+        << "$PhysicalNames\n1\n2 1 \"domain\"\n$EndPhysicalNames\n"
+        << "$Nodes\n";
+  else
+    out << "$NOD\n";
+
+  out << tria.n_vertices() << '\n';
+  for (unsigned int v=0; v<tria.n_vertices(); ++v)
+    {
+      out << vertex_number (v, sparse);
+      for (unsigned int d=0; d<3; ++d)
+        out << ' ' << (d < dim ? tria.get_vertices()[v][d] : 0.);
+      // put two vertices on each line
+      out << ((free_format && (v%2 == 0)) ? ' ' : '\n');
+    }
+
+  out << (version == 2 ? "\n$EndNodes\n$Elements\n" : "\n$ENDNOD\n$ELM\n")
+      << elements.size() << '\n';
+  for (unsigned int e=0; e<elements.size(); ++e)
+    {
+      out << e+1 << ' ' << elements[e].type << ' ';
+      if (version == 2)
+        out << "2 " << elements[e].tag << " 0";
+      else
+        out << elements[e].tag << " 0 " << elements[e].vertices.size();
+      // start the list of vertices on a new line
+      out << (free_format ? '\n' : ' ');
+      for (unsigned int v=0; v<elements[e].vertices.size(); ++v)
+        out << ' ' << vertex_number (elements[e].vertices[v], sparse);
+      out << '\n';
+    }
+  out << (version == 2 ? "$EndElements\n" : "$ENDELM\n");
+}
+
+
+
+template <typename T>
+void write_binary (const T      value,
+                   const bool   swap,
+                   std::ostream &out)
+{
+  char bytes[sizeof(T)];
+  std::memcpy (bytes, &value, sizeof(T));
+  if (swap)
+    std::reverse (bytes, bytes + sizeof(T));
+  out.write (bytes, sizeof(T));
+}
+
+
+
+// write a mesh in the binary format of version 2 of Gmsh, optionally with
+// the opposite byte order
+template <int dim>
+void write_binary_msh (const Triangulation<dim> &tria,
+                       const bool                swap,
+                       std::ostream             &out)
+{
+  std::vector<Element<dim> > elements;
+  collect_elements (tria, elements);
+
+  out << "$MeshFormat\n2.2 1 8\n";
+  write_binary<int> (1, swap, out);
+  out << "\n$EndMeshFormat\n$Nodes\n" << tria.n_vertices() << '\n';
+  for (unsigned int v=0; v<tria.n_vertices(); ++v)
+    {
+      write_binary<int> (vertex_number (v, false), swap, out);
+      for (unsigned int d=0; d<3; ++d)
+        write_binary<double> (d < dim ? tria.get_vertices()[v][d] : 0., swap, out);
+    }
+
+  out << "\n$EndNodes\n$Elements\n" << elements.size() << '\n';
+  // write the elements in blocks of the same type
+  for (unsigned int begin=0, end=0; begin<elements.size(); begin=end)
+    {
+      while ((end < elements.size()) && (elements[end].type == elements[begin].type))
+        ++end;
+      write_binary<int> (elements[begin].type, swap, out);
+      write_binary<int> (end - begin, swap, out);
+      write_binary<int> (2, swap, out);
+      for (unsigned int e=begin; e<end; ++e)
+        {
+          write_binary<int> (e+1, swap, out);
+          write_binary<int> (elements[e].tag, swap, out);
+          write_binary<int> (0, swap, out);
+          for (unsigned int v=0; v<elements[e].vertices.size(); ++v)
+            write_binary<int> (vertex_number (elements[e].vertices[v], false), swap, out);
+        }
+    }
+  out << "\n$EndElements\n";
+}
+
+
+
+template <int dim>
+void write_ucd (const Triangulation<dim> &tria,
+                std::ostream             &out)
+{
+  std::vector<Element<dim> > elements;
+  collect_elements (tria, elements);
+
+  out << std::setprecision (16)
+      << "# a comment\n"
+      << tria.n_vertices() << ' ' << elements.size() << " 0 0 0\n";
+  for (unsigned int v=0; v<tria.n_vertices(); ++v)
+    {
+      out << vertex_number (v, false);
+      for (unsigned int d=0; d<3; ++d)
+        out << ' ' << (d < dim ? tria.get_vertices()[v][d] : 0.);
+      out << '\n';
+    }
+  for (unsigned int e=0; e<elements.size(); ++e)
+    {
+      out << e+1 << ' ' << elements[e].tag << ' '
+          << (elements[e].type == 1 ? "line" :
+              elements[e].type == 3 ? "quad" : "hex");
+      for (unsigned int v=0; v<elements[e].vertices.size(); ++v)
+        out << ' ' << vertex_number (elements[e].vertices[v], false);
+      out << '\n';
+    }
+}
+
+
+
+template <int dim>
+void print_summary (const std::string        &name,
+                    const Triangulation<dim> &tria)
+{
+  std::map<unsigned int, unsigned int> material_ids, boundary_ids;
+  double checksum = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    {
+      ++material_ids[cell->material_id()];
+      for (unsigned int d=0; d<dim; ++d)
+        checksum += (d+1) * (cell->material_id()+1) * cell->center()[d];
+      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+        if (cell->at_boundary(f))
+          ++boundary_ids[cell->face(f)->boundary_id()];
+    }
+
+  deallog << name << ": " << tria.n_vertices() << " vertices, "
+          << tria.n_active_cells() << " cells, checksum " << checksum
+          << std::endl;
+  deallog << "  material ids:";
+  for (std::map<unsigned int, unsigned int>::const_iterator
+       p = material_ids.begin(); p != material_ids.end(); ++p)
+    deallog << ' ' << p->first << ':' << p->second;
+  deallog << std::endl << "  boundary ids:";
+  for (std::map<unsigned int, unsigned int>::const_iterator
+       p = boundary_ids.begin(); p != boundary_ids.end(); ++p)
+    deallog << ' ' << p->first << ':' << p->second;
+  deallog << std::endl;
+}
+
+
+
+template <int dim>
+void read_and_print (const std::string          &name,
+                     const std::string          &content,
+                     typename GridIn<dim>::Format format)
+{
+  std::istringstream in (content);
+  Triangulation<dim> tria;
+  GridIn<dim> grid_in;
+  grid_in.attach_triangulation (tria);
+  grid_in.read (in, format);
+  print_summary (name, tria);
+}
+
+
+
+template <int dim>
+void test (const unsigned int n_subdivisions)
+{
+  deallog << "dim=" << dim << std::endl;
+
+  Triangulation<dim> tria;
+  std::vector<unsigned int> repetitions (dim, n_subdivisions);
+  Point<dim> p1, p2;
+  for (unsigned int d=0; d<dim; ++d)
+    p2[d] = 1;
+  GridGenerator::subdivided_hyper_rectangle (tria, repetitions, p1, p2, true);
+  unsigned int index = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell, ++index)
+    cell->set_material_id (index % 3);
+
+  {
+    std::ostringstream out;
+    write_msh (tria, 2, false, false, out);
+    read_and_print<dim> ("msh 2", out.str(), GridIn<dim>::msh);
+  }
+  {
+    std::ostringstream out;
+    write_msh (tria, 2, true, false, out);
+    read_and_print<dim> ("msh 2, sparse vertex numbers", out.str(), GridIn<dim>::msh);
+  }
+  {
+    std::ostringstream out;
+    write_msh (tria, 2, false, true, out);
+    read_and_print<dim> ("msh 2, free format", out.str(), GridIn<dim>::msh);
+  }
+  {
+    std::ostringstream out;
+    write_msh (tria, 1, false, false, out);
+    read_and_print<dim> ("msh 1", out.str(), GridIn<dim>::msh);
+  }
+  {
+    std::ostringstream out;
+    write_binary_msh (tria, false, out);
+    read_and_print<dim> ("msh 2, binary", out.str(), GridIn<dim>::msh);
+  }
+  {
+    std::ostringstream out;
+    write_binary_msh (tria, true, out);
+    read_and_print<dim> ("msh 2, binary, swapped byte order", out.str(), GridIn<dim>::msh);
+  }
+  {
+    std::ostringstream out;
+    write_ucd (tria, out);
+    read_and_print<dim> ("ucd", out.str(), GridIn<dim>::ucd);
+  }
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.threshold_double(1.e-10);
+
+  test<2> (40);
+  test<3> (12);
+}
@@ -0,0 +1,130 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// rotate the cells of a structured hex mesh randomly, so that neighboring
+// cells disagree about the direction of their common edges, and check that
+// GridReordering makes all edge directions consistent and that a
+// triangulation can be created from the result
+
+#include "../tests.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_reordering.h>
+
+#include <fstream>
+#include <map>
+#include <utility>
+
+
+// the vertex at the position of vertex v after a rotation of the unit cube
+// by 90 degrees around the given axis, with vertices numbered
+// lexicographically
+unsigned int rotate (const unsigned int v,
+                     const unsigned int axis)
+{
+  const unsigned int x = v%2, y = (v/2)%2, z = v/4;
+  switch (axis)
+    {
+    case 0:
+      return x + 2*z + 4*(1-y);
+    case 1:
+      return (1-z) + 2*y + 4*x;
+    default:
+      return y + 2*(1-x) + 4*z;
+    }
+}
+
+
+
+bool edges_are_consistent (const std::vector<CellData<3> > &cells)
+{
+  std::map<std::pair<unsigned int, unsigned int>, unsigned int> edge_start;
+  for (unsigned int c=0; c<cells.size(); ++c)
+    for (unsigned int l=0; l<GeometryInfo<3>::lines_per_cell; ++l)
+      {
+        const unsigned int v0 = cells[c].vertices[GeometryInfo<3>::line_to_cell_vertices(l,0)];
+        const unsigned int v1 = cells[c].vertices[GeometryInfo<3>::line_to_cell_vertices(l,1)];
+        const std::pair<unsigned int, unsigned int> key (std::min(v0,v1), std::max(v0,v1));
+        if (edge_start.find (key) == edge_start.end())
+          edge_start[key] = v0;
+        else if (edge_start[key] != v0)
+          return false;
+      }
+  return true;
+}
+
+
+
+void test (const unsigned int nx,
+           const unsigned int ny,
+           const unsigned int nz)
+{
+  std::vector<Point<3> > vertices;
+  for (unsigned int k=0; k<=nz; ++k)
+    for (unsigned int j=0; j<=ny; ++j)
+      for (unsigned int i=0; i<=nx; ++i)
+        vertices.push_back (Point<3>(i,j,k));
+
+  std::vector<CellData<3> > cells;
+  for (unsigned int k=0; k<nz; ++k)
+    for (unsigned int j=0; j<ny; ++j)
+      for (unsigned int i=0; i<nx; ++i)
+        {
+          unsigned int cell_vertices[8];
+          for (unsigned int v=0; v<8; ++v)
+            cell_vertices[v] = ((k + v/4) * (ny+1) + (j + (v/2)%2)) * (nx+1) + i + v%2;
+
+          // apply a random number of random rotations
+          const unsigned int n_rotations = Testing::rand() % 4;
+          for (unsigned int r=0; r<n_rotations; ++r)
+            {
+              const unsigned int axis = Testing::rand() % 3;
+              unsigned int rotated[8];
+              for (unsigned int v=0; v<8; ++v)
+                rotated[v] = cell_vertices[rotate (v, axis)];
+              std::copy (&rotated[0], &rotated[8], &cell_vertices[0]);
+            }
+
+          cells.push_back (CellData<3>());
+          std::copy (&cell_vertices[0], &cell_vertices[8], &cells.back().vertices[0]);
+        }
+
+  deallog << nx << 'x' << ny << 'x' << nz << " cells" << std::endl;
+  deallog << "consistent before: " << edges_are_consistent (cells) << std::endl;
+  GridReordering<3>::reorder_cells (cells, true);
+  deallog << "consistent after: " << edges_are_consistent (cells) << std::endl;
+
+  Triangulation<3> tria;
+  tria.create_triangulation (vertices, cells, SubCellData());
+  double volume = 0;
+  for (Triangulation<3>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    volume += cell->measure();
+  deallog << "cells: " << tria.n_active_cells()
+          << ", volume: " << volume
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test (4, 3, 2);
+  test (20, 20, 20);
+}
@@ -0,0 +1,114 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check hp::FEValues::precalculate_fe_values(): the objects created up front
+// must give the same results as the ones created lazily in reinit()
+
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/hp/fe_collection.h>
+#include <deal.II/hp/q_collection.h>
+#include <deal.II/hp/fe_values.h>
+
+#include <fstream>
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria, 0, 2);
+
+  hp::FECollection<dim> fe_collection;
+  hp::QCollection<dim>  q_collection;
+  for (unsigned int degree=1; degree<=4; ++degree)
+    {
+      fe_collection.push_back (FE_Q<dim>(degree));
+      q_collection.push_back (QGauss<dim>(degree+1));
+    }
+
+  const UpdateFlags flags = update_values | update_gradients | update_JxW_values;
+  hp::FEValues<dim> precalculated (fe_collection, q_collection, flags);
+  hp::FEValues<dim> lazy (fe_collection, q_collection, flags);
+
+  precalculated.precalculate_fe_values ();
+
+  for (unsigned int i=0; i<fe_collection.size(); ++i)
+    {
+      precalculated.reinit (tria.begin_active(), i, 0, i);
+      lazy.reinit (tria.begin_active(), i, 0, i);
+
+      const FEValues<dim> &fe_values_1 = precalculated.get_present_fe_values();
+      const FEValues<dim> &fe_values_2 = lazy.get_present_fe_values();
+
+      deallog << fe_values_1.get_fe().get_name()
+              << ": dofs_per_cell=" << fe_values_1.dofs_per_cell
+              << ", n_q_points=" << fe_values_1.n_quadrature_points
+              << std::endl;
+
+      for (unsigned int q=0; q<fe_values_1.n_quadrature_points; ++q)
+        {
+          AssertThrow (fe_values_1.JxW(q) == fe_values_2.JxW(q),
+                       ExcInternalError());
+          for (unsigned int k=0; k<fe_values_1.dofs_per_cell; ++k)
+            {
+              AssertThrow (fe_values_1.shape_value(k,q) ==
+                           fe_values_2.shape_value(k,q),
+                           ExcInternalError());
+              AssertThrow (fe_values_1.shape_grad(k,q) ==
+                           fe_values_2.shape_grad(k,q),
+                           ExcInternalError());
+            }
+        }
+    }
+
+  // precalculating a second time, or for explicitly given indices, must not
+  // change anything
+  std::vector<unsigned int> fe_indices (2), mapping_indices (2, 0), q_indices (2);
+  fe_indices[0] = 0;
+  fe_indices[1] = 0;
+  q_indices[0] = 3;
+  q_indices[1] = 3;
+  precalculated.precalculate_fe_values ();
+  precalculated.precalculate_fe_values (fe_indices, mapping_indices, q_indices);
+  precalculated.reinit (tria.begin_active(), 3, 0, 0);
+  deallog << precalculated.get_present_fe_values().get_fe().get_name()
+          << ": n_q_points="
+          << precalculated.get_present_fe_values().n_quadrature_points
+          << std::endl;
+
+  deallog << "OK" << std::endl;
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.threshold_double(1.e-10);
+
+  test<1> ();
+  test<2> ();
+  test<3> ();
+}
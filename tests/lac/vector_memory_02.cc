@@ -0,0 +1,92 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check that GrowingVectorMemory::alloc(model) prefers unused vectors whose
+// size matches the one of the model vector, and check the statistics
+// reported by GrowingVectorMemory::get_statistics()
+
+#include "../tests.h"
+
+#include <deal.II/lac/vector_memory.h>
+#include <deal.II/lac/vector.h>
+
+#include <fstream>
+
+
+template<typename VectorType>
+void
+print_statistics ()
+{
+  const typename GrowingVectorMemory<VectorType>::Statistics stats
+    = GrowingVectorMemory<VectorType>::get_statistics();
+  deallog << "allocations: " << stats.n_allocations
+          << ", matched: " << stats.n_matched_allocations
+          << ", created: " << stats.n_created_vectors
+          << ", vectors: " << stats.n_vectors
+          << ", in use: " << stats.n_vectors_in_use
+          << std::endl;
+}
+
+
+template<typename VectorType>
+void
+test ()
+{
+  GrowingVectorMemory<VectorType> mem;
+
+  VectorType small(5), large(10);
+
+  VectorType *v1 = mem.alloc(small);
+  VectorType *v2 = mem.alloc(large);
+  deallog << "Sizes: " << v1->size() << ' ' << v2->size() << std::endl;
+  print_statistics<VectorType>();
+
+  mem.free(v1);
+  mem.free(v2);
+
+  // the vector of size 10 is the second in the pool, but it should be
+  // found nevertheless
+  VectorType *v3 = mem.alloc(large);
+  deallog << "Reused vector of same size: " << (v3 == v2) << std::endl;
+
+  // now only the vector of size 5 is left, which has to be resized
+  VectorType *v4 = mem.alloc(large);
+  deallog << "Reused other vector: " << (v4 == v1)
+          << ", new size: " << v4->size() << std::endl;
+  print_statistics<VectorType>();
+
+  {
+    typename VectorMemory<VectorType>::Pointer p(mem, small);
+    deallog << "Pointer size: " << p->size() << std::endl;
+    print_statistics<VectorType>();
+  }
+
+  mem.free(v3);
+  mem.free(v4);
+  print_statistics<VectorType>();
+}
+
+
+int
+main()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.threshold_double(1.e-10);
+
+  test<Vector<double> >();
+  test<Vector<float> >();
+}
@@ -0,0 +1,84 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// tests XDMFTimeSeries: the mesh is only written again once it has changed
+
+#include "../tests.h"
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+
+
+template <int dim>
+void write_time_step (XDMFTimeSeries        &time_series,
+                      const DoFHandler<dim> &dof_handler,
+                      const double           time)
+{
+  Vector<double> v (dof_handler.n_dofs());
+  for (unsigned int i=0; i<v.size(); ++i)
+    v(i) = i + time;
+
+  DataOut<dim> data_out;
+  data_out.add_data_vector (dof_handler, v, "linear");
+  data_out.build_patches ();
+
+  time_series.write_time_step (data_out, time);
+  deallog << "time " << time << ": "
+          << time_series.n_mesh_files() << " mesh files, "
+          << time_series.n_time_steps() << " time steps"
+          << std::endl;
+}
+
+
+
+template <int dim>
+void
+test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria, 0., 1.);
+  tria.refine_global (1);
+
+  FE_Q<dim> fe (1);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  XDMFTimeSeries time_series ("solution", MPI_COMM_WORLD);
+  write_time_step (time_series, dof_handler, 0);
+  write_time_step (time_series, dof_handler, 0.5);
+
+  tria.refine_global (1);
+  dof_handler.distribute_dofs (fe);
+  write_time_step (time_series, dof_handler, 1);
+
+  time_series.write_xdmf_file ();
+
+  if (0==Utilities::MPI::this_mpi_process (MPI_COMM_WORLD))
+    cat_file("solution.xdmf");
+}
+
+
+int main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  MPILogInitAll log;
+
+  test<2>();
+}
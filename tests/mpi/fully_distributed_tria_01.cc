@@ -0,0 +1,163 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// create a parallel::fullydistributed::Triangulation from the parts of a
+// serial coarse mesh, refine it globally and locally, and check that the
+// cells and the parallel numbering of the degrees of freedom agree with the
+// ones of the serial mesh refined in the same way
+
+#include "../tests.h"
+#include <deal.II/base/utilities.h>
+#include <deal.II/distributed/fully_distributed_tria.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/lac/parallel_vector.h>
+
+#include <fstream>
+#include <map>
+
+
+template <int dim>
+void flag_cells (Triangulation<dim> &tria)
+{
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    if (cell->is_locally_owned() && (cell->center().norm() < 0.3))
+      cell->set_refine_flag ();
+}
+
+
+
+template <int dim>
+double vertex_value (const Point<dim> &p)
+{
+  double value = 0;
+  for (unsigned int d=0; d<dim; ++d)
+    value += std::pow (10., static_cast<double>(d)) * p[d];
+  return value;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD);
+
+  // partition the coarse mesh into slices in x-direction
+  Triangulation<dim> serial_tria;
+  GridGenerator::subdivided_hyper_cube (serial_tria, 4);
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = serial_tria.begin_active(); cell != serial_tria.end(); ++cell)
+    cell->set_subdomain_id (std::min (static_cast<unsigned int>(cell->center()[0] * 3),
+                                      n_procs-1));
+
+  parallel::fullydistributed::Triangulation<dim> tria (MPI_COMM_WORLD);
+  tria.create_triangulation (parallel::fullydistributed::create_construction_data (serial_tria,
+                             myid));
+
+  tria.refine_global (1);
+  serial_tria.refine_global (1);
+  deallog << "locally owned cells: " << tria.n_locally_owned_active_cells()
+          << " of " << tria.n_global_active_cells()
+          << std::endl;
+
+  flag_cells (tria);
+  flag_cells (serial_tria);
+  tria.execute_coarsening_and_refinement ();
+  serial_tria.execute_coarsening_and_refinement ();
+  deallog << "locally owned cells: " << tria.n_locally_owned_active_cells()
+          << " of " << tria.n_global_active_cells()
+          << std::endl;
+  AssertThrow (tria.n_global_active_cells() == serial_tria.n_active_cells(),
+               ExcInternalError());
+
+  // the locally owned and ghost cells must be cells of the serial mesh
+  std::map<CellId, Point<dim> > serial_cells;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = serial_tria.begin_active(); cell != serial_tria.end(); ++cell)
+    serial_cells[cell->id()] = cell->center();
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    if (!cell->is_artificial())
+      {
+        AssertThrow (serial_cells.find (cell->id()) != serial_cells.end(),
+                     ExcInternalError());
+        AssertThrow (serial_cells[cell->id()].distance (cell->center()) < 1e-12,
+                     ExcInternalError());
+      }
+
+  FE_Q<dim> fe (1);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+  deallog << "locally owned dofs: " << dof_handler.n_locally_owned_dofs()
+          << " of " << dof_handler.n_dofs()
+          << std::endl;
+
+  // write a function of the coordinates of the vertices into a vector by
+  // their owners, and check that the ghost cells see the same values under
+  // their dof indices
+  IndexSet locally_relevant_dofs;
+  DoFTools::extract_locally_relevant_dofs (dof_handler, locally_relevant_dofs);
+  parallel::distributed::Vector<double> coordinates (dof_handler.locally_owned_dofs(),
+                                                     locally_relevant_dofs,
+                                                     MPI_COMM_WORLD);
+  std::vector<types::global_dof_index> dof_indices (fe.dofs_per_cell);
+  for (typename DoFHandler<dim>::active_cell_iterator
+       cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+    if (cell->is_locally_owned())
+      {
+        cell->get_dof_indices (dof_indices);
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          if (dof_handler.locally_owned_dofs().is_element (dof_indices[v]))
+            coordinates (dof_indices[v]) = vertex_value (cell->vertex(v));
+      }
+  coordinates.update_ghost_values ();
+
+  bool ok = true;
+  for (typename DoFHandler<dim>::active_cell_iterator
+       cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+    if (cell->is_ghost())
+      {
+        cell->get_dof_indices (dof_indices);
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          if (std::abs (coordinates (dof_indices[v]) - vertex_value (cell->vertex(v))) > 1e-12)
+            ok = false;
+      }
+  deallog << "dof indices of ghost cells consistent: " << ok << std::endl;
+}
+
+
+
+int main (int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  MPILogInitAll all;
+
+  deallog.push ("2d");
+  test<2> ();
+  deallog.pop ();
+  deallog.push ("3d");
+  test<3> ();
+  deallog.pop ();
+}
@@ -0,0 +1,148 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// evaluate a linear function with RemotePointEvaluation at points that lie
+// on other processors, including points on the boundaries between the
+// subdomains, and check that each point is evaluated exactly once. the
+// mesh is a parallel::fullydistributed::Triangulation whose coarse cells are
+// partitioned into slices, so that the test only needs MPI
+
+#include "../tests.h"
+#include <deal.II/base/function.h>
+#include <deal.II/base/index_set.h>
+#include <deal.II/lac/parallel_vector.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/numerics/remote_point_evaluation.h>
+#include <deal.II/numerics/vector_tools.h>
+#include <deal.II/distributed/fully_distributed_tria.h>
+
+#include <fstream>
+
+
+template <int dim>
+class LinearFunction : public Function<dim>
+{
+public:
+  virtual double value (const Point<dim>   &p,
+                        const unsigned int) const
+  {
+    double value = 0;
+    for (unsigned int d=0; d<dim; ++d)
+      value += (d+1) * p[d];
+    return value;
+  }
+};
+
+
+
+template <int dim>
+void test ()
+{
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  const unsigned int n_procs = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD);
+
+  Triangulation<dim> serial_tria;
+  GridGenerator::subdivided_hyper_cube (serial_tria, 4);
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = serial_tria.begin_active(); cell != serial_tria.end(); ++cell)
+    cell->set_subdomain_id (std::min (static_cast<unsigned int>(cell->center()[0] * 3),
+                                      n_procs-1));
+
+  parallel::fullydistributed::Triangulation<dim> tria (MPI_COMM_WORLD);
+  tria.create_triangulation (parallel::fullydistributed::create_construction_data (serial_tria,
+                             my_rank));
+  tria.refine_global (1);
+
+  FE_Q<dim> fe (1);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  IndexSet locally_relevant_dofs;
+  DoFTools::extract_locally_relevant_dofs (dof_handler, locally_relevant_dofs);
+  parallel::distributed::Vector<double> solution (dof_handler.locally_owned_dofs(),
+                                                  locally_relevant_dofs,
+                                                  MPI_COMM_WORLD);
+  VectorTools::interpolate (dof_handler, LinearFunction<dim>(), solution);
+  solution.update_ghost_values ();
+
+  // every processor asks for the same number of points at different
+  // locations, among them points on faces and vertices of the mesh
+  std::vector<Point<dim> > points;
+  for (unsigned int i=0; i<20; ++i)
+    {
+      Point<dim> p;
+      for (unsigned int d=0; d<dim; ++d)
+        p[d] = (i % 4 == 0 ?
+                0.125 * ((i + 3*d + my_rank) % 9) :
+                (1. + i + 7.*d + 3.*my_rank) / 64. - std::floor ((1. + i + 7.*d + 3.*my_rank) / 64.));
+      points.push_back (p);
+    }
+
+  RemotePointEvaluation<dim> evaluation (tria);
+  evaluation.reinit (points);
+
+  std::vector<Vector<double> > values;
+  std::vector<std::vector<Tensor<1,dim> > > gradients;
+  evaluation.evaluate_values (dof_handler, solution, values);
+  evaluation.evaluate_gradients (dof_handler, solution, gradients);
+
+  unsigned int n_found = 0;
+  for (unsigned int i=0; i<points.size(); ++i)
+    if (evaluation.point_found (i))
+      {
+        ++n_found;
+        AssertThrow (std::abs (values[i][0] - LinearFunction<dim>().value (points[i], 0)) < 1e-10,
+                     ExcInternalError());
+        for (unsigned int d=0; d<dim; ++d)
+          AssertThrow (std::abs (gradients[i][0][d] - (d+1.)) < 1e-10,
+                       ExcInternalError());
+      }
+
+  const unsigned int n_total_found = Utilities::MPI::sum (n_found, MPI_COMM_WORLD);
+  if (my_rank == 0)
+    deallog << n_total_found << " points found, values and gradients OK" << std::endl;
+}
+
+
+
+int main (int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+
+  if (Utilities::MPI::this_mpi_process (MPI_COMM_WORLD) == 0)
+    {
+      std::ofstream logfile("output");
+      deallog.attach(logfile, false);
+      deallog.threshold_double(1.e-10);
+
+      deallog.push("2d");
+      test<2>();
+      deallog.pop();
+      deallog.push("3d");
+      test<3>();
+      deallog.pop();
+    }
+  else
+    {
+      test<2>();
+      test<3>();
+    }
+}
@@ -0,0 +1,99 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// write output through a BackgroundWriter and check that the files are the
+// same as the ones written directly, even if the DataOut object is destroyed
+// before the output is written, and that the staging area is bounded and
+// released once the requests are completed
+
+#include "../tests.h"
+#include <deal.II/base/background_writer.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <fstream>
+#include <sstream>
+
+
+std::string read_file (const std::string &filename)
+{
+  std::ifstream in (filename.c_str(), std::ios::binary);
+  std::ostringstream contents;
+  contents << in.rdbuf();
+  return contents.str();
+}
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (2);
+
+  FE_Q<dim> fe (2);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  Vector<double> solution (dof_handler.n_dofs());
+  for (unsigned int i=0; i<solution.size(); ++i)
+    solution(i) = i;
+
+  // allow for only a few bytes in the staging area, so that every request
+  // has to wait for the previous one
+  BackgroundWriter writer (1);
+
+  std::ostringstream reference;
+  {
+    DataOut<dim> data_out;
+    data_out.attach_dof_handler (dof_handler);
+    data_out.add_data_vector (solution, "solution");
+    data_out.build_patches (2);
+    data_out.set_flags (DataOutBase::VtkFlags (std::numeric_limits<double>::min(),
+                                               std::numeric_limits<unsigned int>::min(),
+                                               false));
+
+    data_out.write_vtu (reference);
+    data_out.write_vtu_in_background (writer, "output.vtu");
+  }
+
+  std::vector<char> buffer (3, 'a');
+  writer.write ("output.dat", buffer);
+  deallog << "buffer size after write: " << buffer.size() << std::endl;
+  // the worker thread may or may not have written the buffer already
+  deallog << "staged memory <= 3: " << (writer.staged_memory() <= 3) << std::endl;
+
+  writer.wait ();
+  deallog << "staged memory after wait: " << writer.staged_memory() << std::endl;
+
+  deallog << "vtu identical: " << (read_file ("output.vtu") == reference.str()) << std::endl;
+  deallog << "dat: " << read_file ("output.dat") << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<2> ();
+  test<3> ();
+}
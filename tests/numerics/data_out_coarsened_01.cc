@@ -0,0 +1,170 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check DataOut::build_coarsened_patches: a linear function must be
+// represented exactly on the coarser patches, cell data must be averaged to
+// the centers of the coarse cells, and the patches must cover the domain
+// (or the given box)
+
+#include "../tests.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <fstream>
+
+
+// have a class that makes sure we can get at the patches the base class
+// generates
+template <int dim>
+class XDataOut : public DataOut<dim>
+{
+public:
+  const std::vector<typename ::DataOutBase::Patch<dim,dim> > &
+  get_patches() const
+  {
+    return DataOut<dim>::get_patches();
+  }
+};
+
+
+
+template <int dim>
+double linear_function (const Point<dim> &p)
+{
+  double value = 1;
+  for (unsigned int d=0; d<dim; ++d)
+    value += (d+1) * p[d];
+  return value;
+}
+
+
+
+template <int dim>
+void check (const XDataOut<dim> &data_out,
+            const double         factor)
+{
+  const std::vector<DataOutBase::Patch<dim,dim> > &patches = data_out.get_patches();
+
+  double nodal_error = 0, cell_error = 0, measure = 0;
+  for (unsigned int i=0; i<patches.size(); ++i)
+    {
+      Point<dim> center;
+      for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        {
+          nodal_error = std::max (nodal_error,
+                                  std::fabs (patches[i].data(0,v) -
+                                             factor * linear_function (patches[i].vertices[v])));
+          center += patches[i].vertices[v] / GeometryInfo<dim>::vertices_per_cell;
+        }
+      cell_error = std::max (cell_error,
+                             std::fabs (patches[i].data(1,0) - center[0]));
+
+      const Tensor<1,dim> diagonal = (patches[i].vertices[GeometryInfo<dim>::vertices_per_cell-1]
+                                      - patches[i].vertices[0]);
+      double cell_measure = 1;
+      for (unsigned int d=0; d<dim; ++d)
+        cell_measure *= diagonal[d];
+      measure += cell_measure;
+    }
+
+  deallog << "patches: " << patches.size()
+          << ", measure: " << measure
+          << ", nodal data exact: " << (nodal_error < 1e-12)
+          << ", cell data exact: " << (cell_error < 1e-12)
+          << std::endl;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  deallog << "dim=" << dim << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (2);
+  tria.begin_active()->set_refine_flag ();
+  tria.execute_coarsening_and_refinement ();
+
+  FE_Q<dim> fe (1);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  Vector<double> solution (dof_handler.n_dofs());
+  Vector<double> cell_data (tria.n_active_cells());
+  for (typename DoFHandler<dim>::active_cell_iterator
+       cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+    {
+      for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        solution(cell->vertex_dof_index(v,0)) = linear_function (cell->vertex(v));
+      cell_data(cell->active_cell_index()) = cell->center()[0];
+    }
+
+  XDataOut<dim> data_out;
+  data_out.attach_dof_handler (dof_handler);
+  data_out.add_data_vector (solution, "solution");
+  data_out.add_data_vector (cell_data, "cell_data");
+
+  for (unsigned int level=0; level<3; ++level)
+    {
+      deallog << "level " << level << std::endl;
+      data_out.build_coarsened_patches (level);
+      check (data_out, 1.);
+    }
+
+  deallog << "level beyond the finest one" << std::endl;
+  data_out.build_coarsened_patches (10);
+  check (data_out, 1.);
+
+  Point<dim> lower_corner, upper_corner;
+  for (unsigned int d=0; d<dim; ++d)
+    upper_corner[d] = 1;
+
+  deallog << "box" << std::endl;
+  upper_corner[0] = 0.4;
+  data_out.build_coarsened_patches (1, lower_corner, upper_corner);
+  check (data_out, 1.);
+
+  deallog << "slice" << std::endl;
+  lower_corner[0] = 0.3;
+  upper_corner[0] = 0.3;
+  data_out.build_coarsened_patches (1, lower_corner, upper_corner);
+  check (data_out, 1.);
+
+  deallog << "updated data" << std::endl;
+  solution *= 2;
+  data_out.update_patch_data ();
+  check (data_out, 2.);
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<1> ();
+  test<2> ();
+  test<3> ();
+}
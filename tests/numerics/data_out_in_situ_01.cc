@@ -0,0 +1,89 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// hand the flat arrays of a DataOut object to an in-situ callback, first
+// with a new mesh and then with only the data updated
+
+#include "../tests.h"
+#include <deal.II/base/std_cxx11/bind.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <fstream>
+#include <numeric>
+
+
+const double *last_points = 0;
+
+
+void in_situ_callback (const DataOutBase::FlatData &flat_data)
+{
+  deallog << "points: " << flat_data.n_points()
+          << ", cells: " << flat_data.n_cells()
+          << ", vertices per cell: " << flat_data.vertices_per_cell
+          << ", VTK cell type: " << flat_data.vtk_cell_type
+          << std::endl;
+  deallog << "mesh updates: " << flat_data.n_mesh_updates
+          << ", point sum: "
+          << std::accumulate (flat_data.points.begin(), flat_data.points.end(), 0.)
+          << ", connectivity sum: "
+          << std::accumulate (flat_data.connectivity.begin(), flat_data.connectivity.end(), 0U)
+          << std::endl;
+  for (unsigned int i=0; i<flat_data.data_names.size(); ++i)
+    deallog << "data set " << flat_data.data_names[i] << ": sum "
+            << std::accumulate (&flat_data.data(i,0),
+                                &flat_data.data(i,0) + flat_data.n_points(),
+                                0.)
+            << std::endl;
+
+  if (last_points != 0)
+    deallog << "same points array: " << (last_points == &flat_data.points[0])
+            << std::endl;
+  last_points = &flat_data.points[0];
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  Triangulation<2> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (1);
+
+  FE_Q<2> fe (1);
+  DoFHandler<2> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  Vector<double> solution (dof_handler.n_dofs());
+  solution = 1;
+
+  DataOut<2> data_out;
+  data_out.attach_dof_handler (dof_handler);
+  data_out.add_data_vector (solution, "solution");
+  data_out.build_patches ();
+  data_out.attach_in_situ_callback (&in_situ_callback);
+  data_out.write_in_situ ();
+
+  solution = 2;
+  data_out.update_patch_data ();
+  data_out.write_in_situ (false);
+}
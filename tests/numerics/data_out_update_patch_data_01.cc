@@ -0,0 +1,142 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// build patches once, then change the data vectors and only update the data
+// on the patches. check that the output is the same as the one of a DataOut
+// object that builds its patches from scratch
+
+#include "../tests.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <fstream>
+#include <sstream>
+
+
+std::vector<double> read_numbers (const std::string &output)
+{
+  std::istringstream in (output);
+  std::vector<double> numbers;
+  std::string line;
+  while (std::getline (in, line))
+    if ((line.size() > 0) && (line[0] != '#'))
+      {
+        std::istringstream line_in (line);
+        double x;
+        while (line_in >> x)
+          numbers.push_back (x);
+      }
+  return numbers;
+}
+
+
+
+template <int dim>
+std::string write (const DoFHandler<dim> &dof_handler,
+                   const DoFHandler<dim> &dof_system,
+                   const Vector<double>  &scalar,
+                   const Vector<double>  &system,
+                   const Vector<double>  &cell_data)
+{
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler (dof_handler);
+  data_out.add_data_vector (scalar, "scalar");
+  data_out.add_data_vector (dof_system, system, "system");
+  data_out.add_data_vector (cell_data, "cell_data");
+  data_out.build_patches (3);
+
+  std::ostringstream out;
+  data_out.write_gnuplot (out);
+  return out.str();
+}
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (1);
+  tria.begin_active()->set_refine_flag ();
+  tria.execute_coarsening_and_refinement ();
+
+  FE_Q<dim> fe_scalar (2);
+  DoFHandler<dim> dof_scalar (tria);
+  dof_scalar.distribute_dofs (fe_scalar);
+
+  FESystem<dim> fe_system (FE_Q<dim>(1), 2, FE_DGQ<dim>(2), 1);
+  DoFHandler<dim> dof_system (tria);
+  dof_system.distribute_dofs (fe_system);
+
+  Vector<double> scalar (dof_scalar.n_dofs());
+  Vector<double> system (dof_system.n_dofs());
+  Vector<double> cell_data (tria.n_active_cells());
+
+  DataOut<dim> data_out;
+  data_out.attach_dof_handler (dof_scalar);
+  data_out.add_data_vector (scalar, "scalar");
+  data_out.add_data_vector (dof_system, system, "system");
+  data_out.add_data_vector (cell_data, "cell_data");
+  data_out.build_patches (3);
+
+  for (unsigned int step=0; step<3; ++step)
+    {
+      for (unsigned int i=0; i<scalar.size(); ++i)
+        scalar(i) = std::sin (1.*i*(step+1));
+      for (unsigned int i=0; i<system.size(); ++i)
+        system(i) = std::cos (1.*i*(step+2));
+      for (unsigned int i=0; i<cell_data.size(); ++i)
+        cell_data(i) = i + step;
+
+      data_out.update_patch_data ();
+      std::ostringstream out;
+      data_out.write_gnuplot (out);
+
+      const std::vector<double> updated = read_numbers (out.str());
+      const std::vector<double> reference
+        = read_numbers (write (dof_scalar, dof_system, scalar, system, cell_data));
+
+      double difference = 0;
+      for (unsigned int i=0; i<updated.size(); ++i)
+        difference = std::max (difference,
+                               std::fabs (updated[i] - reference[i]));
+      deallog << "step " << step
+              << ": same size: "
+              << (updated.size() == reference.size())
+              << ", same values: " << (difference < 1e-12)
+              << std::endl;
+    }
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<1> ();
+  test<2> ();
+  test<3> ();
+}
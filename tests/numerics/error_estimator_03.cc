@@ -0,0 +1,133 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// compute the Kelly indicators for several vectors on a mesh with hanging
+// nodes, once for all cells and once for each subdomain separately. the
+// indicators of the cells of a subdomain must be the same in both cases,
+// irrespective of which cell the faces between subdomains are integrated on
+
+#include "../tests.h"
+#include <deal.II/base/logstream.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/numerics/error_estimator.h>
+
+#include <fstream>
+#include <vector>
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (2);
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    if (cell->center()[0] < 0.5)
+      cell->set_refine_flag ();
+  tria.execute_coarsening_and_refinement ();
+
+  const unsigned int n_subdomains = 3;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    cell->set_subdomain_id (cell->active_cell_index() % n_subdomains);
+
+  FE_Q<dim> fe (2);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  const unsigned int n_vectors = 2;
+  std::vector<Vector<double> > solutions (n_vectors, Vector<double>(dof_handler.n_dofs()));
+  for (unsigned int v=0; v<n_vectors; ++v)
+    for (unsigned int i=0; i<dof_handler.n_dofs(); ++i)
+      solutions[v](i) = std::sin (1.*(v+1)*i);
+
+  std::vector<const Vector<double> *> solution_ptrs (n_vectors);
+  std::vector<Vector<float> > indicators (n_vectors);
+  std::vector<Vector<float> *> indicator_ptrs (n_vectors);
+  for (unsigned int v=0; v<n_vectors; ++v)
+    {
+      solution_ptrs[v] = &solutions[v];
+      indicator_ptrs[v] = &indicators[v];
+    }
+
+  KellyErrorEstimator<dim>::estimate (dof_handler, QGauss<dim-1>(3),
+                                      typename FunctionMap<dim>::type(),
+                                      solution_ptrs, indicator_ptrs);
+  deallog << "cells: " << tria.n_active_cells() << std::endl;
+  for (unsigned int v=0; v<n_vectors; ++v)
+    deallog << "vector " << v << ": l2 norm of indicators "
+            << indicators[v].l2_norm() << std::endl;
+
+  for (unsigned int s=0; s<n_subdomains; ++s)
+    {
+      std::vector<Vector<float> > subdomain_indicators (n_vectors);
+      std::vector<Vector<float> *> subdomain_indicator_ptrs (n_vectors);
+      for (unsigned int v=0; v<n_vectors; ++v)
+        subdomain_indicator_ptrs[v] = &subdomain_indicators[v];
+
+      KellyErrorEstimator<dim>::estimate (dof_handler, QGauss<dim-1>(3),
+                                          typename FunctionMap<dim>::type(),
+                                          solution_ptrs, subdomain_indicator_ptrs,
+                                          ComponentMask(), 0,
+                                          numbers::invalid_unsigned_int, s);
+
+      for (unsigned int v=0; v<n_vectors; ++v)
+        {
+          double difference = 0;
+          for (typename Triangulation<dim>::active_cell_iterator
+               cell = tria.begin_active(); cell != tria.end(); ++cell)
+            {
+              const unsigned int index = cell->active_cell_index();
+              if (cell->subdomain_id() == s)
+                difference = std::max (difference,
+                                       std::fabs (1.*subdomain_indicators[v](index) -
+                                                  indicators[v](index)));
+              else
+                difference = std::max (difference,
+                                       std::fabs (1.*subdomain_indicators[v](index)));
+            }
+          deallog << "subdomain " << s << ", vector " << v
+                  << ": difference " << difference << std::endl;
+        }
+    }
+}
+
+
+
+int main ()
+{
+  initlog();
+  deallog.threshold_double (1.e-10);
+
+  deallog.push ("2d");
+  test<2> ();
+  deallog.pop ();
+
+  deallog.push ("3d");
+  test<3> ();
+  deallog.pop ();
+}
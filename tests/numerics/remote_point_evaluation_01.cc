@@ -0,0 +1,167 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2016 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// check that RemotePointEvaluation on a serial triangulation gives the same
+// values and gradients as VectorTools::point_value and
+// VectorTools::point_gradient, for several vectors on the same points and
+// after the mesh has been refined
+
+#include "../tests.h"
+#include <deal.II/base/function.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/mapping_q.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/tria_boundary_lib.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/numerics/remote_point_evaluation.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <fstream>
+
+
+template <int dim>
+class MyFunction : public Function<dim>
+{
+public:
+  MyFunction () : Function<dim>(2) {}
+
+  virtual double value (const Point<dim>   &p,
+                        const unsigned int  component) const
+  {
+    return (component == 0 ? p.square() : p[0] - 2*p[dim-1]*p[0]);
+  }
+};
+
+
+
+template <int dim>
+void check (const Mapping<dim>               &mapping,
+            const DoFHandler<dim>            &dof_handler,
+            const RemotePointEvaluation<dim> &evaluation,
+            const std::vector<Point<dim> >   &points,
+            const Vector<double>             &solution)
+{
+  std::vector<Vector<double> > values;
+  std::vector<std::vector<Tensor<1,dim> > > gradients;
+  evaluation.evaluate_values (dof_handler, solution, values);
+  evaluation.evaluate_gradients (dof_handler, solution, gradients);
+  AssertThrow (values.size() == points.size(), ExcInternalError());
+  AssertThrow (gradients.size() == points.size(), ExcInternalError());
+
+  const unsigned int n_components = dof_handler.get_fe().n_components();
+  unsigned int n_found = 0;
+  double value_error = 0, gradient_error = 0;
+  for (unsigned int i=0; i<points.size(); ++i)
+    if (evaluation.point_found (i))
+      {
+        ++n_found;
+        Vector<double> value (n_components);
+        std::vector<Tensor<1,dim> > gradient (n_components);
+        VectorTools::point_value (mapping, dof_handler, solution, points[i], value);
+        VectorTools::point_gradient (mapping, dof_handler, solution, points[i], gradient);
+        for (unsigned int c=0; c<n_components; ++c)
+          {
+            value_error = std::max (value_error, std::abs (value[c] - values[i][c]));
+            gradient_error = std::max (gradient_error, (gradient[c] - gradients[i][c]).norm());
+          }
+      }
+    else
+      {
+        // the point lies outside of the domain
+        bool outside = false;
+        try
+          {
+            GridTools::find_active_cell_around_point (mapping, dof_handler, points[i]);
+          }
+        catch (const GridTools::ExcPointNotFound<dim> &)
+          {
+            outside = true;
+          }
+        AssertThrow (outside, ExcInternalError());
+        AssertThrow (values[i].l2_norm() == 0, ExcInternalError());
+      }
+
+  deallog << n_found << " of " << points.size() << " points found, "
+          << "errors: " << value_error << ' ' << gradient_error << std::endl;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  deallog << "dim=" << dim << std::endl;
+
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball (tria);
+  static const HyperBallBoundary<dim> boundary;
+  tria.set_boundary (0, boundary);
+  tria.refine_global (1);
+
+  MappingQ<dim> mapping (2);
+  FESystem<dim> fe (FE_Q<dim>(2), 2);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  std::vector<Point<dim> > points;
+  for (unsigned int i=0; i<100; ++i)
+    {
+      Point<dim> p;
+      for (unsigned int d=0; d<dim; ++d)
+        p[d] = 2.2 * Testing::rand() / RAND_MAX - 1.1;
+      points.push_back (p);
+    }
+  // also a vertex of the mesh, which lies in several cells
+  points.push_back (Point<dim>());
+
+  RemotePointEvaluation<dim> evaluation (tria, mapping);
+  evaluation.reinit (points);
+
+  // evaluate several functions on the same points
+  Vector<double> solution (dof_handler.n_dofs());
+  VectorTools::interpolate (mapping, dof_handler,
+                            MyFunction<dim>(), solution);
+  check (mapping, dof_handler, evaluation, points, solution);
+  solution.add (1.);
+  check (mapping, dof_handler, evaluation, points, solution);
+
+  // refine the mesh, which requires setting up the evaluation again
+  tria.begin_active()->set_refine_flag ();
+  tria.execute_coarsening_and_refinement ();
+  dof_handler.distribute_dofs (fe);
+  solution.reinit (dof_handler.n_dofs());
+  VectorTools::interpolate (mapping, dof_handler,
+                            MyFunction<dim>(), solution);
+  evaluation.reinit (points);
+  check (mapping, dof_handler, evaluation, points, solution);
+}
+
+
+
+int main ()
+{
+  std::ofstream logfile("output");
+  deallog.attach(logfile);
+  deallog.threshold_double(1.e-10);
+
+  test<2> ();
+  test<3> ();
+}
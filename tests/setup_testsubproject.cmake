@@ -3,7 +3,8 @@ FIND_PACKAGE(deal.II 8.5.0 REQUIRED HINTS ${DEAL_II_DIR})
 SET(CMAKE_BUILD_TYPE DebugRelease CACHE STRING "" FORCE)
 DEAL_II_INITIALIZE_CACHED_VARIABLES()
 
-FOREACH(_var DIFF_DIR NUMDIFF_DIR TEST_PICKUP_REGEX TEST_TIME_LIMIT)
+FOREACH(_var DIFF_DIR NUMDIFF_DIR TEST_PICKUP_REGEX TEST_TIME_LIMIT
+    BENCHMARK_BASELINE_DIR BENCHMARK_TOLERANCE BENCHMARK_N_THREADS)
   SET_IF_EMPTY(${_var} "$ENV{${_var}}")
   SET(${_var} "${${_var}}" CACHE STRING "" FORCE)
 ENDFOREACH()